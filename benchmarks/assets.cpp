@@ -0,0 +1,979 @@
+#include "syzygy/assets/cooking.hpp"
+#include "syzygy/assets/texturecache.hpp"
+#include "syzygy/core/log.hpp"
+#include "syzygy/core/threadpool.hpp"
+#include "syzygy/platform/filesystemutils.hpp"
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/renderer/gputypes.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fastgltf/core.hpp>
+#include <fastgltf/types.hpp>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <numbers>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef SZG_BENCHMARK_UPLOADS
+#include "syzygy/assets/assets.hpp"
+#include "syzygy/assets/assetsdetail.hpp"
+#include "syzygy/editor/graphicscontext.hpp"
+#include "syzygy/platform/vulkanusage.hpp"
+#include "syzygy/renderer/buffers.hpp"
+#include "syzygy/renderer/imageview.hpp"
+#include "syzygy/renderer/material.hpp"
+#include "syzygy/renderer/uploadqueue.hpp"
+#include <memory>
+#endif
+
+// Times each stage of importing assets on its own: parsing glTFs, cooking
+// their meshes, decoding and encoding images, then staging and submitting
+// their uploads to a headless device. Runs on a synthetic grid mesh and image,
+// the bundled assets, and any glTFs or images passed as arguments.
+//
+// Usage: SyzygyAssetBenchmark [--json <path>] [path...]
+//
+// Results are printed, and written as JSON with throughput in MB/s, and in
+// vertices/s for geometry, so runs can be compared by scripts. Upload stages
+// are only built with the editor, which creates the device, and prefer a
+// software device such as lavapipe so that runs are comparable between
+// machines.
+
+namespace
+{
+size_t constexpr ITERATIONS{3};
+double constexpr BYTES_PER_MEGABYTE{1024.0 * 1024.0};
+
+// Vertices along each side of the synthetic grid.
+uint32_t constexpr GRID_DIMENSIONS{512};
+
+// At the limit of STBI_MAX_DIMENSIONS, which the cooking library is built with.
+uint32_t constexpr SYNTHETIC_IMAGE_DIMENSIONS{2048};
+
+struct StageResult
+{
+    std::string asset{};
+    std::string stage{};
+    double seconds{0.0};
+    // The bytes the stage consumes, such as the encoded image when decoding.
+    size_t bytes{0};
+    // Only for stages that process geometry.
+    std::optional<size_t> vertices{};
+
+    [[nodiscard]] auto megabytesPerSecond() const -> double
+    {
+        return seconds > 0.0
+                 ? static_cast<double>(bytes) / BYTES_PER_MEGABYTE / seconds
+                 : 0.0;
+    }
+    [[nodiscard]] auto verticesPerSecond() const -> std::optional<double>
+    {
+        if (!vertices.has_value() || seconds <= 0.0)
+        {
+            return std::nullopt;
+        }
+        return static_cast<double>(vertices.value()) / seconds;
+    }
+};
+
+struct Results
+{
+    std::vector<StageResult> stages{};
+    size_t failures{0};
+
+    // A missing duration means the stage failed.
+    void add(
+        std::string_view const asset,
+        std::string_view const stage,
+        std::optional<double> const seconds,
+        size_t const bytes,
+        std::optional<size_t> const vertices = std::nullopt
+    )
+    {
+        if (!seconds.has_value())
+        {
+            std::cout << std::format("{:<40} {:<22} FAILED\n", asset, stage);
+            failures++;
+            return;
+        }
+
+        StageResult const& result{stages.emplace_back(StageResult{
+            .asset = std::string{asset},
+            .stage = std::string{stage},
+            .seconds = seconds.value(),
+            .bytes = bytes,
+            .vertices = vertices,
+        })};
+
+        std::cout << std::format(
+            "{:<40} {:<22} {:>10.3f} ms {:>10.1f} MB/s",
+            asset,
+            stage,
+            result.seconds * 1000.0,
+            result.megabytesPerSecond()
+        );
+        if (std::optional<double> const verticesPerSecond{
+                result.verticesPerSecond()
+            };
+            verticesPerSecond.has_value())
+        {
+            std::cout << std::format(
+                " {:>14.0f} vertices/s", verticesPerSecond.value()
+            );
+        }
+        std::cout << "\n";
+    }
+};
+
+using Clock = std::chrono::steady_clock;
+
+auto secondsBetween(Clock::time_point const start, Clock::time_point const end)
+    -> double
+{
+    return std::chrono::duration<double>(end - start).count();
+}
+
+// Returns the fastest of several runs, or nullopt if any run fails.
+auto measure(std::function<bool()> const& run) -> std::optional<double>
+{
+    std::optional<double> fastest{};
+    for (size_t iteration{0}; iteration < ITERATIONS; iteration++)
+    {
+        Clock::time_point const start{Clock::now()};
+        if (!run())
+        {
+            return std::nullopt;
+        }
+        double const seconds{secondsBetween(start, Clock::now())};
+        fastest = std::min(fastest.value_or(seconds), seconds);
+    }
+    return fastest;
+}
+
+auto fileSize(std::filesystem::path const& path) -> size_t
+{
+    std::error_code error{};
+    uintmax_t const size{std::filesystem::file_size(path, error)};
+    return error ? 0 : static_cast<size_t>(size);
+}
+
+// A heightfield of gentle waves, so the grid is not trivially simplified into
+// a few triangles when its levels of detail are built.
+auto writeSyntheticGLTF(std::filesystem::path const& directory)
+    -> std::optional<std::filesystem::path>
+{
+    size_t constexpr VERTEX_COUNT{
+        static_cast<size_t>(GRID_DIMENSIONS) * GRID_DIMENSIONS
+    };
+    size_t constexpr INDEX_COUNT{
+        static_cast<size_t>(GRID_DIMENSIONS - 1) * (GRID_DIMENSIONS - 1) * 6
+    };
+    float constexpr WAVE_HEIGHT{0.05F};
+    float constexpr WAVE_FREQUENCY{8.0F * std::numbers::pi_v<float>};
+
+    std::vector<float> positions{};
+    std::vector<float> normals{};
+    std::vector<float> uvs{};
+    positions.reserve(VERTEX_COUNT * 3);
+    normals.reserve(VERTEX_COUNT * 3);
+    uvs.reserve(VERTEX_COUNT * 2);
+    for (uint32_t row{0}; row < GRID_DIMENSIONS; row++)
+    {
+        for (uint32_t column{0}; column < GRID_DIMENSIONS; column++)
+        {
+            float const u{
+                static_cast<float>(column)
+                / static_cast<float>(GRID_DIMENSIONS - 1)
+            };
+            float const v{
+                static_cast<float>(row)
+                / static_cast<float>(GRID_DIMENSIONS - 1)
+            };
+            float const x{u * 2.0F - 1.0F};
+            float const z{v * 2.0F - 1.0F};
+
+            float const sinX{std::sin(WAVE_FREQUENCY * x)};
+            float const sinZ{std::sin(WAVE_FREQUENCY * z)};
+            float const y{WAVE_HEIGHT * sinX * sinZ};
+
+            float const slopeX{
+                WAVE_HEIGHT * WAVE_FREQUENCY * std::cos(WAVE_FREQUENCY * x)
+                * sinZ
+            };
+            float const slopeZ{
+                WAVE_HEIGHT * WAVE_FREQUENCY * sinX
+                * std::cos(WAVE_FREQUENCY * z)
+            };
+            float const normalLength{
+                std::sqrt(slopeX * slopeX + 1.0F + slopeZ * slopeZ)
+            };
+
+            positions.insert(positions.end(), {x, y, z});
+            normals.insert(
+                normals.end(),
+                {-slopeX / normalLength,
+                 1.0F / normalLength,
+                 -slopeZ / normalLength}
+            );
+            uvs.insert(uvs.end(), {u, v});
+        }
+    }
+
+    std::vector<uint32_t> indices{};
+    indices.reserve(INDEX_COUNT);
+    for (uint32_t row{0}; row + 1 < GRID_DIMENSIONS; row++)
+    {
+        for (uint32_t column{0}; column + 1 < GRID_DIMENSIONS; column++)
+        {
+            uint32_t const topLeft{row * GRID_DIMENSIONS + column};
+            uint32_t const bottomLeft{topLeft + GRID_DIMENSIONS};
+            indices.insert(
+                indices.end(),
+                {topLeft,
+                 bottomLeft,
+                 topLeft + 1,
+                 topLeft + 1,
+                 bottomLeft,
+                 bottomLeft + 1}
+            );
+        }
+    }
+
+    size_t const positionBytes{positions.size() * sizeof(float)};
+    size_t const uvBytes{uvs.size() * sizeof(float)};
+    size_t const indexBytes{indices.size() * sizeof(uint32_t)};
+    size_t const bufferBytes{positionBytes * 2 + uvBytes + indexBytes};
+
+    std::filesystem::path const gltfPath{directory / "synthetic.gltf"};
+    std::filesystem::path const bufferPath{directory / "synthetic.bin"};
+
+    std::error_code error{};
+    std::filesystem::create_directories(directory, error);
+
+    std::ofstream buffer{bufferPath, std::ios::binary | std::ios::trunc};
+    for (std::span<std::byte const> const bytes :
+         {std::as_bytes(std::span{positions}),
+          std::as_bytes(std::span{normals}),
+          std::as_bytes(std::span{uvs}),
+          std::as_bytes(std::span{indices})})
+    {
+        buffer.write(
+            reinterpret_cast<char const*>(bytes.data()),
+            static_cast<std::streamsize>(bytes.size())
+        );
+    }
+    buffer.close();
+
+    std::ofstream gltf{gltfPath, std::ios::trunc};
+    gltf << std::format(
+        R"({{
+    "asset": {{"version": "2.0"}},
+    "buffers": [{{"uri": "synthetic.bin", "byteLength": {0}}}],
+    "bufferViews": [
+        {{"buffer": 0, "byteOffset": 0, "byteLength": {1}}},
+        {{"buffer": 0, "byteOffset": {1}, "byteLength": {1}}},
+        {{"buffer": 0, "byteOffset": {2}, "byteLength": {3}}},
+        {{"buffer": 0, "byteOffset": {4}, "byteLength": {5}}}
+    ],
+    "accessors": [
+        {{"bufferView": 0, "componentType": 5126, "count": {6},
+          "type": "VEC3", "min": [-1, {8}, -1], "max": [1, {9}, 1]}},
+        {{"bufferView": 1, "componentType": 5126, "count": {6},
+          "type": "VEC3"}},
+        {{"bufferView": 2, "componentType": 5126, "count": {6},
+          "type": "VEC2"}},
+        {{"bufferView": 3, "componentType": 5125, "count": {7},
+          "type": "SCALAR"}}
+    ],
+    "meshes": [{{"name": "grid", "primitives": [{{
+        "attributes": {{"POSITION": 0, "NORMAL": 1, "TEXCOORD_0": 2}},
+        "indices": 3
+    }}]}}],
+    "nodes": [{{"mesh": 0}}],
+    "scenes": [{{"nodes": [0]}}],
+    "scene": 0
+}}
+)",
+        bufferBytes,
+        positionBytes,
+        positionBytes * 2,
+        uvBytes,
+        positionBytes * 2 + uvBytes,
+        indexBytes,
+        VERTEX_COUNT,
+        indices.size(),
+        -WAVE_HEIGHT,
+        WAVE_HEIGHT
+    );
+    gltf.close();
+
+    if (!buffer || !gltf)
+    {
+        std::cout << std::format(
+            "Unable to write synthetic glTF to {}\n", directory.string()
+        );
+        return std::nullopt;
+    }
+
+    return gltfPath;
+}
+
+// An uncompressed 32-bit TGA of noise, so decoding is only a copy and a swizzle
+// and the stages after it see incompressible texels.
+auto makeSyntheticImage() -> std::vector<uint8_t>
+{
+    size_t constexpr HEADER_BYTES{18};
+    size_t constexpr TEXEL_BYTES{4};
+
+    // NOLINTBEGIN(readability-magic-numbers)
+    std::vector<uint8_t> image(
+        HEADER_BYTES
+        + static_cast<size_t>(SYNTHETIC_IMAGE_DIMENSIONS)
+              * SYNTHETIC_IMAGE_DIMENSIONS * TEXEL_BYTES
+    );
+    // Uncompressed true color, with 8 bits of alpha and the origin at the top
+    // left.
+    image[2] = 2;
+    image[12] = static_cast<uint8_t>(SYNTHETIC_IMAGE_DIMENSIONS & 0xFFU);
+    image[13] = static_cast<uint8_t>(SYNTHETIC_IMAGE_DIMENSIONS >> 8U);
+    image[14] = static_cast<uint8_t>(SYNTHETIC_IMAGE_DIMENSIONS & 0xFFU);
+    image[15] = static_cast<uint8_t>(SYNTHETIC_IMAGE_DIMENSIONS >> 8U);
+    image[16] = 32;
+    image[17] = 0x28;
+
+    // A fixed xorshift, so every run encodes the same texels.
+    uint32_t state{0x9E3779B9U};
+    for (size_t index{HEADER_BYTES}; index < image.size(); index++)
+    {
+        state ^= state << 13U;
+        state ^= state >> 17U;
+        state ^= state << 5U;
+        image[index] = static_cast<uint8_t>(state);
+    }
+    // NOLINTEND(readability-magic-numbers)
+
+    return image;
+}
+
+auto isGLTF(std::filesystem::path const& path) -> bool
+{
+    return path.extension() == ".gltf" || path.extension() == ".glb";
+}
+
+auto isImage(std::filesystem::path const& path) -> bool
+{
+    return path.extension() == ".png" || path.extension() == ".jpg"
+        || path.extension() == ".jpeg" || path.extension() == ".tga"
+        || path.extension() == ".bmp";
+}
+
+// Parses the glTF and cooks its meshes, which are returned for the upload
+// stages.
+auto benchmarkGLTF(
+    Results& results,
+    syzygy::ThreadPool& workers,
+    std::string_view const asset,
+    std::filesystem::path const& path
+) -> std::vector<syzygy::CookedGLTFMesh>
+{
+    fastgltf::Expected<fastgltf::Asset> gltfLoadResult{
+        syzygy::loadGLTFAsset(path, true)
+    };
+    if (gltfLoadResult.error() != fastgltf::Error::None)
+    {
+        results.add(asset, "parse", std::nullopt, 0);
+        return {};
+    }
+    fastgltf::Asset const& gltf{gltfLoadResult.get()};
+
+    size_t sourceBytes{fileSize(path)};
+    for (std::filesystem::path const& buffer :
+         syzygy::GLTFExternalFiles::collect(
+             gltf, syzygy::ensureAbsolutePath(path).parent_path()
+         )
+             .buffers)
+    {
+        sourceBytes += fileSize(buffer);
+    }
+
+    std::optional<double> const parseSeconds{measure([&]()
+    {
+        return syzygy::loadGLTFAsset(path, true).error()
+            == fastgltf::Error::None;
+    })};
+    results.add(asset, "parse", parseSeconds, sourceBytes);
+
+    std::vector<syzygy::CookedGLTFMesh> meshes{};
+    std::optional<double> const cookSeconds{measure([&]()
+    {
+        meshes = syzygy::cookGLTFMeshes(
+            gltf, syzygy::VertexWeldTolerance{}, workers
+        );
+        return true;
+    })};
+
+    size_t cookedBytes{0};
+    size_t cookedVertices{0};
+    for (syzygy::CookedGLTFMesh const& mesh : meshes)
+    {
+        cookedBytes += mesh.vertices.size() * sizeof(syzygy::VertexPacked)
+                     + mesh.indices.size() * sizeof(uint32_t);
+        cookedVertices += mesh.vertices.size();
+    }
+    results.add(asset, "cookMeshes", cookSeconds, cookedBytes, cookedVertices);
+
+    return meshes;
+}
+
+// Decodes and encodes the image, which is returned for the upload stages.
+auto benchmarkImage(
+    Results& results,
+    std::string_view const asset,
+    std::span<uint8_t const> const encoded
+) -> std::optional<std::pair<syzygy::DecodedRGBA, syzygy::CookedTexture>>
+{
+    std::optional<syzygy::DecodedRGBA> decoded{};
+    std::optional<double> const decodeSeconds{measure([&]()
+    {
+        decoded = syzygy::decodeRGBA(encoded);
+        return decoded.has_value();
+    })};
+    results.add(asset, "decode", decodeSeconds, encoded.size());
+    if (!decoded.has_value())
+    {
+        return std::nullopt;
+    }
+
+    std::optional<syzygy::CookedTexture> cooked{};
+    std::optional<double> const encodeSeconds{measure([&]()
+    {
+        cooked.emplace(syzygy::CookedTexture::encode(
+            syzygy::TextureEncoding::Color,
+            decoded.value().bytes(),
+            decoded.value().x,
+            decoded.value().y
+        ));
+        return true;
+    })};
+    results.add(
+        asset, "encode", encodeSeconds, decoded.value().bytes().size()
+    );
+
+    return std::pair{std::move(decoded).value(), std::move(cooked).value()};
+}
+
+#ifdef SZG_BENCHMARK_UPLOADS
+struct UploadDevice
+{
+    syzygy::GraphicsContext& graphics;
+    syzygy::UploadQueue& uploadQueue;
+};
+
+struct UploadTimings
+{
+    // Writing the data into staging memory and recording the copies.
+    double staging{0.0};
+    // From submission until the device has finished the copies.
+    double submit{0.0};
+};
+
+// Returns the fastest of several runs for each half of the upload, or nullopt
+// if any run fails.
+auto measureUpload(
+    syzygy::UploadQueue& uploadQueue,
+    std::function<bool(syzygy::UploadBatch&)> const& stage
+) -> std::optional<UploadTimings>
+{
+    std::optional<UploadTimings> fastest{};
+    for (size_t iteration{0}; iteration < ITERATIONS; iteration++)
+    {
+        syzygy::UploadBatch batch{};
+
+        Clock::time_point const start{Clock::now()};
+        if (!stage(batch))
+        {
+            return std::nullopt;
+        }
+        Clock::time_point const staged{Clock::now()};
+        if (!detail::submitAndWait(uploadQueue, std::move(batch)))
+        {
+            return std::nullopt;
+        }
+        Clock::time_point const end{Clock::now()};
+
+        uploadQueue.collect();
+
+        UploadTimings const timings{
+            .staging = secondsBetween(start, staged),
+            .submit = secondsBetween(staged, end),
+        };
+        if (!fastest.has_value())
+        {
+            fastest = timings;
+            continue;
+        }
+        fastest.value().staging =
+            std::min(fastest.value().staging, timings.staging);
+        fastest.value().submit =
+            std::min(fastest.value().submit, timings.submit);
+    }
+    return fastest;
+}
+
+void addUpload(
+    Results& results,
+    std::string_view const asset,
+    std::string_view const stage,
+    std::optional<UploadTimings> const& timings,
+    size_t const bytes,
+    std::optional<size_t> const vertices = std::nullopt
+)
+{
+    results.add(
+        asset,
+        std::format("{}Staging", stage),
+        timings.has_value() ? std::optional{timings.value().staging}
+                            : std::nullopt,
+        bytes,
+        vertices
+    );
+    results.add(
+        asset,
+        std::format("{}Submit", stage),
+        timings.has_value() ? std::optional{timings.value().submit}
+                            : std::nullopt,
+        bytes,
+        vertices
+    );
+}
+
+// Every mesh of the glTF is uploaded in one batch, as the asset library does.
+void benchmarkMeshUpload(
+    Results& results,
+    std::string_view const asset,
+    UploadDevice const& device,
+    std::span<syzygy::CookedGLTFMesh const> const cookedMeshes
+)
+{
+    std::vector<std::unique_ptr<syzygy::Mesh>> meshes{};
+    size_t bytes{0};
+    size_t vertices{0};
+    for (syzygy::CookedGLTFMesh const& cookedMesh : cookedMeshes)
+    {
+        if (cookedMesh.surfaces.empty())
+        {
+            continue;
+        }
+
+        meshes.push_back(detail::makeCookedMesh(
+            cookedMesh.surfaces,
+            cookedMesh.lodChain.surfaces,
+            cookedMesh.lodChain.errors,
+            cookedMesh.bounds,
+            {},
+            syzygy::MaterialData{}
+        ));
+        bytes += cookedMesh.vertices.size() * sizeof(syzygy::VertexPacked)
+               + cookedMesh.indices.size() * sizeof(uint32_t);
+        vertices += cookedMesh.vertices.size();
+    }
+    if (meshes.empty())
+    {
+        return;
+    }
+
+    // The buffers of each run are kept until the next replaces them, since
+    // they are written by the device until the run's upload completes.
+    std::vector<std::unique_ptr<syzygy::GPUMeshBuffers>> buffers{};
+    std::optional<UploadTimings> const timings{measureUpload(
+        device.uploadQueue,
+        [&](syzygy::UploadBatch& batch)
+    {
+        buffers.clear();
+        size_t meshIndex{0};
+        for (syzygy::CookedGLTFMesh const& cookedMesh : cookedMeshes)
+        {
+            if (cookedMesh.surfaces.empty())
+            {
+                continue;
+            }
+
+            syzygy::Mesh& mesh{*meshes[meshIndex++]};
+            std::optional<std::unique_ptr<syzygy::GPUMeshBuffers>>
+                uploadResult{detail::uploadMeshToGPU(
+                    device.graphics.device(),
+                    device.graphics.allocator(),
+                    device.uploadQueue,
+                    batch,
+                    // The asset library's default.
+                    syzygy::VertexFormat::Full,
+                    mesh.surfaces,
+                    mesh.lods,
+                    cookedMesh.indices,
+                    cookedMesh.vertices
+                )};
+            if (!uploadResult.has_value())
+            {
+                return false;
+            }
+            buffers.push_back(std::move(uploadResult).value());
+        }
+        return true;
+    }
+    )};
+
+    addUpload(results, asset, "mesh", timings, bytes, vertices);
+}
+
+void benchmarkTextureUpload(
+    Results& results,
+    std::string_view const asset,
+    UploadDevice const& device,
+    syzygy::DecodedRGBA const& decoded,
+    syzygy::CookedTexture const& cooked
+)
+{
+    // As with meshes, each run's texture is kept until the next replaces it.
+    std::unique_ptr<syzygy::ImageView> texture{};
+
+    std::optional<UploadTimings> const rgbaTimings{measureUpload(
+        device.uploadQueue,
+        [&](syzygy::UploadBatch& batch)
+    {
+        std::optional<std::unique_ptr<syzygy::ImageView>> uploadResult{
+            detail::uploadTextureFromRGBA(
+                device.graphics.device(),
+                device.graphics.allocator(),
+                device.uploadQueue,
+                batch,
+                VK_FORMAT_R8G8B8A8_SRGB,
+                decoded.extent(),
+                decoded.bytes(),
+                0
+            )
+        };
+        if (!uploadResult.has_value())
+        {
+            return false;
+        }
+        texture = std::move(uploadResult).value();
+        return true;
+    }
+    )};
+    addUpload(results, asset, "texture", rgbaTimings, decoded.bytes().size());
+
+    std::optional<UploadTimings> const cookedTimings{measureUpload(
+        device.uploadQueue,
+        [&](syzygy::UploadBatch& batch)
+    {
+        std::optional<std::unique_ptr<syzygy::ImageView>> uploadResult{
+            detail::uploadCookedTexture(
+                device.graphics.device(),
+                device.graphics.allocator(),
+                device.uploadQueue,
+                batch,
+                cooked,
+                0
+            )
+        };
+        if (!uploadResult.has_value())
+        {
+            return false;
+        }
+        texture = std::move(uploadResult).value();
+        return true;
+    }
+    )};
+    addUpload(
+        results, asset, "cookedTexture", cookedTimings, cooked.byteCount()
+    );
+}
+
+auto createUploadQueue(std::optional<syzygy::GraphicsContext>& graphicsResult)
+    -> std::optional<syzygy::UploadQueue>
+{
+    if (!graphicsResult.has_value())
+    {
+        return std::nullopt;
+    }
+    syzygy::GraphicsContext& graphics{graphicsResult.value()};
+
+    return syzygy::UploadQueue::create(
+        graphics.device(),
+        graphics.allocator(),
+        graphics.transferQueue(),
+        graphics.transferQueueFamily(),
+        graphics.universalQueue(),
+        graphics.universalQueueFamily()
+    );
+}
+#endif
+
+auto jsonString(std::string_view const text) -> std::string
+{
+    std::string escaped{"\""};
+    for (char const character : text)
+    {
+        switch (character)
+        {
+        case '"':
+            escaped += "\\\"";
+            break;
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        default:
+            if (static_cast<unsigned char>(character) < 0x20U)
+            {
+                escaped += std::format(
+                    "\\u{:04x}", static_cast<unsigned char>(character)
+                );
+            }
+            else
+            {
+                escaped += character;
+            }
+        }
+    }
+    escaped += "\"";
+    return escaped;
+}
+
+auto writeJSON(
+    std::filesystem::path const& path,
+    std::optional<std::string> const& device,
+    Results const& results
+) -> bool
+{
+    std::ofstream file{path, std::ios::trunc};
+    file << std::format(
+        "{{\n  \"iterations\": {},\n  \"device\": {},\n  \"results\": [",
+        ITERATIONS,
+        device.has_value() ? jsonString(device.value()) : "null"
+    );
+
+    bool first{true};
+    for (StageResult const& result : results.stages)
+    {
+        std::optional<double> const verticesPerSecond{
+            result.verticesPerSecond()
+        };
+        file << std::format(
+            "{}\n    {{\"asset\": {}, \"stage\": {}, \"seconds\": {}, "
+            "\"bytes\": {}, \"megabytesPerSecond\": {}, "
+            "\"verticesPerSecond\": {}}}",
+            first ? "" : ",",
+            jsonString(result.asset),
+            jsonString(result.stage),
+            result.seconds,
+            result.bytes,
+            result.megabytesPerSecond(),
+            verticesPerSecond.has_value()
+                ? std::format("{}", verticesPerSecond.value())
+                : "null"
+        );
+        first = false;
+    }
+
+    file << "\n  ],\n";
+    file << std::format("  \"failures\": {}\n}}\n", results.failures);
+    file.close();
+
+    return static_cast<bool>(file);
+}
+} // namespace
+
+auto main(int const argc, char const* const* const argv) -> int
+{
+    std::span<char const* const> const arguments{
+        std::span<char const* const>{argv, static_cast<size_t>(argc)}.subspan(1)
+    };
+    std::filesystem::path jsonPath{"SyzygyAssetBenchmark.json"};
+    std::vector<std::filesystem::path> paths{};
+    for (size_t index{0}; index < arguments.size(); index++)
+    {
+        std::string_view const argument{arguments[index]};
+        if (argument != "--json")
+        {
+            paths.emplace_back(argument);
+            continue;
+        }
+
+        if (index + 1 >= arguments.size())
+        {
+            std::cerr << "Usage: SyzygyAssetBenchmark [--json <path>] "
+                         "[path...]\n";
+            return EXIT_FAILURE;
+        }
+        index++;
+        jsonPath = arguments[index];
+    }
+
+    std::error_code error{};
+    for (std::filesystem::directory_entry const& entry :
+         std::filesystem::directory_iterator{
+             SZG_BENCHMARK_ASSETS_DIRECTORY, error
+         })
+    {
+        paths.push_back(entry.path());
+    }
+    std::sort(paths.begin(), paths.end());
+
+    syzygy::Logger::initLogging();
+
+    std::optional<std::string> deviceName{};
+#ifdef SZG_BENCHMARK_UPLOADS
+    std::optional<syzygy::GraphicsContext> graphicsResult{
+        syzygy::GraphicsContext::createHeadless()
+    };
+    std::optional<syzygy::UploadQueue> uploadQueueResult{
+        createUploadQueue(graphicsResult)
+    };
+    std::optional<UploadDevice> device{};
+    if (graphicsResult.has_value())
+    {
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(
+            graphicsResult.value().physicalDevice(), &properties
+        );
+        deviceName = properties.deviceName;
+    }
+    if (uploadQueueResult.has_value())
+    {
+        device.emplace(UploadDevice{
+            .graphics = graphicsResult.value(),
+            .uploadQueue = uploadQueueResult.value(),
+        });
+    }
+    else
+    {
+        std::cout << "No headless device, skipping upload stages.\n";
+    }
+#else
+    std::cout << "Built without the editor, skipping upload stages.\n";
+#endif
+
+    std::cout << std::format(
+        "Fastest of {} runs on {}.\n",
+        ITERATIONS,
+        deviceName.value_or("no device")
+    );
+
+    Results results{};
+
+    // Cooking splits meshes and primitives across these, as the editor does.
+    syzygy::ThreadPool workers{syzygy::ThreadPool::defaultWorkerCount()};
+
+    std::vector<std::pair<std::string, std::filesystem::path>> gltfs{};
+    if (std::optional<std::filesystem::path> const synthetic{
+            writeSyntheticGLTF(
+                std::filesystem::temp_directory_path(error)
+                / "SyzygyAssetBenchmark"
+            )
+        };
+        synthetic.has_value())
+    {
+        gltfs.emplace_back(
+            std::format("synthetic {0}x{0} grid", GRID_DIMENSIONS),
+            synthetic.value()
+        );
+    }
+    else
+    {
+        results.failures++;
+    }
+
+    std::vector<std::pair<std::string, std::filesystem::path>> images{};
+    for (std::filesystem::path const& path : paths)
+    {
+        if (isGLTF(path))
+        {
+            gltfs.emplace_back(path.string(), path);
+        }
+        else if (isImage(path))
+        {
+            images.emplace_back(path.string(), path);
+        }
+    }
+
+    for (auto const& [asset, path] : gltfs)
+    {
+        std::vector<syzygy::CookedGLTFMesh> const meshes{
+            benchmarkGLTF(results, workers, asset, path)
+        };
+#ifdef SZG_BENCHMARK_UPLOADS
+        if (device.has_value())
+        {
+            benchmarkMeshUpload(results, asset, device.value(), meshes);
+        }
+#endif
+    }
+
+    auto const benchmarkImageBytes{
+        [&](std::string_view const asset, std::span<uint8_t const> const bytes)
+    {
+        std::optional<std::pair<syzygy::DecodedRGBA, syzygy::CookedTexture>>
+            imageResult{benchmarkImage(results, asset, bytes)};
+#ifdef SZG_BENCHMARK_UPLOADS
+        if (device.has_value() && imageResult.has_value())
+        {
+            benchmarkTextureUpload(
+                results,
+                asset,
+                device.value(),
+                imageResult.value().first,
+                imageResult.value().second
+            );
+        }
+#endif
+    }
+    };
+
+    benchmarkImageBytes(
+        std::format(
+            "synthetic {0}x{0} image", SYNTHETIC_IMAGE_DIMENSIONS
+        ),
+        makeSyntheticImage()
+    );
+    for (auto const& [asset, path] : images)
+    {
+        std::optional<syzygy::MappedFile> const file{syzygy::MappedFile::open(
+            path, syzygy::MappedFile::AccessPattern::Sequential
+        )};
+        if (!file.has_value())
+        {
+            results.add(asset, "decode", std::nullopt, 0);
+            continue;
+        }
+        benchmarkImageBytes(asset, file.value().bytes());
+    }
+
+    if (!writeJSON(jsonPath, deviceName, results))
+    {
+        std::cout << std::format(
+            "Unable to write results to {}\n", jsonPath.string()
+        );
+        return EXIT_FAILURE;
+    }
+    std::cout << std::format(
+        "Wrote {} results to {}, {} failed.\n",
+        results.stages.size(),
+        jsonPath.string(),
+        results.failures
+    );
+
+    return results.failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,266 @@
+#include "syzygy/assets/texelkernels.hpp"
+#include "syzygy/platform/integer.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Times each texel kernel for every instruction set the CPU supports, on 4K
+// images, and checks that every version produces identical output.
+
+namespace
+{
+using syzygy::TexelKernels;
+
+uint32_t constexpr IMAGE_DIMENSIONS{4096};
+size_t constexpr TEXEL_COUNT{
+    static_cast<size_t>(IMAGE_DIMENSIONS) * IMAGE_DIMENSIONS
+};
+size_t constexpr RGBA_BYTES{TEXEL_COUNT * 4};
+size_t constexpr RGB_BYTES{TEXEL_COUNT * 3};
+size_t constexpr ITERATIONS{8};
+
+struct RGBATexel
+{
+    uint8_t r{0};
+    uint8_t g{0};
+    uint8_t b{0};
+    uint8_t a{0};
+};
+
+// The per-texel multiply-add that channel overrides were applied with before
+// the kernels, kept as the baseline.
+void legacyOverrideChannels(
+    std::span<uint8_t> const rgba,
+    std::array<std::optional<uint8_t>, 4> const& overrides
+)
+{
+    uint64_t const redSelector{overrides[0].has_value() ? 0U : 1U};
+    uint64_t const redValue{overrides[0].value_or(0)};
+
+    uint64_t const greenSelector{overrides[1].has_value() ? 0U : 1U};
+    uint64_t const greenValue{overrides[1].value_or(0)};
+
+    uint64_t const blueSelector{overrides[2].has_value() ? 0U : 1U};
+    uint64_t const blueValue{overrides[2].value_or(0)};
+
+    uint64_t const alphaSelector{overrides[3].has_value() ? 0U : 1U};
+    uint64_t const alphaValue{overrides[3].value_or(0)};
+
+    for (RGBATexel& texel : std::span<RGBATexel>{
+             reinterpret_cast<RGBATexel*>(rgba.data()),
+             rgba.size() / sizeof(RGBATexel)
+         })
+    {
+        texel.r = static_cast<uint8_t>(texel.r * redSelector + redValue);
+        texel.g = static_cast<uint8_t>(texel.g * greenSelector + greenValue);
+        texel.b = static_cast<uint8_t>(texel.b * blueSelector + blueValue);
+        texel.a = static_cast<uint8_t>(texel.a * alphaSelector + alphaValue);
+    }
+}
+
+// Returns the fastest of several runs, in throughput of input bytes.
+auto measure(size_t const bytes, std::function<void()> const& run) -> double
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::chrono::duration<double> fastest{std::chrono::duration<double>::max()
+    };
+    for (size_t iteration{0}; iteration < ITERATIONS; iteration++)
+    {
+        Clock::time_point const start{Clock::now()};
+        run();
+        fastest = std::min<std::chrono::duration<double>>(
+            fastest, Clock::now() - start
+        );
+    }
+
+    double constexpr BYTES_PER_MEGABYTE{1024.0 * 1024.0};
+    return static_cast<double>(bytes) / BYTES_PER_MEGABYTE / fastest.count();
+}
+
+void report(
+    std::string_view const kernel,
+    std::string_view const isa,
+    double const throughput
+)
+{
+    std::cout << std::format(
+        "{:<20} {:<8} {:>10.1f} MB/s\n", kernel, isa, throughput
+    );
+}
+
+auto instructionSetName(TexelKernels::InstructionSet const instructionSet)
+    -> std::string_view
+{
+    switch (instructionSet)
+    {
+    case TexelKernels::InstructionSet::Scalar:
+        return "scalar";
+    case TexelKernels::InstructionSet::SSE41:
+        return "sse4.1";
+    case TexelKernels::InstructionSet::AVX2:
+        return "avx2";
+    }
+    return "unknown";
+}
+
+struct Outputs
+{
+    std::vector<uint8_t> overridden{};
+    std::vector<uint8_t> expanded{};
+    std::vector<uint8_t> packed{};
+    std::vector<uint8_t> renormalized{};
+    std::vector<float> linear{};
+    std::vector<uint8_t> encoded{};
+
+    auto operator==(Outputs const&) const -> bool = default;
+};
+
+auto runKernels(
+    TexelKernels const& kernels,
+    std::string_view const isa,
+    std::span<uint8_t const> const source,
+    std::span<uint8_t const> const other
+) -> Outputs
+{
+    // NOLINTBEGIN(readability-magic-numbers)
+    uint32_t constexpr KEEP_RED_GREEN{0x0000FFFFU};
+    uint32_t constexpr FILL_OPAQUE_BLACK{0xFF000000U};
+    uint8_t constexpr OPAQUE_ALPHA{255U};
+    // NOLINTEND(readability-magic-numbers)
+
+    Outputs outputs{
+        .overridden = std::vector<uint8_t>(RGBA_BYTES),
+        .expanded = std::vector<uint8_t>(RGBA_BYTES),
+        .packed = std::vector<uint8_t>(RGBA_BYTES),
+        .renormalized = std::vector<uint8_t>(RGBA_BYTES),
+        .linear = std::vector<float>(RGBA_BYTES),
+        .encoded = std::vector<uint8_t>(RGBA_BYTES),
+    };
+
+    // Kernels that work in place are restored from the source before each
+    // run, so that copy is timed too. The legacy loop is timed the same way.
+    auto const overrideChannels{[&]()
+    {
+        std::copy(source.begin(), source.end(), outputs.overridden.begin());
+        kernels.overrideChannels(
+            outputs.overridden, KEEP_RED_GREEN, FILL_OPAQUE_BLACK
+        );
+    }};
+    auto const expandRGBToRGBA{[&]()
+    {
+        kernels.expandRGBToRGBA(
+            source.first(RGB_BYTES), outputs.expanded, OPAQUE_ALPHA
+        );
+    }};
+    auto const packORM{[&]()
+    { kernels.packORM(source, other, outputs.packed); }};
+    auto const renormalizeNormals{[&]()
+    {
+        std::copy(source.begin(), source.end(), outputs.renormalized.begin());
+        kernels.renormalizeNormals(outputs.renormalized);
+    }};
+    auto const srgbToLinear{[&]()
+    { kernels.srgbToLinear(source, outputs.linear); }};
+    auto const linearToSRGB{[&]()
+    { kernels.linearToSRGB(outputs.linear, outputs.encoded); }};
+
+    report("overrideChannels", isa, measure(RGBA_BYTES, overrideChannels));
+    report("expandRGBToRGBA", isa, measure(RGB_BYTES, expandRGBToRGBA));
+    report("packORM", isa, measure(RGBA_BYTES, packORM));
+    report("renormalizeNormals", isa, measure(RGBA_BYTES, renormalizeNormals));
+    report("srgbToLinear", isa, measure(RGBA_BYTES, srgbToLinear));
+    report(
+        "linearToSRGB",
+        isa,
+        measure(RGBA_BYTES * sizeof(float), linearToSRGB)
+    );
+
+    return outputs;
+}
+} // namespace
+
+auto main() -> int
+{
+    std::vector<uint8_t> source(RGBA_BYTES);
+    std::vector<uint8_t> other(RGBA_BYTES);
+    {
+        std::mt19937 generator{std::random_device{}()};
+        std::uniform_int_distribution<uint32_t> distribution{0, UINT8_MAX};
+        for (uint8_t& byte : source)
+        {
+            byte = static_cast<uint8_t>(distribution(generator));
+        }
+        for (uint8_t& byte : other)
+        {
+            byte = static_cast<uint8_t>(distribution(generator));
+        }
+    }
+
+    std::cout << std::format(
+        "{}x{} RGBA8, fastest of {} runs. Best instruction set is {}.\n",
+        IMAGE_DIMENSIONS,
+        IMAGE_DIMENSIONS,
+        ITERATIONS,
+        instructionSetName(TexelKernels::bestInstructionSet())
+    );
+
+    {
+        // Matches the overrides the kernels are run with.
+        // NOLINTNEXTLINE(readability-magic-numbers)
+        std::array<std::optional<uint8_t>, 4> const overrides{
+            std::nullopt, std::nullopt, 0, 255
+        };
+        std::vector<uint8_t> legacy(RGBA_BYTES);
+        auto const overrideChannels{[&]()
+        {
+            std::copy(source.begin(), source.end(), legacy.begin());
+            legacyOverrideChannels(legacy, overrides);
+        }};
+        report(
+            "overrideChannels", "legacy", measure(RGBA_BYTES, overrideChannels)
+        );
+    }
+
+    std::optional<Outputs> reference{};
+    bool allMatch{true};
+    for (TexelKernels::InstructionSet const instructionSet :
+         {TexelKernels::InstructionSet::Scalar,
+          TexelKernels::InstructionSet::SSE41,
+          TexelKernels::InstructionSet::AVX2})
+    {
+        std::string_view const isa{instructionSetName(instructionSet)};
+
+        std::optional<TexelKernels> const kernels{
+            TexelKernels::forInstructionSet(instructionSet)
+        };
+        if (!kernels.has_value())
+        {
+            std::cout << std::format("Skipping {}, unsupported by CPU\n", isa);
+            continue;
+        }
+
+        Outputs outputs{runKernels(kernels.value(), isa, source, other)};
+        if (!reference.has_value())
+        {
+            reference = std::move(outputs);
+        }
+        else if (outputs != reference.value())
+        {
+            std::cout << std::format("{} output differs from scalar\n", isa);
+            allMatch = false;
+        }
+    }
+
+    return allMatch ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -90,4 +90,15 @@ FetchContent_Declare(
 	GIT_SHALLOW ON
 	GIT_PROGRESS ON
 	SYSTEM
-)
\ No newline at end of file
+)
+# Only the transcoder is built, from its sources, since the project's own
+# CMakeLists builds the encoder and its tools.
+FetchContent_Declare(
+	basisu
+	GIT_REPOSITORY https://github.com/BinomialLLC/basis_universal.git
+	GIT_TAG 1.16.4
+	GIT_SHALLOW ON
+	GIT_PROGRESS ON
+	SOURCE_SUBDIR transcoder
+	SYSTEM
+)
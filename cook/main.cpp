@@ -0,0 +1,543 @@
+#include "syzygy/assets/cooking.hpp"
+#include "syzygy/assets/meshcache.hpp"
+#include "syzygy/assets/texturecache.hpp"
+#include "syzygy/assets/vertexwelding.hpp"
+#include "syzygy/core/log.hpp"
+#include "syzygy/core/threadpool.hpp"
+#include "syzygy/platform/filesystemutils.hpp"
+#include "syzygy/platform/integer.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <fastgltf/core.hpp>
+#include <fastgltf/types.hpp>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Cooks every glTF in the given files and directories into the asset cache,
+// exactly as the editor does when importing them, so the editor then loads
+// them without cooking anything. No device or window is needed, so this can
+// run on build machines.
+//
+// Usage: SyzygyCook [--weld-position <tolerance>] [--weld-normal <tolerance>]
+//                   [--weld-uv <tolerance>] <path>...
+//
+// The weld tolerances must match the editor's for it to find the meshes.
+
+namespace
+{
+enum class CookStatus
+{
+    Cooked,
+    // Already in the cache from an earlier cook.
+    Cached,
+    // Shares its content with another texture that was cooked this run.
+    Shared,
+    // The editor would not cache it either, such as geometry whose buffers are
+    // not local files.
+    Skipped,
+    Failed,
+};
+
+auto statusName(CookStatus const status) -> std::string_view
+{
+    switch (status)
+    {
+    case CookStatus::Cooked:
+        return "cooked";
+    case CookStatus::Cached:
+        return "cached";
+    case CookStatus::Shared:
+        return "shared";
+    case CookStatus::Skipped:
+        return "skipped";
+    case CookStatus::Failed:
+        return "FAILED";
+    }
+}
+
+auto encodingName(syzygy::TextureEncoding const encoding) -> std::string_view
+{
+    switch (encoding)
+    {
+    case syzygy::TextureEncoding::Color:
+        return "color";
+    case syzygy::TextureEncoding::Normal:
+        return "normal";
+    case syzygy::TextureEncoding::OcclusionRoughnessMetallic:
+        return "orm";
+    }
+}
+
+struct CookReport
+{
+    std::string asset{};
+    CookStatus status{CookStatus::Failed};
+    double seconds{0.0};
+};
+
+struct CookOptions
+{
+    syzygy::VertexWeldTolerance weldTolerance{};
+    std::vector<std::filesystem::path> paths{};
+};
+
+auto parseOptions(std::span<char const* const> const arguments)
+    -> std::optional<CookOptions>
+{
+    CookOptions options{};
+    for (size_t index{0}; index < arguments.size(); index++)
+    {
+        std::string_view const argument{arguments[index]};
+        if (!argument.starts_with("--"))
+        {
+            options.paths.emplace_back(argument);
+            continue;
+        }
+
+        float* tolerance{nullptr};
+        if (argument == "--weld-position")
+        {
+            tolerance = &options.weldTolerance.position;
+        }
+        else if (argument == "--weld-normal")
+        {
+            tolerance = &options.weldTolerance.normal;
+        }
+        else if (argument == "--weld-uv")
+        {
+            tolerance = &options.weldTolerance.uv;
+        }
+        else
+        {
+            std::cerr << std::format("Unknown option {}\n", argument);
+            return std::nullopt;
+        }
+
+        if (index + 1 >= arguments.size())
+        {
+            std::cerr << std::format("{} needs a value\n", argument);
+            return std::nullopt;
+        }
+        index++;
+
+        std::string_view const value{arguments[index]};
+        if (auto const [end, error]{std::from_chars(
+                value.data(), value.data() + value.size(), *tolerance
+            )};
+            error != std::errc{} || end != value.data() + value.size()
+            || *tolerance < 0.0F)
+        {
+            std::cerr << std::format(
+                "{} needs a non-negative number, not {}\n", argument, value
+            );
+            return std::nullopt;
+        }
+    }
+
+    if (options.paths.empty())
+    {
+        return std::nullopt;
+    }
+
+    return options;
+}
+
+auto isGLTF(std::filesystem::path const& path) -> bool
+{
+    return path.extension() == ".gltf" || path.extension() == ".glb";
+}
+
+// Sorted, so that the report is in the same order every run.
+auto findGLTFs(std::span<std::filesystem::path const> const paths)
+    -> std::vector<std::filesystem::path>
+{
+    std::vector<std::filesystem::path> files{};
+    for (std::filesystem::path const& path : paths)
+    {
+        std::error_code error{};
+        if (std::filesystem::is_directory(path, error))
+        {
+            for (std::filesystem::directory_entry const& entry :
+                 std::filesystem::recursive_directory_iterator{
+                     path,
+                     std::filesystem::directory_options::skip_permission_denied,
+                     error
+                 })
+            {
+                if (entry.is_regular_file() && isGLTF(entry.path()))
+                {
+                    files.push_back(entry.path());
+                }
+            }
+        }
+        else if (std::filesystem::is_regular_file(path, error) && isGLTF(path))
+        {
+            files.push_back(path);
+        }
+
+        if (error)
+        {
+            std::cerr << std::format(
+                "Unable to search {}: {}\n", path.string(), error.message()
+            );
+        }
+    }
+
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+    return files;
+}
+
+auto secondsSince(std::chrono::steady_clock::time_point const start) -> double
+{
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now() - start
+    )
+        .count();
+}
+
+// Keyed as in AssetLibrary::importGLTF.
+auto cookGeometry(
+    std::filesystem::path const& path,
+    syzygy::VertexWeldTolerance const weldTolerance,
+    std::filesystem::path const& cacheDirectory,
+    syzygy::ThreadPool& workers
+) -> CookStatus
+{
+    std::filesystem::path const assetRoot{
+        syzygy::ensureAbsolutePath(path).parent_path()
+    };
+
+    std::optional<uint64_t> const sourceHash{syzygy::hashFile(path)};
+    if (!sourceHash.has_value())
+    {
+        return CookStatus::Failed;
+    }
+    uint64_t const key{
+        syzygy::cookedMeshKey(sourceHash.value(), weldTolerance)
+    };
+
+    if (syzygy::MeshCacheFile::open(cacheDirectory, key, assetRoot)
+            .has_value())
+    {
+        return CookStatus::Cached;
+    }
+
+    fastgltf::Expected<fastgltf::Asset> gltfLoadResult{
+        syzygy::loadGLTFAsset(path, true)
+    };
+    if (gltfLoadResult.error() != fastgltf::Error::None)
+    {
+        SZG_ERROR(
+            "Failed to load glTF {}: {} : {}",
+            path.string(),
+            fastgltf::getErrorName(gltfLoadResult.error()),
+            fastgltf::getErrorMessage(gltfLoadResult.error())
+        );
+        return CookStatus::Failed;
+    }
+    fastgltf::Asset const& gltf{gltfLoadResult.get()};
+
+    std::optional<std::vector<syzygy::CookedDependency>> const dependencies{
+        syzygy::collectGLTFBufferDependencies(gltf, assetRoot)
+    };
+    if (!dependencies.has_value())
+    {
+        return CookStatus::Skipped;
+    }
+
+    std::vector<syzygy::CookedGLTFMesh> const meshes{
+        syzygy::cookGLTFMeshes(gltf, weldTolerance, workers)
+    };
+    std::vector<syzygy::CookedMeshSource> sources{};
+    sources.reserve(meshes.size());
+    for (syzygy::CookedGLTFMesh const& mesh : meshes)
+    {
+        sources.push_back(mesh.source());
+    }
+
+    return syzygy::MeshCacheFile::cook(
+               cacheDirectory, key, dependencies.value(), sources
+           )
+             ? CookStatus::Cooked
+             : CookStatus::Failed;
+}
+
+// Textures with the same content, whether in one glTF or several, are only
+// cooked once.
+struct CookedKeys
+{
+    std::mutex mutex{};
+    std::set<uint64_t> keys{};
+
+    // Returns if the key was not claimed before.
+    auto claim(uint64_t const key) -> bool
+    {
+        std::lock_guard const lock{mutex};
+        return keys.insert(key).second;
+    }
+};
+
+// Keyed as in AssetLibrary::importGLTF, though the image is hashed here on a
+// worker rather than before the cook is scheduled.
+auto cookTexture(
+    fastgltf::Asset const& gltf,
+    std::filesystem::path const& assetRoot,
+    syzygy::GLTFTextureCook const& cook,
+    std::filesystem::path const& cacheDirectory,
+    CookedKeys& cookedKeys
+) -> CookStatus
+{
+    std::vector<std::optional<std::reference_wrapper<fastgltf::Image const>>>
+        textureSourcesByGLTFIndex{syzygy::gltfTextureSources(gltf)};
+    std::optional<std::reference_wrapper<fastgltf::Image const>> const image{
+        syzygy::accessGLTFTexture(textureSourcesByGLTFIndex, cook.textureIndex)
+    };
+    if (!image.has_value())
+    {
+        return CookStatus::Failed;
+    }
+
+    std::optional<uint64_t> const sourceHash{
+        syzygy::hashGLTFImageSource(image.value().get(), assetRoot)
+    };
+    if (!sourceHash.has_value())
+    {
+        return CookStatus::Failed;
+    }
+    uint64_t const key{syzygy::cookedTextureKey(
+        sourceHash.value(), cook.overrides, cook.encoding
+    )};
+
+    if (!cookedKeys.claim(key))
+    {
+        return CookStatus::Shared;
+    }
+    if (syzygy::CookedTexture::load(cacheDirectory, key).has_value())
+    {
+        return CookStatus::Cached;
+    }
+
+    return syzygy::cookGLTFImage(
+               image.value().get(),
+               cook.overrides,
+               assetRoot,
+               cook.encoding,
+               cacheDirectory,
+               key
+           )
+                   .has_value()
+             ? CookStatus::Cooked
+             : CookStatus::Failed;
+}
+
+// The glTF is parsed here for its materials, so that each texture can be
+// cooked as its own job. The geometry is loaded by its job.
+void submitGLTF(
+    syzygy::ThreadPool& workers,
+    std::filesystem::path const& path,
+    CookOptions const& options,
+    CookedKeys& cookedKeys,
+    std::vector<std::future<CookReport>>& reports
+)
+{
+    std::filesystem::path const meshCacheDirectory{
+        syzygy::cookedAssetDirectory("meshes")
+    };
+    std::filesystem::path const textureCacheDirectory{
+        syzygy::cookedAssetDirectory("textures")
+    };
+
+    reports.push_back(workers.submit(
+        [&workers,
+         path,
+         weldTolerance = options.weldTolerance,
+         meshCacheDirectory]()
+    {
+        auto const start{std::chrono::steady_clock::now()};
+        CookStatus const status{
+            cookGeometry(path, weldTolerance, meshCacheDirectory, workers)
+        };
+        return CookReport{
+            .asset = std::format("{} geometry", path.string()),
+            .status = status,
+            .seconds = secondsSince(start),
+        };
+    }
+    ));
+
+    fastgltf::Expected<fastgltf::Asset> gltfLoadResult{
+        syzygy::loadGLTFAsset(path, false)
+    };
+    if (gltfLoadResult.error() != fastgltf::Error::None)
+    {
+        // Reported by the geometry's job, which fails the same way.
+        return;
+    }
+    // Shared by the texture jobs, since embedded images point into it.
+    auto const gltf{
+        std::make_shared<fastgltf::Asset const>(std::move(gltfLoadResult.get()))
+    };
+    std::filesystem::path const assetRoot{
+        syzygy::ensureAbsolutePath(path).parent_path()
+    };
+
+    // Materials often share textures, which are only submitted once per glTF.
+    std::vector<syzygy::GLTFTextureCook> cooks{};
+    for (fastgltf::Material const& material : gltf->materials)
+    {
+        syzygy::GLTFMaterialTextures const textures{
+            syzygy::GLTFMaterialTextures::parse(material)
+        };
+        for (std::optional<syzygy::GLTFTextureCook> const& cook :
+             {textures.color, textures.normal, textures.ORM})
+        {
+            if (!cook.has_value())
+            {
+                continue;
+            }
+
+            bool const submitted{std::any_of(
+                cooks.begin(),
+                cooks.end(),
+                [&](syzygy::GLTFTextureCook const& other)
+            {
+                return other.textureIndex == cook.value().textureIndex
+                    && other.encoding == cook.value().encoding
+                    && other.overrides.red == cook.value().overrides.red
+                    && other.overrides.green == cook.value().overrides.green
+                    && other.overrides.blue == cook.value().overrides.blue
+                    && other.overrides.alpha == cook.value().overrides.alpha;
+            }
+            )};
+            if (!submitted)
+            {
+                cooks.push_back(cook.value());
+            }
+        }
+    }
+
+    for (syzygy::GLTFTextureCook const& cook : cooks)
+    {
+        reports.push_back(workers.submit(
+            [gltf,
+             assetRoot,
+             cook,
+             textureCacheDirectory,
+             &cookedKeys,
+             asset = std::format(
+                 "{} texture {} ({})",
+                 path.string(),
+                 cook.textureIndex,
+                 encodingName(cook.encoding)
+             )]()
+        {
+            auto const start{std::chrono::steady_clock::now()};
+            CookStatus const status{cookTexture(
+                *gltf, assetRoot, cook, textureCacheDirectory, cookedKeys
+            )};
+            return CookReport{
+                .asset = asset,
+                .status = status,
+                .seconds = secondsSince(start),
+            };
+        }
+        ));
+    }
+}
+} // namespace
+
+auto main(int const argc, char const* const* const argv) -> int
+{
+    std::optional<CookOptions> const optionsResult{parseOptions(
+        std::span<char const* const>{argv, static_cast<size_t>(argc)}
+            .subspan(1)
+    )};
+    if (!optionsResult.has_value())
+    {
+        std::cerr << "Usage: SyzygyCook [--weld-position <tolerance>] "
+                     "[--weld-normal <tolerance>] [--weld-uv <tolerance>] "
+                     "<path>...\n";
+        return EXIT_FAILURE;
+    }
+    CookOptions const& options{optionsResult.value()};
+
+    syzygy::Logger::initLogging();
+
+    std::vector<std::filesystem::path> const files{findGLTFs(options.paths)};
+
+    // The main thread only waits on the workers, so it does not keep a core.
+    size_t const workerCount{
+        std::max<size_t>(std::thread::hardware_concurrency(), 1)
+    };
+
+    std::cout << std::format(
+        "Cooking {} glTF files on {} workers into {} and {}\n",
+        files.size(),
+        workerCount,
+        syzygy::cookedAssetDirectory("meshes").string(),
+        syzygy::cookedAssetDirectory("textures").string()
+    );
+
+    auto const start{std::chrono::steady_clock::now()};
+
+    CookedKeys cookedKeys{};
+    std::vector<std::future<CookReport>> reports{};
+    {
+        syzygy::ThreadPool workers{workerCount};
+        for (std::filesystem::path const& file : files)
+        {
+            submitGLTF(workers, file, options, cookedKeys, reports);
+        }
+
+        // Waited on before the pool is destroyed, which would discard jobs.
+        for (std::future<CookReport> const& report : reports)
+        {
+            report.wait();
+        }
+    }
+
+    size_t failures{0};
+    double cookSeconds{0.0};
+    for (std::future<CookReport>& reportFuture : reports)
+    {
+        CookReport const report{reportFuture.get()};
+        std::cout << std::format(
+            "{:9.3f}s {:>7} {}\n",
+            report.seconds,
+            statusName(report.status),
+            report.asset
+        );
+
+        cookSeconds += report.seconds;
+        failures += report.status == CookStatus::Failed ? 1 : 0;
+    }
+
+    std::cout << std::format(
+        "Cooked {} assets from {} files in {:.3f} seconds, {:.3f} seconds "
+        "across workers. {} failed.\n",
+        reports.size(),
+        files.size(),
+        secondsSince(start),
+        cookSeconds,
+        failures
+    );
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
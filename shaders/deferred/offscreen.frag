@@ -45,14 +45,17 @@ vec3 perturbNormal(vec3 N, vec3 V, vec2 texcoord)
 {
     // assume N, the interpolated vertex normal and
     // V, the view vector (vertex to eye)
-    vec3 map = texture(normal, texcoord).xyz;
+    // Normal maps may be block compressed down to only x and y, so z is
+    // always reconstructed from the unit length.
+    vec3 map = vec3(texture(normal, texcoord).xy, 0.0);
 
 #ifdef WITH_NORMAL_MAP_UNSIGNED
-    map = map * 255. / 127. - 128. / 127.;
+    map.xy = map.xy * 255. / 127. - 128. / 127.;
 #endif
 #ifdef WITH_NORMAL_MAP_GREEN_UP
     map.y = -map.y;
 #endif
+    map.z = sqrt(max(0.0, 1.0 - dot(map.xy, map.xy)));
 
     mat3 TBN = cotangentFrame(N, -V, texcoord);
     return normalize(TBN * map);
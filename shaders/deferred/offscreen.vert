@@ -7,18 +7,13 @@ layout(location = 1) out vec2 outTexCoord;
 layout(location = 2) out vec3 outNormal;
 
 #include "../types/camera.glsl"
-#include "../types/vertex.glsl"
+#include "../types/meshvertex.glsl"
 
 layout(buffer_reference, std430) readonly buffer CameraBuffer
 {
     Camera cameras[];
 };
 
-layout(buffer_reference, std430) readonly buffer VertexBuffer
-{
-    Vertex vertices[];
-};
-
 layout(buffer_reference, std430) readonly buffer ModelBuffer
 {
     mat4 models[];
@@ -36,13 +31,22 @@ layout(push_constant) uniform PushConstant
     ModelInverseTransposeBuffer modelInverseTransposeBuffer;
     CameraBuffer cameraBuffer;
     uint cameraIndex;
+    uint vertexFormat;
+    vec4 positionOffset;
+    vec4 positionScale;
 } pushConstant;
 
 void main()
 {
     mat4 model = pushConstant.modelBuffer.models[gl_InstanceIndex];
     mat4 modelInverseTranspose = pushConstant.modelInverseTransposeBuffer.modelInverseTransposes[gl_InstanceIndex];
-    Vertex vertex = pushConstant.vertexBuffer.vertices[gl_VertexIndex];
+    Vertex vertex = loadMeshVertex(
+        pushConstant.vertexBuffer,
+        pushConstant.vertexFormat,
+        pushConstant.positionOffset.xyz,
+        pushConstant.positionScale.xyz,
+        uint(gl_VertexIndex)
+    );
     Camera camera = pushConstant.cameraBuffer.cameras[pushConstant.cameraIndex];
 
     vec4 position = model * vec4(vertex.position, 1.0);
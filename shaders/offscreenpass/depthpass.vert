@@ -2,18 +2,13 @@
 #extension GL_EXT_buffer_reference2 : require
 #extension GL_ARB_shading_language_include : require
 
-#include "../types/vertex.glsl"
+#include "../types/meshvertex.glsl"
 
 layout(buffer_reference, std430) readonly buffer ProjViewBuffer
 {
     mat4 matrices[];
 };
 
-layout(buffer_reference, std430) readonly buffer VertexBuffer
-{
-    Vertex vertices[];
-};
-
 layout(buffer_reference, std430) readonly buffer ModelBuffer
 {
     mat4 models[];
@@ -25,13 +20,22 @@ layout(push_constant) uniform PushConstant
     ModelBuffer modelBuffer;
     ProjViewBuffer projViewBuffer;
     uint projViewIndex;
+    uint vertexFormat;
+    vec4 positionOffset;
+    vec4 positionScale;
 } pushConstant;
 
 void main()
 {
     mat4 model = pushConstant.modelBuffer.models[gl_InstanceIndex];
 
-    Vertex vertex = pushConstant.vertexBuffer.vertices[gl_VertexIndex];
+    Vertex vertex = loadMeshVertex(
+        pushConstant.vertexBuffer,
+        pushConstant.vertexFormat,
+        pushConstant.positionOffset.xyz,
+        pushConstant.positionScale.xyz,
+        uint(gl_VertexIndex)
+    );
     mat4 projView = pushConstant.projViewBuffer.matrices[pushConstant.projViewIndex];
 
     gl_Position = projView * model * vec4(vertex.position, 1.0f);
@@ -0,0 +1,31 @@
+// See MeshletPacked.
+struct Meshlet
+{
+    vec4 boundingSphere;
+    vec4 coneAxisCutoff;
+    uint firstIndex;
+    uint indexCount;
+    uint padding0;
+    uint padding1;
+};
+
+// See MeshletCullViewPacked.
+struct MeshletCullView
+{
+    vec4 frustumPlanes[6];
+    vec4 eye;
+    float facingCull;
+    float padding0;
+    float padding1;
+    float padding2;
+};
+
+// Matches VkDrawIndexedIndirectCommand.
+struct DrawIndexedCommand
+{
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
@@ -0,0 +1,101 @@
+// Requires GL_EXT_buffer_reference2.
+// Mesh vertex buffers may be in any of these layouts, see VertexFormat.
+
+#include "vertex.glsl"
+
+const uint VERTEX_FORMAT_FULL = 0;
+const uint VERTEX_FORMAT_COMPACT = 1;
+const uint VERTEX_FORMAT_QUANTIZED = 2;
+
+struct VertexCompact
+{
+    float positionX;
+    float positionY;
+    float positionZ;
+    uint normalOctahedral;
+    uint uv;
+    uint color;
+};
+
+struct VertexQuantized
+{
+    uint positionXY;
+    uint positionZNormal;
+    uint uv;
+    uint color;
+};
+
+layout(buffer_reference, std430) readonly buffer VertexBuffer
+{
+    Vertex vertices[];
+};
+
+layout(buffer_reference, std430) readonly buffer VertexCompactBuffer
+{
+    VertexCompact vertices[];
+};
+
+layout(buffer_reference, std430) readonly buffer VertexQuantizedBuffer
+{
+    VertexQuantized vertices[];
+};
+
+vec3 decodeOctahedral(vec2 encoded)
+{
+    vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    // Unfold the lower hemisphere
+    float fold = max(-normal.z, 0.0);
+    normal.x += normal.x >= 0.0 ? -fold : fold;
+    normal.y += normal.y >= 0.0 ? -fold : fold;
+    return normalize(normal);
+}
+
+// The format is the same for every vertex of a draw, so this branch does not
+// diverge.
+Vertex loadMeshVertex(
+    VertexBuffer buffer,
+    uint format,
+    vec3 positionOffset,
+    vec3 positionScale,
+    uint index
+)
+{
+    if (format == VERTEX_FORMAT_FULL)
+    {
+        return buffer.vertices[index];
+    }
+
+    Vertex vertex;
+    vec2 uv;
+    if (format == VERTEX_FORMAT_COMPACT)
+    {
+        VertexCompact compact =
+            VertexCompactBuffer(buffer).vertices[index];
+
+        vertex.position =
+            vec3(compact.positionX, compact.positionY, compact.positionZ);
+        vertex.normal =
+            decodeOctahedral(unpackSnorm2x16(compact.normalOctahedral));
+        uv = unpackHalf2x16(compact.uv);
+        vertex.color = unpackUnorm4x8(compact.color);
+    }
+    else
+    {
+        VertexQuantized quantized =
+            VertexQuantizedBuffer(buffer).vertices[index];
+
+        vec3 normalized = vec3(
+            unpackUnorm2x16(quantized.positionXY),
+            unpackUnorm2x16(quantized.positionZNormal).x
+        );
+        vertex.position = positionOffset + positionScale * normalized;
+        vertex.normal =
+            decodeOctahedral(unpackSnorm4x8(quantized.positionZNormal).zw);
+        uv = unpackHalf2x16(quantized.uv);
+        vertex.color = unpackUnorm4x8(quantized.color);
+    }
+    vertex.uv_x = uv.x;
+    vertex.uv_y = uv.y;
+
+    return vertex;
+}
@@ -0,0 +1,281 @@
+#pragma once
+
+#include "syzygy/assets/assetstypes.hpp"
+#include "syzygy/platform/integer.hpp"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace syzygy
+{
+// Stores the assets of one type in contiguous slots, that are looked up by
+// AssetHandle.
+//
+// Slots are allocated in fixed size chunks that never move, so registering an
+// asset never invalidates references to the others. A lookup is a generation
+// check and two indexed loads, with no locks or reference counting, which is
+// cheap enough for per-frame loops.
+//
+// Registration, pinning, releasing and iteration are thread-safe. Lookups are
+// not synchronized, so an asset must not be released while it is being looked
+// up on another thread, and a handle may only be looked up once the
+// registration that returned it has completed.
+//
+// Each asset is also shared through a lifetime token, for code that holds onto
+// assets as AssetPtr. A released slot is only reused once no AssetShared of
+// its asset remains.
+template <typename T> struct AssetPool
+{
+public:
+    static uint32_t constexpr CHUNK_SLOTS{256};
+    static uint32_t constexpr MAX_CHUNKS{
+        (AssetHandle<T>::INDEX_MASK + 1) / CHUNK_SLOTS
+    };
+
+    AssetPool() = default;
+
+    auto operator=(AssetPool&&) -> AssetPool& = delete;
+    AssetPool(AssetPool&&) = delete;
+    auto operator=(AssetPool const&) -> AssetPool& = delete;
+    AssetPool(AssetPool const&) = delete;
+
+    ~AssetPool() = default;
+
+    // Fills in the asset's handle and pool. Returns an invalid handle if every
+    // slot is in use.
+    auto add(Asset<T>&& asset) -> AssetHandle<T>
+    {
+        std::lock_guard<std::mutex> const lock{m_mutex};
+
+        reclaimReleased();
+
+        uint32_t index{0};
+        if (!m_freeSlots.empty())
+        {
+            index = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+        else if (m_slotCount < MAX_CHUNKS * CHUNK_SLOTS)
+        {
+            index = m_slotCount;
+            if (index % CHUNK_SLOTS == 0)
+            {
+                m_chunks[index / CHUNK_SLOTS] = std::make_unique<Chunk>();
+            }
+            m_slotCount++;
+        }
+        else
+        {
+            return AssetHandle<T>{};
+        }
+
+        Slot& slot{slotAt(index)};
+        slot.asset = std::move(asset);
+        slot.asset.handle = AssetHandle<T>::make(index, slot.generation);
+        slot.asset.pool = this;
+        slot.pins = 0;
+        slot.occupied = true;
+        // Aliases a token, since the slot owns the asset itself.
+        slot.shared = std::shared_ptr<Asset<T>>{
+            std::make_shared<std::byte>(), &slot.asset
+        };
+
+        m_size++;
+        return slot.asset.handle;
+    }
+
+    [[nodiscard]] auto valid(AssetHandle<T> const handle) const -> bool
+    {
+        return find(handle) != nullptr;
+    }
+
+    [[nodiscard]] auto get(AssetHandle<T> const handle) const
+        -> Asset<T> const*
+    {
+        Slot const* const slot{find(handle)};
+        return slot != nullptr ? &slot->asset : nullptr;
+    }
+
+    [[nodiscard]] auto get(AssetHandle<T> const handle) -> Asset<T>*
+    {
+        Slot* const slot{find(handle)};
+        return slot != nullptr ? &slot->asset : nullptr;
+    }
+
+    // For code that keeps the asset as an AssetPtr or AssetShared. This is
+    // reference counted, so it should be kept out of per-frame loops.
+    [[nodiscard]] auto shared(AssetHandle<T> const handle) const
+        -> std::shared_ptr<Asset<T>>
+    {
+        Slot const* const slot{find(handle)};
+        return slot != nullptr ? slot->shared : nullptr;
+    }
+
+    // A pinned asset cannot be released. Pins are counted, so each must be
+    // matched by an unpin.
+    auto pin(AssetHandle<T> const handle) -> bool
+    {
+        std::lock_guard<std::mutex> const lock{m_mutex};
+        Slot* const slot{find(handle)};
+        if (slot == nullptr)
+        {
+            return false;
+        }
+        slot->pins++;
+        return true;
+    }
+
+    void unpin(AssetHandle<T> const handle)
+    {
+        std::lock_guard<std::mutex> const lock{m_mutex};
+        Slot* const slot{find(handle)};
+        if (slot == nullptr || slot->pins == 0)
+        {
+            return;
+        }
+        slot->pins--;
+    }
+
+    [[nodiscard]] auto pins(AssetHandle<T> const handle) const -> uint32_t
+    {
+        std::lock_guard<std::mutex> const lock{m_mutex};
+        Slot const* const slot{find(handle)};
+        return slot != nullptr ? slot->pins : 0;
+    }
+
+    // Invalidates every handle to the asset, and returns its data for the
+    // caller to destroy once it is no longer in use. Fails if the asset is
+    // pinned.
+    //
+    // Outstanding AssetShared of the asset keep its metadata, but not its data.
+    auto release(AssetHandle<T> const handle)
+        -> std::optional<std::shared_ptr<T>>
+    {
+        std::lock_guard<std::mutex> const lock{m_mutex};
+        Slot* const found{find(handle)};
+        if (found == nullptr || found->pins > 0)
+        {
+            return std::nullopt;
+        }
+        Slot& slot{*found};
+
+        std::shared_ptr<T> data{std::move(slot.asset.data)};
+
+        slot.occupied = false;
+        slot.released = slot.shared;
+        slot.shared.reset();
+        m_size--;
+
+        // Slots whose generations run out are retired for good, so that old
+        // handles never alias a new asset.
+        if (slot.generation < AssetHandle<T>::MAX_GENERATION)
+        {
+            slot.generation++;
+            m_releasedSlots.push_back(handle.index());
+        }
+
+        return data;
+    }
+
+    // Every registered asset, in slot order.
+    [[nodiscard]] auto handles() const -> std::vector<AssetHandle<T>>
+    {
+        std::lock_guard<std::mutex> const lock{m_mutex};
+
+        std::vector<AssetHandle<T>> handles{};
+        handles.reserve(m_size);
+        for (uint32_t index{0}; index < m_slotCount; index++)
+        {
+            Slot const& slot{slotAt(index)};
+            if (slot.occupied)
+            {
+                handles.push_back(slot.asset.handle);
+            }
+        }
+        return handles;
+    }
+
+    [[nodiscard]] auto size() const -> size_t
+    {
+        std::lock_guard<std::mutex> const lock{m_mutex};
+        return m_size;
+    }
+
+private:
+    struct Slot
+    {
+        Asset<T> asset{};
+        std::shared_ptr<Asset<T>> shared{};
+        // Expires once no AssetShared of a released asset remains.
+        std::weak_ptr<Asset<T>> released{};
+        uint32_t generation{1};
+        uint32_t pins{0};
+        bool occupied{false};
+    };
+    using Chunk = std::array<Slot, CHUNK_SLOTS>;
+
+    [[nodiscard]] auto slotAt(uint32_t const index) const -> Slot const&
+    {
+        return (*m_chunks[index / CHUNK_SLOTS])[index % CHUNK_SLOTS];
+    }
+    [[nodiscard]] auto slotAt(uint32_t const index) -> Slot&
+    {
+        return (*m_chunks[index / CHUNK_SLOTS])[index % CHUNK_SLOTS];
+    }
+
+    // Chunks are owned through pointers, so this can hand out mutable slots.
+    [[nodiscard]] auto find(AssetHandle<T> const handle) const -> Slot*
+    {
+        // Checked first, so the default handle never touches the chunks.
+        if (handle.generation() == 0)
+        {
+            return nullptr;
+        }
+
+        Chunk* const chunk{m_chunks[handle.index() / CHUNK_SLOTS].get()};
+        if (chunk == nullptr)
+        {
+            return nullptr;
+        }
+
+        Slot& slot{(*chunk)[handle.index() % CHUNK_SLOTS]};
+        if (!slot.occupied || slot.generation != handle.generation())
+        {
+            return nullptr;
+        }
+        return &slot;
+    }
+
+    // Frees the released slots whose assets are no longer shared.
+    void reclaimReleased()
+    {
+        std::erase_if(
+            m_releasedSlots,
+            [&](uint32_t const index)
+        {
+            Slot& slot{slotAt(index)};
+            if (!slot.released.expired())
+            {
+                return false;
+            }
+            slot.asset = Asset<T>{};
+            m_freeSlots.push_back(index);
+            return true;
+        }
+        );
+    }
+
+    mutable std::mutex m_mutex{};
+
+    std::array<std::unique_ptr<Chunk>, MAX_CHUNKS> m_chunks{};
+    // Slots past this have never been used.
+    uint32_t m_slotCount{0};
+    size_t m_size{0};
+
+    std::vector<uint32_t> m_freeSlots{};
+    std::vector<uint32_t> m_releasedSlots{};
+};
+} // namespace syzygy
@@ -1,7 +1,15 @@
 #include "assets.hpp"
 
-#include "syzygy/core/immediate.hpp"
+#include "syzygy/assets/assetsdetail.hpp"
+#include "syzygy/assets/cooking.hpp"
+#include "syzygy/assets/meshcache.hpp"
+#include "syzygy/assets/meshlets.hpp"
+#include "syzygy/assets/mipchain.hpp"
+#include "syzygy/assets/texturecache.hpp"
+#include "syzygy/assets/vertexwelding.hpp"
+#include "syzygy/core/hash.hpp"
 #include "syzygy/core/log.hpp"
+#include "syzygy/core/threadpool.hpp"
 #include "syzygy/editor/graphicscontext.hpp"
 #include "syzygy/platform/filesystemutils.hpp"
 #include "syzygy/platform/integer.hpp"
@@ -11,30 +19,32 @@
 #include "syzygy/renderer/gputypes.hpp"
 #include "syzygy/renderer/image.hpp"
 #include "syzygy/renderer/imageview.hpp"
+#include "syzygy/renderer/scene.hpp"
+#include "syzygy/renderer/uploadqueue.hpp"
+#include "syzygy/renderer/vertexencoding.hpp"
+#include "syzygy/renderer/vulkanstructs.hpp"
 #include "syzygy/ui/uiwidgets.hpp"
 #include <algorithm>
-#include <cassert>
+#include <array>
+#include <chrono>
 #include <fastgltf/core.hpp>
-#include <fastgltf/glm_element_traits.hpp> // IWYU pragma: keep
-#include <fastgltf/tools.hpp>
 #include <fastgltf/types.hpp>
 #include <filesystem>
-#include <fstream>
 #include <functional>
+#include <future>
 #include <glm/common.hpp>
-#include <glm/vec2.hpp>
+#include <glm/geometric.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 #include <limits>
 #include <span>
 #include <spdlog/fmt/bundled/core.h>
+#include <string>
 #include <tuple>
+#include <unordered_set>
 #include <utility>
 #include <variant>
 
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb/stb_image.h>
-
 namespace
 {
 struct RGBATexel
@@ -43,8 +53,6 @@ struct RGBATexel
     uint8_t g{0};
     uint8_t b{0};
     uint8_t a{std::numeric_limits<uint8_t>::max()};
-
-    static uint8_t constexpr SATURATED_COMPONENT{255U};
 };
 
 struct ImageRGBA
@@ -53,124 +61,428 @@ struct ImageRGBA
     uint32_t y{0};
     std::vector<uint8_t> bytes{};
 };
+
+// Image files are uploaded as 8-bit RGBA of the requested format. KTX2 files
+// with Basis Universal payloads are instead transcoded to the block compressed
+// format that decodes the same way.
+auto ktx2Encoding(VkFormat const fileFormat) -> syzygy::TextureEncoding
+{
+    return fileFormat == VK_FORMAT_R8G8B8A8_SRGB
+             ? syzygy::TextureEncoding::Color
+             : syzygy::TextureEncoding::OcclusionRoughnessMetallic;
+}
+
+// Textures are sampled by materials as 2D, so array and cube map files are
+// rejected.
+auto openKTX2Texture(
+    std::filesystem::path const& path, VkFormat const fileFormat
+) -> std::optional<syzygy::CookedTexture>
+{
+    std::optional<syzygy::CookedTexture> texture{
+        syzygy::CookedTexture::openKTX2(path, ktx2Encoding(fileFormat))
+    };
+    if (!texture.has_value())
+    {
+        return std::nullopt;
+    }
+    if (texture.value().arrayLayers() != 1)
+    {
+        SZG_WARNING(
+            "KTX2 file at {} has {} array layers or cube faces, but only 2D "
+            "textures are supported.",
+            path.string(),
+            texture.value().arrayLayers()
+        );
+        return std::nullopt;
+    }
+    return texture;
+}
 } // namespace
 
-namespace detail
+namespace syzygy
 {
-auto uploadImageToGPU(
-    VkDevice const device,
-    VmaAllocator const allocator,
-    VkQueue const transferQueue,
-    syzygy::ImmediateSubmissionQueue const& submissionQueue,
-    VkFormat const format,
-    VkImageUsageFlags const additionalFlags,
-    ImageRGBA const& image
-) -> std::optional<std::unique_ptr<syzygy::Image>>
+// A texture that was registered with placeholder data, whose real pixels are
+// still being decoded and block compressed on the asset library's worker pool.
+// The decode also hashes the image, returning the key it was cooked under.
+struct TextureDecodeTask
 {
-    VkExtent2D const imageExtent{.width = image.x, .height = image.y};
+    AssetPtr<ImageView> texture{};
+    // What the texture falls back to when it is evicted.
+    AssetPtr<ImageView> fallback{};
+    // The glTF that scheduled the texture, which records the key once known.
+    std::weak_ptr<GLTFReloadSource> source{};
+    std::future<std::optional<
+        std::tuple<CookedTexture, std::filesystem::path, uint64_t>>>
+        decodeResult{};
+};
 
-    std::optional<std::unique_ptr<syzygy::Image>> stagingImageResult{
-        syzygy::Image::allocate(
-            device,
-            allocator,
-            syzygy::ImageAllocationParameters{
-                .extent = imageExtent,
-                .format = format,
-                .usageFlags = VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
-                .initialLayout = VK_IMAGE_LAYOUT_PREINITIALIZED,
-                .tiling = VK_IMAGE_TILING_LINEAR,
-                .vmaUsage = VMA_MEMORY_USAGE_CPU_ONLY,
-                .vmaFlags = VMA_ALLOCATION_CREATE_MAPPED_BIT,
-            }
-        )
+// Device data that is still being written by the upload queue. It is swapped
+// into the asset once the ticket is complete, and must not be used before then.
+struct TextureUploadTask
+{
+    AssetPtr<ImageView> texture{};
+    std::unique_ptr<ImageView> data{};
+    std::optional<std::filesystem::path> sourcePath{};
+    // The data is missing the levels before this, see TextureResidency.
+    uint32_t firstLevel{0};
+    UploadTicket ticket{};
+};
+
+struct MeshUploadTask
+{
+    AssetPtr<Mesh> mesh{};
+    std::unique_ptr<GPUMeshBuffers> data{};
+    // When set, the buffers are for this mesh, which replaces the asset's data
+    // entirely. Otherwise, the buffers are installed into the asset's mesh.
+    std::unique_ptr<Mesh> replacement{};
+    UploadTicket ticket{};
+};
+
+// The uploads of a single import, such as a set of glTF files, or the textures
+// whose decodes finished in one call to AssetLibrary::processTasks. Uploads are
+// either submitted together once the import is done, or one asset at a time.
+struct UploadImport
+{
+    bool batched{true};
+    std::chrono::steady_clock::time_point start{};
+
+    UploadBatch batch{};
+    std::vector<std::shared_ptr<TextureUploadTask>> textures{};
+    std::vector<std::shared_ptr<MeshUploadTask>> meshes{};
+
+    size_t assets{0};
+    size_t submissions{0};
+    double recordSeconds{0.0};
+    std::optional<UploadTicket> lastTicket{};
+};
+} // namespace syzygy
+
+namespace detail
+{
+auto submitAndWait(
+    syzygy::UploadQueue& uploadQueue, syzygy::UploadBatch&& batch
+) -> bool
+{
+    std::optional<syzygy::UploadTicket> const ticket{
+        uploadQueue.submit(std::move(batch))
     };
-    if (!stagingImageResult.has_value())
+    if (!ticket.has_value())
     {
-        SZG_ERROR("Failed to allocate staging image.");
-        return std::nullopt;
+        SZG_ERROR("Failed to submit uploads.");
+        return false;
     }
-    syzygy::Image& stagingImage{*stagingImageResult.value()};
 
-    std::optional<VmaAllocationInfo> const allocationInfo{
-        stagingImage.fetchAllocationInfo()
+    VkResult const waitResult{
+        uploadQueue.wait(ticket.value(), std::numeric_limits<uint64_t>::max())
     };
+    if (waitResult != VK_SUCCESS)
+    {
+        SZG_LOG_VK(waitResult, "Failed to wait on uploads.");
+        return false;
+    }
+
+    return true;
+}
 
-    if (allocationInfo.has_value()
-        && allocationInfo.value().pMappedData != nullptr)
+// Covers everything that makes up a mesh asset. Materials are identified by
+// their texture assets, which are themselves deduplicated by content. The
+// vertex format is included since it changes what is uploaded.
+auto hashMeshContent(
+    std::span<syzygy::GeometrySurface const> const surfaces,
+    std::span<uint32_t const> const indices,
+    std::span<syzygy::VertexPacked const> const vertices,
+    syzygy::VertexFormat const vertexFormat
+) -> uint64_t
+{
+    uint64_t hash{syzygy::ContentHash::hash(std::span<uint8_t const>{
+        reinterpret_cast<uint8_t const*>(vertices.data()), vertices.size_bytes()
+    })};
+    hash = syzygy::ContentHash::hash(
+        std::span<uint8_t const>{
+            reinterpret_cast<uint8_t const*>(indices.data()),
+            indices.size_bytes()
+        },
+        hash
+    );
+
+    for (syzygy::GeometrySurface const& surface : surfaces)
     {
-        auto* const stagingImageData{
-            reinterpret_cast<uint8_t*>(allocationInfo.value().pMappedData)
+        std::array<uint64_t, 5> const surfaceKey{
+            surface.firstIndex,
+            surface.indexCount,
+            surface.material.color.handle.value,
+            surface.material.normal.handle.value,
+            surface.material.ORM.handle.value,
         };
+        hash = syzygy::ContentHash::hash(
+            std::span<uint8_t const>{
+                reinterpret_cast<uint8_t const*>(surfaceKey.data()),
+                sizeof(surfaceKey)
+            },
+            hash
+        );
+    }
+
+    hash = syzygy::ContentHash::hash(
+        std::span<uint8_t const>{
+            reinterpret_cast<uint8_t const*>(&vertexFormat),
+            sizeof(vertexFormat)
+        },
+        hash
+    );
+
+    return hash;
+}
+
+// Records copies of every mip level of the destination image from staging
+// memory that was already written. The destination image must stay alive and in
+// place until the batch is submitted, and can only be used once that submission
+// completes.
+void recordImageCopies(
+    syzygy::UploadBatch& batch,
+    syzygy::Image& destination,
+    VkBuffer const stagingBuffer,
+    std::vector<VkDeviceSize>&& mipOffsets
+)
+{
+    batch.recordCopies.emplace_back(
+        [&destination, stagingBuffer, mipOffsets = std::move(mipOffsets)](
+            VkCommandBuffer const cmd
+        )
+    {
+        destination.recordTransitionBarriered(
+            cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT
+        );
+        destination.recordCopyFromBuffer(
+            cmd, stagingBuffer, mipOffsets, VK_IMAGE_ASPECT_COLOR_BIT
+        );
 
-        std::copy(image.bytes.begin(), image.bytes.end(), stagingImageData);
+        // The handoff recorded after the copies leaves the image in its final
+        // layout, which the image itself does not track.
+        destination.setExpectedLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
     }
-    else
+    );
+    batch.images.push_back(syzygy::UploadQueue::ImageHandoff{
+        .image = destination.image(),
+        .subresourceRange =
+            syzygy::imageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT),
+        .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        .dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+        .dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+    });
+}
+
+// Copies texels into staging memory, then records their upload as
+// recordImageCopies does. There must be one span of texels for each of the
+// image's mip levels, starting from level 0.
+auto recordImageUpload(
+    syzygy::UploadQueue& uploadQueue,
+    syzygy::UploadBatch& batch,
+    syzygy::Image& destination,
+    std::span<std::span<uint8_t const> const> const mipTexels
+) -> bool
+{
+    if (mipTexels.size() != destination.mipLevels())
     {
-        SZG_ERROR("Failed to map bytes of staging image.");
-        return std::nullopt;
+        SZG_ERROR(
+            "Image has {} mip levels, but texels for {} were provided.",
+            destination.mipLevels(),
+            mipTexels.size()
+        );
+        return false;
     }
 
-    std::optional<std::unique_ptr<syzygy::Image>> finalImageResult{
-        syzygy::Image::allocate(
-            device,
-            allocator,
-            syzygy::ImageAllocationParameters{
-                .extent = imageExtent,
-                .format = format,
-                .usageFlags = VK_IMAGE_USAGE_SAMPLED_BIT
-                            | VK_IMAGE_USAGE_TRANSFER_DST_BIT | additionalFlags,
-                .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-                .tiling = VK_IMAGE_TILING_OPTIMAL
-            }
-        )
-    };
-    if (!finalImageResult.has_value())
+    size_t totalBytes{0};
+    for (std::span<uint8_t const> const texels : mipTexels)
     {
-        SZG_ERROR("Failed to allocate final image.");
-        return std::nullopt;
+        totalBytes += texels.size();
     }
-    syzygy::Image& finalImage{*finalImageResult.value()};
 
-    if (auto const submissionResult{submissionQueue.immediateSubmit(
-            transferQueue,
-            [&](VkCommandBuffer const cmd)
+    std::optional<syzygy::StagingRing::Reservation> const stagingResult{
+        uploadQueue.allocateStaging(totalBytes)
+    };
+    if (!stagingResult.has_value())
     {
-        stagingImage.recordTransitionBarriered(
-            cmd, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT
+        SZG_ERROR("Failed to allocate staging memory for image.");
+        return false;
+    }
+    syzygy::StagingRing::Reservation const staging{stagingResult.value()};
+
+    // Levels are packed back to back. Their sizes are all multiples of the
+    // texel or block size, so each offset stays aligned for the copy.
+    std::vector<VkDeviceSize> mipOffsets{};
+    mipOffsets.reserve(mipTexels.size());
+    size_t levelOffset{0};
+    for (std::span<uint8_t const> const texels : mipTexels)
+    {
+        mipOffsets.push_back(staging.offset + levelOffset);
+        std::copy(
+            texels.begin(),
+            texels.end(),
+            staging.bytes.subspan(levelOffset).begin()
         );
+        levelOffset += texels.size();
+    }
 
-        finalImage.recordTransitionBarriered(
-            cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT
-        );
+    recordImageCopies(
+        batch, destination, staging.buffer, std::move(mipOffsets)
+    );
 
-        syzygy::Image::recordCopyEntire(
-            cmd, stagingImage, finalImage, VK_IMAGE_ASPECT_COLOR_BIT
-        );
+    return true;
+}
+
+// Levels of detail, laid out as in MeshLodChain, that take their materials
+// from the mesh's surfaces.
+auto makeMeshLods(
+    std::span<syzygy::GeometrySurface const> const surfaces,
+    std::span<syzygy::CookedSurface const> const lodSurfaces,
+    std::span<float const> const lodErrors
+) -> std::vector<syzygy::MeshLod>
+{
+    std::vector<syzygy::MeshLod> lods{};
+    if (lodSurfaces.size() != lodErrors.size() * surfaces.size())
+    {
+        return lods;
     }
-        )};
-        submissionResult
-        != syzygy::ImmediateSubmissionQueue::SubmissionResult::SUCCESS)
+
+    lods.reserve(lodErrors.size());
+    for (size_t level{0}; level < lodErrors.size(); level++)
     {
-        SZG_ERROR("Failed to copy images.");
-        return std::nullopt;
+        syzygy::MeshLod& lod{lods.emplace_back(syzygy::MeshLod{
+            .surfaces = {},
+            .error = lodErrors[level],
+        })};
+        lod.surfaces.reserve(surfaces.size());
+        for (size_t surface{0}; surface < surfaces.size(); surface++)
+        {
+            syzygy::CookedSurface const& lodSurface{
+                lodSurfaces[level * surfaces.size() + surface]
+            };
+            lod.surfaces.push_back(syzygy::GeometrySurface{
+                .firstIndex = lodSurface.firstIndex,
+                .indexCount = lodSurface.indexCount,
+                .material = surfaces[surface].material,
+                .bounds = lodSurface.bounds,
+                .boundingSphere = lodSurface.boundingSphere,
+            });
+        }
+    }
+    return lods;
+}
+
+auto makeCookedMesh(
+    std::span<syzygy::CookedSurface const> const cookedSurfaces,
+    std::span<syzygy::CookedSurface const> const lodSurfaces,
+    std::span<float const> const lodErrors,
+    syzygy::AABB const& bounds,
+    std::span<syzygy::MaterialData const> const materialsByGLTFIndex,
+    syzygy::MaterialData const& defaultMaterial
+) -> std::unique_ptr<syzygy::Mesh>
+{
+    std::vector<syzygy::GeometrySurface> surfaces{};
+    surfaces.reserve(cookedSurfaces.size());
+    for (syzygy::CookedSurface const& cookedSurface : cookedSurfaces)
+    {
+        bool const hasMaterial{
+            cookedSurface.materialIndex >= 0
+            && static_cast<size_t>(cookedSurface.materialIndex)
+                   < materialsByGLTFIndex.size()
+        };
+        surfaces.push_back(syzygy::GeometrySurface{
+            .firstIndex = cookedSurface.firstIndex,
+            .indexCount = cookedSurface.indexCount,
+            .material = hasMaterial ? materialsByGLTFIndex[static_cast<size_t>(
+                                          cookedSurface.materialIndex
+                                      )]
+                                    : defaultMaterial,
+            .bounds = cookedSurface.bounds,
+            .boundingSphere = cookedSurface.boundingSphere,
+        });
     }
 
-    return std::move(finalImageResult).value();
+    std::vector<syzygy::MeshLod> lods{
+        makeMeshLods(surfaces, lodSurfaces, lodErrors)
+    };
+    return std::make_unique<syzygy::Mesh>(syzygy::Mesh{
+        .surfaces = std::move(surfaces),
+        .lods = std::move(lods),
+        .vertexBounds = bounds,
+        .meshBuffers = nullptr,
+    });
 }
 
 auto uploadMeshToGPU(
     VkDevice const device,
     VmaAllocator const allocator,
-    VkQueue const transferQueue,
-    syzygy::ImmediateSubmissionQueue const& submissionQueue,
+    syzygy::UploadQueue& uploadQueue,
+    syzygy::UploadBatch& batch,
+    syzygy::VertexFormat const vertexFormat,
+    std::span<syzygy::GeometrySurface> const surfaces,
+    std::span<syzygy::MeshLod> const lods,
     std::span<uint32_t const> const indices,
     std::span<syzygy::VertexPacked const> const vertices
-) -> std::unique_ptr<syzygy::GPUMeshBuffers>
+) -> std::optional<std::unique_ptr<syzygy::GPUMeshBuffers>>
 {
+    syzygy::VertexEncoding const vertexEncoding{
+        syzygy::VertexEncoding::create(vertexFormat, vertices)
+    };
+    VkIndexType const indexType{
+        syzygy::IndexEncoding::indexType(vertices.size())
+    };
+
+    // Bounds are built from the full precision positions, so they are padded
+    // by the most that quantization can move a vertex.
+    float const boundsPadding{
+        vertexFormat == syzygy::VertexFormat::Quantized
+            ? glm::length(vertexEncoding.positionScale)
+                  / static_cast<float>(std::numeric_limits<uint16_t>::max())
+            : 0.0F
+    };
+    syzygy::MeshletBuilder meshlets{vertices, boundsPadding};
+    auto const appendMeshlets{
+        [&](std::span<syzygy::GeometrySurface> const appendedSurfaces)
+    {
+        for (syzygy::GeometrySurface& surface : appendedSurfaces)
+        {
+            if (static_cast<size_t>(surface.firstIndex) + surface.indexCount
+                > indices.size())
+            {
+                SZG_ERROR("Mesh surface is out of bounds of its indices.");
+                return false;
+            }
+
+            surface.firstMeshlet =
+                static_cast<uint32_t>(meshlets.meshlets().size());
+            surface.meshletCount = meshlets.appendSurface(
+                indices, surface.firstIndex, surface.indexCount
+            );
+        }
+        return true;
+    }
+    };
+    if (!appendMeshlets(surfaces))
+    {
+        return std::nullopt;
+    }
+    for (syzygy::MeshLod& lod : lods)
+    {
+        if (!appendMeshlets(lod.surfaces))
+        {
+            return std::nullopt;
+        }
+    }
+    auto const meshletCount{static_cast<uint32_t>(meshlets.meshlets().size())};
+
     // Allocate buffer
 
-    size_t const indexBufferSize{indices.size_bytes()};
-    size_t const vertexBufferSize{vertices.size_bytes()};
+    size_t const indexBufferSize{
+        indices.size() * syzygy::IndexEncoding::stride(indexType)
+    };
+    size_t const vertexBufferSize{
+        vertices.size() * syzygy::VertexEncoding::stride(vertexFormat)
+    };
+    size_t const meshletBufferSize{meshlets.meshlets().size_bytes()};
 
     syzygy::AllocatedBuffer indexBuffer{syzygy::AllocatedBuffer::allocate(
         device,
@@ -191,80 +503,128 @@ auto uploadMeshToGPU(
         0
     )};
 
-    // Copy data into buffer
-
-    syzygy::AllocatedBuffer stagingBuffer{syzygy::AllocatedBuffer::allocate(
+    // Vulkan does not allow empty buffers, and a mesh without triangles still
+    // needs an address.
+    syzygy::AllocatedBuffer meshletBuffer{syzygy::AllocatedBuffer::allocate(
         device,
         allocator,
-        vertexBufferSize + indexBufferSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VMA_MEMORY_USAGE_CPU_ONLY,
-        VMA_ALLOCATION_CREATE_MAPPED_BIT
+        std::max(meshletBufferSize, sizeof(syzygy::MeshletPacked)),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT
+            | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+        VMA_MEMORY_USAGE_GPU_ONLY,
+        0
     )};
 
-    assert(
-        stagingBuffer.isMapped()
-        && "Staging buffer for mesh upload was not mapped."
-    );
+    // Copy data into buffer
 
-    stagingBuffer.writeBytes(
-        0,
-        std::span<uint8_t const>{
-            reinterpret_cast<uint8_t const*>(vertices.data()), vertexBufferSize
-        }
+    std::optional<syzygy::StagingRing::Reservation> const stagingResult{
+        uploadQueue.allocateStaging(
+            vertexBufferSize + indexBufferSize + meshletBufferSize
+        )
+    };
+    if (!stagingResult.has_value())
+    {
+        SZG_ERROR("Failed to allocate staging memory for mesh.");
+        return std::nullopt;
+    }
+    syzygy::StagingRing::Reservation const staging{stagingResult.value()};
+
+    vertexEncoding.encode(
+        vertices, staging.bytes.subspan(0, vertexBufferSize)
     );
-    stagingBuffer.writeBytes(
-        vertexBufferSize,
-        std::span<uint8_t const>{
-            reinterpret_cast<uint8_t const*>(indices.data()), indexBufferSize
-        }
+    syzygy::IndexEncoding::encode(
+        indices,
+        indexType,
+        staging.bytes.subspan(vertexBufferSize, indexBufferSize)
+    );
+    size_t const meshletOffset{vertexBufferSize + indexBufferSize};
+    std::copy(
+        reinterpret_cast<uint8_t const*>(meshlets.meshlets().data()),
+        reinterpret_cast<uint8_t const*>(meshlets.meshlets().data())
+            + meshletBufferSize,
+        staging.bytes.subspan(meshletOffset, meshletBufferSize).begin()
     );
 
-    if (auto result{submissionQueue.immediateSubmit(
-            transferQueue,
-            [&](VkCommandBuffer cmd)
+    VkBuffer const indexHandle{indexBuffer.buffer()};
+    VkBuffer const vertexHandle{vertexBuffer.buffer()};
+    VkBuffer const meshletHandle{meshletBuffer.buffer()};
+
+    batch.recordCopies.emplace_back(
+        [staging,
+         indexHandle,
+         vertexHandle,
+         meshletHandle,
+         vertexBufferSize,
+         indexBufferSize,
+         meshletOffset,
+         meshletBufferSize](VkCommandBuffer const cmd)
     {
         VkBufferCopy const vertexCopy{
-            .srcOffset = 0,
+            .srcOffset = staging.offset,
             .dstOffset = 0,
             .size = vertexBufferSize,
         };
-        vkCmdCopyBuffer(
-            cmd, stagingBuffer.buffer(), vertexBuffer.buffer(), 1, &vertexCopy
-        );
+        vkCmdCopyBuffer(cmd, staging.buffer, vertexHandle, 1, &vertexCopy);
 
         VkBufferCopy const indexCopy{
-            .srcOffset = vertexBufferSize,
+            .srcOffset = staging.offset + vertexBufferSize,
             .dstOffset = 0,
             .size = indexBufferSize,
         };
-        vkCmdCopyBuffer(
-            cmd, stagingBuffer.buffer(), indexBuffer.buffer(), 1, &indexCopy
-        );
-    }
-        )};
-        result != syzygy::ImmediateSubmissionQueue::SubmissionResult::SUCCESS)
-    {
-        SZG_WARNING("Command submission for mesh upload failed, buffers will "
-                    "likely contain junk or no data.");
+        vkCmdCopyBuffer(cmd, staging.buffer, indexHandle, 1, &indexCopy);
+
+        if (meshletBufferSize > 0)
+        {
+            VkBufferCopy const meshletCopy{
+                .srcOffset = staging.offset + meshletOffset,
+                .dstOffset = 0,
+                .size = meshletBufferSize,
+            };
+            vkCmdCopyBuffer(
+                cmd, staging.buffer, meshletHandle, 1, &meshletCopy
+            );
+        }
     }
+    );
+
+    // Vertices are pulled by address in the vertex shaders.
+    batch.buffers.push_back(syzygy::UploadQueue::BufferHandoff{
+        .buffer = indexHandle,
+        .dstStageMask = VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT,
+        .dstAccessMask = VK_ACCESS_2_INDEX_READ_BIT,
+    });
+    batch.buffers.push_back(syzygy::UploadQueue::BufferHandoff{
+        .buffer = vertexHandle,
+        .dstStageMask = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT,
+        .dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+    });
+    // Meshlets are read when culling.
+    batch.buffers.push_back(syzygy::UploadQueue::BufferHandoff{
+        .buffer = meshletHandle,
+        .dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        .dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+    });
 
     return std::make_unique<syzygy::GPUMeshBuffers>(
-        std::move(indexBuffer), std::move(vertexBuffer)
+        std::move(indexBuffer),
+        indexType,
+        std::move(vertexBuffer),
+        vertexEncoding,
+        std::move(meshletBuffer),
+        meshletCount
     );
 }
 
-auto registerTextureFromRGBA(
-    syzygy::AssetLibrary& library,
+auto uploadTextureFromRGBA(
     VkDevice const device,
     VmaAllocator const allocator,
-    VkQueue const transferQueue,
-    syzygy::ImmediateSubmissionQueue const& submissionQueue,
+    syzygy::UploadQueue& uploadQueue,
+    syzygy::UploadBatch& batch,
     VkFormat const format,
-    std::string const& name,
-    ImageRGBA const& image,
-    std::optional<std::filesystem::path> const& sourcePath
-) -> std::optional<syzygy::AssetShared<syzygy::ImageView>>
+    VkExtent2D const extent,
+    std::span<uint8_t const> const rgba,
+    uint32_t const firstLevel
+) -> std::optional<std::unique_ptr<syzygy::ImageView>>
 {
     // TODO: add more formats and a way to generally check if a format is
     // reasonable. Also support copying 32 bit -> any image format.
@@ -277,862 +637,904 @@ auto registerTextureFromRGBA(
         );
     }
 
-    std::optional<std::unique_ptr<syzygy::Image>> uploadResult{uploadImageToGPU(
-        device,
-        allocator,
-        transferQueue,
-        submissionQueue,
-        format,
-        VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
-        image
-    )};
-    if (!uploadResult.has_value())
+    size_t const levelZeroBytes{
+        static_cast<size_t>(extent.width) * extent.height * sizeof(RGBATexel)
+    };
+    if (rgba.size() < levelZeroBytes)
     {
-        SZG_ERROR("Failed to upload image to GPU.");
+        SZG_ERROR("Texture has fewer texels than its extent requires.");
         return std::nullopt;
     }
+
+    // Sampled textures are trilinearly filtered, so they get a full mip chain.
+    uint32_t const mipLevels{
+        syzygy::MipChain::levelCount(extent.width, extent.height)
+    };
+    uint32_t const uploadedLevel{std::min(firstLevel, mipLevels - 1)};
+
+    // The view owns the image on the heap, so the batch can refer to it until
+    // submission.
     std::optional<std::unique_ptr<syzygy::ImageView>> imageViewResult{
         syzygy::ImageView::allocate(
             device,
             allocator,
-            std::move(*uploadResult.value()),
+            syzygy::ImageAllocationParameters{
+                .extent =
+                    VkExtent2D{
+                        .width = std::max(extent.width >> uploadedLevel, 1U),
+                        .height = std::max(extent.height >> uploadedLevel, 1U),
+                    },
+                .format = format,
+                .mipLevels = mipLevels - uploadedLevel,
+                .usageFlags = VK_IMAGE_USAGE_SAMPLED_BIT
+                            | VK_IMAGE_USAGE_TRANSFER_DST_BIT
+                            | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                .tiling = VK_IMAGE_TILING_OPTIMAL
+            },
             syzygy::ImageViewAllocationParameters{}
         )
     };
     if (!imageViewResult.has_value() || imageViewResult.value() == nullptr)
     {
-        SZG_ERROR("Failed to convert image into imageview.");
+        SZG_ERROR("Failed to allocate imageview for texture.");
         return std::nullopt;
     }
 
-    return library.registerAsset<syzygy::ImageView>(
-        std::move(imageViewResult).value(),
-        fmt::format("texture_{}", name),
-        sourcePath
-    );
-}
-
-} // namespace detail
-
-namespace detail_stbi
-{
-auto loadRGBA(std::span<uint8_t const> const bytes) -> std::optional<ImageRGBA>
-{
-    int32_t x{0};
-    int32_t y{0};
-
-    int32_t components{0};
-    uint16_t constexpr RGBA_COMPONENT_COUNT{4};
-
-    stbi_uc* const parsedImage{stbi_load_from_memory(
-        bytes.data(),
-        static_cast<int32_t>(bytes.size()),
-        &x,
-        &y,
-        &components,
-        RGBA_COMPONENT_COUNT
-    )};
-
-    if (parsedImage == nullptr)
+    std::optional<syzygy::StagingRing::Reservation> const stagingResult{
+        uploadQueue.allocateStaging(
+            syzygy::MipChain::chainBytes(extent.width, extent.height)
+        )
+    };
+    if (!stagingResult.has_value())
     {
-        SZG_ERROR("stbi: Failed to convert image.");
+        SZG_ERROR("Failed to allocate staging memory for image.");
         return std::nullopt;
     }
+    syzygy::StagingRing::Reservation const staging{stagingResult.value()};
+
+    std::copy(
+        rgba.begin(),
+        rgba.begin() + static_cast<std::ptrdiff_t>(levelZeroBytes),
+        staging.bytes.begin()
+    );
 
-    if (x < 1 || y < 1)
+    // Each level is downsampled from the one before it, which was just written
+    // to the same staging memory.
+    std::vector<VkDeviceSize> mipOffsets{staging.offset};
+    mipOffsets.reserve(mipLevels);
+    size_t levelOffset{0};
+    size_t levelBytes{levelZeroBytes};
+    uint32_t levelWidth{extent.width};
+    uint32_t levelHeight{extent.height};
+    for (uint32_t mipLevel{1}; mipLevel < mipLevels; mipLevel++)
     {
-        SZG_ERROR(fmt::format(
-            "stbi: Parsed image had invalid dimensions: ({},{})", x, y
-        ));
-        return std::nullopt;
-    }
+        uint32_t const nextWidth{std::max(levelWidth / 2, 1U)};
+        uint32_t const nextHeight{std::max(levelHeight / 2, 1U)};
+        size_t const nextBytes{
+            static_cast<size_t>(nextWidth) * nextHeight * sizeof(RGBATexel)
+        };
 
-    auto widthPixels{static_cast<uint32_t>(x)};
-    auto heightPixels{static_cast<uint32_t>(y)};
-    size_t constexpr BYTES_PER_COMPONENT{1};
-    size_t constexpr BYTES_PER_PIXEL{
-        RGBA_COMPONENT_COUNT * BYTES_PER_COMPONENT
-    };
-    std::vector<uint8_t> const rgba{
-        parsedImage,
-        parsedImage
-            + static_cast<size_t>(widthPixels * heightPixels) * BYTES_PER_PIXEL
-    };
+        syzygy::MipChain::downsample(
+            staging.bytes.subspan(levelOffset, levelBytes),
+            levelWidth,
+            levelHeight,
+            format == VK_FORMAT_R8G8B8A8_SRGB,
+            staging.bytes.subspan(levelOffset + levelBytes, nextBytes)
+        );
 
-    stbi_image_free(parsedImage);
+        levelOffset += levelBytes;
+        mipOffsets.push_back(staging.offset + levelOffset);
 
-    return ImageRGBA{.x = widthPixels, .y = heightPixels, .bytes = rgba};
-}
-} // namespace detail_stbi
+        levelBytes = nextBytes;
+        levelWidth = nextWidth;
+        levelHeight = nextHeight;
+    }
 
-namespace detail_fastgltf
-{
-struct ImageChannelOverrides
-{
-    std::optional<uint8_t> red{};
-    std::optional<uint8_t> green{};
-    std::optional<uint8_t> blue{};
-    std::optional<uint8_t> alpha{};
-};
+    // Dropped levels are still generated, since the kept ones are downsampled
+    // from them.
+    mipOffsets.erase(
+        mipOffsets.begin(),
+        mipOffsets.begin() + static_cast<std::ptrdiff_t>(uploadedLevel)
+    );
+    recordImageCopies(
+        batch,
+        imageViewResult.value()->image(),
+        staging.buffer,
+        std::move(mipOffsets)
+    );
 
-// glTF material texture indices oragnized into syzygy's material format
-struct MaterialTextureIndices
-{
-    std::optional<size_t> color{};
-    std::optional<size_t> normal{};
-    std::optional<size_t> occlusion{};
-    std::optional<size_t> roughnessMetallic{};
-};
+    return std::move(imageViewResult).value();
+}
 
-enum class MapTypes
-{
-    Color,
-    Normal,
-    OcclusionRoughnessMetallic
-};
-auto string_MapTypes(MapTypes const mapType)
+auto uploadCookedTexture(
+    VkDevice const device,
+    VmaAllocator const allocator,
+    syzygy::UploadQueue& uploadQueue,
+    syzygy::UploadBatch& batch,
+    syzygy::CookedTexture const& texture,
+    uint32_t const firstLevel
+) -> std::optional<std::unique_ptr<syzygy::ImageView>>
 {
-    switch (mapType)
+    // Materials sample textures as 2D, so they must not get array views.
+    if (texture.arrayLayers() != 1)
     {
-    case MapTypes::Color:
-        return "color";
-    case MapTypes::Normal:
-        return "normal";
-    case MapTypes::OcclusionRoughnessMetallic:
-        return "orm";
+        SZG_WARNING(
+            "Cooked texture has {} array layers, but only 2D textures can be "
+            "uploaded.",
+            texture.arrayLayers()
+        );
+        return std::nullopt;
     }
-}
-
-auto loadGLTFAsset(std::filesystem::path const& path)
-    -> fastgltf::Expected<fastgltf::Asset>
-{
-    std::filesystem::path const assetPath{syzygy::ensureAbsolutePath(path)};
 
-    fastgltf::GltfDataBuffer data;
-    data.loadFromFile(assetPath);
-
-    auto constexpr GLTF_OPTIONS{
-        fastgltf::Options::LoadGLBBuffers
-        | fastgltf::Options::LoadExternalBuffers
-        //        | fastgltf::Options::LoadExternalImages // Defer loading
-        //        images so we have access to the URIs
+    uint32_t const uploadedLevel{
+        std::min(firstLevel, texture.mipLevels() - 1)
     };
+    std::vector<std::span<uint8_t const>> levels{texture.levels()};
+    levels.erase(
+        levels.begin(),
+        levels.begin() + static_cast<std::ptrdiff_t>(uploadedLevel)
+    );
 
-    fastgltf::Parser parser{};
-
-    if (assetPath.extension() == ".gltf")
+    std::optional<std::unique_ptr<syzygy::ImageView>> imageViewResult{
+        syzygy::ImageView::allocate(
+            device,
+            allocator,
+            syzygy::ImageAllocationParameters{
+                .extent =
+                    VkExtent2D{
+                        .width = std::max(
+                            texture.extent().width >> uploadedLevel, 1U
+                        ),
+                        .height = std::max(
+                            texture.extent().height >> uploadedLevel, 1U
+                        ),
+                    },
+                .format = texture.format(),
+                .mipLevels = texture.mipLevels() - uploadedLevel,
+                .usageFlags = VK_IMAGE_USAGE_SAMPLED_BIT
+                            | VK_IMAGE_USAGE_TRANSFER_DST_BIT
+                            | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                .tiling = VK_IMAGE_TILING_OPTIMAL
+            },
+            syzygy::ImageViewAllocationParameters{}
+        )
+    };
+    if (!imageViewResult.has_value() || imageViewResult.value() == nullptr)
     {
-        return parser.loadGltfJson(
-            &data, assetPath.parent_path(), GLTF_OPTIONS
+        // Formats outside of what the device requires, such as ASTC from a
+        // KTX2 file, may be unsupported.
+        SZG_ERROR(
+            "Failed to allocate imageview for cooked texture of format {}.",
+            string_VkFormat(texture.format())
         );
+        return std::nullopt;
+    }
+
+    if (!recordImageUpload(
+            uploadQueue, batch, imageViewResult.value()->image(), levels
+        ))
+    {
+        SZG_ERROR("Failed to upload cooked texture to GPU.");
+        return std::nullopt;
     }
 
-    return parser.loadGltfBinary(&data, assetPath.parent_path(), GLTF_OPTIONS);
+    return std::move(imageViewResult).value();
 }
 
-// Preserves glTF indexing.
-auto getTextureSources(
-    std::span<fastgltf::Texture const> const textures,
-    std::span<fastgltf::Image const> const images
-) -> std::vector<std::optional<std::reference_wrapper<fastgltf::Image const>>>
+// Blocks until the upload completes, so the texture is ready once registered.
+auto registerTextureFromRGBA(
+    syzygy::AssetLibrary& library,
+    VkDevice const device,
+    VmaAllocator const allocator,
+    syzygy::UploadQueue& uploadQueue,
+    VkFormat const format,
+    std::string const& name,
+    ImageRGBA const& image,
+    std::optional<std::filesystem::path> const& sourcePath
+) -> std::optional<syzygy::AssetShared<syzygy::ImageView>>
 {
-    std::vector<std::optional<std::reference_wrapper<fastgltf::Image const>>>
-        textureSourcesByGLTFIndex{};
-    textureSourcesByGLTFIndex.reserve(textures.size());
-    for (fastgltf::Texture const& texture : textures)
+    syzygy::UploadBatch batch{};
+    std::optional<std::unique_ptr<syzygy::ImageView>> textureResult{
+        uploadTextureFromRGBA(
+            device,
+            allocator,
+            uploadQueue,
+            batch,
+            format,
+            VkExtent2D{.width = image.x, .height = image.y},
+            image.bytes,
+            0
+        )
+    };
+    if (!textureResult.has_value()
+        || !submitAndWait(uploadQueue, std::move(batch)))
     {
-        textureSourcesByGLTFIndex.emplace_back(std::nullopt);
-        auto& sourceImage{textureSourcesByGLTFIndex.back()};
-
-        if (!texture.imageIndex.has_value())
-        {
-            SZG_WARNING("Texture {} was missing imageIndex.", texture.name);
-            continue;
-        }
-
-        size_t const loadedIndex{texture.imageIndex.value()};
-
-        if (loadedIndex >= textures.size())
-        {
-            SZG_WARNING(
-                "Texture {} had imageIndex that was out of bounds.",
-                texture.name
-            );
-            continue;
-        }
-
-        sourceImage = images[loadedIndex];
+        return std::nullopt;
     }
 
-    return textureSourcesByGLTFIndex;
+    return library.registerAsset<syzygy::ImageView>(
+        std::move(textureResult).value(),
+        fmt::format("texture_{}", name),
+        sourcePath
+    );
 }
 
-auto convertGLTFImageToRGBAAndFullyQualifiedSource(
-    fastgltf::Image const& image,
-    ImageChannelOverrides const overrides,
-    std::filesystem::path const& assetRoot
-) -> std::optional<std::tuple<ImageRGBA, std::filesystem::path>>
-{
-    std::optional<std::tuple<ImageRGBA, std::filesystem::path>> result{
-        std::nullopt
-    };
+} // namespace detail
 
-    if (std::holds_alternative<fastgltf::sources::Array>(image.data))
+namespace syzygy
+{
+// A texture that is read from its source again, after TextureResidency evicted
+// or reduced it. Its current data is kept until the upload completes.
+struct TextureStreamTask
+{
+    struct DecodedFile
     {
-        std::span<uint8_t const> const data =
-            std::get<fastgltf::sources::Array>(image.data).bytes;
+        DecodedRGBA image;
+        VkFormat format{VK_FORMAT_UNDEFINED};
+    };
+    using Texels = std::variant<CookedTexture, DecodedFile>;
 
-        std::optional<ImageRGBA> imageConvertResult{detail_stbi::loadRGBA(data)
-        };
+    AssetPtr<ImageView> texture{};
+    uint32_t firstLevel{0};
+    std::future<std::optional<Texels>> texels{};
 
-        if (imageConvertResult.has_value())
+    static auto read(TextureStreamSource const& source)
+        -> std::optional<Texels>
+    {
+        if (auto const* const cooked{std::get_if<CookedTextureSource>(&source)
+            };
+            cooked != nullptr)
         {
-            result = {std::move(imageConvertResult.value()), assetRoot};
+            std::optional<CookedTexture> texture{
+                CookedTexture::load(cooked->cacheDirectory, cooked->key)
+            };
+            if (!texture.has_value())
+            {
+                return std::nullopt;
+            }
+            return Texels{std::move(texture).value()};
         }
-    }
-    else if (std::holds_alternative<fastgltf::sources::URI>(image.data))
-    {
-        fastgltf::sources::URI const& uri{
-            std::get<fastgltf::sources::URI>(image.data)
-        };
-
-        // These asserts should be loosened as we support a larger subset of
-        // glTF.
-        assert(uri.fileByteOffset == 0);
-        assert(uri.uri.isLocalPath());
-
-        std::filesystem::path const path{assetRoot / uri.uri.fspath()};
-
-        std::ifstream file(path, std::ios::binary);
 
-        if (!std::filesystem::is_regular_file(path))
+        auto const& file{std::get<ImageFileSource>(source)};
+        std::optional<AssetFile> const fileResult{loadAssetFile(file.path)};
+        if (!fileResult.has_value())
         {
-            SZG_WARNING(
-                "glTF image source URI does not result in a valid file path. "
-                "URI was: {}. Full path is: {}",
-                uri.uri.string(),
-                path.string()
-            );
             return std::nullopt;
         }
-
-        size_t const lengthBytes{std::filesystem::file_size(path)};
-
-        std::vector<uint8_t> data(lengthBytes);
-        file.read(
-            reinterpret_cast<char*>(data.data()),
-            static_cast<std::streamsize>(lengthBytes)
-        );
-
-        // Throw the file to stbi and hope for the best, it should detect the
-        // file headers properly
-
-        std::optional<ImageRGBA> imageConvertResult{detail_stbi::loadRGBA(data)
+        if (CookedTexture::isKTX2(fileResult.value().fileBytes()))
+        {
+            std::optional<CookedTexture> texture{
+                openKTX2Texture(fileResult.value().path, file.format)
+            };
+            if (!texture.has_value())
+            {
+                return std::nullopt;
+            }
+            return Texels{std::move(texture).value()};
+        }
+        std::optional<DecodedRGBA> image{
+            decodeRGBA(fileResult.value().fileBytes())
         };
-
-        if (imageConvertResult.has_value())
+        if (!image.has_value())
         {
-            result = {std::move(imageConvertResult.value()), path};
+            return std::nullopt;
         }
+        return Texels{DecodedFile{
+            .image = std::move(image).value(),
+            .format = file.format,
+        }};
     }
-    else
-    {
-        SZG_WARNING("Unsupported glTF image source found.");
-        return std::nullopt;
-    }
-
-    if (!result.has_value())
-    {
-        SZG_WARNING("Failed to load image from glTF.");
-        return std::nullopt;
-    }
-
-    uint64_t const redSelector{overrides.red.has_value() ? 0U : 1U};
-    uint64_t const redValue{overrides.red.value_or(0)};
-
-    uint64_t const greenSelector{overrides.green.has_value() ? 0U : 1U};
-    uint64_t const greenValue{overrides.green.value_or(0)};
-
-    uint64_t const blueSelector{overrides.blue.has_value() ? 0U : 1U};
-    uint64_t const blueValue{overrides.blue.value_or(0)};
-
-    uint64_t const alphaSelector{overrides.alpha.has_value() ? 0U : 1U};
-    uint64_t const alphaValue{overrides.alpha.value_or(0)};
+};
+} // namespace syzygy
 
-    auto& imageBytes{std::get<0>(result.value()).bytes};
-    for (RGBATexel& texel : std::span<RGBATexel>{
-             reinterpret_cast<RGBATexel*>(imageBytes.data()),
-             imageBytes.size() / sizeof(RGBATexel)
-         })
+namespace detail_fastgltf
+{
+auto textureNameSuffix(syzygy::TextureEncoding const encoding)
+{
+    switch (encoding)
     {
-        texel.r = static_cast<uint8_t>(texel.r * redSelector + redValue);
-        texel.g = static_cast<uint8_t>(texel.g * greenSelector + greenValue);
-        texel.b = static_cast<uint8_t>(texel.b * blueSelector + blueValue);
-        texel.a = static_cast<uint8_t>(texel.a * alphaSelector + alphaValue);
+    case syzygy::TextureEncoding::Color:
+        return "color";
+    case syzygy::TextureEncoding::Normal:
+        return "normal";
+    case syzygy::TextureEncoding::OcclusionRoughnessMetallic:
+        return "orm";
     }
-
-    return result;
 }
 
-// Preserves gltf indexing. Returns a vector whose size matches the count of
-// materials passed in.
-auto parseMaterialIndices(fastgltf::Material const& material)
-    -> MaterialTextureIndices
+// A texture that a glTF's materials use, with what it was cooked from, so that
+// it can be cooked again when its image changes.
+struct ScheduledTexture
 {
-    MaterialTextureIndices indices{};
-
-    {
-        std::optional<fastgltf::TextureInfo> const& color{
-            material.pbrData.baseColorTexture
-        };
-        if (!color.has_value())
-        {
-            SZG_WARNING("Material {}: Missing color texture.", material.name);
-        }
-        else
-        {
-            indices.color = color.value().textureIndex;
-        }
-    }
+    syzygy::AssetPtr<syzygy::ImageView> texture{};
+    syzygy::AssetPtr<syzygy::ImageView> fallback{};
+    size_t textureIndex{0};
+    syzygy::ImageChannelOverrides overrides{};
+    syzygy::TextureEncoding encoding{};
+    // The texture is indexed for deduplication under this, see
+    // syzygy::gltfImageSignature.
+    uint64_t signature{0};
+    // The key the texture was cooked under. Empty until its decode finishes.
+    std::optional<uint64_t> contentHash{};
+};
 
+// Cooks the image on the workers, into the texture cache under the key. The
+// job holds onto the glTF so image sources stay alive until the decode is done.
+// Without a key, the job hashes the image to find it, so that the main thread
+// never reads image files.
+auto submitTextureCook(
+    syzygy::ThreadPool& decodeWorkers,
+    std::shared_ptr<fastgltf::Asset const> const& gltf,
+    size_t const imageIndex,
+    syzygy::ImageChannelOverrides const overrides,
+    std::filesystem::path const& assetRoot,
+    syzygy::TextureEncoding const encoding,
+    std::optional<uint64_t> const contentHash
+) -> std::future<std::optional<
+      std::tuple<syzygy::CookedTexture, std::filesystem::path, uint64_t>>>
+{
+    std::filesystem::path const cacheDirectory{
+        syzygy::cookedAssetDirectory("textures")
+    };
+    return decodeWorkers.submit(
+        [gltf,
+         imageIndex,
+         overrides,
+         assetRoot,
+         encoding,
+         cacheDirectory,
+         contentHash]()
+        -> std::optional<std::tuple<
+            syzygy::CookedTexture,
+            std::filesystem::path,
+            uint64_t>>
     {
-        std::optional<fastgltf::NormalTextureInfo> const& normal{
-            material.normalTexture
-        };
-        if (!normal.has_value())
-        {
-            SZG_WARNING("Material {}: Missing normal texture.", material.name);
-        }
-        else
-        {
-            indices.normal = normal.value().textureIndex;
-        }
-    }
+        fastgltf::Image const& image{gltf->images[imageIndex]};
 
-    {
-        std::optional<fastgltf::OcclusionTextureInfo> const& occlusion{
-            material.occlusionTexture
-        };
-        if (!occlusion.has_value())
+        std::optional<uint64_t> key{contentHash};
+        if (!key.has_value())
         {
-            SZG_WARNING(
-                "Material {}: Missing occlusion texture.", material.name
+            std::optional<uint64_t> const sourceHash{
+                syzygy::hashGLTFImageSource(image, assetRoot)
+            };
+            if (!sourceHash.has_value())
+            {
+                SZG_WARNING("Failed to read glTF image source.");
+                return std::nullopt;
+            }
+            key = syzygy::cookedTextureKey(
+                sourceHash.value(), overrides, encoding
             );
         }
-        else
-        {
-            indices.occlusion = occlusion.value().textureIndex;
-        }
-    }
 
-    {
-        std::optional<fastgltf::TextureInfo> const& metallicRoughness{
-            material.pbrData.metallicRoughnessTexture
-        };
-        if (!metallicRoughness.has_value())
-        {
-            SZG_WARNING(
-                "Material {}: Missing metallicRoughness texture", material.name
-            );
-        }
-        else
+        std::optional<std::tuple<syzygy::CookedTexture, std::filesystem::path>>
+            cookResult{syzygy::cookGLTFImage(
+                image,
+                overrides,
+                assetRoot,
+                encoding,
+                cacheDirectory,
+                key.value()
+            )};
+        if (!cookResult.has_value())
         {
-            indices.roughnessMetallic = metallicRoughness.value().textureIndex;
+            return std::nullopt;
         }
-    }
-
-    return indices;
-}
-
-auto accessTexture(
-    std::span<std::optional<std::reference_wrapper<fastgltf::Image const>>>
-        textureSourcesByGLTFIndex,
-    size_t const textureIndex
-) -> std::optional<std::reference_wrapper<fastgltf::Image const>>
-{
-    if (textureIndex >= textureSourcesByGLTFIndex.size())
-    {
-        SZG_WARNING("Out of bounds texture index.");
-        return std::nullopt;
-    }
 
-    if (!textureSourcesByGLTFIndex[textureIndex].has_value())
-    {
-        SZG_WARNING("Texture index source was not loaded.");
-        return std::nullopt;
+        auto& [cooked, sourcePath]{cookResult.value()};
+        return std::tuple{
+            std::move(cooked), std::move(sourcePath), key.value()
+        };
     }
-
-    return textureSourcesByGLTFIndex[textureIndex].value().get();
+    );
 }
 
-auto uploadTextureFromIndex(
+// Registers a texture asset that initially shares the placeholder's data, and
+// queues the decode of the real image onto the worker pool. The asset's data is
+// swapped in place by AssetLibrary::processTasks once the decode finishes.
+// Images whose files were already scheduled unchanged, by this or an earlier
+// import, resolve to that asset instead. Only the files' signatures are read
+// here, the decode hashes their content.
+auto scheduleTextureFromIndex(
     syzygy::AssetLibrary& destinationLibrary,
-    VkDevice const device,
-    VmaAllocator const allocator,
-    VkQueue const transferQueue,
-    syzygy::ImmediateSubmissionQueue const& submissionQueue,
+    syzygy::ThreadPool& decodeWorkers,
+    std::vector<std::shared_ptr<syzygy::TextureDecodeTask>>& decodeTasks,
+    std::shared_ptr<fastgltf::Asset const> const& gltf,
+    uint64_t const gltfSignature,
     std::span<std::optional<std::reference_wrapper<fastgltf::Image const>>>
         textureSourcesByGLTFIndex,
-    size_t const textureIndex,
-    ImageChannelOverrides const overrides,
+    syzygy::GLTFTextureCook const& cook,
     std::filesystem::path const& assetRoot,
     std::string const& gltfAssetName,
-    MapTypes const mapType
+    syzygy::AssetPtr<syzygy::ImageView> const& placeholder,
+    std::vector<ScheduledTexture>& scheduledTextures
 ) -> std::optional<syzygy::AssetShared<syzygy::ImageView>>
 {
     std::optional<std::reference_wrapper<fastgltf::Image const>> textureResult{
-        accessTexture(textureSourcesByGLTFIndex, textureIndex)
+        syzygy::accessGLTFTexture(textureSourcesByGLTFIndex, cook.textureIndex)
     };
     if (!textureResult.has_value())
     {
         return std::nullopt;
     }
 
-    std::optional<std::tuple<ImageRGBA, std::filesystem::path>> convertResult{
-        convertGLTFImageToRGBAAndFullyQualifiedSource(
-            textureResult.value().get(), overrides, assetRoot
-        )
+    syzygy::AssetShared<syzygy::ImageView> const placeholderAsset{
+        placeholder.lock()
+    };
+    if (placeholderAsset == nullptr)
+    {
+        SZG_WARNING("Placeholder texture for glTF image was not loaded.");
+        return std::nullopt;
+    }
+
+    // accessGLTFTexture succeeding means this index is valid.
+    size_t const imageIndex{
+        gltf->textures[cook.textureIndex].imageIndex.value()
     };
-    if (!convertResult.has_value())
+
+    std::optional<uint64_t> const sourceSignature{syzygy::gltfImageSignature(
+        textureResult.value().get(), imageIndex, gltfSignature, assetRoot
+    )};
+    if (!sourceSignature.has_value())
     {
+        SZG_WARNING("Failed to read glTF image source.");
         return std::nullopt;
     }
+    uint64_t const signature{syzygy::cookedTextureKey(
+        sourceSignature.value(), cook.overrides, cook.encoding
+    )};
+
+    ScheduledTexture const scheduled{
+        .fallback = placeholder,
+        .textureIndex = cook.textureIndex,
+        .overrides = cook.overrides,
+        .encoding = cook.encoding,
+        .signature = signature,
+    };
 
-    VkFormat fileFormat{};
-    switch (mapType)
+    if (std::optional<syzygy::AssetShared<syzygy::ImageView>> existing{
+            destinationLibrary.findByContent<syzygy::ImageView>(signature)
+        };
+        existing.has_value())
     {
-    case MapTypes::Color:
-        fileFormat = VK_FORMAT_R8G8B8A8_SRGB;
-        break;
-    case MapTypes::Normal:
-    case MapTypes::OcclusionRoughnessMetallic:
-        fileFormat = VK_FORMAT_R8G8B8A8_UNORM;
-        break;
+        scheduledTextures.push_back(scheduled);
+        scheduledTextures.back().texture = existing.value();
+        return existing;
     }
 
     std::string assetName{textureResult.value().get().name};
     if (assetName.empty())
     {
         assetName = fmt::format(
-            "{}_{}_{}", gltfAssetName, textureIndex, string_MapTypes(mapType)
+            "{}_{}_{}",
+            gltfAssetName,
+            cook.textureIndex,
+            textureNameSuffix(cook.encoding)
         );
     }
 
-    return detail::registerTextureFromRGBA(
-        destinationLibrary,
-        device,
-        allocator,
-        transferQueue,
-        submissionQueue,
-        fileFormat,
-        assetName,
-        std::get<0>(convertResult.value()),
-        std::get<1>(convertResult.value())
+    std::optional<syzygy::AssetShared<syzygy::ImageView>> registerResult{
+        destinationLibrary.registerAsset<syzygy::ImageView>(
+            placeholderAsset->data,
+            fmt::format("texture_{}", assetName),
+            assetRoot
+        )
+    };
+    if (!registerResult.has_value())
+    {
+        return std::nullopt;
+    }
+    destinationLibrary.indexContent<syzygy::ImageView>(
+        signature, registerResult.value()
     );
+    scheduledTextures.push_back(scheduled);
+    scheduledTextures.back().texture = registerResult.value();
+
+    decodeTasks.push_back(std::make_shared<syzygy::TextureDecodeTask>(
+        syzygy::TextureDecodeTask{
+            .texture = registerResult.value(),
+            .fallback = placeholder,
+            .decodeResult = submitTextureCook(
+                decodeWorkers,
+                gltf,
+                imageIndex,
+                cook.overrides,
+                assetRoot,
+                cook.encoding,
+                std::nullopt
+            ),
+        }
+    ));
+
+    return registerResult;
 }
 
-// NOLINTNEXTLINE(readability-function-cognitive-complexity)
-auto uploadMaterialDataAsAssets(
+// Returns materials whose textures are placeholders from fallbackMaterialData,
+// which are filled in as their decodes finish. See scheduleTextureFromIndex.
+// Every texture the materials use is appended to scheduledTextures.
+auto scheduleMaterialTextures(
     syzygy::AssetLibrary& destinationLibrary,
-    VkDevice const device,
-    VmaAllocator const allocator,
-    VkQueue const transferQueue,
-    syzygy::ImmediateSubmissionQueue const& submissionQueue,
+    syzygy::ThreadPool& decodeWorkers,
+    std::vector<std::shared_ptr<syzygy::TextureDecodeTask>>& decodeTasks,
     syzygy::MaterialData const& fallbackMaterialData,
-    fastgltf::Asset const& gltf,
-    std::filesystem::path const& assetRoot
+    std::shared_ptr<fastgltf::Asset const> const& gltf,
+    uint64_t const gltfSignature,
+    std::filesystem::path const& assetRoot,
+    std::vector<ScheduledTexture>& scheduledTextures
 ) -> std::vector<syzygy::MaterialData>
 {
     // Follow texture.imageIndex -> image indirection by one step
     std::vector<std::optional<std::reference_wrapper<fastgltf::Image const>>>
-        textureSourcesByGLTFIndex{
-            detail_fastgltf::getTextureSources(gltf.textures, gltf.images)
-        };
+        textureSourcesByGLTFIndex{syzygy::gltfTextureSources(*gltf)};
 
     std::vector<syzygy::MaterialData> materialDataByGLTFIndex{};
-    materialDataByGLTFIndex.reserve(gltf.materials.size());
-    for (fastgltf::Material const& material : gltf.materials)
+    materialDataByGLTFIndex.reserve(gltf->materials.size());
+    for (fastgltf::Material const& material : gltf->materials)
     {
         materialDataByGLTFIndex.push_back(fallbackMaterialData);
         syzygy::MaterialData& materialData{materialDataByGLTFIndex.back()};
 
-        detail_fastgltf::MaterialTextureIndices materialTextures{
-            parseMaterialIndices(material)
+        syzygy::GLTFMaterialTextures const materialTextures{
+            syzygy::GLTFMaterialTextures::parse(material)
         };
 
-        if (materialTextures.roughnessMetallic.has_value()
-            || materialTextures.occlusion.has_value())
+        auto const schedule{[&](std::optional<syzygy::GLTFTextureCook> const&
+                                    cook,
+                                syzygy::PooledAssetPtr<syzygy::ImageView> const&
+                                    placeholder,
+                                syzygy::PooledAssetPtr<syzygy::ImageView>&
+                                    texture)
         {
-            size_t ormTextureIndex{};
-            ImageChannelOverrides overrides{};
-
-            if (materialTextures.occlusion.has_value()
-                && materialTextures.occlusion
-                       != materialTextures.roughnessMetallic)
-            {
-                SZG_WARNING("Material {}: occlusion and roughnessMetallic "
-                            "textures differ. Loading roughnessMetallic and "
-                            "overriding its occlusion channel.");
-            }
-
-            if (materialTextures.roughnessMetallic.has_value())
+            if (!cook.has_value())
             {
-                ormTextureIndex = materialTextures.roughnessMetallic.value();
-                overrides.red = RGBATexel::SATURATED_COMPONENT;
-            }
-            else
-            {
-                ormTextureIndex = materialTextures.occlusion.value();
-                overrides.green = 0U;
-                overrides.blue = 0U;
+                return;
             }
 
             if (std::optional<syzygy::AssetShared<syzygy::ImageView>>
-                    textureLoadResult{uploadTextureFromIndex(
+                    textureLoadResult{scheduleTextureFromIndex(
                         destinationLibrary,
-                        device,
-                        allocator,
-                        transferQueue,
-                        submissionQueue,
+                        decodeWorkers,
+                        decodeTasks,
+                        gltf,
+                        gltfSignature,
                         textureSourcesByGLTFIndex,
-                        ormTextureIndex,
-                        overrides,
+                        cook.value(),
                         assetRoot,
                         std::string{material.name},
-                        MapTypes::OcclusionRoughnessMetallic
+                        placeholder.shared(),
+                        scheduledTextures
                     )};
                 !textureLoadResult.has_value()
                 || textureLoadResult.value() == nullptr)
             {
                 SZG_WARNING(
-                    "Material {}: Failed to upload ORM texture.", material.name
+                    "Material {}: Failed to schedule {} texture.",
+                    material.name,
+                    textureNameSuffix(cook.value().encoding)
                 );
             }
             else
             {
-                materialData.ORM = textureLoadResult.value();
-            }
-        }
-
-        if (materialTextures.color.has_value())
-        {
-            if (std::optional<syzygy::AssetShared<syzygy::ImageView>>
-                    textureLoadResult{uploadTextureFromIndex(
-                        destinationLibrary,
-                        device,
-                        allocator,
-                        transferQueue,
-                        submissionQueue,
-                        textureSourcesByGLTFIndex,
-                        materialTextures.color.value(),
-                        {},
-                        assetRoot,
-                        std::string{material.name},
-                        MapTypes::Color
-                    )};
-                !textureLoadResult.has_value()
-                || textureLoadResult.value() == nullptr)
-            {
-                SZG_WARNING(
-                    "Material {}: Failed to upload color texture.",
-                    material.name
+                texture = syzygy::PooledAssetPtr<syzygy::ImageView>::from(
+                    *textureLoadResult.value()
                 );
             }
-            else
-            {
-                materialData.color = textureLoadResult.value();
-            }
-        }
+        }};
 
-        if (materialTextures.normal.has_value())
-        {
-            if (std::optional<syzygy::AssetShared<syzygy::ImageView>>
-                    textureLoadResult{uploadTextureFromIndex(
-                        destinationLibrary,
-                        device,
-                        allocator,
-                        transferQueue,
-                        submissionQueue,
-                        textureSourcesByGLTFIndex,
-                        materialTextures.normal.value(),
-                        {},
-                        assetRoot,
-                        std::string{material.name},
-                        MapTypes::Normal
-                    )};
-                !textureLoadResult.has_value()
-                || textureLoadResult.value() == nullptr)
-            {
-                SZG_WARNING(
-                    "Material {}: Failed to upload normal texture.",
-                    material.name
-                );
-            }
-            else
-            {
-                materialData.normal = textureLoadResult.value();
-            }
-        }
+        schedule(
+            materialTextures.ORM, fallbackMaterialData.ORM, materialData.ORM
+        );
+        schedule(
+            materialTextures.color,
+            fallbackMaterialData.color,
+            materialData.color
+        );
+        schedule(
+            materialTextures.normal,
+            fallbackMaterialData.normal,
+            materialData.normal
+        );
     }
 
     return materialDataByGLTFIndex;
 }
 
-// Preserves gltf indexing, with nullptr on any positions where loading
-// failed. All passed gltf objects should come from the same object, so
-// accessors are utilized properly.
-// TODO: simplify and breakup. There are some roadblocks because e.g. fastgltf
-// accessors are separate from the mesh
-// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+struct LoadedMesh
+{
+    // Has no meshBuffers, those are uploaded from the geometry. Null if the
+    // mesh failed to load.
+    std::unique_ptr<syzygy::Mesh> mesh{};
+    syzygy::CookedGLTFMesh geometry{};
+};
+
+// Cooks the glTF's meshes on the workers, then resolves their materials.
+// Preserves glTF indexing.
 auto loadMeshes(
-    VkDevice const device,
-    VmaAllocator const allocator,
-    VkQueue const transferQueue,
-    syzygy::ImmediateSubmissionQueue const& submissionQueue,
     std::span<syzygy::MaterialData const> const materialsByGLTFIndex,
     syzygy::MaterialData const& defaultMaterial,
+    syzygy::VertexWeldTolerance const weldTolerance,
+    syzygy::ThreadPool& workers,
     fastgltf::Asset const& gltf
-) -> std::vector<std::unique_ptr<syzygy::Mesh>>
+) -> std::vector<LoadedMesh>
 {
-    std::vector<std::unique_ptr<syzygy::Mesh>> newMeshes{};
-    newMeshes.reserve(gltf.meshes.size());
-    for (fastgltf::Mesh const& mesh : gltf.meshes)
-    {
-        newMeshes.push_back(nullptr);
-        std::unique_ptr<syzygy::Mesh>& newMesh{newMeshes.back()};
+    std::vector<syzygy::CookedGLTFMesh> cookedMeshes{
+        syzygy::cookGLTFMeshes(gltf, weldTolerance, workers)
+    };
 
-        std::vector<uint32_t> indices{};
-        std::vector<syzygy::VertexPacked> vertices{};
+    std::vector<LoadedMesh> newMeshes{};
+    newMeshes.reserve(cookedMeshes.size());
+    for (syzygy::CookedGLTFMesh& cookedMesh : cookedMeshes)
+    {
+        LoadedMesh& newMesh{newMeshes.emplace_back(LoadedMesh{
+            .geometry = std::move(cookedMesh),
+        })};
+        if (newMesh.geometry.surfaces.empty())
+        {
+            continue;
+        }
 
-        std::vector<syzygy::GeometrySurface> surfaces{};
+        newMesh.mesh = detail::makeCookedMesh(
+            newMesh.geometry.surfaces,
+            newMesh.geometry.lodChain.surfaces,
+            newMesh.geometry.lodChain.errors,
+            newMesh.geometry.bounds,
+            materialsByGLTFIndex,
+            defaultMaterial
+        );
+    }
 
-        // Proliferate indices and vertices
-        for (auto&& primitive : mesh.primitives)
-        {
-            if (!primitive.indicesAccessor.has_value()
-                || primitive.indicesAccessor.value() >= gltf.accessors.size())
-            {
-                SZG_WARNING("glTF mesh primitive had no valid indices "
-                            "accessor. It will be skipped.");
-                continue;
-            }
-            if (auto const* positionAttribute{primitive.findAttribute("POSITION"
-                )};
-                positionAttribute == primitive.attributes.end()
-                || positionAttribute == nullptr)
-            {
-                SZG_WARNING("glTF mesh primitive had no valid vertices "
-                            "accessor. It will be skipped.");
-                continue;
-            }
+    return newMeshes;
+}
 
-            if (primitive.type != fastgltf::PrimitiveType::Triangles)
-            {
-                SZG_WARNING("Loading glTF mesh primitive as Triangles mode "
-                            "when it is not.");
-            }
+// What is in a glTF's files now, to compare against what was imported.
+struct GLTFReload
+{
+    // Shared with the decode jobs of textures that changed.
+    std::shared_ptr<fastgltf::Asset const> gltf{};
+    // Parallel to the scheduled textures, with the key each would be cooked
+    // under now. Empty where the image could not be read.
+    std::vector<std::optional<uint64_t>> textureKeys{};
+    // Parallel to textureKeys, see ScheduledTexture::signature.
+    std::vector<std::optional<uint64_t>> textureSignatures{};
+    // Only loaded when the geometry changed. Preserves glTF indexing.
+    std::vector<LoadedMesh> meshes{};
+    // Parallel to meshes, see detail::hashMeshContent.
+    std::vector<uint64_t> meshHashes{};
+};
 
-            surfaces.push_back(syzygy::GeometrySurface{
-                .firstIndex = static_cast<uint32_t>(indices.size()),
-                .indexCount = 0,
-                .material = defaultMaterial
-            });
-            syzygy::GeometrySurface& surface{surfaces.back()};
+// Runs on the decode workers, so everything is passed by value. The images are
+// hashed without being decoded, and the geometry is only loaded if requested,
+// with its meshes cooked on the same workers.
+auto reloadGLTF(
+    std::filesystem::path const& path,
+    bool const reloadGeometry,
+    std::vector<ScheduledTexture> const scheduledTextures,
+    std::vector<syzygy::MaterialData> const materialsByGLTFIndex,
+    syzygy::MaterialData const defaultMaterial,
+    syzygy::VertexWeldTolerance const weldTolerance,
+    syzygy::VertexFormat const vertexFormat,
+    syzygy::ThreadPool& workers
+) -> std::optional<GLTFReload>
+{
+    std::filesystem::path const assetRoot{
+        syzygy::ensureAbsolutePath(path).parent_path()
+    };
 
-            if (!primitive.materialIndex.has_value())
-            {
-                SZG_WARNING(
-                    "Mesh {} has a primitive that is missing material "
-                    "index.",
-                    mesh.name
-                );
-            }
-            else if (size_t const materialIndex{primitive.materialIndex.value()
-                     };
-                     materialIndex >= materialsByGLTFIndex.size())
-            {
-                SZG_WARNING(
-                    "Mesh {} has a primitive with out of bounds material "
-                    "index.",
-                    mesh.name
-                );
-            }
-            else
-            {
-                surface.material = materialsByGLTFIndex[materialIndex];
-            }
-
-            size_t const initialVertexIndex{vertices.size()};
-
-            { // Indices, not optional
-                fastgltf::Accessor const& indicesAccessor{
-                    gltf.accessors[primitive.indicesAccessor.value()]
-                };
-
-                surface.indexCount =
-                    static_cast<uint32_t>(indicesAccessor.count);
-
-                indices.reserve(indices.size() + indicesAccessor.count);
-                fastgltf::iterateAccessor<uint32_t>(
-                    gltf,
-                    indicesAccessor,
-                    [&](uint32_t index)
-                { indices.push_back(index + initialVertexIndex); }
-                );
-            }
-
-            { // Positions, not optional
-                fastgltf::Accessor const& positionAccessor{
-                    gltf.accessors[primitive.findAttribute("POSITION")->second]
-                };
-
-                vertices.reserve(vertices.size() + positionAccessor.count);
-
-                fastgltf::iterateAccessorWithIndex<glm::vec3>(
-                    gltf,
-                    positionAccessor,
-                    [&](glm::vec3 position, size_t /*index*/)
-                {
-                    vertices.push_back(syzygy::VertexPacked{
-                        .position = position,
-                        .uv_x = 0.0F,
-                        .normal = glm::vec3{1, 0, 0},
-                        .uv_y = 0.0F,
-                        .color = glm::vec4{1.0F},
-                    });
-                }
-                );
-            }
-
-            // The rest of these parameters are optional.
-
-            { // Normals
-                auto const* const normals{primitive.findAttribute("NORMAL")};
-                if (normals != primitive.attributes.end())
-                {
-                    fastgltf::iterateAccessorWithIndex<glm::vec3>(
-                        gltf,
-                        gltf.accessors[(*normals).second],
-                        [&](glm::vec3 normal, size_t index)
-                    { vertices[initialVertexIndex + index].normal = normal; }
-                    );
-                }
-            }
+    fastgltf::Expected<fastgltf::Asset> gltfLoadResult{
+        syzygy::loadGLTFAsset(path, reloadGeometry)
+    };
+    if (gltfLoadResult.error() != fastgltf::Error::None)
+    {
+        SZG_WARNING(
+            "Failed to reload glTF {}: {} : {}",
+            path.string(),
+            fastgltf::getErrorName(gltfLoadResult.error()),
+            fastgltf::getErrorMessage(gltfLoadResult.error())
+        );
+        return std::nullopt;
+    }
 
-            { // UVs
-                auto const* const uvs{primitive.findAttribute("TEXCOORD_0")};
-                if (uvs != primitive.attributes.end())
-                {
-                    fastgltf::iterateAccessorWithIndex<glm::vec2>(
-                        gltf,
-                        gltf.accessors[(*uvs).second],
-                        [&](glm::vec2 texcoord, size_t index)
-                    {
-                        vertices[initialVertexIndex + index].uv_x = texcoord.x;
-                        vertices[initialVertexIndex + index].uv_y = texcoord.y;
-                    }
-                    );
-                }
-            }
+    GLTFReload reload{
+        .gltf = std::make_shared<fastgltf::Asset const>(
+            std::move(gltfLoadResult.get())
+        ),
+    };
+    fastgltf::Asset const& gltf{*reload.gltf};
+    std::optional<uint64_t> const gltfSignature{syzygy::fileSignature(path)};
 
-            { // Colors
-                auto const* const colors{primitive.findAttribute("COLOR_0")};
-                if (colors != primitive.attributes.end())
-                {
-                    fastgltf::iterateAccessorWithIndex<glm::vec4>(
-                        gltf,
-                        gltf.accessors[(*colors).second],
-                        [&](glm::vec4 color, size_t index)
-                    { vertices[initialVertexIndex + index].color = color; }
-                    );
-                }
-            }
+    std::vector<std::optional<std::reference_wrapper<fastgltf::Image const>>>
+        textureSourcesByGLTFIndex{syzygy::gltfTextureSources(gltf)};
+    reload.textureKeys.reserve(scheduledTextures.size());
+    reload.textureSignatures.reserve(scheduledTextures.size());
+    for (ScheduledTexture const& scheduled : scheduledTextures)
+    {
+        reload.textureKeys.emplace_back(std::nullopt);
+        reload.textureSignatures.emplace_back(std::nullopt);
+
+        std::optional<std::reference_wrapper<fastgltf::Image const>> const
+            image{syzygy::accessGLTFTexture(
+                textureSourcesByGLTFIndex, scheduled.textureIndex
+            )};
+        if (!image.has_value())
+        {
+            continue;
         }
 
-        bool constexpr FLIP_Y{true};
-        if (FLIP_Y)
+        if (std::optional<uint64_t> const sourceHash{
+                syzygy::hashGLTFImageSource(image.value().get(), assetRoot)
+            };
+            sourceHash.has_value())
         {
-            for (syzygy::VertexPacked& vertex : vertices)
-            {
-                vertex.normal.y *= -1;
-                vertex.position.y *= -1;
-            }
+            reload.textureKeys.back() = syzygy::cookedTextureKey(
+                sourceHash.value(), scheduled.overrides, scheduled.encoding
+            );
         }
 
-        if (surfaces.empty())
+        if (!gltfSignature.has_value())
         {
             continue;
         }
-
-        glm::vec3 vertexMinimum{std::numeric_limits<float>::max()};
-        glm::vec3 vertexMaximum{std::numeric_limits<float>::lowest()};
-
-        for (syzygy::VertexPacked const& vertex : vertices)
+        if (std::optional<uint64_t> const sourceSignature{
+                syzygy::gltfImageSignature(
+                    image.value().get(),
+                    gltf.textures[scheduled.textureIndex].imageIndex.value(),
+                    gltfSignature.value(),
+                    assetRoot
+                )
+            };
+            sourceSignature.has_value())
         {
-            vertexMinimum = glm::min(vertex.position, vertexMinimum);
-            vertexMaximum = glm::max(vertex.position, vertexMaximum);
+            reload.textureSignatures.back() = syzygy::cookedTextureKey(
+                sourceSignature.value(),
+                scheduled.overrides,
+                scheduled.encoding
+            );
         }
+    }
 
-        newMesh = std::make_unique<syzygy::Mesh>(syzygy::Mesh{
-            .surfaces = std::move(surfaces),
-            .vertexBounds = syzygy::AABB::create(vertexMinimum, vertexMaximum),
-            .meshBuffers = detail::uploadMeshToGPU(
-                device,
-                allocator,
-                transferQueue,
-                submissionQueue,
-                indices,
-                vertices
-            ),
-        });
+    if (!reloadGeometry)
+    {
+        return reload;
     }
 
-    return newMeshes;
+    reload.meshes = loadMeshes(
+        materialsByGLTFIndex, defaultMaterial, weldTolerance, workers, gltf
+    );
+    reload.meshHashes.reserve(reload.meshes.size());
+    for (LoadedMesh const& mesh : reload.meshes)
+    {
+        reload.meshHashes.push_back(
+            mesh.mesh == nullptr ? 0
+                                 : detail::hashMeshContent(
+                                     mesh.mesh->surfaces,
+                                     mesh.geometry.indices,
+                                     mesh.geometry.vertices,
+                                     vertexFormat
+                                 )
+        );
+    }
+
+    return reload;
 }
 } // namespace detail_fastgltf
 
+namespace syzygy
+{
+// An imported glTF, and the assets that were created from it, so that they can
+// be updated in place when its files change on disk.
+struct GLTFReloadSource
+{
+    std::filesystem::path path{};
+    // The glTF itself and its external buffers, which the meshes are read
+    // from.
+    std::vector<std::filesystem::path> geometryFiles{};
+    // Changes to these only need the textures to be cooked again.
+    std::vector<std::filesystem::path> imageFiles{};
+
+    std::vector<MaterialData> materialsByGLTFIndex{};
+    MaterialData defaultMaterial{};
+    std::vector<detail_fastgltf::ScheduledTexture> textures{};
+    // Preserves glTF indexing, with expired pointers where no mesh was
+    // registered.
+    std::vector<AssetPtr<Mesh>> meshesByGLTFIndex{};
+
+    // Changes seen since the last reload started, which are reloaded once no
+    // reload is running.
+    bool changed{false};
+    bool geometryChanged{false};
+    bool reloading{false};
+};
+
+struct GLTFReloadTask
+{
+    std::shared_ptr<GLTFReloadSource> source{};
+    std::future<std::optional<detail_fastgltf::GLTFReload>> reload{};
+};
+} // namespace syzygy
+
 namespace syzygy
 {
 auto loadAssetFile(std::filesystem::path const& path)
     -> std::optional<AssetFile>
 {
     std::filesystem::path const assetPath{syzygy::ensureAbsolutePath(path)};
-    std::ifstream file(path, std::ios::ate | std::ios::binary);
 
-    if (!file.is_open())
+    // Empty files also fail to map.
+    std::optional<MappedFile> fileResult{
+        MappedFile::open(assetPath, MappedFile::AccessPattern::Sequential)
+    };
+    if (!fileResult.has_value())
     {
         SZG_ERROR("Unable to open file at {}", path.string());
         return std::nullopt;
     }
 
-    size_t const fileSizeBytes = static_cast<size_t>(file.tellg());
-    if (fileSizeBytes == 0)
+    return AssetFile{
+        .path = path,
+        .mapping = std::move(fileResult).value(),
+    };
+}
+
+auto lodSurfaces(Mesh const& mesh, size_t const level)
+    -> std::span<GeometrySurface const>
+{
+    if (level == 0 || mesh.lods.empty())
     {
-        SZG_ERROR("File at empty at {}", path.string());
-        return std::nullopt;
+        return mesh.surfaces;
     }
+    return mesh.lods[std::min(level, mesh.lods.size()) - 1].surfaces;
+}
 
-    std::vector<uint8_t> buffer(fileSizeBytes);
+void AssetLibrary::trackResidency(
+    AssetShared<ImageView> const& texture,
+    TextureStreamSource source,
+    AssetShared<ImageView> const& fallback
+)
+{
+    if (texture == nullptr || texture->pool != m_textures.get())
+    {
+        return;
+    }
 
-    file.seekg(0, std::ios::beg);
-    file.read(
-        reinterpret_cast<char*>(buffer.data()),
-        static_cast<std::streamsize>(fileSizeBytes)
+    m_textureResidency.track(
+        m_textures->shared(texture->handle), std::move(source), fallback
     );
+}
 
-    file.close();
+auto AssetLibrary::textureResidency() -> TextureResidency&
+{
+    return m_textureResidency;
+}
 
-    return AssetFile{
-        .path = path,
-        .fileBytes = buffer,
+auto AssetLibrary::loadTextureFromPath(
+    VkDevice const device,
+    VmaAllocator const allocator,
+    UploadQueue& uploadQueue,
+    VkFormat const fileFormat,
+    std::filesystem::path const& filePath
+) -> std::optional<AssetShared<ImageView>>
+{
+    UploadImport uploads{
+        .batched = m_batchUploads,
+        .start = std::chrono::steady_clock::now(),
     };
+
+    std::optional<AssetShared<ImageView>> textureResult{importTexture(
+        device, allocator, uploadQueue, uploads, fileFormat, filePath
+    )};
+
+    finishUploads(uploadQueue, std::move(uploads));
+
+    return textureResult;
 }
 
-auto AssetLibrary::loadTextureFromPath(
+auto AssetLibrary::importTexture(
     VkDevice const device,
     VmaAllocator const allocator,
-    VkQueue const transferQueue,
-    ImmediateSubmissionQueue const& submissionQueue,
+    UploadQueue& uploadQueue,
+    UploadImport& uploads,
     VkFormat const fileFormat,
     std::filesystem::path const& filePath
 ) -> std::optional<AssetShared<ImageView>>
@@ -1147,24 +1549,111 @@ auto AssetLibrary::loadTextureFromPath(
 
     AssetFile const& file{fileResult.value()};
 
-    std::optional<ImageRGBA> imageResult{detail_stbi::loadRGBA(file.fileBytes)};
-    if (!imageResult.has_value())
+    // The same file uploaded as another format is a different texture.
+    uint64_t const contentHash{ContentHash::hash(
+        std::span<uint8_t const>{
+            reinterpret_cast<uint8_t const*>(&fileFormat), sizeof(VkFormat)
+        },
+        ContentHash::hash(file.fileBytes())
+    )};
+    if (std::optional<AssetShared<ImageView>> existing{
+            findByContent<ImageView>(contentHash)
+        };
+        existing.has_value())
+    {
+        SZG_INFO("Texture content was already loaded, reusing it.");
+        return existing;
+    }
+
+    std::optional<std::unique_ptr<ImageView>> uploadResult{};
+    if (CookedTexture::isKTX2(file.fileBytes()))
+    {
+        // Mapped again, so payloads that are already block compressed are
+        // copied from the file straight into staging memory.
+        std::optional<CookedTexture> const ktx2Result{
+            openKTX2Texture(file.path, fileFormat)
+        };
+        if (!ktx2Result.has_value())
+        {
+            SZG_ERROR("Failed to read KTX2 texture.");
+            return std::nullopt;
+        }
+
+        uploadResult = detail::uploadCookedTexture(
+            device,
+            allocator,
+            uploadQueue,
+            uploads.batch,
+            ktx2Result.value(),
+            0
+        );
+    }
+    else
+    {
+        std::optional<DecodedRGBA> const imageResult{
+            decodeRGBA(file.fileBytes())
+        };
+        if (!imageResult.has_value())
+        {
+            SZG_ERROR("Failed to convert file to 32 bit RGBA image.");
+            return std::nullopt;
+        }
+
+        uploadResult = detail::uploadTextureFromRGBA(
+            device,
+            allocator,
+            uploadQueue,
+            uploads.batch,
+            fileFormat,
+            imageResult.value().extent(),
+            imageResult.value().bytes(),
+            0
+        );
+    }
+    if (!uploadResult.has_value())
     {
-        SZG_ERROR("Failed to convert file to 32 bit RGBA image.");
         return std::nullopt;
     }
 
-    return detail::registerTextureFromRGBA(
-        *this,
-        device,
-        allocator,
-        transferQueue,
-        submissionQueue,
-        fileFormat,
-        file.path.stem().string(),
-        imageResult.value(),
-        filePath
-    );
+    // The default color map stands in until the upload completes.
+    std::optional<AssetShared<ImageView>> registerResult{
+        registerAsset<ImageView>(
+            m_defaultColorMap->data,
+            fmt::format("texture_{}", file.path.stem().string()),
+            filePath
+        )
+    };
+    if (registerResult.has_value())
+    {
+        indexContent<ImageView>(contentHash, registerResult.value());
+        trackResidency(
+            registerResult.value(),
+            ImageFileSource{.path = filePath, .format = fileFormat},
+            m_defaultColorMap
+        );
+
+        if (m_fileWatcher.watch(filePath))
+        {
+            m_watchedTextureFiles.push_back(WatchedTextureFile{
+                .path = FileWatcher::normalize(filePath),
+                .texture = registerResult.value(),
+                .format = fileFormat,
+            });
+        }
+    }
+
+    // Queued even without an asset, since the batch refers to the texture
+    // until it is submitted.
+    uploads.textures.push_back(std::make_shared<TextureUploadTask>(
+        TextureUploadTask{
+            .texture = registerResult.value_or(nullptr),
+            .data = std::move(uploadResult).value(),
+            .sourcePath = filePath,
+        }
+    ));
+    queueUpload(uploadQueue, uploads);
+
+    return registerResult;
 }
 
 void AssetLibrary::loadTexturesDialog(
@@ -1191,14 +1680,63 @@ void AssetLibrary::loadTexturesDialog(
 
 void AssetLibrary::loadGLTFFromPath(
     GraphicsContext& graphicsContext,
-    ImmediateSubmissionQueue const& submissionQueue,
+    UploadQueue& uploadQueue,
+    std::filesystem::path const& filePath
+)
+{
+    loadGLTFsFromPaths(
+        graphicsContext,
+        uploadQueue,
+        std::span<std::filesystem::path const>{&filePath, 1}
+    );
+}
+
+void AssetLibrary::loadGLTFsFromPaths(
+    GraphicsContext& graphicsContext,
+    UploadQueue& uploadQueue,
+    std::span<std::filesystem::path const> const filePaths
+)
+{
+    UploadImport uploads{
+        .batched = m_batchUploads,
+        .start = std::chrono::steady_clock::now(),
+    };
+
+    DeduplicationStats const statsBefore{m_deduplicationStats};
+
+    for (std::filesystem::path const& filePath : filePaths)
+    {
+        importGLTF(graphicsContext, uploadQueue, uploads, filePath);
+    }
+
+    SZG_INFO(
+        "Reused {}/{} textures and {}/{} meshes that were already loaded.",
+        m_deduplicationStats.textureHits - statsBefore.textureHits,
+        m_deduplicationStats.textureLookups - statsBefore.textureLookups,
+        m_deduplicationStats.meshHits - statsBefore.meshHits,
+        m_deduplicationStats.meshLookups - statsBefore.meshLookups
+    );
+
+    finishUploads(uploadQueue, std::move(uploads));
+}
+
+void AssetLibrary::importGLTF(
+    GraphicsContext& graphicsContext,
+    UploadQueue& uploadQueue,
+    UploadImport& uploads,
     std::filesystem::path const& filePath
 )
 {
     SZG_INFO("Loading glTF from {}", filePath.string());
 
+    std::filesystem::path const assetRoot{
+        ensureAbsolutePath(filePath).parent_path()
+    };
+
+    // Materials only need the JSON. The buffers are only loaded if the
+    // geometry needs to be cooked.
     fastgltf::Expected<fastgltf::Asset> gltfLoadResult{
-        detail_fastgltf::loadGLTFAsset(filePath)
+        loadGLTFAsset(filePath, false)
     };
     if (gltfLoadResult.error() != fastgltf::Error::None)
     {
@@ -1209,93 +1747,372 @@ void AssetLibrary::loadGLTFFromPath(
         ));
         return;
     }
-    fastgltf::Asset const& gltf{gltfLoadResult.get()};
+    // Shared with the texture decode jobs, which may outlive this call.
+    auto const gltfShared{
+        std::make_shared<fastgltf::Asset const>(std::move(gltfLoadResult.get()))
+    };
+    fastgltf::Asset const& gltf{*gltfShared};
+
+    std::optional<uint64_t> const gltfSignature{fileSignature(filePath)};
+    if (!gltfSignature.has_value())
+    {
+        SZG_ERROR("Failed to read glTF file.");
+        return;
+    }
 
     MaterialData const defaultMaterialData{
-        .ORM = m_defaultORMMap,
-        .normal = m_defaultNormalMap,
-        .color = m_defaultColorMap,
+        .ORM = PooledAssetPtr<ImageView>::from(m_defaultORMMap),
+        .normal = PooledAssetPtr<ImageView>::from(m_defaultNormalMap),
+        .color = PooledAssetPtr<ImageView>::from(m_defaultColorMap),
     };
 
+    std::vector<detail_fastgltf::ScheduledTexture> scheduledTextures{};
+    size_t const decodesQueuedBefore{m_textureDecodes.size()};
     std::vector<MaterialData> const materialDataByGLTFIndex{
-        detail_fastgltf::uploadMaterialDataAsAssets(
+        detail_fastgltf::scheduleMaterialTextures(
             *this,
-            graphicsContext.device(),
-            graphicsContext.allocator(),
-            graphicsContext.universalQueue(),
-            submissionQueue,
+            *m_decodeWorkers,
+            m_textureDecodes,
             defaultMaterialData,
-            gltf,
-            filePath.parent_path()
+            gltfShared,
+            gltfSignature.value(),
+            assetRoot,
+            scheduledTextures
         )
     };
+    SZG_INFO(
+        "Queued {} glTF textures for decoding on {} workers.",
+        m_textureDecodes.size() - decodesQueuedBefore,
+        m_decodeWorkers->workerCount()
+    );
+
+    // The meshes are filled in as they are imported below.
+    auto const reloadSource{std::make_shared<GLTFReloadSource>(GLTFReloadSource{
+        .path = FileWatcher::normalize(filePath),
+        .materialsByGLTFIndex = materialDataByGLTFIndex,
+        .defaultMaterial = defaultMaterialData,
+        .textures = std::move(scheduledTextures),
+    })};
+    for (size_t index{decodesQueuedBefore}; index < m_textureDecodes.size();
+         index++)
+    {
+        m_textureDecodes[index]->source = reloadSource;
+    }
+    GLTFExternalFiles const externalFiles{
+        GLTFExternalFiles::collect(gltf, assetRoot)
+    };
+    watchGLTF(reloadSource, externalFiles.buffers, externalFiles.images);
 
-    std::vector<std::unique_ptr<syzygy::Mesh>> newMeshes{
+    auto const meshesStart{std::chrono::steady_clock::now()};
+
+    std::filesystem::path const cacheDirectory{
+        cookedAssetDirectory("meshes")
+    };
+    // Keyed by content to share the cache with the cooker, but an unchanged
+    // glTF is not read again to hash it.
+    std::optional<uint64_t> sourceHash{hashFile(filePath)};
+    if (sourceHash.has_value())
+    {
+        sourceHash = cookedMeshKey(
+            sourceHash.value(), m_vertexWeldTolerance
+        );
+    }
+
+    if (sourceHash.has_value())
+    {
+        if (std::optional<MeshCacheFile> const cache{MeshCacheFile::open(
+                cacheDirectory, sourceHash.value(), assetRoot
+            )};
+            cache.has_value())
+        {
+            reloadSource->meshesByGLTFIndex = importCookedMeshes(
+                graphicsContext,
+                uploadQueue,
+                uploads,
+                cache.value(),
+                materialDataByGLTFIndex,
+                defaultMaterialData,
+                filePath
+            );
+            size_t const loadedMeshes{static_cast<size_t>(std::count_if(
+                reloadSource->meshesByGLTFIndex.begin(),
+                reloadSource->meshesByGLTFIndex.end(),
+                [](AssetPtr<Mesh> const& mesh) { return !mesh.expired(); }
+            ))};
+
+            SZG_INFO(
+                "Loaded {} meshes from cooked glTF in {:.3f} seconds, "
+                "uploading.",
+                loadedMeshes,
+                std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - meshesStart
+                )
+                    .count()
+            );
+            return;
+        }
+    }
+
+    fastgltf::Expected<fastgltf::Asset> geometryLoadResult{
+        loadGLTFAsset(filePath, true)
+    };
+    if (geometryLoadResult.error() != fastgltf::Error::None)
+    {
+        SZG_ERROR(fmt::format(
+            "Failed to load glTF buffers: {} : {}",
+            fastgltf::getErrorName(geometryLoadResult.error()),
+            fastgltf::getErrorMessage(geometryLoadResult.error())
+        ));
+        return;
+    }
+
+    std::vector<detail_fastgltf::LoadedMesh> newMeshes{
         detail_fastgltf::loadMeshes(
-            graphicsContext.device(),
-            graphicsContext.allocator(),
-            graphicsContext.universalQueue(),
-            submissionQueue,
             materialDataByGLTFIndex,
             defaultMaterialData,
-            gltf
+            m_vertexWeldTolerance,
+            *m_decodeWorkers,
+            geometryLoadResult.get()
         )
     };
 
+    if (std::optional<std::vector<CookedDependency>> const dependencies{
+            collectGLTFBufferDependencies(gltf, assetRoot)
+        };
+        sourceHash.has_value() && dependencies.has_value())
+    {
+        // Failed meshes are kept, without surfaces, to preserve indexing.
+        std::vector<CookedMeshSource> cookedMeshes{};
+        cookedMeshes.reserve(newMeshes.size());
+        for (detail_fastgltf::LoadedMesh const& newMesh : newMeshes)
+        {
+            cookedMeshes.push_back(newMesh.geometry.source());
+        }
+
+        if (MeshCacheFile::cook(
+                cacheDirectory,
+                sourceHash.value(),
+                dependencies.value(),
+                cookedMeshes
+            ))
+        {
+            SZG_INFO("Cooked glTF geometry into {}", cacheDirectory.string());
+        }
+    }
+
     size_t loadedMeshes{0};
+    reloadSource->meshesByGLTFIndex.resize(newMeshes.size());
     for (size_t gltfMeshIndex{0}; gltfMeshIndex < newMeshes.size();
          gltfMeshIndex++)
     {
-        if (newMeshes[gltfMeshIndex] == nullptr)
+        detail_fastgltf::LoadedMesh& newMesh{newMeshes[gltfMeshIndex]};
+        if (newMesh.mesh == nullptr)
         {
             continue;
         }
 
-        if (registerAsset<Mesh>(
-                std::move(newMeshes[gltfMeshIndex]),
-                fmt::format("mesh_{}", gltf.meshes[gltfMeshIndex].name),
-                filePath
-            )
-                .has_value())
+        if (std::optional<AssetShared<Mesh>> const meshResult{importMesh(
+                graphicsContext,
+                uploadQueue,
+                uploads,
+                std::move(newMesh.mesh),
+                newMesh.geometry.name,
+                filePath,
+                newMesh.geometry.indices,
+                newMesh.geometry.vertices
+            )};
+            meshResult.has_value())
         {
+            reloadSource->meshesByGLTFIndex[gltfMeshIndex] = meshResult.value();
             loadedMeshes++;
         }
     }
 
-    SZG_INFO("Loaded {} meshes from glTF", loadedMeshes);
+    SZG_INFO(
+        "Loaded {} meshes from glTF in {:.3f} seconds, uploading.",
+        loadedMeshes,
+        std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - meshesStart
+        )
+            .count()
+    );
 }
 
-void AssetLibrary::loadMeshesDialog(
-    PlatformWindow const& window,
-    GraphicsContext& graphicsContext,
-    ImmediateSubmissionQueue const& submissionQueue
+void AssetLibrary::watchGLTF(
+    std::shared_ptr<GLTFReloadSource> const& source,
+    std::span<std::filesystem::path const> const bufferFiles,
+    std::span<std::filesystem::path const> const imageFiles
 )
 {
-    auto const paths{openFiles(window)};
-    if (paths.empty())
+    source->geometryFiles.push_back(source->path);
+    for (std::filesystem::path const& file : bufferFiles)
     {
-        return;
+        source->geometryFiles.push_back(FileWatcher::normalize(file));
+    }
+    for (std::filesystem::path const& file : imageFiles)
+    {
+        source->imageFiles.push_back(FileWatcher::normalize(file));
     }
 
-    for (auto const& path : paths)
+    for (std::filesystem::path const& file : source->geometryFiles)
+    {
+        m_fileWatcher.watch(file);
+    }
+    for (std::filesystem::path const& file : source->imageFiles)
     {
-        loadGLTFFromPath(graphicsContext, submissionQueue, path);
+        m_fileWatcher.watch(file);
     }
+
+    // Importing the same file again replaces its record, since the newer
+    // assets are the ones that will be found by content.
+    std::erase_if(
+        m_gltfSources,
+        [&](std::shared_ptr<GLTFReloadSource> const& existing)
+    { return existing->path == source->path; }
+    );
+    m_gltfSources.push_back(source);
 }
 
-auto AssetLibrary::loadDefaultAssets(
+auto AssetLibrary::importCookedMeshes(
     GraphicsContext& graphicsContext,
-    ImmediateSubmissionQueue const& submissionQueue
-) -> std::optional<AssetLibrary>
+    UploadQueue& uploadQueue,
+    UploadImport& uploads,
+    MeshCacheFile const& cache,
+    std::span<MaterialData const> const materialsByGLTFIndex,
+    MaterialData const& defaultMaterial,
+    std::filesystem::path const& sourcePath
+) -> std::vector<AssetPtr<Mesh>>
 {
-    std::optional<AssetLibrary> libraryResult{AssetLibrary{}};
-    AssetLibrary& library{libraryResult.value()};
+    std::vector<AssetPtr<Mesh>> meshesByGLTFIndex(cache.meshCount());
+    for (size_t meshIndex{0}; meshIndex < cache.meshCount(); meshIndex++)
+    {
+        CookedMeshView const cookedMesh{cache.mesh(meshIndex)};
+        if (cookedMesh.surfaces.empty())
+        {
+            continue;
+        }
 
-    size_t constexpr DEFAULT_IMAGE_DIMENSIONS{64ULL};
+        // The geometry is copied straight from the mapped file into staging.
+        if (std::optional<AssetShared<Mesh>> const meshResult{importMesh(
+                graphicsContext,
+                uploadQueue,
+                uploads,
+                detail::makeCookedMesh(
+                    cookedMesh.surfaces,
+                    cookedMesh.lodSurfaces,
+                    cookedMesh.lodErrors,
+                    cookedMesh.bounds,
+                    materialsByGLTFIndex,
+                    defaultMaterial
+                ),
+                std::string{cookedMesh.name},
+                sourcePath,
+                cookedMesh.indices,
+                cookedMesh.vertices
+            )};
+            meshResult.has_value())
+        {
+            meshesByGLTFIndex[meshIndex] = meshResult.value();
+        }
+    }
 
-    ImageRGBA defaultImage{
-        .x = DEFAULT_IMAGE_DIMENSIONS,
-        .y = DEFAULT_IMAGE_DIMENSIONS,
+    return meshesByGLTFIndex;
+}
+
+auto AssetLibrary::importMesh(
+    GraphicsContext& graphicsContext,
+    UploadQueue& uploadQueue,
+    UploadImport& uploads,
+    std::unique_ptr<Mesh>&& mesh,
+    std::string const& name,
+    std::filesystem::path const& sourcePath,
+    std::span<uint32_t const> const indices,
+    std::span<VertexPacked const> const vertices
+) -> std::optional<AssetShared<Mesh>>
+{
+    uint64_t const contentHash{
+        detail::hashMeshContent(
+            mesh->surfaces, indices, vertices, m_meshVertexFormat
+        )
+    };
+    if (std::optional<AssetShared<Mesh>> existing{
+            findByContent<Mesh>(contentHash)
+        };
+        existing.has_value())
+    {
+        return existing;
+    }
+
+    std::optional<std::unique_ptr<GPUMeshBuffers>> uploadResult{
+        detail::uploadMeshToGPU(
+            graphicsContext.device(),
+            graphicsContext.allocator(),
+            uploadQueue,
+            uploads.batch,
+            m_meshVertexFormat,
+            mesh->surfaces,
+            mesh->lods,
+            indices,
+            vertices
+        )
+    };
+    if (!uploadResult.has_value())
+    {
+        SZG_WARNING("Failed to upload mesh {}.", name);
+        return std::nullopt;
+    }
+
+    // Registered without buffers, which the renderer skips until the upload
+    // completes and they are installed by processTasks.
+    std::optional<AssetShared<Mesh>> const registerResult{registerAsset<Mesh>(
+        std::move(mesh), fmt::format("mesh_{}", name), sourcePath
+    )};
+    if (registerResult.has_value())
+    {
+        indexContent<Mesh>(contentHash, registerResult.value());
+    }
+
+    // Queued even without an asset, since the batch refers to the buffers
+    // until it is submitted.
+    uploads.meshes.push_back(std::make_shared<MeshUploadTask>(MeshUploadTask{
+        .mesh = registerResult.value_or(nullptr),
+        .data = std::move(uploadResult).value(),
+    }));
+    queueUpload(uploadQueue, uploads);
+
+    return registerResult;
+}
+
+void AssetLibrary::loadMeshesDialog(
+    PlatformWindow const& window,
+    GraphicsContext& graphicsContext,
+    UploadQueue& uploadQueue
+)
+{
+    auto const paths{openFiles(window)};
+    if (paths.empty())
+    {
+        return;
+    }
+
+    loadGLTFsFromPaths(graphicsContext, uploadQueue, paths);
+}
+
+auto AssetLibrary::loadDefaultAssets(
+    GraphicsContext& graphicsContext, UploadQueue& uploadQueue
+) -> std::optional<AssetLibrary>
+{
+    std::optional<AssetLibrary> libraryResult{AssetLibrary{}};
+    AssetLibrary& library{libraryResult.value()};
+
+    library.m_decodeWorkers =
+        std::make_unique<ThreadPool>(ThreadPool::defaultWorkerCount());
+
+    size_t constexpr DEFAULT_IMAGE_DIMENSIONS{64ULL};
+
+    ImageRGBA defaultImage{
+        .x = DEFAULT_IMAGE_DIMENSIONS,
+        .y = DEFAULT_IMAGE_DIMENSIONS,
         .bytes = std::vector<uint8_t>{}
     };
     defaultImage.bytes.resize(
@@ -1319,8 +2136,7 @@ auto AssetLibrary::loadDefaultAssets(
                                       library,
                                       graphicsContext.device(),
                                       graphicsContext.allocator(),
-                                      graphicsContext.universalQueue(),
-                                      submissionQueue,
+                                      uploadQueue,
                                       VK_FORMAT_R8G8B8A8_UNORM,
                                       "NonOccludedDialectric",
                                       defaultImage,
@@ -1358,8 +2174,7 @@ auto AssetLibrary::loadDefaultAssets(
                                         library,
                                         graphicsContext.device(),
                                         graphicsContext.allocator(),
-                                        graphicsContext.universalQueue(),
-                                        submissionQueue,
+                                        uploadQueue,
                                         VK_FORMAT_R8G8B8A8_UNORM,
                                         "defaultColor",
                                         defaultImage,
@@ -1387,8 +2202,7 @@ auto AssetLibrary::loadDefaultAssets(
                                          library,
                                          graphicsContext.device(),
                                          graphicsContext.allocator(),
-                                         graphicsContext.universalQueue(),
-                                         submissionQueue,
+                                         uploadQueue,
                                          VK_FORMAT_R8G8B8A8_UNORM,
                                          "defaultNormal",
                                          defaultImage,
@@ -1436,9 +2250,15 @@ auto AssetLibrary::loadDefaultAssets(
             .indexCount = 6,
             .material =
                 MaterialData{
-                    .ORM = library.m_defaultORMMap,
-                    .normal = library.m_defaultNormalMap,
-                    .color = library.m_defaultColorMap,
+                    .ORM = PooledAssetPtr<ImageView>::from(
+                        library.m_defaultORMMap
+                    ),
+                    .normal = PooledAssetPtr<ImageView>::from(
+                        library.m_defaultNormalMap
+                    ),
+                    .color = PooledAssetPtr<ImageView>::from(
+                        library.m_defaultColorMap
+                    ),
                 }
         }};
 
@@ -1451,17 +2271,36 @@ auto AssetLibrary::loadDefaultAssets(
             vertexMaximum = glm::max(vertex.position, vertexMaximum);
         }
 
-        auto newMesh = std::make_unique<syzygy::Mesh>(syzygy::Mesh{
-            .surfaces = std::move(surfaces),
-            .vertexBounds = syzygy::AABB::create(vertexMinimum, vertexMaximum),
-            .meshBuffers = detail::uploadMeshToGPU(
+        // The one surface covers every vertex.
+        AABB const vertexBounds{AABB::create(vertexMinimum, vertexMaximum)};
+        surfaces.front().bounds = vertexBounds;
+        surfaces.front().boundingSphere = Sphere::circumscribe(vertexBounds);
+
+        UploadBatch batch{};
+        std::optional<std::unique_ptr<GPUMeshBuffers>> uploadResult{
+            detail::uploadMeshToGPU(
                 graphicsContext.device(),
                 graphicsContext.allocator(),
-                graphicsContext.universalQueue(),
-                submissionQueue,
+                uploadQueue,
+                batch,
+                library.m_meshVertexFormat,
+                surfaces,
+                {},
                 indices,
                 vertices
-            ),
+            )
+        };
+        if (!uploadResult.has_value()
+            || !detail::submitAndWait(uploadQueue, std::move(batch)))
+        {
+            SZG_ERROR("Failed to upload default plane mesh.");
+            return std::nullopt;
+        }
+
+        auto newMesh = std::make_unique<syzygy::Mesh>(syzygy::Mesh{
+            .surfaces = std::move(surfaces),
+            .vertexBounds = vertexBounds,
+            .meshBuffers = std::move(uploadResult).value(),
         });
 
         library.m_meshPlane =
@@ -1574,9 +2413,15 @@ auto AssetLibrary::loadDefaultAssets(
             .indexCount = static_cast<uint32_t>(indices.size()),
             .material =
                 MaterialData{
-                    .ORM = library.m_defaultORMMap,
-                    .normal = library.m_defaultNormalMap,
-                    .color = library.m_defaultColorMap,
+                    .ORM = PooledAssetPtr<ImageView>::from(
+                        library.m_defaultORMMap
+                    ),
+                    .normal = PooledAssetPtr<ImageView>::from(
+                        library.m_defaultNormalMap
+                    ),
+                    .color = PooledAssetPtr<ImageView>::from(
+                        library.m_defaultColorMap
+                    ),
                 }
         }};
 
@@ -1589,17 +2434,36 @@ auto AssetLibrary::loadDefaultAssets(
             vertexMaximum = glm::max(vertex.position, vertexMaximum);
         }
 
-        auto newMesh = std::make_unique<syzygy::Mesh>(syzygy::Mesh{
-            .surfaces = std::move(surfaces),
-            .vertexBounds = syzygy::AABB::create(vertexMinimum, vertexMaximum),
-            .meshBuffers = detail::uploadMeshToGPU(
+        // The one surface covers every vertex.
+        AABB const vertexBounds{AABB::create(vertexMinimum, vertexMaximum)};
+        surfaces.front().bounds = vertexBounds;
+        surfaces.front().boundingSphere = Sphere::circumscribe(vertexBounds);
+
+        UploadBatch batch{};
+        std::optional<std::unique_ptr<GPUMeshBuffers>> uploadResult{
+            detail::uploadMeshToGPU(
                 graphicsContext.device(),
                 graphicsContext.allocator(),
-                graphicsContext.universalQueue(),
-                submissionQueue,
+                uploadQueue,
+                batch,
+                library.m_meshVertexFormat,
+                surfaces,
+                {},
                 indices,
                 vertices
-            ),
+            )
+        };
+        if (!uploadResult.has_value()
+            || !detail::submitAndWait(uploadQueue, std::move(batch)))
+        {
+            SZG_ERROR("Failed to upload default cube mesh.");
+            return std::nullopt;
+        }
+
+        auto newMesh = std::make_unique<syzygy::Mesh>(syzygy::Mesh{
+            .surfaces = std::move(surfaces),
+            .vertexBounds = vertexBounds,
+            .meshBuffers = std::move(uploadResult).value(),
         });
 
         library.m_meshCube =
@@ -1610,13 +2474,32 @@ auto AssetLibrary::loadDefaultAssets(
                 .value();
     }
 
+    // Defaults back materials and evicted textures, so they are never
+    // unloaded.
+    for (AssetShared<ImageView> const& texture :
+         {library.m_defaultColorMap,
+          library.m_defaultNormalMap,
+          library.m_defaultORMMap})
+    {
+        library.m_textures->pin(texture->handle);
+    }
+    library.m_meshes->pin(library.m_meshPlane->handle);
+    library.m_meshes->pin(library.m_meshCube->handle);
+
     return libraryResult;
 }
 void AssetLibrary::processTasks(
-    GraphicsContext& graphicsContext,
-    ImmediateSubmissionQueue const& submissionQueue
+    GraphicsContext& graphicsContext, UploadQueue& uploadQueue
 )
 {
+    // As with textures, see TextureResidency::RETIRE_FRAMES.
+    m_frame++;
+    std::erase_if(
+        m_retiredMeshes,
+        [&](RetiredMesh const& retired)
+    { return retired.frame + TextureResidency::RETIRE_FRAMES <= m_frame; }
+    );
+
     for (std::shared_ptr<ImageLoadingTask> const& task : m_tasks)
     {
         if (task->status != TaskStatus::Success)
@@ -1624,6 +2507,11 @@ void AssetLibrary::processTasks(
             continue;
         }
 
+        UploadImport uploads{
+            .batched = m_batchUploads,
+            .start = std::chrono::steady_clock::now(),
+        };
+
         size_t loaded{0};
         for (ImageDiskSource const& source : task->loadees)
         {
@@ -1633,11 +2521,11 @@ void AssetLibrary::processTasks(
             };
 
             // TODO: more usage flags necessary here, such as sampled
-            if (loadTextureFromPath(
+            if (importTexture(
                     graphicsContext.device(),
                     graphicsContext.allocator(),
-                    graphicsContext.universalQueue(),
-                    submissionQueue,
+                    uploadQueue,
+                    uploads,
                     fileFormat,
                     source.path
                 )
@@ -1647,9 +2535,331 @@ void AssetLibrary::processTasks(
             }
         }
 
+        finishUploads(uploadQueue, std::move(uploads));
+
         SZG_INFO("Finished Task: Loaded {} textures.", loaded);
     }
 
+    // Evicts textures when over budget. Evicted textures swap in their
+    // fallback right away, while streams replace their data once uploaded.
+    for (TextureStreamRequest& request :
+         m_textureResidency.update(graphicsContext.allocator()))
+    {
+        m_textureStreams.push_back(std::make_shared<TextureStreamTask>(
+            TextureStreamTask{
+                .texture = std::move(request.texture),
+                .firstLevel = request.firstLevel,
+                .texels = m_decodeWorkers->submit(
+                    [source = std::move(request.source)]()
+        { return TextureStreamTask::read(source); }
+                ),
+            }
+        ));
+    }
+
+    reloadChangedFiles();
+
+    // Everything decoded by now is uploaded together.
+    UploadImport decodedUploads{
+        .batched = m_batchUploads,
+        .start = std::chrono::steady_clock::now(),
+    };
+
+    for (std::shared_ptr<GLTFReloadTask> const& task : m_gltfReloads)
+    {
+        if (task->reload.wait_for(std::chrono::seconds{0})
+            == std::future_status::ready)
+        {
+            finishGLTFReload(
+                graphicsContext, uploadQueue, decodedUploads, *task
+            );
+        }
+    }
+    std::erase_if(
+        m_gltfReloads,
+        [](std::shared_ptr<GLTFReloadTask> const& task)
+    { return task == nullptr || !task->reload.valid(); }
+    );
+
+    size_t texturesDecoded{0};
+    for (std::shared_ptr<TextureDecodeTask> const& task : m_textureDecodes)
+    {
+        if (task->decodeResult.wait_for(std::chrono::seconds{0})
+            != std::future_status::ready)
+        {
+            continue;
+        }
+
+        // Consumes the future, marking this task for removal below.
+        std::optional<
+            std::tuple<CookedTexture, std::filesystem::path, uint64_t>>
+            decodeResult{task->decodeResult.get()};
+        if (!decodeResult.has_value())
+        {
+            SZG_WARNING("Texture decode failed, keeping placeholder data.");
+            if (AssetShared<ImageView> const texture{task->texture.lock()};
+                texture != nullptr)
+            {
+                m_textureResidency.streamFailed(*texture);
+            }
+            continue;
+        }
+
+        AssetShared<ImageView> const texture{task->texture.lock()};
+        if (texture == nullptr)
+        {
+            // The texture was unloaded before its decode finished.
+            continue;
+        }
+
+        uint64_t const key{std::get<2>(decodeResult.value())};
+        if (std::shared_ptr<GLTFReloadSource> const source{
+                task->source.lock()
+            };
+            source != nullptr)
+        {
+            for (detail_fastgltf::ScheduledTexture& scheduled :
+                 source->textures)
+            {
+                if (scheduled.texture.lock() == texture)
+                {
+                    scheduled.contentHash = key;
+                }
+            }
+        }
+
+        // Once cooked, the texture can be streamed back in from the cache.
+        trackResidency(
+            texture,
+            CookedTextureSource{
+                .cacheDirectory = cookedAssetDirectory("textures"),
+                .key = key,
+            },
+            task->fallback.lock()
+        );
+
+        std::optional<std::unique_ptr<ImageView>> uploadResult{
+            detail::uploadCookedTexture(
+                graphicsContext.device(),
+                graphicsContext.allocator(),
+                uploadQueue,
+                decodedUploads.batch,
+                std::get<0>(decodeResult.value()),
+                0
+            )
+        };
+        if (!uploadResult.has_value())
+        {
+            SZG_WARNING("Failed to upload decoded texture, keeping "
+                        "placeholder data.");
+            if (AssetShared<ImageView> const texture{task->texture.lock()};
+                texture != nullptr)
+            {
+                m_textureResidency.streamFailed(*texture);
+            }
+            continue;
+        }
+
+        decodedUploads.textures.push_back(std::make_shared<TextureUploadTask>(
+            TextureUploadTask{
+                .texture = task->texture,
+                .data = std::move(uploadResult).value(),
+                .sourcePath = std::get<1>(decodeResult.value()),
+            }
+        ));
+        queueUpload(uploadQueue, decodedUploads);
+
+        texturesDecoded++;
+    }
+
+    for (std::shared_ptr<TextureStreamTask> const& task : m_textureStreams)
+    {
+        if (task->texels.wait_for(std::chrono::seconds{0})
+            != std::future_status::ready)
+        {
+            continue;
+        }
+
+        // Consumes the future, marking this task for removal below.
+        std::optional<TextureStreamTask::Texels> texels{task->texels.get()};
+        AssetShared<ImageView> const texture{task->texture.lock()};
+        if (texture == nullptr)
+        {
+            continue;
+        }
+
+        std::optional<std::unique_ptr<ImageView>> uploadResult{};
+        if (!texels.has_value())
+        {
+            SZG_WARNING(
+                "Failed to read texture '{}' from its source, it keeps its "
+                "current data.",
+                texture->metadata.displayName
+            );
+        }
+        else if (auto const* const cooked{
+                     std::get_if<CookedTexture>(&texels.value())
+                 };
+                 cooked != nullptr)
+        {
+            uploadResult = detail::uploadCookedTexture(
+                graphicsContext.device(),
+                graphicsContext.allocator(),
+                uploadQueue,
+                decodedUploads.batch,
+                *cooked,
+                task->firstLevel
+            );
+        }
+        else
+        {
+            auto const& file{
+                std::get<TextureStreamTask::DecodedFile>(texels.value())
+            };
+            uploadResult = detail::uploadTextureFromRGBA(
+                graphicsContext.device(),
+                graphicsContext.allocator(),
+                uploadQueue,
+                decodedUploads.batch,
+                file.format,
+                file.image.extent(),
+                file.image.bytes(),
+                task->firstLevel
+            );
+        }
+        if (!uploadResult.has_value())
+        {
+            m_textureResidency.streamFailed(*texture);
+            continue;
+        }
+
+        decodedUploads.textures.push_back(std::make_shared<TextureUploadTask>(
+            TextureUploadTask{
+                .texture = task->texture,
+                .data = std::move(uploadResult).value(),
+                .firstLevel = task->firstLevel,
+            }
+        ));
+        queueUpload(uploadQueue, decodedUploads);
+    }
+    std::erase_if(
+        m_textureStreams,
+        [](std::shared_ptr<TextureStreamTask> const& task)
+    { return task == nullptr || !task->texels.valid(); }
+    );
+
+    finishUploads(uploadQueue, std::move(decodedUploads));
+    std::erase_if(
+        m_textureDecodes,
+        [](std::shared_ptr<TextureDecodeTask> const& task)
+    { return task == nullptr || !task->decodeResult.valid(); }
+    );
+    if (texturesDecoded > 0)
+    {
+        SZG_INFO(
+            "AssetLibrary: Finished decoding {} textures, {} remaining.",
+            texturesDecoded,
+            m_textureDecodes.size()
+        );
+    }
+
+    size_t texturesUploaded{0};
+    for (std::shared_ptr<TextureUploadTask> const& task : m_textureUploads)
+    {
+        if (!uploadQueue.isComplete(task->ticket))
+        {
+            continue;
+        }
+
+        AssetShared<ImageView> const texture{task->texture.lock()};
+        Asset<ImageView>* const textureAsset{
+            texture != nullptr ? m_textures->get(texture->handle) : nullptr
+        };
+        if (textureAsset != nullptr)
+        {
+            Asset<ImageView>& asset{*textureAsset};
+            // Frames in flight may still sample the replaced data.
+            m_textureResidency.retire(std::move(asset.data));
+            asset.data = std::move(task->data);
+            m_textureResidency.installed(asset, task->firstLevel);
+            if (task->sourcePath.has_value())
+            {
+                asset.metadata.fileLocalPath =
+                    task->sourcePath.value().string();
+            }
+            texturesUploaded++;
+        }
+
+        task->data.reset();
+    }
+    size_t meshesUploaded{0};
+    for (std::shared_ptr<MeshUploadTask> const& task : m_meshUploads)
+    {
+        if (!uploadQueue.isComplete(task->ticket))
+        {
+            continue;
+        }
+
+        AssetShared<Mesh> const mesh{task->mesh.lock()};
+        if (task->replacement != nullptr)
+        {
+            Asset<Mesh>* const meshAsset{
+                mesh != nullptr ? m_meshes->get(mesh->handle) : nullptr
+            };
+            if (meshAsset != nullptr)
+            {
+                Asset<Mesh>& asset{*meshAsset};
+                task->replacement->meshBuffers = std::move(task->data);
+                // Frames in flight may still draw the replaced mesh.
+                m_retiredMeshes.push_back(RetiredMesh{
+                    .data = std::move(asset.data),
+                    .frame = m_frame,
+                });
+                asset.data = std::move(task->replacement);
+                meshesUploaded++;
+            }
+        }
+        else if (mesh != nullptr && mesh->data != nullptr)
+        {
+            mesh->data->meshBuffers = std::move(task->data);
+            meshesUploaded++;
+        }
+
+        task->data.reset();
+        task->replacement.reset();
+    }
+    // Completed tasks have had their data consumed or dropped above.
+    std::erase_if(
+        m_textureUploads,
+        [](std::shared_ptr<TextureUploadTask> const& task)
+    { return task == nullptr || task->data == nullptr; }
+    );
+    std::erase_if(
+        m_meshUploads,
+        [](std::shared_ptr<MeshUploadTask> const& task)
+    { return task == nullptr || task->data == nullptr; }
+    );
+    if (texturesUploaded > 0 || meshesUploaded > 0)
+    {
+        SZG_INFO(
+            "AssetLibrary: Finished uploading {} textures and {} meshes.",
+            texturesUploaded,
+            meshesUploaded
+        );
+    }
+
+    for (std::shared_ptr<UploadImport>& uploads : m_uploadImports)
+    {
+        if (!uploadQueue.isComplete(uploads->lastTicket.value()))
+        {
+            continue;
+        }
+
+        recordUploadTimings(*uploads);
+        uploads.reset();
+    }
+    std::erase(m_uploadImports, nullptr);
+
     size_t const taskCount{m_tasks.size()};
     m_tasks.erase(
         std::remove_if(
@@ -1665,6 +2875,549 @@ void AssetLibrary::processTasks(
         SZG_INFO("AssetLibrary: Culled {} tasks.", taskCount - m_tasks.size());
     }
 }
+void AssetLibrary::reloadChangedFiles()
+{
+    // Drained even while disabled, so that old changes are not reloaded once
+    // it is enabled.
+    std::vector<std::filesystem::path> const changedFiles{m_fileWatcher.poll()
+    };
+    if (!m_hotReload)
+    {
+        return;
+    }
+
+    std::erase_if(
+        m_watchedTextureFiles,
+        [](WatchedTextureFile const& watched)
+    { return watched.texture.expired(); }
+    );
+
+    for (std::filesystem::path const& file : changedFiles)
+    {
+        SZG_INFO("AssetLibrary: {} changed on disk.", file.string());
+
+        // Read on the workers as a stream, which replaces the texture's data
+        // once uploaded.
+        for (WatchedTextureFile const& watched : m_watchedTextureFiles)
+        {
+            AssetShared<ImageView> const texture{watched.texture.lock()};
+            if (watched.path != file || texture == nullptr)
+            {
+                continue;
+            }
+
+            reindexContent<ImageView>(texture, std::nullopt);
+            m_textureStreams.push_back(std::make_shared<TextureStreamTask>(
+                TextureStreamTask{
+                    .texture = watched.texture,
+                    .firstLevel = 0,
+                    .texels = m_decodeWorkers->submit(
+                        [source = TextureStreamSource{ImageFileSource{
+                             .path = watched.path,
+                             .format = watched.format,
+                         }}]() { return TextureStreamTask::read(source); }
+                    ),
+                }
+            ));
+        }
+
+        for (std::shared_ptr<GLTFReloadSource> const& source : m_gltfSources)
+        {
+            bool const geometry{
+                std::find(
+                    source->geometryFiles.begin(),
+                    source->geometryFiles.end(),
+                    file
+                )
+                != source->geometryFiles.end()
+            };
+            bool const image{
+                std::find(
+                    source->imageFiles.begin(), source->imageFiles.end(), file
+                )
+                != source->imageFiles.end()
+            };
+
+            source->changed = source->changed || geometry || image;
+            source->geometryChanged = source->geometryChanged || geometry;
+        }
+    }
+
+    for (std::shared_ptr<GLTFReloadSource> const& source : m_gltfSources)
+    {
+        if (!source->changed || source->reloading)
+        {
+            continue;
+        }
+
+        // The worker gets copies, since the source is updated on this thread.
+        m_gltfReloads.push_back(std::make_shared<GLTFReloadTask>(GLTFReloadTask{
+            .source = source,
+            .reload = m_decodeWorkers->submit(
+                [path = source->path,
+                 geometry = source->geometryChanged,
+                 textures = source->textures,
+                 materials = source->materialsByGLTFIndex,
+                 defaultMaterial = source->defaultMaterial,
+                 weldTolerance = m_vertexWeldTolerance,
+                 vertexFormat = m_meshVertexFormat,
+                 workers = m_decodeWorkers.get()]()
+        {
+            return detail_fastgltf::reloadGLTF(
+                path,
+                geometry,
+                textures,
+                materials,
+                defaultMaterial,
+                weldTolerance,
+                vertexFormat,
+                *workers
+            );
+        }
+            ),
+        }));
+
+        source->changed = false;
+        source->geometryChanged = false;
+        source->reloading = true;
+    }
+}
+
+void AssetLibrary::finishGLTFReload(
+    GraphicsContext& graphicsContext,
+    UploadQueue& uploadQueue,
+    UploadImport& uploads,
+    GLTFReloadTask& task
+)
+{
+    GLTFReloadSource& source{*task.source};
+    source.reloading = false;
+
+    // Consumes the future, marking this task for removal.
+    std::optional<detail_fastgltf::GLTFReload> reloadResult{task.reload.get()};
+    if (!reloadResult.has_value())
+    {
+        return;
+    }
+    detail_fastgltf::GLTFReload& reload{reloadResult.value()};
+
+    std::filesystem::path const assetRoot{source.path.parent_path()};
+
+    // Several materials can share a texture, which is only cooked once.
+    std::vector<Asset<ImageView> const*> texturesChanged{};
+    for (size_t index{0};
+         index < source.textures.size() && index < reload.textureKeys.size();
+         index++)
+    {
+        detail_fastgltf::ScheduledTexture& scheduled{source.textures[index]};
+        std::optional<uint64_t> const key{reload.textureKeys[index]};
+        std::optional<uint64_t> const signature{
+            reload.textureSignatures[index]
+        };
+        AssetShared<ImageView> const texture{scheduled.texture.lock()};
+        if (texture == nullptr)
+        {
+            continue;
+        }
+
+        // Touching a file changes its signature without changing the key.
+        if (signature.has_value() && signature.value() != scheduled.signature)
+        {
+            scheduled.signature = signature.value();
+            reindexContent<ImageView>(texture, signature.value());
+        }
+
+        if (!key.has_value() || key == scheduled.contentHash)
+        {
+            continue;
+        }
+        scheduled.contentHash = key.value();
+
+        if (std::find(
+                texturesChanged.begin(), texturesChanged.end(), texture.get()
+            )
+            != texturesChanged.end())
+        {
+            continue;
+        }
+        texturesChanged.push_back(texture.get());
+
+        // The current data is kept until the new data is uploaded, as with
+        // the placeholder on import.
+        m_textureDecodes.push_back(std::make_shared<TextureDecodeTask>(
+            TextureDecodeTask{
+                .texture = scheduled.texture,
+                .fallback = scheduled.fallback,
+                .source = task.source,
+                .decodeResult = detail_fastgltf::submitTextureCook(
+                    *m_decodeWorkers,
+                    reload.gltf,
+                    reload.gltf->textures[scheduled.textureIndex]
+                        .imageIndex.value(),
+                    scheduled.overrides,
+                    assetRoot,
+                    scheduled.encoding,
+                    key.value()
+                ),
+            }
+        ));
+    }
+
+    size_t meshesChanged{0};
+    for (size_t index{0}; index < reload.meshes.size()
+                          && index < source.meshesByGLTFIndex.size();
+         index++)
+    {
+        detail_fastgltf::LoadedMesh& loadedMesh{reload.meshes[index]};
+        AssetShared<Mesh> const mesh{source.meshesByGLTFIndex[index].lock()};
+        if (loadedMesh.mesh == nullptr || mesh == nullptr)
+        {
+            continue;
+        }
+
+        uint64_t const contentHash{reload.meshHashes[index]};
+        if (auto const indexed{m_meshesByContent.find(contentHash)};
+            indexed != m_meshesByContent.end()
+            && indexed->second.lock() == mesh)
+        {
+            continue;
+        }
+
+        std::optional<std::unique_ptr<GPUMeshBuffers>> uploadResult{
+            detail::uploadMeshToGPU(
+                graphicsContext.device(),
+                graphicsContext.allocator(),
+                uploadQueue,
+                uploads.batch,
+                m_meshVertexFormat,
+                loadedMesh.mesh->surfaces,
+                loadedMesh.mesh->lods,
+                loadedMesh.geometry.indices,
+                loadedMesh.geometry.vertices
+            )
+        };
+        if (!uploadResult.has_value())
+        {
+            SZG_WARNING(
+                "Failed to upload reloaded mesh {}, it keeps its current data.",
+                mesh->metadata.displayName
+            );
+            continue;
+        }
+        reindexContent<Mesh>(mesh, contentHash);
+
+        uploads.meshes.push_back(std::make_shared<MeshUploadTask>(
+            MeshUploadTask{
+                .mesh = mesh,
+                .data = std::move(uploadResult).value(),
+                .replacement = std::move(loadedMesh.mesh),
+            }
+        ));
+        queueUpload(uploadQueue, uploads);
+        meshesChanged++;
+    }
+
+    SZG_INFO(
+        "AssetLibrary: Reloading {} textures and {} meshes that changed in {}",
+        texturesChanged.size(),
+        meshesChanged,
+        source.path.string()
+    );
+}
+
+void AssetLibrary::setHotReload(bool const enabled) { m_hotReload = enabled; }
+
+auto AssetLibrary::hotReload() const -> bool { return m_hotReload; }
+
+void AssetLibrary::setBatchUploads(bool const batched)
+{
+    m_batchUploads = batched;
+}
+
+auto AssetLibrary::batchUploads() const -> bool { return m_batchUploads; }
+
+void AssetLibrary::setMeshVertexFormat(VertexFormat const format)
+{
+    m_meshVertexFormat = format;
+}
+
+auto AssetLibrary::meshVertexFormat() const -> VertexFormat
+{
+    return m_meshVertexFormat;
+}
+
+void AssetLibrary::setVertexWeldTolerance(VertexWeldTolerance const tolerance)
+{
+    m_vertexWeldTolerance = tolerance;
+}
+
+auto AssetLibrary::vertexWeldTolerance() const -> VertexWeldTolerance
+{
+    return m_vertexWeldTolerance;
+}
+
+auto AssetLibrary::deduplicationStats() const -> DeduplicationStats const&
+{
+    return m_deduplicationStats;
+}
+
+auto AssetLibrary::uploadTimings(bool const batched) const
+    -> UploadTimings const&
+{
+    return batched ? m_batchedUploadTimings : m_perAssetUploadTimings;
+}
+
+void AssetLibrary::queueUpload(
+    UploadQueue& uploadQueue, UploadImport& uploads
+)
+{
+    uploads.assets++;
+
+    if (!uploads.batched)
+    {
+        flushUploads(uploadQueue, uploads);
+    }
+}
+
+void AssetLibrary::flushUploads(
+    UploadQueue& uploadQueue, UploadImport& uploads
+)
+{
+    if (uploads.batch.empty())
+    {
+        return;
+    }
+
+    std::optional<UploadTicket> const ticket{
+        uploadQueue.submit(std::exchange(uploads.batch, UploadBatch{}))
+    };
+    uploads.submissions++;
+
+    if (!ticket.has_value())
+    {
+        SZG_WARNING(
+            "AssetLibrary: Failed to submit uploads for {} textures and {} "
+            "meshes, they will keep placeholder data.",
+            uploads.textures.size(),
+            uploads.meshes.size()
+        );
+        uploads.textures.clear();
+        uploads.meshes.clear();
+        return;
+    }
+
+    for (std::shared_ptr<TextureUploadTask>& task : uploads.textures)
+    {
+        task->ticket = ticket.value();
+        m_textureUploads.push_back(std::move(task));
+    }
+    uploads.textures.clear();
+
+    for (std::shared_ptr<MeshUploadTask>& task : uploads.meshes)
+    {
+        task->ticket = ticket.value();
+        m_meshUploads.push_back(std::move(task));
+    }
+    uploads.meshes.clear();
+
+    uploads.lastTicket = ticket;
+}
+
+void AssetLibrary::finishUploads(
+    UploadQueue& uploadQueue, UploadImport&& uploads
+)
+{
+    flushUploads(uploadQueue, uploads);
+
+    if (!uploads.lastTicket.has_value())
+    {
+        return;
+    }
+
+    uploads.recordSeconds =
+        std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - uploads.start
+        )
+            .count();
+
+    m_uploadImports.push_back(
+        std::make_shared<UploadImport>(std::move(uploads))
+    );
+}
+
+void AssetLibrary::recordUploadTimings(UploadImport const& uploads)
+{
+    // Completion is only observed once per frame, so this is an upper bound.
+    double const completionSeconds{
+        std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - uploads.start
+        )
+            .count()
+    };
+
+    UploadTimings& timings{
+        uploads.batched ? m_batchedUploadTimings : m_perAssetUploadTimings
+    };
+    timings.imports++;
+    timings.assets += uploads.assets;
+    timings.submissions += uploads.submissions;
+    timings.recordSeconds += uploads.recordSeconds;
+    timings.completionSeconds += completionSeconds;
+
+    double constexpr MILLISECONDS_PER_SECOND{1000.0};
+    SZG_INFO(
+        "AssetLibrary: {} upload of {} assets in {} submissions. Recorded in "
+        "{:.2f} ms, completed in {:.2f} ms.",
+        uploads.batched ? "Batched" : "Per-asset",
+        uploads.assets,
+        uploads.submissions,
+        uploads.recordSeconds * MILLISECONDS_PER_SECOND,
+        completionSeconds * MILLISECONDS_PER_SECOND
+    );
+
+    if (m_batchedUploadTimings.assets == 0
+        || m_perAssetUploadTimings.assets == 0)
+    {
+        return;
+    }
+
+    SZG_INFO(
+        "AssetLibrary: Batched uploads are {:.2f}x faster to record and "
+        "{:.2f}x faster to complete per asset, than per-asset uploads.",
+        m_perAssetUploadTimings.recordSecondsPerAsset()
+            / m_batchedUploadTimings.recordSecondsPerAsset(),
+        m_perAssetUploadTimings.completionSecondsPerAsset()
+            / m_batchedUploadTimings.completionSecondsPerAsset()
+    );
+}
+
+void AssetLibrary::unloadUnused(std::span<MeshInstanced const> const geometry)
+{
+    std::unordered_set<uint32_t> usedMeshes{};
+    for (MeshInstanced const& instance : geometry)
+    {
+        if (std::optional<AssetRef<Mesh>> const mesh{instance.getMesh()};
+            mesh.has_value())
+        {
+            usedMeshes.insert(mesh.value().get().handle.value);
+        }
+    }
+
+    size_t meshesUnloaded{0};
+    for (AssetHandle<Mesh> const handle : m_meshes->handles())
+    {
+        if (usedMeshes.contains(handle.value))
+        {
+            continue;
+        }
+
+        // Kept alive until the content index is updated below.
+        AssetShared<Mesh> const mesh{m_meshes->shared(handle)};
+        std::optional<std::shared_ptr<Mesh>> data{m_meshes->release(handle)};
+        if (!data.has_value())
+        {
+            continue;
+        }
+
+        reindexContent<Mesh>(mesh, std::nullopt);
+        // Frames in flight may still draw the mesh.
+        m_retiredMeshes.push_back(RetiredMesh{
+            .data = std::move(data).value(),
+            .frame = m_frame,
+        });
+        meshesUnloaded++;
+    }
+
+    // Textures are used by the materials of the remaining meshes, which
+    // instances may override. Levels of detail share their mesh's materials.
+    std::unordered_set<uint32_t> usedTextures{};
+    auto const markUsed{[&](MaterialData const& material)
+    {
+        for (PooledAssetPtr<ImageView> const& texture :
+             {material.color, material.normal, material.ORM})
+        {
+            if (texture.pool == m_textures.get() && texture.get() != nullptr)
+            {
+                usedTextures.insert(texture.handle.value);
+            }
+        }
+    }};
+    for (AssetHandle<Mesh> const handle : m_meshes->handles())
+    {
+        Asset<Mesh> const* const mesh{m_meshes->get(handle)};
+        if (mesh == nullptr || mesh->data == nullptr)
+        {
+            continue;
+        }
+        for (GeometrySurface const& surface : mesh->data->surfaces)
+        {
+            markUsed(surface.material);
+        }
+    }
+    for (MeshInstanced const& instance : geometry)
+    {
+        for (MaterialData const& material : instance.getMaterialOverrides())
+        {
+            markUsed(material);
+        }
+    }
+
+    size_t texturesUnloaded{0};
+    for (AssetHandle<ImageView> const handle : m_textures->handles())
+    {
+        if (usedTextures.contains(handle.value))
+        {
+            continue;
+        }
+
+        AssetShared<ImageView> const texture{m_textures->shared(handle)};
+        std::optional<std::shared_ptr<ImageView>> data{
+            m_textures->release(handle)
+        };
+        if (!data.has_value())
+        {
+            continue;
+        }
+
+        // Untracked before the slot, and so the address, can be reused.
+        m_textureResidency.untrack(*texture);
+        reindexContent<ImageView>(texture, std::nullopt);
+        m_textureResidency.retire(std::move(data).value());
+        texturesUnloaded++;
+    }
+
+    // Nothing is left to reload from sources whose assets are all unloaded.
+    std::erase_if(
+        m_watchedTextureFiles,
+        [](WatchedTextureFile const& watched)
+    { return watched.texture.expired(); }
+    );
+    std::erase_if(
+        m_gltfSources,
+        [](std::shared_ptr<GLTFReloadSource> const& source)
+    {
+        return std::all_of(
+                   source->meshesByGLTFIndex.begin(),
+                   source->meshesByGLTFIndex.end(),
+                   [](AssetPtr<Mesh> const& mesh) { return mesh.expired(); }
+               )
+            && std::all_of(
+                   source->textures.begin(),
+                   source->textures.end(),
+                   [](detail_fastgltf::ScheduledTexture const& scheduled)
+        { return scheduled.texture.expired(); }
+            );
+    }
+    );
+
+    SZG_INFO(
+        "AssetLibrary: Unloaded {} meshes and {} textures, whose device memory "
+        "is released once no frame in flight uses it.",
+        meshesUnloaded,
+        texturesUnloaded
+    );
+}
+
 auto AssetLibrary::defaultMesh(DefaultMeshAssets const asset) -> AssetPtr<Mesh>
 {
     switch (asset)
@@ -1,15 +1,24 @@
 #pragma once
 
+#include "syzygy/assets/assetpool.hpp"
 #include "syzygy/assets/assetstypes.hpp"
+#include "syzygy/assets/textureresidency.hpp"
+#include "syzygy/assets/vertexwelding.hpp"
+#include "syzygy/core/threadpool.hpp"
 #include "syzygy/core/uuid.hpp"
 #include "syzygy/geometry/geometrytypes.hpp"
+#include "syzygy/platform/filesystemutils.hpp"
+#include "syzygy/platform/filewatcher.hpp"
 #include "syzygy/platform/integer.hpp"
 #include "syzygy/platform/vulkanusage.hpp"
 #include "syzygy/renderer/buffers.hpp"
 #include "syzygy/renderer/material.hpp"
+#include "syzygy/renderer/vertexencoding.hpp"
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -19,9 +28,20 @@ namespace syzygy
 struct PlatformWindow;
 struct UILayer;
 struct GraphicsContext;
-struct ImmediateSubmissionQueue;
+struct UploadQueue;
+struct UploadBatch;
+struct UploadImport;
 struct ImageView;
 struct ImageLoadingTask;
+struct TextureDecodeTask;
+struct TextureUploadTask;
+struct TextureStreamTask;
+struct MeshUploadTask;
+struct GLTFReloadSource;
+struct GLTFReloadTask;
+struct MeshCacheFile;
+struct MeshInstanced;
+struct VertexPacked;
 } // namespace syzygy
 
 namespace syzygy
@@ -32,19 +52,50 @@ struct GeometrySurface
     uint32_t firstIndex;
     uint32_t indexCount;
     MaterialData material{};
+    // The meshlets that cover the indices, in the mesh's meshlet buffer. These
+    // are filled in when the mesh is uploaded.
+    uint32_t firstMeshlet{0};
+    uint32_t meshletCount{0};
+    // Of the vertices that the indices reference, in mesh space, so that
+    // surfaces can be culled individually.
+    AABB bounds{};
+    Sphere boundingSphere{};
+};
+
+// A simplified version of a mesh, drawn from the same vertex and index buffers.
+struct MeshLod
+{
+    // Parallel to the mesh's surfaces, with the same materials.
+    std::vector<GeometrySurface> surfaces{};
+    // Roughly how far the surfaces deviate from the mesh's, in model space.
+    float error{0.0F};
 };
 
 struct Mesh
 {
     std::vector<GeometrySurface> surfaces{};
+    // Ordered from finest to coarsest, not including the mesh itself.
+    std::vector<MeshLod> lods{};
     AABB vertexBounds{};
     std::unique_ptr<syzygy::GPUMeshBuffers> meshBuffers{};
 };
 
+// The surfaces of a level of detail, where 0 is the mesh itself. Levels past
+// the coarsest are clamped to it.
+auto lodSurfaces(Mesh const& mesh, size_t level)
+    -> std::span<GeometrySurface const>;
+
+// The file's bytes are read in place from a read-only mapping, rather than
+// copied into memory.
 struct AssetFile
 {
     std::filesystem::path path{};
-    std::vector<uint8_t> fileBytes{};
+    MappedFile mapping;
+
+    [[nodiscard]] auto fileBytes() const -> std::span<uint8_t const>
+    {
+        return mapping.bytes();
+    }
 };
 
 auto loadAssetFile(std::filesystem::path const& path)
@@ -61,29 +112,31 @@ auto assetPtrToRef(AssetPtr<T> const& asset) -> std::optional<AssetRef<T>>
     return *asset.lock();
 }
 
+template <typename T>
+auto assetPtrToRef(PooledAssetPtr<T> const& asset)
+    -> std::optional<AssetRef<T>>
+{
+    Asset<T> const* const resolved{asset.get()};
+    if (resolved == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    return *resolved;
+}
+
 struct AssetLibrary
 {
 public:
     template <typename T>
     [[nodiscard]] auto fetchAssets() -> std::vector<AssetPtr<T>>
     {
-        std::vector<AssetPtr<T>> assets{};
+        AssetPool<T> const& assetPool{pool<T>()};
 
-        if constexpr (std::is_same_v<T, ImageView>)
-        {
-            assets.reserve(m_textures.size());
-            for (auto& texture : m_textures)
-            {
-                assets.emplace_back(texture);
-            }
-        }
-        else if constexpr (std::is_same_v<T, Mesh>)
+        std::vector<AssetPtr<T>> assets{};
+        for (AssetHandle<T> const handle : assetPool.handles())
         {
-            assets.reserve(m_meshes.size());
-            for (auto& texture : m_meshes)
-            {
-                assets.emplace_back(texture);
-            }
+            assets.emplace_back(assetPool.shared(handle));
         }
 
         return assets;
@@ -92,37 +145,31 @@ public:
     template <typename T>
     [[nodiscard]] auto fetchAssetRefs() -> std::vector<AssetRef<T>>
     {
-        std::vector<AssetRef<T>> assets{};
+        AssetPool<T> const& assetPool{pool<T>()};
 
-        if constexpr (std::is_same_v<T, ImageView>)
-        {
-            assets.reserve(m_textures.size());
-            for (auto& texture : m_textures)
-            {
-                if (texture == nullptr)
-                {
-                    continue;
-                }
-                assets.emplace_back(*texture);
-            }
-        }
-        else if constexpr (std::is_same_v<T, Mesh>)
+        std::vector<AssetRef<T>> assets{};
+        for (AssetHandle<T> const handle : assetPool.handles())
         {
-            assets.reserve(m_meshes.size());
-            for (auto& mesh : m_meshes)
+            if (Asset<T> const* const asset{assetPool.get(handle)};
+                asset != nullptr)
             {
-                if (mesh == nullptr)
-                {
-                    continue;
-                }
-                assets.emplace_back(*mesh);
+                assets.emplace_back(*asset);
             }
         }
 
         return assets;
     }
 
-    // WARNING! This may invalidate existing references/pointers to assets
+    // Where the library's assets of a type are stored. Scene geometry looks
+    // its meshes up here each frame, by handle.
+    template <typename T>
+    [[nodiscard]] auto pool() const -> AssetPool<T> const&
+    {
+        return mutablePool<T>();
+    }
+
+    // Safe to call from several threads. Registering never invalidates
+    // references to other assets, see AssetPool.
     template <typename T>
     auto registerAsset(
         std::shared_ptr<T> data,
@@ -130,10 +177,16 @@ public:
         std::optional<std::filesystem::path> const& sourcePath
     ) -> std::optional<AssetShared<T>>
     {
+        std::string displayName{};
+        {
+            std::lock_guard<std::mutex> const lock{*m_registrationMutex};
+            displayName = deduplicateAssetName(name);
+        }
+
         Asset<T> asset{
             .metadata =
                 AssetMetadata{
-                    .displayName = deduplicateAssetName(name),
+                    .displayName = std::move(displayName),
                     .id = UUID::createNew(),
                 },
             .data = std::move(data),
@@ -148,64 +201,201 @@ public:
             asset.metadata.fileLocalPath = "No source on disk.";
         }
 
+        // Fails only once every slot of the pool is in use.
+        AssetPool<T>& assetPool{mutablePool<T>()};
+        AssetHandle<T> const handle{assetPool.add(std::move(asset))};
+        if (!assetPool.valid(handle))
+        {
+            return std::nullopt;
+        }
+
+        return assetPool.shared(handle);
+    }
+
+    // Assets can be indexed by a hash of the content they were created from,
+    // such as ContentHash of their source bytes, so that identical content
+    // resolves to one asset with one copy on the device. Returns the asset
+    // indexed under the hash, if any. Every call counts towards the
+    // deduplication statistics.
+    template <typename T>
+    auto findByContent(uint64_t const contentHash)
+        -> std::optional<AssetShared<T>>
+    {
+        auto const find{[&](auto& index, size_t& lookups, size_t& hits)
+                            -> std::optional<AssetShared<T>>
+        {
+            lookups++;
+
+            auto const iterator{index.find(contentHash)};
+            if (iterator == index.end())
+            {
+                return std::nullopt;
+            }
+
+            AssetShared<T> asset{iterator->second.lock()};
+            if (asset == nullptr)
+            {
+                index.erase(iterator);
+                return std::nullopt;
+            }
+
+            hits++;
+            return asset;
+        }};
+
         if constexpr (std::is_same_v<T, ImageView>)
         {
-            m_textures.push_back(std::make_shared<Asset<T>>(std::move(asset)));
-            return m_textures.back();
+            return find(
+                m_texturesByContent,
+                m_deduplicationStats.textureLookups,
+                m_deduplicationStats.textureHits
+            );
         }
         else if constexpr (std::is_same_v<T, Mesh>)
         {
-            m_meshes.push_back(std::make_shared<Asset<T>>(std::move(asset)));
-            return m_meshes.back();
+            return find(
+                m_meshesByContent,
+                m_deduplicationStats.meshLookups,
+                m_deduplicationStats.meshHits
+            );
         }
 
         return std::nullopt;
     }
 
-    template <typename T> [[nodiscard]] auto empty() -> bool
+    template <typename T>
+    void indexContent(uint64_t const contentHash, AssetShared<T> const& asset)
     {
         if constexpr (std::is_same_v<T, ImageView>)
         {
-            return m_textures.empty();
+            m_texturesByContent.insert_or_assign(contentHash, asset);
         }
         else if constexpr (std::is_same_v<T, Mesh>)
         {
-            return m_meshes.empty();
+            m_meshesByContent.insert_or_assign(contentHash, asset);
         }
+    }
+
+    struct DeduplicationStats
+    {
+        size_t textureLookups{0};
+        size_t textureHits{0};
+        size_t meshLookups{0};
+        size_t meshHits{0};
+    };
 
-        return true;
+    [[nodiscard]] auto deduplicationStats() const
+        -> DeduplicationStats const&;
+
+    template <typename T> [[nodiscard]] auto empty() -> bool
+    {
+        return pool<T>().size() == 0;
     }
 
+    // The texture is evicted to the fallback's data when the device runs low on
+    // memory, and streamed back in from its source when it is used again.
+    void trackResidency(
+        AssetShared<ImageView> const& texture,
+        TextureStreamSource source,
+        AssetShared<ImageView> const& fallback
+    );
+
+    // Materials mark the textures they use with this each frame.
+    auto textureResidency() -> TextureResidency&;
+
+    // The texture initially shares the default color map's data, until its
+    // upload completes in processTasks.
     auto loadTextureFromPath(
         VkDevice,
         VmaAllocator,
-        VkQueue,
-        ImmediateSubmissionQueue const&,
+        UploadQueue&,
         VkFormat fileFormat,
         std::filesystem::path const& filePath
     ) -> std::optional<AssetShared<ImageView>>;
 
     void loadTexturesDialog(PlatformWindow const&, UILayer&);
 
+    // Meshes are registered with null meshBuffers, which are filled in once
+    // their uploads complete in processTasks.
     void loadGLTFFromPath(
+        GraphicsContext&, UploadQueue&, std::filesystem::path const& filePath
+    );
+
+    // Uploads from every file are submitted together, see setBatchUploads.
+    void loadGLTFsFromPaths(
         GraphicsContext&,
-        ImmediateSubmissionQueue const&,
-        std::filesystem::path const& filePath
+        UploadQueue&,
+        std::span<std::filesystem::path const> filePaths
     );
 
     void loadMeshesDialog(
-        PlatformWindow const&,
-        GraphicsContext&,
-        ImmediateSubmissionQueue const& submissionQueue
+        PlatformWindow const&, GraphicsContext&, UploadQueue& uploadQueue
     );
 
-    static auto loadDefaultAssets(
-        GraphicsContext&, ImmediateSubmissionQueue const& submissionQueue
-    ) -> std::optional<AssetLibrary>;
+    // Waits for the uploads of default assets, so they are immediately usable.
+    static auto loadDefaultAssets(GraphicsContext&, UploadQueue& uploadQueue)
+        -> std::optional<AssetLibrary>;
+
+    void processTasks(GraphicsContext&, UploadQueue& uploadQueue);
+
+    // Releases the meshes that no instance uses, then the textures that no
+    // remaining mesh's materials or instance's overrides use. Default assets
+    // are pinned, and never released. Handles to released assets become
+    // invalid, and their data is destroyed once no frame in flight can be
+    // using it, see TextureResidency::RETIRE_FRAMES.
+    void unloadUnused(std::span<MeshInstanced const> geometry);
+
+    // When enabled, the files that assets were imported from are watched, and
+    // assets are updated in place when their files change, with their old
+    // data kept until the new data is uploaded. Only the textures whose images
+    // changed are cooked again, and only the meshes whose geometry changed
+    // are uploaded again. Meshes and materials that an edit adds to a glTF
+    // need it to be imported again.
+    void setHotReload(bool enabled);
+    [[nodiscard]] auto hotReload() const -> bool;
+
+    // When enabled, all uploads of an import are recorded into one command
+    // buffer and submitted once. Otherwise, each asset is submitted on its
+    // own. Both are timed, for comparison.
+    void setBatchUploads(bool batched);
+    [[nodiscard]] auto batchUploads() const -> bool;
+
+    // The layout vertices are uploaded in, for meshes imported from now on.
+    // Meshes already on the device keep theirs.
+    void setMeshVertexFormat(VertexFormat);
+    [[nodiscard]] auto meshVertexFormat() const -> VertexFormat;
+
+    // How glTF vertices are welded, for meshes imported from now on. Cooked
+    // meshes are keyed by it, so changing it cooks them again.
+    void setVertexWeldTolerance(VertexWeldTolerance);
+    [[nodiscard]] auto vertexWeldTolerance() const -> VertexWeldTolerance;
+
+    struct UploadTimings
+    {
+        size_t imports{0};
+        size_t assets{0};
+        size_t submissions{0};
 
-    void processTasks(
-        GraphicsContext&, ImmediateSubmissionQueue const& submissionQueue
-    );
+        // From the start of an import until all of its uploads are submitted.
+        double recordSeconds{0.0};
+        // From the start of an import until processTasks sees all of its
+        // uploads complete.
+        double completionSeconds{0.0};
+
+        [[nodiscard]] auto recordSecondsPerAsset() const -> double
+        {
+            return assets > 0 ? recordSeconds / static_cast<double>(assets)
+                              : 0.0;
+        }
+        [[nodiscard]] auto completionSecondsPerAsset() const -> double
+        {
+            return assets > 0 ? completionSeconds / static_cast<double>(assets)
+                              : 0.0;
+        }
+    };
+
+    [[nodiscard]] auto uploadTimings(bool batched) const
+        -> UploadTimings const&;
 
     enum class DefaultMeshAssets
     {
@@ -218,28 +408,198 @@ public:
 private:
     AssetLibrary() = default;
 
+    // Pools are held by pointer, so this is not limited to a mutable library.
+    template <typename T>
+    [[nodiscard]] auto mutablePool() const -> AssetPool<T>&
+    {
+        if constexpr (std::is_same_v<T, ImageView>)
+        {
+            return *m_textures;
+        }
+        else if constexpr (std::is_same_v<T, Mesh>)
+        {
+            return *m_meshes;
+        }
+    }
+
     // Expects a name of format assetType_name and returns assetType_name_N
     // where N means there have been N-1 in existence
     // e.g. mesh_Cube becomes mesh_Cube_3
     auto deduplicateAssetName(std::string const& name) -> std::string;
 
+    void importGLTF(
+        GraphicsContext&,
+        UploadQueue&,
+        UploadImport&,
+        std::filesystem::path const& filePath
+    );
+
+    // Preserves glTF indexing, with expired pointers where no mesh was
+    // registered.
+    auto importCookedMeshes(
+        GraphicsContext&,
+        UploadQueue&,
+        UploadImport&,
+        MeshCacheFile const&,
+        std::span<MaterialData const> materialsByGLTFIndex,
+        MaterialData const& defaultMaterial,
+        std::filesystem::path const& sourcePath
+    ) -> std::vector<AssetPtr<Mesh>>;
+
+    // The geometry is copied into staging memory before this returns. Returns
+    // the registered mesh, or the mesh already loaded with the same content.
+    auto importMesh(
+        GraphicsContext&,
+        UploadQueue&,
+        UploadImport&,
+        std::unique_ptr<Mesh>&& mesh,
+        std::string const& name,
+        std::filesystem::path const& sourcePath,
+        std::span<uint32_t const> indices,
+        std::span<VertexPacked const> vertices
+    ) -> std::optional<AssetShared<Mesh>>;
+
+    auto importTexture(
+        VkDevice,
+        VmaAllocator,
+        UploadQueue&,
+        UploadImport&,
+        VkFormat fileFormat,
+        std::filesystem::path const& filePath
+    ) -> std::optional<AssetShared<ImageView>>;
+
+    // Watches the glTF and the files it reads from, see setHotReload.
+    void watchGLTF(
+        std::shared_ptr<GLTFReloadSource> const&,
+        std::span<std::filesystem::path const> bufferFiles,
+        std::span<std::filesystem::path const> imageFiles
+    );
+
+    // Starts reading the changed files on the decode workers.
+    void reloadChangedFiles();
+
+    // Uploads what changed, which replaces the assets' data once complete.
+    void finishGLTFReload(
+        GraphicsContext&, UploadQueue&, UploadImport&, GLTFReloadTask&
+    );
+
+    // Drops the asset from the content index, such as when its content
+    // changed, then indexes it under the new hash if there is one.
+    template <typename T>
+    void reindexContent(
+        AssetShared<T> const& asset, std::optional<uint64_t> const contentHash
+    )
+    {
+        auto const reindex{[&](auto& index)
+        {
+            std::erase_if(
+                index,
+                [&](auto const& entry)
+            { return entry.second.lock() == asset; }
+            );
+            if (contentHash.has_value())
+            {
+                index.insert_or_assign(contentHash.value(), asset);
+            }
+        }};
+
+        if constexpr (std::is_same_v<T, ImageView>)
+        {
+            reindex(m_texturesByContent);
+        }
+        else if constexpr (std::is_same_v<T, Mesh>)
+        {
+            reindex(m_meshesByContent);
+        }
+    }
+
+    // Call once an asset's upload has been added to the import's batch.
+    void queueUpload(UploadQueue&, UploadImport&);
+    void flushUploads(UploadQueue&, UploadImport&);
+    void finishUploads(UploadQueue&, UploadImport&&);
+
+    void recordUploadTimings(UploadImport const&);
+
+    // Guards the name deduplication of registerAsset. Held by pointer, like
+    // the pools, so that the library can be moved.
+    std::unique_ptr<std::mutex> m_registrationMutex{
+        std::make_unique<std::mutex>()
+    };
     std::unordered_map<std::string, size_t> m_nameDuplicationCounters{};
 
-    // The asset library stores pointers to all loaded/active assets, to keep
-    // them alive for the lifetime of the library.
-    // Asset library keeps shared_ptr<Asset<T>>, while the rest of the
-    // application gets shared_ptr<Asset<T> const>. This allows interior
+    // The asset library owns all loaded/active assets, keeping them alive
+    // until they are unloaded, see unloadUnused.
+    // The library has mutable access to assets through their pools, while the
+    // rest of the application gets Asset<T> const. This allows interior
     // mutability of the asset data, but not metadata/pointers to data/metadata.
+    //
+    // Pools are held by pointer, since assets refer back to them.
 
     AssetShared<ImageView> m_defaultColorMap{};
     AssetShared<ImageView> m_defaultNormalMap{};
     AssetShared<ImageView> m_defaultORMMap{};
-    std::vector<std::shared_ptr<Asset<ImageView>>> m_textures{};
+    std::unique_ptr<AssetPool<ImageView>> m_textures{
+        std::make_unique<AssetPool<ImageView>>()
+    };
 
     AssetShared<Mesh> m_meshPlane{};
     AssetShared<Mesh> m_meshCube{};
-    std::vector<std::shared_ptr<Asset<Mesh>>> m_meshes{};
+    std::unique_ptr<AssetPool<Mesh>> m_meshes{
+        std::make_unique<AssetPool<Mesh>>()
+    };
+
+    std::unordered_map<uint64_t, AssetPtr<ImageView>> m_texturesByContent{};
+    std::unordered_map<uint64_t, AssetPtr<Mesh>> m_meshesByContent{};
+    DeduplicationStats m_deduplicationStats{};
 
     std::vector<std::shared_ptr<ImageLoadingTask>> m_tasks{};
+
+    // Decodes glTF textures off of the main thread. Finished decodes are
+    // uploaded and swapped into their placeholder assets in processTasks.
+    std::unique_ptr<ThreadPool> m_decodeWorkers{};
+    std::vector<std::shared_ptr<TextureDecodeTask>> m_textureDecodes{};
+
+    // Uploads in flight on the upload queue, whose data is installed into
+    // their assets once complete.
+    std::vector<std::shared_ptr<TextureUploadTask>> m_textureUploads{};
+    std::vector<std::shared_ptr<MeshUploadTask>> m_meshUploads{};
+
+    TextureResidency m_textureResidency{};
+    // Reads of evicted or reduced textures, on the decode workers.
+    std::vector<std::shared_ptr<TextureStreamTask>> m_textureStreams{};
+
+    FileWatcher m_fileWatcher{};
+    bool m_hotReload{true};
+    std::vector<std::shared_ptr<GLTFReloadSource>> m_gltfSources{};
+    std::vector<std::shared_ptr<GLTFReloadTask>> m_gltfReloads{};
+
+    // A texture loaded from an image file, which is read again when the file
+    // changes.
+    struct WatchedTextureFile
+    {
+        std::filesystem::path path{};
+        AssetPtr<ImageView> texture{};
+        VkFormat format{VK_FORMAT_UNDEFINED};
+    };
+    std::vector<WatchedTextureFile> m_watchedTextureFiles{};
+
+    // Mesh data that a reload replaced or that was unloaded, which frames in
+    // flight may still draw.
+    struct RetiredMesh
+    {
+        std::shared_ptr<Mesh> data{};
+        uint64_t frame{0};
+    };
+    std::vector<RetiredMesh> m_retiredMeshes{};
+    // Counts calls to processTasks, which happen once per frame.
+    uint64_t m_frame{0};
+
+    bool m_batchUploads{true};
+    VertexFormat m_meshVertexFormat{VertexFormat::Full};
+    VertexWeldTolerance m_vertexWeldTolerance{};
+    // Imports whose uploads are all submitted, waiting to be timed.
+    std::vector<std::shared_ptr<UploadImport>> m_uploadImports{};
+    UploadTimings m_batchedUploadTimings{};
+    UploadTimings m_perAssetUploadTimings{};
 };
 } // namespace syzygy
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "syzygy/assets/assets.hpp"
+#include "syzygy/assets/meshcache.hpp"
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/platform/vulkanusage.hpp"
+#include "syzygy/renderer/gputypes.hpp"
+#include "syzygy/renderer/vertexencoding.hpp"
+#include <memory>
+#include <optional>
+#include <span>
+
+namespace syzygy
+{
+struct CookedTexture;
+struct UploadBatch;
+struct UploadQueue;
+} // namespace syzygy
+
+// The stages of an import after its assets are cooked, shared between
+// AssetLibrary and the asset benchmark, which times each stage on its own.
+namespace detail
+{
+// A mesh without buffers, made from the cooked surfaces of a source file such
+// as a glTF. Surfaces take their materials from the source's by index, or the
+// default if it is out of bounds.
+auto makeCookedMesh(
+    std::span<syzygy::CookedSurface const> cookedSurfaces,
+    std::span<syzygy::CookedSurface const> lodSurfaces,
+    std::span<float const> lodErrors,
+    syzygy::AABB const& bounds,
+    std::span<syzygy::MaterialData const> materialsByGLTFIndex,
+    syzygy::MaterialData const& defaultMaterial
+) -> std::unique_ptr<syzygy::Mesh>;
+
+// Blocks until the batch's uploads complete.
+auto submitAndWait(
+    syzygy::UploadQueue& uploadQueue, syzygy::UploadBatch&& batch
+) -> bool;
+
+// The returned buffers can only be used once the batch is submitted and
+// completes. Vertices and indices are encoded straight into staging memory,
+// with indices narrowed to 16 bits when the mesh is small enough.
+//
+// The surfaces are split into meshlets, and each surface is updated with the
+// range of meshlets that covers it.
+auto uploadMeshToGPU(
+    VkDevice device,
+    VmaAllocator allocator,
+    syzygy::UploadQueue& uploadQueue,
+    syzygy::UploadBatch& batch,
+    syzygy::VertexFormat vertexFormat,
+    std::span<syzygy::GeometrySurface> surfaces,
+    std::span<syzygy::MeshLod> lods,
+    std::span<uint32_t const> indices,
+    std::span<syzygy::VertexPacked const> vertices
+) -> std::optional<std::unique_ptr<syzygy::GPUMeshBuffers>>;
+
+// The returned texture can only be used once the batch is submitted and
+// completes. The texels are copied once, straight into staging memory, where
+// the rest of the mip chain is generated in place. Only the levels from
+// firstLevel onwards are uploaded, so the texture can be kept at a reduced
+// resolution.
+auto uploadTextureFromRGBA(
+    VkDevice device,
+    VmaAllocator allocator,
+    syzygy::UploadQueue& uploadQueue,
+    syzygy::UploadBatch& batch,
+    VkFormat format,
+    VkExtent2D extent,
+    std::span<uint8_t const> rgba,
+    uint32_t firstLevel
+) -> std::optional<std::unique_ptr<syzygy::ImageView>>;
+
+// The returned texture can only be used once the batch is submitted and
+// completes. Only the levels from firstLevel onwards are uploaded. Textures
+// with more than one array layer are rejected, since materials sample them as
+// 2D.
+auto uploadCookedTexture(
+    VkDevice device,
+    VmaAllocator allocator,
+    syzygy::UploadQueue& uploadQueue,
+    syzygy::UploadBatch& batch,
+    syzygy::CookedTexture const& texture,
+    uint32_t firstLevel
+) -> std::optional<std::unique_ptr<syzygy::ImageView>>;
+} // namespace detail
@@ -1,10 +1,16 @@
 #pragma once
 
 #include "syzygy/core/uuid.hpp"
+#include "syzygy/platform/integer.hpp"
 #include <functional>
 #include <memory>
 #include <string>
 
+namespace syzygy
+{
+template <typename T> struct AssetPool;
+} // namespace syzygy
+
 namespace syzygy
 {
 struct AssetMetadata
@@ -14,14 +20,85 @@ struct AssetMetadata
     syzygy::UUID id{};
 };
 
+// Identifies an asset in an AssetPool by the index of its slot, and the
+// generation of that slot when the asset was registered. Once the asset is
+// released, the slot's generation moves on, so the handle stays invalid even
+// after the slot is reused.
+template <typename T> struct AssetHandle
+{
+    static uint32_t constexpr INDEX_BITS{20};
+    static uint32_t constexpr GENERATION_BITS{32 - INDEX_BITS};
+    static uint32_t constexpr INDEX_MASK{(1U << INDEX_BITS) - 1};
+    static uint32_t constexpr MAX_GENERATION{(1U << GENERATION_BITS) - 1};
+
+    // Generations start at 1, so the default handle is never valid.
+    uint32_t value{0};
+
+    static auto make(uint32_t const index, uint32_t const generation)
+        -> AssetHandle
+    {
+        return AssetHandle{
+            .value = (generation << INDEX_BITS) | (index & INDEX_MASK)
+        };
+    }
+
+    [[nodiscard]] auto index() const -> uint32_t { return value & INDEX_MASK; }
+    [[nodiscard]] auto generation() const -> uint32_t
+    {
+        return value >> INDEX_BITS;
+    }
+
+    auto operator==(AssetHandle const&) const -> bool = default;
+};
+
 template <typename T> struct Asset
 {
     AssetMetadata metadata{};
     std::shared_ptr<T> data{};
+
+    // Where the asset is registered, so that holders of the asset can look it
+    // up again by handle. Both are set by AssetPool.
+    AssetHandle<T> handle{};
+    AssetPool<T> const* pool{nullptr};
 };
 
 template <typename T> using AssetPtr = std::weak_ptr<Asset<T> const>;
 template <typename T> using AssetShared = std::shared_ptr<Asset<T> const>;
 
 template <typename T> using AssetRef = std::reference_wrapper<Asset<T> const>;
+
+// Refers to an asset without keeping it alive, like AssetPtr, but by its handle
+// and pool. Resolving it is an AssetPool lookup instead of locking a weak_ptr,
+// so it is cheap enough for per-frame loops. Callers of get and shared need
+// assetpool.hpp.
+template <typename T> struct PooledAssetPtr
+{
+    AssetPool<T> const* pool{nullptr};
+    AssetHandle<T> handle{};
+
+    static auto from(Asset<T> const& asset) -> PooledAssetPtr
+    {
+        return PooledAssetPtr{.pool = asset.pool, .handle = asset.handle};
+    }
+    static auto from(AssetPtr<T> const& asset) -> PooledAssetPtr
+    {
+        AssetShared<T> const shared{asset.lock()};
+        return shared != nullptr ? from(*shared) : PooledAssetPtr{};
+    }
+
+    // Null once the asset is released.
+    [[nodiscard]] auto get() const -> Asset<T> const*
+    {
+        return pool != nullptr ? pool->get(handle) : nullptr;
+    }
+
+    // For code that keeps the asset as an AssetPtr or AssetShared. This is
+    // reference counted, so it should be kept out of per-frame loops.
+    [[nodiscard]] auto shared() const -> AssetShared<T>
+    {
+        return pool != nullptr ? pool->shared(handle) : nullptr;
+    }
+
+    auto operator==(PooledAssetPtr const&) const -> bool = default;
+};
 } // namespace syzygy
\ No newline at end of file
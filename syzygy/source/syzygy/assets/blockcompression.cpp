@@ -0,0 +1,530 @@
+#include "blockcompression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace
+{
+size_t constexpr TEXELS_PER_BLOCK{16};
+size_t constexpr RGBA_CHANNELS{4};
+
+using TexelBytes = std::array<uint8_t, RGBA_CHANNELS>;
+using BlockBytes = std::array<TexelBytes, TEXELS_PER_BLOCK>;
+using Texel = std::array<float, RGBA_CHANNELS>;
+
+float constexpr CHANNEL_MAX{255.0F};
+
+auto loadBlock(
+    std::span<uint8_t const> const rgba,
+    uint32_t const width,
+    uint32_t const height,
+    uint32_t const blockX,
+    uint32_t const blockY
+) -> BlockBytes
+{
+    uint32_t constexpr EXTENT{syzygy::BlockCompression::BLOCK_EXTENT};
+
+    BlockBytes block{};
+    for (uint32_t y{0}; y < EXTENT; y++)
+    {
+        uint32_t const sourceY{std::min(blockY * EXTENT + y, height - 1)};
+        for (uint32_t x{0}; x < EXTENT; x++)
+        {
+            uint32_t const sourceX{std::min(blockX * EXTENT + x, width - 1)};
+            size_t const offset{
+                (static_cast<size_t>(sourceY) * width + sourceX)
+                * RGBA_CHANNELS
+            };
+            std::copy_n(
+                rgba.begin() + static_cast<ptrdiff_t>(offset),
+                RGBA_CHANNELS,
+                block[y * EXTENT + x].begin()
+            );
+        }
+    }
+    return block;
+}
+
+// Writes the fields of a block in order, starting from its least significant
+// bit.
+struct BlockWriter
+{
+    std::span<uint8_t> bytes;
+    uint32_t position{0};
+
+    void write(uint32_t const value, uint32_t const bitCount)
+    {
+        for (uint32_t bit{0}; bit < bitCount; bit++)
+        {
+            if (((value >> bit) & 1U) != 0)
+            {
+                bytes[position / 8] |=
+                    static_cast<uint8_t>(1U << (position % 8));
+            }
+            position++;
+        }
+    }
+};
+
+// BC7 mode 6: one subset, RGBA endpoints of 7 bits plus a unique p-bit each,
+// and a 4-bit index per texel.
+
+uint32_t constexpr MODE6_INDEX_COUNT{16};
+uint32_t constexpr MODE6_INDEX_BITS{4};
+uint32_t constexpr MODE6_COLOR_BITS{7};
+uint32_t constexpr MODE6_COLOR_MAX{127};
+
+std::array<uint32_t, MODE6_INDEX_COUNT> constexpr MODE6_WEIGHTS{
+    0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64
+};
+uint32_t constexpr WEIGHT_MAX{64};
+
+struct Mode6Endpoint
+{
+    std::array<uint32_t, RGBA_CHANNELS> color{};
+    uint32_t pBit{0};
+
+    [[nodiscard]] auto expanded(size_t const channel) const -> uint32_t
+    {
+        return (color[channel] << 1U) | pBit;
+    }
+};
+
+struct Mode6Fit
+{
+    std::array<Mode6Endpoint, 2> endpoints{};
+    std::array<uint32_t, TEXELS_PER_BLOCK> indices{};
+    float error{std::numeric_limits<float>::max()};
+};
+
+auto quantizeMode6(Texel const& endpoint) -> Mode6Endpoint
+{
+    Mode6Endpoint best{};
+    float bestError{std::numeric_limits<float>::max()};
+
+    for (uint32_t pBit{0}; pBit < 2; pBit++)
+    {
+        Mode6Endpoint candidate{.pBit = pBit};
+        float error{0.0F};
+        for (size_t channel{0}; channel < RGBA_CHANNELS; channel++)
+        {
+            float const target{std::clamp(endpoint[channel], 0.0F, CHANNEL_MAX)
+            };
+            long const color{
+                std::lround((target - static_cast<float>(pBit)) / 2.0F)
+            };
+            candidate.color[channel] = static_cast<uint32_t>(
+                std::clamp<long>(color, 0, MODE6_COLOR_MAX)
+            );
+
+            float const difference{
+                static_cast<float>(candidate.expanded(channel)) - target
+            };
+            error += difference * difference;
+        }
+
+        if (error < bestError)
+        {
+            best = candidate;
+            bestError = error;
+        }
+    }
+
+    return best;
+}
+
+// Finds the closest palette entry for every texel.
+auto assignMode6Indices(
+    BlockBytes const& block, std::array<Mode6Endpoint, 2> const& endpoints
+) -> Mode6Fit
+{
+    std::array<std::array<uint32_t, RGBA_CHANNELS>, MODE6_INDEX_COUNT>
+        palette{};
+    for (uint32_t index{0}; index < MODE6_INDEX_COUNT; index++)
+    {
+        uint32_t const weight{MODE6_WEIGHTS[index]};
+        for (size_t channel{0}; channel < RGBA_CHANNELS; channel++)
+        {
+            uint32_t const low{endpoints[0].expanded(channel)};
+            uint32_t const high{endpoints[1].expanded(channel)};
+            palette[index][channel] =
+                ((WEIGHT_MAX - weight) * low + weight * high + 32) >> 6U;
+        }
+    }
+
+    Mode6Fit fit{.endpoints = endpoints, .error = 0.0F};
+    for (size_t texel{0}; texel < TEXELS_PER_BLOCK; texel++)
+    {
+        uint32_t bestError{std::numeric_limits<uint32_t>::max()};
+        for (uint32_t index{0}; index < MODE6_INDEX_COUNT; index++)
+        {
+            uint32_t error{0};
+            for (size_t channel{0}; channel < RGBA_CHANNELS; channel++)
+            {
+                int32_t const difference{
+                    static_cast<int32_t>(palette[index][channel])
+                    - static_cast<int32_t>(block[texel][channel])
+                };
+                error += static_cast<uint32_t>(difference * difference);
+            }
+            if (error < bestError)
+            {
+                bestError = error;
+                fit.indices[texel] = index;
+            }
+        }
+        fit.error += static_cast<float>(bestError);
+    }
+
+    return fit;
+}
+
+// Endpoints at the extremes of the block's principal axis.
+auto principalEndpoints(BlockBytes const& block) -> std::array<Texel, 2>
+{
+    Texel mean{};
+    Texel minimumTexel{CHANNEL_MAX, CHANNEL_MAX, CHANNEL_MAX, CHANNEL_MAX};
+    Texel maximumTexel{};
+    for (TexelBytes const& texel : block)
+    {
+        for (size_t channel{0}; channel < RGBA_CHANNELS; channel++)
+        {
+            auto const value{static_cast<float>(texel[channel])};
+            mean[channel] += value;
+            minimumTexel[channel] = std::min(minimumTexel[channel], value);
+            maximumTexel[channel] = std::max(maximumTexel[channel], value);
+        }
+    }
+    for (float& component : mean)
+    {
+        component /= static_cast<float>(TEXELS_PER_BLOCK);
+    }
+
+    std::array<std::array<float, RGBA_CHANNELS>, RGBA_CHANNELS> covariance{};
+    for (TexelBytes const& texel : block)
+    {
+        for (size_t row{0}; row < RGBA_CHANNELS; row++)
+        {
+            for (size_t column{0}; column < RGBA_CHANNELS; column++)
+            {
+                covariance[row][column] +=
+                    (static_cast<float>(texel[row]) - mean[row])
+                    * (static_cast<float>(texel[column]) - mean[column]);
+            }
+        }
+    }
+
+    // Power iteration converges quickly enough for the dominant axis. The
+    // bounding box's diagonal is a good first guess.
+    size_t constexpr POWER_ITERATIONS{8};
+    Texel axis{};
+    for (size_t channel{0}; channel < RGBA_CHANNELS; channel++)
+    {
+        axis[channel] = maximumTexel[channel] - minimumTexel[channel];
+    }
+    for (size_t iteration{0}; iteration < POWER_ITERATIONS; iteration++)
+    {
+        Texel next{};
+        for (size_t row{0}; row < RGBA_CHANNELS; row++)
+        {
+            for (size_t column{0}; column < RGBA_CHANNELS; column++)
+            {
+                next[row] += covariance[row][column] * axis[column];
+            }
+        }
+
+        float lengthSquared{0.0F};
+        for (float const component : next)
+        {
+            lengthSquared += component * component;
+        }
+        if (lengthSquared <= std::numeric_limits<float>::epsilon())
+        {
+            // The texels barely vary, so the bounds are close enough.
+            return {minimumTexel, maximumTexel};
+        }
+
+        float const inverseLength{1.0F / std::sqrt(lengthSquared)};
+        for (size_t channel{0}; channel < RGBA_CHANNELS; channel++)
+        {
+            axis[channel] = next[channel] * inverseLength;
+        }
+    }
+
+    float minimum{std::numeric_limits<float>::max()};
+    float maximum{std::numeric_limits<float>::lowest()};
+    for (TexelBytes const& texel : block)
+    {
+        float projection{0.0F};
+        for (size_t channel{0}; channel < RGBA_CHANNELS; channel++)
+        {
+            projection +=
+                (static_cast<float>(texel[channel]) - mean[channel])
+                * axis[channel];
+        }
+        minimum = std::min(minimum, projection);
+        maximum = std::max(maximum, projection);
+    }
+
+    std::array<Texel, 2> endpoints{};
+    for (size_t channel{0}; channel < RGBA_CHANNELS; channel++)
+    {
+        endpoints[0][channel] = mean[channel] + axis[channel] * minimum;
+        endpoints[1][channel] = mean[channel] + axis[channel] * maximum;
+    }
+    return endpoints;
+}
+
+// Least squares endpoints for a fixed choice of indices. Returns nullopt when
+// the indices do not constrain both endpoints.
+auto refitEndpoints(
+    BlockBytes const& block,
+    std::array<uint32_t, TEXELS_PER_BLOCK> const& indices
+) -> std::optional<std::array<Texel, 2>>
+{
+    float lowLow{0.0F};
+    float lowHigh{0.0F};
+    float highHigh{0.0F};
+    Texel lowTarget{};
+    Texel highTarget{};
+
+    for (size_t texel{0}; texel < TEXELS_PER_BLOCK; texel++)
+    {
+        float const high{
+            static_cast<float>(MODE6_WEIGHTS[indices[texel]])
+            / static_cast<float>(WEIGHT_MAX)
+        };
+        float const low{1.0F - high};
+
+        lowLow += low * low;
+        lowHigh += low * high;
+        highHigh += high * high;
+        for (size_t channel{0}; channel < RGBA_CHANNELS; channel++)
+        {
+            float const value{static_cast<float>(block[texel][channel])};
+            lowTarget[channel] += low * value;
+            highTarget[channel] += high * value;
+        }
+    }
+
+    float const determinant{lowLow * highHigh - lowHigh * lowHigh};
+    if (std::abs(determinant) <= std::numeric_limits<float>::epsilon())
+    {
+        return std::nullopt;
+    }
+
+    std::array<Texel, 2> endpoints{};
+    for (size_t channel{0}; channel < RGBA_CHANNELS; channel++)
+    {
+        endpoints[0][channel] =
+            (highHigh * lowTarget[channel] - lowHigh * highTarget[channel])
+            / determinant;
+        endpoints[1][channel] =
+            (lowLow * highTarget[channel] - lowHigh * lowTarget[channel])
+            / determinant;
+    }
+    return endpoints;
+}
+
+void encodeBC7Block(BlockBytes const& block, std::span<uint8_t> const output)
+{
+    std::array<Texel, 2> const initial{principalEndpoints(block)};
+    Mode6Fit best{assignMode6Indices(
+        block, {quantizeMode6(initial[0]), quantizeMode6(initial[1])}
+    )};
+
+    size_t constexpr REFINE_ITERATIONS{2};
+    for (size_t iteration{0}; iteration < REFINE_ITERATIONS; iteration++)
+    {
+        std::optional<std::array<Texel, 2>> const refit{
+            refitEndpoints(block, best.indices)
+        };
+        if (!refit.has_value())
+        {
+            break;
+        }
+
+        Mode6Fit const candidate{assignMode6Indices(
+            block,
+            {quantizeMode6(refit.value()[0]), quantizeMode6(refit.value()[1])}
+        )};
+        if (candidate.error >= best.error)
+        {
+            break;
+        }
+        best = candidate;
+    }
+
+    // The most significant bit of the first index is implied to be zero, so
+    // swap the endpoints if it is set.
+    uint32_t constexpr ANCHOR_BIT{1U << (MODE6_INDEX_BITS - 1)};
+    if ((best.indices[0] & ANCHOR_BIT) != 0)
+    {
+        std::swap(best.endpoints[0], best.endpoints[1]);
+        for (uint32_t& index : best.indices)
+        {
+            index = MODE6_INDEX_COUNT - 1 - index;
+        }
+    }
+
+    std::fill(output.begin(), output.end(), 0);
+    BlockWriter writer{.bytes = output};
+
+    uint32_t constexpr MODE{6};
+    writer.write(1U << MODE, MODE + 1);
+    for (size_t channel{0}; channel < RGBA_CHANNELS; channel++)
+    {
+        writer.write(best.endpoints[0].color[channel], MODE6_COLOR_BITS);
+        writer.write(best.endpoints[1].color[channel], MODE6_COLOR_BITS);
+    }
+    writer.write(best.endpoints[0].pBit, 1);
+    writer.write(best.endpoints[1].pBit, 1);
+
+    writer.write(best.indices[0], MODE6_INDEX_BITS - 1);
+    for (size_t texel{1}; texel < TEXELS_PER_BLOCK; texel++)
+    {
+        writer.write(best.indices[texel], MODE6_INDEX_BITS);
+    }
+    assert(writer.position == syzygy::BlockCompression::BLOCK_BYTES * 8);
+}
+
+// BC4 in its eight value mode, with the maximum as the first endpoint. BC5 is
+// two of these.
+size_t constexpr BC4_BLOCK_BYTES{8};
+uint32_t constexpr BC4_INDEX_COUNT{8};
+uint32_t constexpr BC4_INDEX_BITS{3};
+
+void encodeBC4Block(
+    BlockBytes const& block, size_t const channel, std::span<uint8_t> output
+)
+{
+    uint32_t low{std::numeric_limits<uint8_t>::max()};
+    uint32_t high{0};
+    for (TexelBytes const& texel : block)
+    {
+        low = std::min<uint32_t>(low, texel[channel]);
+        high = std::max<uint32_t>(high, texel[channel]);
+    }
+
+    std::array<uint32_t, BC4_INDEX_COUNT> palette{high, low};
+    for (uint32_t index{2}; index < BC4_INDEX_COUNT; index++)
+    {
+        palette[index] =
+            ((BC4_INDEX_COUNT - index) * high + (index - 1) * low
+             + (BC4_INDEX_COUNT - 1) / 2)
+            / (BC4_INDEX_COUNT - 1);
+    }
+
+    uint64_t indexBits{0};
+    for (size_t texel{0}; texel < TEXELS_PER_BLOCK; texel++)
+    {
+        auto const value{static_cast<int32_t>(block[texel][channel])};
+
+        uint64_t bestIndex{0};
+        int32_t bestError{std::numeric_limits<int32_t>::max()};
+        for (uint32_t index{0}; index < BC4_INDEX_COUNT; index++)
+        {
+            int32_t const error{
+                std::abs(static_cast<int32_t>(palette[index]) - value)
+            };
+            if (error < bestError)
+            {
+                bestError = error;
+                bestIndex = index;
+            }
+        }
+        indexBits |= bestIndex << (texel * BC4_INDEX_BITS);
+    }
+
+    output[0] = static_cast<uint8_t>(high);
+    output[1] = static_cast<uint8_t>(low);
+    for (size_t byte{2}; byte < BC4_BLOCK_BYTES; byte++)
+    {
+        output[byte] = static_cast<uint8_t>(indexBits >> ((byte - 2) * 8));
+    }
+}
+
+template <typename EncodeBlock>
+auto encodeBlocks(
+    std::span<uint8_t const> const rgba,
+    uint32_t const width,
+    uint32_t const height,
+    EncodeBlock const& encodeBlock
+) -> std::vector<uint8_t>
+{
+    assert(rgba.size() >= static_cast<size_t>(width) * height * RGBA_CHANNELS);
+
+    uint32_t constexpr EXTENT{syzygy::BlockCompression::BLOCK_EXTENT};
+    size_t constexpr BLOCK_BYTES{syzygy::BlockCompression::BLOCK_BYTES};
+
+    uint32_t const blocksX{(width + EXTENT - 1) / EXTENT};
+    uint32_t const blocksY{(height + EXTENT - 1) / EXTENT};
+
+    std::vector<uint8_t> blocks(
+        syzygy::BlockCompression::blockCount(width, height) * BLOCK_BYTES
+    );
+    for (uint32_t blockY{0}; blockY < blocksY; blockY++)
+    {
+        for (uint32_t blockX{0}; blockX < blocksX; blockX++)
+        {
+            size_t const blockIndex{
+                static_cast<size_t>(blockY) * blocksX + blockX
+            };
+            encodeBlock(
+                loadBlock(rgba, width, height, blockX, blockY),
+                std::span<uint8_t>{blocks}.subspan(
+                    blockIndex * BLOCK_BYTES, BLOCK_BYTES
+                )
+            );
+        }
+    }
+
+    return blocks;
+}
+} // namespace
+
+namespace syzygy
+{
+auto BlockCompression::blockCount(uint32_t const width, uint32_t const height)
+    -> size_t
+{
+    size_t const blocksX{(width + BLOCK_EXTENT - 1) / BLOCK_EXTENT};
+    size_t const blocksY{(height + BLOCK_EXTENT - 1) / BLOCK_EXTENT};
+    return blocksX * blocksY;
+}
+
+auto BlockCompression::encodeBC7(
+    std::span<uint8_t const> const rgba,
+    uint32_t const width,
+    uint32_t const height
+) -> std::vector<uint8_t>
+{
+    return encodeBlocks(rgba, width, height, encodeBC7Block);
+}
+
+auto BlockCompression::encodeBC5(
+    std::span<uint8_t const> const rgba,
+    uint32_t const width,
+    uint32_t const height
+) -> std::vector<uint8_t>
+{
+    return encodeBlocks(
+        rgba,
+        width,
+        height,
+        [](BlockBytes const& block, std::span<uint8_t> const output)
+    {
+        encodeBC4Block(block, 0, output.subspan(0, BC4_BLOCK_BYTES));
+        encodeBC4Block(
+            block, 1, output.subspan(BC4_BLOCK_BYTES, BC4_BLOCK_BYTES)
+        );
+    }
+    );
+}
+} // namespace syzygy
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "syzygy/platform/integer.hpp"
+#include <span>
+#include <vector>
+
+namespace syzygy
+{
+// Encoders for block-compressed texture formats. Each block covers 4x4
+// texels, with partial blocks at the right and bottom edges padded by
+// repeating the last row and column.
+//
+// Source texels are 8-bit RGBA, tightly packed row by row. The encoders favor
+// speed over the best possible quality, since they run on every texture the
+// first time it is loaded.
+struct BlockCompression
+{
+    static uint32_t constexpr BLOCK_EXTENT{4};
+
+    // Both BC5 and BC7 blocks are this size.
+    static size_t constexpr BLOCK_BYTES{16};
+
+    [[nodiscard]] static auto blockCount(uint32_t width, uint32_t height)
+        -> size_t;
+
+    // Uses only mode 6, one subset of RGBA endpoints with 4-bit indices.
+    static auto encodeBC7(
+        std::span<uint8_t const> rgba, uint32_t width, uint32_t height
+    ) -> std::vector<uint8_t>;
+
+    // Keeps only the red and green channels, such as the x and y of a tangent
+    // space normal. The rest must be reconstructed when sampled.
+    static auto encodeBC5(
+        std::span<uint8_t const> rgba, uint32_t width, uint32_t height
+    ) -> std::vector<uint8_t>;
+};
+} // namespace syzygy
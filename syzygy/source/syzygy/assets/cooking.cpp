@@ -0,0 +1,1517 @@
+#include "cooking.hpp"
+
+#include "syzygy/assets/meshcache.hpp"
+#include "syzygy/assets/meshoptimization.hpp"
+#include "syzygy/assets/meshsimplification.hpp"
+#include "syzygy/assets/texelkernels.hpp"
+#include "syzygy/assets/texturecache.hpp"
+#include "syzygy/assets/vertexwelding.hpp"
+#include "syzygy/core/hash.hpp"
+#include "syzygy/core/log.hpp"
+#include "syzygy/core/threadpool.hpp"
+#include "syzygy/geometry/geometrytypes.hpp"
+#include "syzygy/platform/filesystemutils.hpp"
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/renderer/gputypes.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <fastgltf/core.hpp>
+#include <fastgltf/glm_element_traits.hpp> // IWYU pragma: keep
+#include <fastgltf/tools.hpp>
+#include <fastgltf/types.hpp>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <spdlog/fmt/bundled/core.h>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+#include <xmmintrin.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+
+namespace
+{
+// glTF material texture indices oragnized into syzygy's material format
+struct MaterialTextureIndices
+{
+    std::optional<size_t> color{};
+    std::optional<size_t> normal{};
+    std::optional<size_t> occlusion{};
+    std::optional<size_t> roughnessMetallic{};
+};
+
+auto parseMaterialIndices(fastgltf::Material const& material)
+    -> MaterialTextureIndices
+{
+    MaterialTextureIndices indices{};
+
+    {
+        std::optional<fastgltf::TextureInfo> const& color{
+            material.pbrData.baseColorTexture
+        };
+        if (!color.has_value())
+        {
+            SZG_WARNING("Material {}: Missing color texture.", material.name);
+        }
+        else
+        {
+            indices.color = color.value().textureIndex;
+        }
+    }
+
+    {
+        std::optional<fastgltf::NormalTextureInfo> const& normal{
+            material.normalTexture
+        };
+        if (!normal.has_value())
+        {
+            SZG_WARNING("Material {}: Missing normal texture.", material.name);
+        }
+        else
+        {
+            indices.normal = normal.value().textureIndex;
+        }
+    }
+
+    {
+        std::optional<fastgltf::OcclusionTextureInfo> const& occlusion{
+            material.occlusionTexture
+        };
+        if (!occlusion.has_value())
+        {
+            SZG_WARNING(
+                "Material {}: Missing occlusion texture.", material.name
+            );
+        }
+        else
+        {
+            indices.occlusion = occlusion.value().textureIndex;
+        }
+    }
+
+    {
+        std::optional<fastgltf::TextureInfo> const& metallicRoughness{
+            material.pbrData.metallicRoughnessTexture
+        };
+        if (!metallicRoughness.has_value())
+        {
+            SZG_WARNING(
+                "Material {}: Missing metallicRoughness texture", material.name
+            );
+        }
+        else
+        {
+            indices.roughnessMetallic = metallicRoughness.value().textureIndex;
+        }
+    }
+
+    return indices;
+}
+
+// The fully qualified path of a glTF image. Images embedded in the glTF are
+// attributed to the directory it is in.
+auto gltfImageSourcePath(
+    fastgltf::Image const& image, std::filesystem::path const& assetRoot
+) -> std::optional<std::filesystem::path>
+{
+    if (std::holds_alternative<fastgltf::sources::Array>(image.data))
+    {
+        return assetRoot;
+    }
+
+    if (std::holds_alternative<fastgltf::sources::URI>(image.data))
+    {
+        fastgltf::sources::URI const& uri{
+            std::get<fastgltf::sources::URI>(image.data)
+        };
+
+        // These asserts should be loosened as we support a larger subset of
+        // glTF.
+        assert(uri.fileByteOffset == 0);
+        assert(uri.uri.isLocalPath());
+
+        return assetRoot / uri.uri.fspath();
+    }
+
+    SZG_WARNING("Unsupported glTF image source found.");
+    return std::nullopt;
+}
+
+// The encoded bytes of a glTF image, such as a PNG. External images are mapped
+// rather than read into memory, so they are decoded straight from the file.
+struct GLTFImageSource
+{
+    std::optional<syzygy::MappedFile> mapping{};
+
+    // Points into either the mapping or the glTF, which must outlive this.
+    std::span<uint8_t const> bytes{};
+    std::filesystem::path path{};
+};
+
+auto loadGLTFImageSource(
+    fastgltf::Image const& image, std::filesystem::path const& assetRoot
+) -> std::optional<GLTFImageSource>
+{
+    std::optional<std::filesystem::path> pathResult{
+        gltfImageSourcePath(image, assetRoot)
+    };
+    if (!pathResult.has_value())
+    {
+        return std::nullopt;
+    }
+
+    if (std::holds_alternative<fastgltf::sources::Array>(image.data))
+    {
+        return GLTFImageSource{
+            .bytes = std::get<fastgltf::sources::Array>(image.data).bytes,
+            .path = std::move(pathResult).value(),
+        };
+    }
+
+    std::filesystem::path const& path{pathResult.value()};
+    if (!std::filesystem::is_regular_file(path))
+    {
+        SZG_WARNING(
+            "glTF image source URI does not result in a valid file path. Full "
+            "path is: {}",
+            path.string()
+        );
+        return std::nullopt;
+    }
+
+    std::optional<syzygy::MappedFile> mapping{syzygy::MappedFile::open(
+        path, syzygy::MappedFile::AccessPattern::Sequential
+    )};
+    if (!mapping.has_value())
+    {
+        return std::nullopt;
+    }
+
+    // Moving the mapping does not move the mapped bytes.
+    std::span<uint8_t const> const bytes{mapping.value().bytes()};
+    return GLTFImageSource{
+        .mapping = std::move(mapping),
+        .bytes = bytes,
+        .path = std::move(pathResult).value(),
+    };
+}
+
+// Overwrites the texels in place.
+void applyChannelOverrides(
+    std::span<uint8_t> const rgba, syzygy::ImageChannelOverrides const overrides
+)
+{
+    // NOLINTBEGIN(readability-magic-numbers)
+    uint32_t constexpr CHANNEL_BITS{8U};
+    uint32_t constexpr CHANNEL_MASK{0xFFU};
+    // NOLINTEND(readability-magic-numbers)
+
+    // Texels are little-endian, so red is the lowest byte.
+    uint32_t keepMask{0};
+    uint32_t fill{0};
+    std::array<std::optional<uint8_t>, 4> const channels{
+        overrides.red, overrides.green, overrides.blue, overrides.alpha
+    };
+    for (size_t channel{0}; channel < channels.size(); channel++)
+    {
+        uint32_t const shift{static_cast<uint32_t>(channel) * CHANNEL_BITS};
+        if (channels[channel].has_value())
+        {
+            fill |= static_cast<uint32_t>(channels[channel].value()) << shift;
+        }
+        else
+        {
+            keepMask |= CHANNEL_MASK << shift;
+        }
+    }
+
+    syzygy::TexelKernels::best().overrideChannels(rgba, keepMask, fill);
+}
+// Where an accessor's elements can be read straight from its buffer, which
+// must be loaded into memory. The accessor must not be sparse, and must have
+// exactly the expected layout, so no conversion is needed.
+struct AccessorView
+{
+    std::byte const* data{nullptr};
+    size_t stride{0};
+
+    [[nodiscard]] auto element(size_t const index) const -> std::byte const*
+    {
+        return data + index * stride;
+    }
+};
+
+auto loadedBufferBytes(fastgltf::Buffer const& buffer)
+    -> std::span<std::byte const>
+{
+    if (auto const* const vector{
+            std::get_if<fastgltf::sources::Vector>(&buffer.data)
+        })
+    {
+        return std::as_bytes(std::span<uint8_t const>{vector->bytes});
+    }
+    if (auto const* const array{
+            std::get_if<fastgltf::sources::Array>(&buffer.data)
+        })
+    {
+        return std::as_bytes(
+            std::span<uint8_t const>{array->bytes.data(), array->bytes.size()}
+        );
+    }
+    if (auto const* const view{
+            std::get_if<fastgltf::sources::ByteView>(&buffer.data)
+        })
+    {
+        return std::span<std::byte const>{
+            view->bytes.data(), view->bytes.size()
+        };
+    }
+    return {};
+}
+
+auto viewAccessor(
+    fastgltf::Asset const& gltf,
+    fastgltf::Accessor const& accessor,
+    fastgltf::AccessorType const type,
+    fastgltf::ComponentType const componentType
+) -> std::optional<AccessorView>
+{
+    if (accessor.type != type || accessor.componentType != componentType
+        || accessor.normalized || accessor.sparse.has_value()
+        || accessor.count == 0 || !accessor.bufferViewIndex.has_value()
+        || accessor.bufferViewIndex.value() >= gltf.bufferViews.size())
+    {
+        return std::nullopt;
+    }
+
+    fastgltf::BufferView const& bufferView{
+        gltf.bufferViews[accessor.bufferViewIndex.value()]
+    };
+    if (bufferView.bufferIndex >= gltf.buffers.size())
+    {
+        return std::nullopt;
+    }
+    std::span<std::byte const> const bytes{
+        loadedBufferBytes(gltf.buffers[bufferView.bufferIndex])
+    };
+
+    size_t const elementSize{fastgltf::getElementByteSize(type, componentType)
+    };
+    size_t const stride{bufferView.byteStride.value_or(elementSize)};
+    if (stride < elementSize)
+    {
+        return std::nullopt;
+    }
+
+    size_t const offset{bufferView.byteOffset + accessor.byteOffset};
+    size_t const end{offset + stride * (accessor.count - 1) + elementSize};
+    if (end > bufferView.byteOffset + bufferView.byteLength
+        || end > bytes.size())
+    {
+        return std::nullopt;
+    }
+
+    return AccessorView{.data = bytes.data() + offset, .stride = stride};
+}
+
+template <typename Index>
+void copyIndexElements(
+    AccessorView const& view, std::span<uint32_t> const destination
+)
+{
+    for (size_t index{0}; index < destination.size(); index++)
+    {
+        Index element{};
+        std::memcpy(&element, view.element(index), sizeof(Index));
+        destination[index] = element;
+    }
+}
+
+// Reads the indices of a primitive, offset so that they index into the mesh's
+// vertices rather than the primitive's. Dense 32-bit indices are copied in one
+// block, and other layouts are converted element by element.
+void copyIndices(
+    fastgltf::Asset const& gltf,
+    fastgltf::Accessor const& accessor,
+    std::span<uint32_t> const destination,
+    uint32_t const firstVertex
+)
+{
+    if (std::optional<AccessorView> const view{viewAccessor(
+            gltf,
+            accessor,
+            fastgltf::AccessorType::Scalar,
+            fastgltf::ComponentType::UnsignedInt
+        )};
+        view.has_value())
+    {
+        if (view.value().stride == sizeof(uint32_t))
+        {
+            std::memcpy(
+                destination.data(),
+                view.value().data,
+                destination.size_bytes()
+            );
+        }
+        else
+        {
+            copyIndexElements<uint32_t>(view.value(), destination);
+        }
+    }
+    else if (std::optional<AccessorView> const shortView{viewAccessor(
+                 gltf,
+                 accessor,
+                 fastgltf::AccessorType::Scalar,
+                 fastgltf::ComponentType::UnsignedShort
+             )};
+             shortView.has_value())
+    {
+        copyIndexElements<uint16_t>(shortView.value(), destination);
+    }
+    else
+    {
+        fastgltf::iterateAccessorWithIndex<uint32_t>(
+            gltf,
+            accessor,
+            [&](uint32_t const vertexIndex, size_t const index)
+        { destination[index] = vertexIndex; }
+        );
+    }
+
+    for (uint32_t& index : destination)
+    {
+        index += firstVertex;
+    }
+}
+
+// Reads an attribute into the primitive's vertices, through a strided copy
+// when the accessor holds floats that can be read in place. Elements past the
+// primitive's vertex count are ignored.
+template <typename Element, typename Assign>
+void copyAttribute(
+    fastgltf::Asset const& gltf,
+    fastgltf::Accessor const& accessor,
+    fastgltf::AccessorType const type,
+    std::span<syzygy::VertexPacked> const vertices,
+    Assign const& assign
+)
+{
+    if (std::optional<AccessorView> const view{viewAccessor(
+            gltf, accessor, type, fastgltf::ComponentType::Float
+        )};
+        view.has_value())
+    {
+        size_t const count{std::min(accessor.count, vertices.size())};
+        for (size_t index{0}; index < count; index++)
+        {
+            Element element{};
+            std::memcpy(&element, view.value().element(index), sizeof(Element));
+            assign(vertices[index], element);
+        }
+        return;
+    }
+
+    fastgltf::iterateAccessorWithIndex<Element>(
+        gltf,
+        accessor,
+        [&](Element const& element, size_t const index)
+    {
+        if (index < vertices.size())
+        {
+            assign(vertices[index], element);
+        }
+    }
+    );
+}
+
+// The ranges of a mesh's indices and vertices that one of its primitives is
+// read into. They are disjoint, so primitives can be read in parallel.
+struct PrimitiveRange
+{
+    fastgltf::Primitive const* primitive{nullptr};
+
+    size_t firstIndex{0};
+    size_t indexCount{0};
+
+    size_t firstVertex{0};
+    size_t vertexCount{0};
+};
+
+// The primitive must have been checked to have positions, and indices if it
+// is indexed.
+void readPrimitive(
+    fastgltf::Asset const& gltf,
+    PrimitiveRange const& range,
+    std::span<uint32_t> const meshIndices,
+    std::span<syzygy::VertexPacked> const meshVertices
+)
+{
+    fastgltf::Primitive const& primitive{*range.primitive};
+
+    std::span<uint32_t> const indices{
+        meshIndices.subspan(range.firstIndex, range.indexCount)
+    };
+    std::span<syzygy::VertexPacked> const vertices{
+        meshVertices.subspan(range.firstVertex, range.vertexCount)
+    };
+    auto const firstVertex{static_cast<uint32_t>(range.firstVertex)};
+
+    // Unindexed primitives draw their vertices in order, so they get
+    // sequential indices for welding to compact.
+    if (primitive.indicesAccessor.has_value())
+    {
+        copyIndices(
+            gltf,
+            gltf.accessors[primitive.indicesAccessor.value()],
+            indices,
+            firstVertex
+        );
+    }
+    else
+    {
+        std::iota(indices.begin(), indices.end(), firstVertex);
+    }
+
+    // Attributes other than positions are optional.
+    std::fill(
+        vertices.begin(),
+        vertices.end(),
+        syzygy::VertexPacked{
+            .position = glm::vec3{0.0F},
+            .uv_x = 0.0F,
+            .normal = glm::vec3{1.0F, 0.0F, 0.0F},
+            .uv_y = 0.0F,
+            .color = glm::vec4{1.0F},
+        }
+    );
+
+    copyAttribute<glm::vec3>(
+        gltf,
+        gltf.accessors[primitive.findAttribute("POSITION")->second],
+        fastgltf::AccessorType::Vec3,
+        vertices,
+        [](syzygy::VertexPacked& vertex, glm::vec3 const& position)
+    { vertex.position = position; }
+    );
+
+    if (auto const* const normals{primitive.findAttribute("NORMAL")};
+        normals != primitive.attributes.end())
+    {
+        copyAttribute<glm::vec3>(
+            gltf,
+            gltf.accessors[normals->second],
+            fastgltf::AccessorType::Vec3,
+            vertices,
+            [](syzygy::VertexPacked& vertex, glm::vec3 const& normal)
+        { vertex.normal = normal; }
+        );
+    }
+
+    if (auto const* const uvs{primitive.findAttribute("TEXCOORD_0")};
+        uvs != primitive.attributes.end())
+    {
+        copyAttribute<glm::vec2>(
+            gltf,
+            gltf.accessors[uvs->second],
+            fastgltf::AccessorType::Vec2,
+            vertices,
+            [](syzygy::VertexPacked& vertex, glm::vec2 const& texcoord)
+        {
+            vertex.uv_x = texcoord.x;
+            vertex.uv_y = texcoord.y;
+        }
+        );
+    }
+
+    if (auto const* const colors{primitive.findAttribute("COLOR_0")};
+        colors != primitive.attributes.end())
+    {
+        copyAttribute<glm::vec4>(
+            gltf,
+            gltf.accessors[colors->second],
+            fastgltf::AccessorType::Vec4,
+            vertices,
+            [](syzygy::VertexPacked& vertex, glm::vec4 const& color)
+        { vertex.color = color; }
+        );
+    }
+}
+
+// glTF is +Y up, while the renderer is +Y down. Flips the positions and
+// normals, and bounds the flipped positions, in one pass. Each position and
+// normal is loaded as four floats along with the UV component after it, which
+// the flip leaves as is.
+auto flipYAndBound(std::span<syzygy::VertexPacked> const vertices)
+    -> syzygy::AABB
+{
+    static_assert(
+        offsetof(syzygy::VertexPacked, uv_x)
+        == offsetof(syzygy::VertexPacked, position) + sizeof(glm::vec3)
+    );
+    static_assert(
+        offsetof(syzygy::VertexPacked, uv_y)
+        == offsetof(syzygy::VertexPacked, normal) + sizeof(glm::vec3)
+    );
+
+    __m128 const flip{_mm_setr_ps(1.0F, -1.0F, 1.0F, 1.0F)};
+    __m128 minimum{_mm_set1_ps(std::numeric_limits<float>::max())};
+    __m128 maximum{_mm_set1_ps(std::numeric_limits<float>::lowest())};
+
+    for (syzygy::VertexPacked& vertex : vertices)
+    {
+        float* const positionUV{&vertex.position.x};
+        float* const normalUV{&vertex.normal.x};
+
+        __m128 const position{_mm_mul_ps(_mm_loadu_ps(positionUV), flip)};
+        _mm_storeu_ps(positionUV, position);
+        _mm_storeu_ps(normalUV, _mm_mul_ps(_mm_loadu_ps(normalUV), flip));
+
+        minimum = _mm_min_ps(minimum, position);
+        maximum = _mm_max_ps(maximum, position);
+    }
+
+    std::array<float, 4> minimumLanes{};
+    std::array<float, 4> maximumLanes{};
+    _mm_storeu_ps(minimumLanes.data(), minimum);
+    _mm_storeu_ps(maximumLanes.data(), maximum);
+
+    return syzygy::AABB::create(
+        glm::vec3{minimumLanes[0], minimumLanes[1], minimumLanes[2]},
+        glm::vec3{maximumLanes[0], maximumLanes[1], maximumLanes[2]}
+    );
+}
+
+// Bounds the vertices that the surface's indices reference, skipping any that
+// are out of bounds. The sphere is centered on the box, and only grows to the
+// furthest vertex rather than the box's corners.
+void boundSurface(
+    syzygy::CookedSurface& surface,
+    std::span<uint32_t const> const indices,
+    std::span<syzygy::VertexPacked const> const vertices
+)
+{
+    if (static_cast<size_t>(surface.firstIndex) + surface.indexCount
+        > indices.size())
+    {
+        return;
+    }
+    std::span<uint32_t const> const surfaceIndices{
+        indices.subspan(surface.firstIndex, surface.indexCount)
+    };
+
+    glm::vec3 minimum{std::numeric_limits<float>::max()};
+    glm::vec3 maximum{std::numeric_limits<float>::lowest()};
+    for (uint32_t const index : surfaceIndices)
+    {
+        if (index >= vertices.size())
+        {
+            continue;
+        }
+        minimum = glm::min(minimum, vertices[index].position);
+        maximum = glm::max(maximum, vertices[index].position);
+    }
+    if (minimum.x > maximum.x)
+    {
+        // No indices were in bounds.
+        return;
+    }
+
+    syzygy::AABB const bounds{syzygy::AABB::create(minimum, maximum)};
+
+    float radiusSquared{0.0F};
+    for (uint32_t const index : surfaceIndices)
+    {
+        if (index >= vertices.size())
+        {
+            continue;
+        }
+        glm::vec3 const offset{vertices[index].position - bounds.center};
+        radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+    }
+
+    surface.bounds = bounds;
+    surface.boundingSphere = syzygy::Sphere{
+        .center = bounds.center,
+        .radius = std::sqrt(radiusSquared),
+    };
+}
+
+struct MeshCookStatistics
+{
+    size_t weldedBytesSaved{0};
+    syzygy::VertexCacheStatistics before{};
+    syzygy::VertexCacheStatistics after{};
+    size_t lodLevelCount{0};
+};
+
+// The mesh's primitives are validated in order, then read in parallel into
+// their ranges of the mesh's indices and vertices.
+auto cookGLTFMesh(
+    fastgltf::Asset const& gltf,
+    fastgltf::Mesh const& mesh,
+    syzygy::VertexWeldTolerance const weldTolerance,
+    syzygy::ThreadPool& workers,
+    MeshCookStatistics& statistics
+) -> syzygy::CookedGLTFMesh
+{
+    syzygy::CookedGLTFMesh newMesh{.name = std::string{mesh.name}};
+
+    std::vector<syzygy::CookedSurface> surfaces{};
+    std::vector<PrimitiveRange> ranges{};
+    size_t indexCount{0};
+    size_t vertexCount{0};
+    for (fastgltf::Primitive const& primitive : mesh.primitives)
+    {
+        bool const indexed{primitive.indicesAccessor.has_value()};
+        if (indexed
+            && primitive.indicesAccessor.value() >= gltf.accessors.size())
+        {
+            SZG_WARNING("glTF mesh primitive had no valid indices "
+                        "accessor. It will be skipped.");
+            continue;
+        }
+        auto const* const positionAttribute{primitive.findAttribute("POSITION")
+        };
+        if (positionAttribute == primitive.attributes.end()
+            || positionAttribute == nullptr
+            || positionAttribute->second >= gltf.accessors.size())
+        {
+            SZG_WARNING("glTF mesh primitive had no valid vertices "
+                        "accessor. It will be skipped.");
+            continue;
+        }
+
+        if (primitive.type != fastgltf::PrimitiveType::Triangles)
+        {
+            SZG_WARNING("Loading glTF mesh primitive as Triangles mode "
+                        "when it is not.");
+        }
+
+        size_t const primitiveVertexCount{
+            gltf.accessors[positionAttribute->second].count
+        };
+        size_t const primitiveIndexCount{
+            indexed ? gltf.accessors[primitive.indicesAccessor.value()].count
+                    : primitiveVertexCount
+        };
+
+        syzygy::CookedSurface& surface{surfaces.emplace_back(
+            syzygy::CookedSurface{
+                .firstIndex = static_cast<uint32_t>(indexCount),
+                .indexCount = static_cast<uint32_t>(primitiveIndexCount),
+                .materialIndex = syzygy::CookedSurface::DEFAULT_MATERIAL,
+            }
+        )};
+
+        // Out of bounds materials are left for the loader to replace, the
+        // same as missing ones.
+        if (!primitive.materialIndex.has_value())
+        {
+            SZG_WARNING(
+                "Mesh {} has a primitive that is missing material index.",
+                mesh.name
+            );
+        }
+        else
+        {
+            surface.materialIndex =
+                static_cast<int32_t>(primitive.materialIndex.value());
+        }
+
+        ranges.push_back(PrimitiveRange{
+            .primitive = &primitive,
+            .firstIndex = indexCount,
+            .indexCount = primitiveIndexCount,
+            .firstVertex = vertexCount,
+            .vertexCount = primitiveVertexCount,
+        });
+        indexCount += primitiveIndexCount;
+        vertexCount += primitiveVertexCount;
+    }
+
+    if (surfaces.empty())
+    {
+        return newMesh;
+    }
+
+    std::vector<uint32_t> indices(indexCount);
+    std::vector<syzygy::VertexPacked> vertices(vertexCount);
+    workers.parallelFor(
+        ranges.size(),
+        [&](size_t const index)
+    { readPrimitive(gltf, ranges[index], indices, vertices); }
+    );
+
+    if (std::optional<syzygy::VertexWelding> const welding{
+            syzygy::VertexWelding::weld(weldTolerance, indices, vertices)
+        };
+        welding.has_value() && welding.value().bytesSaved() > 0)
+    {
+        SZG_INFO(
+            "Welded mesh {} from {} to {} vertices, saving {} bytes.",
+            mesh.name,
+            welding.value().vertexCount,
+            welding.value().weldedVertexCount,
+            welding.value().bytesSaved()
+        );
+        statistics.weldedBytesSaved += welding.value().bytesSaved();
+    }
+
+    // Before flipping, which would reverse the winding.
+    syzygy::MeshLodChain lodChain{};
+    if (std::optional<syzygy::MeshOptimization> const optimization{
+            syzygy::MeshOptimization::optimize(surfaces, indices, vertices)
+        };
+        optimization.has_value())
+    {
+        statistics.before += optimization.value().before;
+        statistics.after += optimization.value().after;
+
+        // After optimizing, since the levels share the final vertices.
+        lodChain = syzygy::MeshLodChain::build(surfaces, indices, vertices);
+        statistics.lodLevelCount += lodChain.levelCount();
+    }
+    else
+    {
+        SZG_WARNING(
+            "Mesh {} has out of bounds indices, so it will not be "
+            "optimized.",
+            mesh.name
+        );
+    }
+
+    newMesh.bounds = flipYAndBound(vertices);
+    for (syzygy::CookedSurface& surface : surfaces)
+    {
+        boundSurface(surface, indices, vertices);
+    }
+    for (syzygy::CookedSurface& surface : lodChain.surfaces)
+    {
+        boundSurface(surface, indices, vertices);
+    }
+
+    newMesh.surfaces = std::move(surfaces);
+    newMesh.indices = std::move(indices);
+    newMesh.vertices = std::move(vertices);
+    newMesh.lodChain = std::move(lodChain);
+
+    return newMesh;
+}
+
+// A file's content hash, remembered under its signature. The magic changes
+// with ContentHash, so that hashes from an older algorithm are not reused.
+struct HashMemo
+{
+    static uint64_t constexpr MAGIC{0x3148534148475A53ULL}; // "SZGHASH1"
+
+    uint64_t magic{MAGIC};
+    uint64_t signature{0};
+    uint64_t contentHash{0};
+};
+
+auto hashMemoPath(uint64_t const signature) -> std::filesystem::path
+{
+    return syzygy::cookedAssetDirectory("hashes")
+         / fmt::format("{:016x}.hash", signature);
+}
+
+auto loadHashMemo(uint64_t const signature) -> std::optional<uint64_t>
+{
+    std::ifstream file{hashMemoPath(signature), std::ios::binary};
+    HashMemo memo{};
+    if (!file.read(reinterpret_cast<char*>(&memo), sizeof(HashMemo))
+        || memo.magic != HashMemo::MAGIC || memo.signature != signature)
+    {
+        return std::nullopt;
+    }
+    return memo.contentHash;
+}
+
+// Failing to store the memo only means the file is read again next time.
+void storeHashMemo(uint64_t const signature, uint64_t const contentHash)
+{
+    std::filesystem::path const path{hashMemoPath(signature)};
+
+    std::error_code error{};
+    std::filesystem::create_directories(path.parent_path(), error);
+    if (error)
+    {
+        return;
+    }
+
+    // Decode workers may hash the same file at once, so each writes its own
+    // temporary file.
+    std::filesystem::path temporaryPath{path};
+    temporaryPath += fmt::format(
+        ".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id())
+    );
+
+    {
+        HashMemo const memo{
+            .signature = signature,
+            .contentHash = contentHash,
+        };
+        std::ofstream file{temporaryPath, std::ios::binary | std::ios::trunc};
+        if (!file.write(
+                reinterpret_cast<char const*>(&memo), sizeof(HashMemo)
+            ))
+        {
+            file.close();
+            std::filesystem::remove(temporaryPath, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temporaryPath, error);
+    }
+}
+} // namespace
+
+namespace syzygy
+{
+auto cookedAssetDirectory(std::string const& kind) -> std::filesystem::path
+{
+    std::error_code error{};
+    std::filesystem::path const temporaryDirectory{
+        std::filesystem::temp_directory_path(error)
+    };
+    if (error)
+    {
+        return ensureAbsolutePath(std::filesystem::path{"cache"} / kind);
+    }
+
+    return temporaryDirectory / "syzygy" / kind;
+}
+
+auto fileSignature(std::filesystem::path const& path)
+    -> std::optional<uint64_t>
+{
+    std::filesystem::path const absolutePath{ensureAbsolutePath(path)};
+
+    std::error_code error{};
+    uint64_t const size{std::filesystem::file_size(absolutePath, error)};
+    if (error)
+    {
+        return std::nullopt;
+    }
+    int64_t const lastWrite{
+        std::filesystem::last_write_time(absolutePath, error)
+            .time_since_epoch()
+            .count()
+    };
+    if (error)
+    {
+        return std::nullopt;
+    }
+
+    std::string const pathString{absolutePath.string()};
+    uint64_t signature{ContentHash::hash(std::span<uint8_t const>{
+        reinterpret_cast<uint8_t const*>(pathString.data()), pathString.size()
+    })};
+    signature = ContentHash::hash(
+        std::span<uint8_t const>{
+            reinterpret_cast<uint8_t const*>(&size), sizeof(size)
+        },
+        signature
+    );
+    signature = ContentHash::hash(
+        std::span<uint8_t const>{
+            reinterpret_cast<uint8_t const*>(&lastWrite), sizeof(lastWrite)
+        },
+        signature
+    );
+    return signature;
+}
+
+auto hashFile(std::filesystem::path const& path) -> std::optional<uint64_t>
+{
+    std::optional<uint64_t> const signature{fileSignature(path)};
+    if (signature.has_value())
+    {
+        if (std::optional<uint64_t> const memo{
+                loadHashMemo(signature.value())
+            };
+            memo.has_value())
+        {
+            return memo;
+        }
+    }
+
+    std::optional<MappedFile> const file{MappedFile::open(
+        ensureAbsolutePath(path), MappedFile::AccessPattern::Sequential
+    )};
+    if (!file.has_value())
+    {
+        return std::nullopt;
+    }
+
+    uint64_t const contentHash{ContentHash::hash(file.value().bytes())};
+    if (signature.has_value())
+    {
+        storeHashMemo(signature.value(), contentHash);
+    }
+    return contentHash;
+}
+
+auto DecodedRGBA::extent() const -> VkExtent2D
+{
+    return VkExtent2D{.width = x, .height = y};
+}
+
+auto DecodedRGBA::bytes() const -> std::span<uint8_t>
+{
+    uint32_t constexpr RGBA_BYTES{4};
+    return std::span<uint8_t>{
+        texels.get(), static_cast<size_t>(x) * y * RGBA_BYTES
+    };
+}
+
+auto decodeRGBA(std::span<uint8_t const> const bytes)
+    -> std::optional<DecodedRGBA>
+{
+    int32_t x{0};
+    int32_t y{0};
+
+    int32_t components{0};
+    uint16_t constexpr RGBA_COMPONENT_COUNT{4};
+
+    DecodedRGBA image{};
+    image.texels.reset(stbi_load_from_memory(
+        bytes.data(),
+        static_cast<int32_t>(bytes.size()),
+        &x,
+        &y,
+        &components,
+        RGBA_COMPONENT_COUNT
+    ));
+
+    if (image.texels == nullptr)
+    {
+        SZG_ERROR("stbi: Failed to convert image.");
+        return std::nullopt;
+    }
+
+    if (x < 1 || y < 1)
+    {
+        SZG_ERROR(fmt::format(
+            "stbi: Parsed image had invalid dimensions: ({},{})", x, y
+        ));
+        return std::nullopt;
+    }
+
+    image.x = static_cast<uint32_t>(x);
+    image.y = static_cast<uint32_t>(y);
+
+    return image;
+}
+
+auto GLTFMaterialTextures::parse(fastgltf::Material const& material)
+    -> GLTFMaterialTextures
+{
+    MaterialTextureIndices const indices{parseMaterialIndices(material)};
+
+    GLTFMaterialTextures textures{};
+
+    if (indices.roughnessMetallic.has_value() || indices.occlusion.has_value())
+    {
+        GLTFTextureCook& ORM{textures.ORM.emplace(GLTFTextureCook{
+            .encoding = TextureEncoding::OcclusionRoughnessMetallic,
+        })};
+
+        if (indices.occlusion.has_value()
+            && indices.occlusion != indices.roughnessMetallic)
+        {
+            SZG_WARNING(
+                "Material {}: occlusion and roughnessMetallic textures differ. "
+                "Loading roughnessMetallic and overriding its occlusion "
+                "channel.",
+                material.name
+            );
+        }
+
+        if (indices.roughnessMetallic.has_value())
+        {
+            ORM.textureIndex = indices.roughnessMetallic.value();
+            ORM.overrides.red = std::numeric_limits<uint8_t>::max();
+        }
+        else
+        {
+            ORM.textureIndex = indices.occlusion.value();
+            ORM.overrides.green = 0U;
+            ORM.overrides.blue = 0U;
+        }
+    }
+
+    if (indices.color.has_value())
+    {
+        textures.color = GLTFTextureCook{
+            .textureIndex = indices.color.value(),
+            .encoding = TextureEncoding::Color,
+        };
+    }
+
+    if (indices.normal.has_value())
+    {
+        textures.normal = GLTFTextureCook{
+            .textureIndex = indices.normal.value(),
+            .encoding = TextureEncoding::Normal,
+        };
+    }
+
+    return textures;
+}
+
+auto CookedGLTFMesh::source() const -> CookedMeshSource
+{
+    return CookedMeshSource{
+        .name = name,
+        .bounds = bounds,
+        .surfaces = surfaces,
+        .vertices = vertices,
+        .indices = indices,
+        .lodSurfaces = lodChain.surfaces,
+        .lodErrors = lodChain.errors,
+    };
+}
+
+auto loadGLTFAsset(std::filesystem::path const& path, bool const loadBuffers)
+    -> fastgltf::Expected<fastgltf::Asset>
+{
+    std::filesystem::path const assetPath{ensureAbsolutePath(path)};
+
+    fastgltf::GltfDataBuffer data;
+    data.loadFromFile(assetPath);
+
+    // Images are never loaded by fastgltf, so we have access to their URIs.
+    fastgltf::Options const gltfOptions{
+        loadBuffers ? fastgltf::Options::LoadGLBBuffers
+                          | fastgltf::Options::LoadExternalBuffers
+                    : fastgltf::Options::None
+    };
+
+    // KTX2 images are only referenced through this extension, since they are
+    // not a core image format.
+    fastgltf::Parser parser{fastgltf::Extensions::KHR_texture_basisu};
+
+    if (assetPath.extension() == ".gltf")
+    {
+        return parser.loadGltfJson(&data, assetPath.parent_path(), gltfOptions);
+    }
+
+    return parser.loadGltfBinary(&data, assetPath.parent_path(), gltfOptions);
+}
+
+auto collectGLTFBufferDependencies(
+    fastgltf::Asset const& gltf, std::filesystem::path const& assetRoot
+) -> std::optional<std::vector<CookedDependency>>
+{
+    std::vector<CookedDependency> dependencies{};
+    for (fastgltf::Buffer const& buffer : gltf.buffers)
+    {
+        // Other sources are embedded in the glTF itself, and are covered by
+        // its hash.
+        auto const* const uri{std::get_if<fastgltf::sources::URI>(&buffer.data)
+        };
+        if (uri == nullptr)
+        {
+            continue;
+        }
+        if (!uri->uri.isLocalPath())
+        {
+            return std::nullopt;
+        }
+
+        std::optional<CookedDependency> dependency{CookedDependency::fromFile(
+            assetRoot, uri->uri.fspath().string()
+        )};
+        if (!dependency.has_value())
+        {
+            return std::nullopt;
+        }
+        dependencies.push_back(std::move(dependency).value());
+    }
+
+    return dependencies;
+}
+
+auto GLTFExternalFiles::collect(
+    fastgltf::Asset const& gltf, std::filesystem::path const& assetRoot
+) -> GLTFExternalFiles
+{
+    auto const localPath{[&](auto const& source
+                         ) -> std::optional<std::filesystem::path>
+    {
+        auto const* const uri{std::get_if<fastgltf::sources::URI>(&source)};
+        if (uri == nullptr || !uri->uri.isLocalPath())
+        {
+            return std::nullopt;
+        }
+        return assetRoot / uri->uri.fspath();
+    }};
+
+    GLTFExternalFiles files{};
+    for (fastgltf::Buffer const& buffer : gltf.buffers)
+    {
+        if (std::optional<std::filesystem::path> path{localPath(buffer.data)};
+            path.has_value())
+        {
+            files.buffers.push_back(std::move(path).value());
+        }
+    }
+    for (fastgltf::Image const& image : gltf.images)
+    {
+        if (std::optional<std::filesystem::path> path{localPath(image.data)};
+            path.has_value())
+        {
+            files.images.push_back(std::move(path).value());
+        }
+    }
+
+    return files;
+}
+
+auto gltfTextureSources(fastgltf::Asset const& gltf)
+    -> std::vector<std::optional<std::reference_wrapper<fastgltf::Image const>>>
+{
+    std::vector<std::optional<std::reference_wrapper<fastgltf::Image const>>>
+        textureSourcesByGLTFIndex{};
+    textureSourcesByGLTFIndex.reserve(gltf.textures.size());
+    for (fastgltf::Texture const& texture : gltf.textures)
+    {
+        textureSourcesByGLTFIndex.emplace_back(std::nullopt);
+        auto& sourceImage{textureSourcesByGLTFIndex.back()};
+
+        // The KTX2 image is preferred, with the core image being a fallback
+        // for viewers without the extension.
+        std::optional<size_t> imageIndex{};
+        if (texture.basisuImageIndex.has_value())
+        {
+            imageIndex = texture.basisuImageIndex.value();
+        }
+        else if (texture.imageIndex.has_value())
+        {
+            imageIndex = texture.imageIndex.value();
+        }
+
+        if (!imageIndex.has_value())
+        {
+            SZG_WARNING("Texture {} was missing imageIndex.", texture.name);
+            continue;
+        }
+
+        size_t const loadedIndex{imageIndex.value()};
+
+        if (loadedIndex >= gltf.images.size())
+        {
+            SZG_WARNING(
+                "Texture {} had imageIndex that was out of bounds.",
+                texture.name
+            );
+            continue;
+        }
+
+        sourceImage = gltf.images[loadedIndex];
+    }
+
+    return textureSourcesByGLTFIndex;
+}
+
+auto accessGLTFTexture(
+    std::span<std::optional<std::reference_wrapper<fastgltf::Image const>>>
+        textureSourcesByGLTFIndex,
+    size_t const textureIndex
+) -> std::optional<std::reference_wrapper<fastgltf::Image const>>
+{
+    if (textureIndex >= textureSourcesByGLTFIndex.size())
+    {
+        SZG_WARNING("Out of bounds texture index.");
+        return std::nullopt;
+    }
+
+    if (!textureSourcesByGLTFIndex[textureIndex].has_value())
+    {
+        SZG_WARNING("Texture index source was not loaded.");
+        return std::nullopt;
+    }
+
+    return textureSourcesByGLTFIndex[textureIndex].value().get();
+}
+
+auto hashGLTFImageSource(
+    fastgltf::Image const& image, std::filesystem::path const& assetRoot
+) -> std::optional<uint64_t>
+{
+    if (std::holds_alternative<fastgltf::sources::Array>(image.data))
+    {
+        return ContentHash::hash(
+            std::get<fastgltf::sources::Array>(image.data).bytes
+        );
+    }
+
+    if (std::holds_alternative<fastgltf::sources::URI>(image.data))
+    {
+        fastgltf::sources::URI const& uri{
+            std::get<fastgltf::sources::URI>(image.data)
+        };
+        if (!uri.uri.isLocalPath())
+        {
+            return std::nullopt;
+        }
+
+        return hashFile(assetRoot / uri.uri.fspath());
+    }
+
+    return std::nullopt;
+}
+
+auto gltfImageSignature(
+    fastgltf::Image const& image,
+    size_t const imageIndex,
+    uint64_t const gltfSignature,
+    std::filesystem::path const& assetRoot
+) -> std::optional<uint64_t>
+{
+    if (std::holds_alternative<fastgltf::sources::URI>(image.data))
+    {
+        fastgltf::sources::URI const& uri{
+            std::get<fastgltf::sources::URI>(image.data)
+        };
+        if (!uri.uri.isLocalPath())
+        {
+            return std::nullopt;
+        }
+
+        return fileSignature(assetRoot / uri.uri.fspath());
+    }
+
+    if (std::holds_alternative<fastgltf::sources::Array>(image.data))
+    {
+        return ContentHash::hash(
+            std::span<uint8_t const>{
+                reinterpret_cast<uint8_t const*>(&imageIndex),
+                sizeof(imageIndex)
+            },
+            gltfSignature
+        );
+    }
+
+    return std::nullopt;
+}
+
+auto cookedTextureKey(
+    uint64_t const sourceHash,
+    ImageChannelOverrides const overrides,
+    TextureEncoding const encoding
+) -> uint64_t
+{
+    std::array<uint8_t, 9> const parameters{
+        static_cast<uint8_t>(encoding),
+        static_cast<uint8_t>(overrides.red.has_value()),
+        overrides.red.value_or(0),
+        static_cast<uint8_t>(overrides.green.has_value()),
+        overrides.green.value_or(0),
+        static_cast<uint8_t>(overrides.blue.has_value()),
+        overrides.blue.value_or(0),
+        static_cast<uint8_t>(overrides.alpha.has_value()),
+        overrides.alpha.value_or(0),
+    };
+
+    return ContentHash::hash(parameters, sourceHash);
+}
+
+auto cookedMeshKey(
+    uint64_t const sourceHash, VertexWeldTolerance const weldTolerance
+) -> uint64_t
+{
+    std::array<float, 3> const parameters{
+        weldTolerance.position, weldTolerance.normal, weldTolerance.uv
+    };
+
+    return ContentHash::hash(
+        std::span<uint8_t const>{
+            reinterpret_cast<uint8_t const*>(parameters.data()),
+            sizeof(parameters)
+        },
+        sourceHash
+    );
+}
+
+auto cookGLTFImage(
+    fastgltf::Image const& image,
+    ImageChannelOverrides const overrides,
+    std::filesystem::path const& assetRoot,
+    TextureEncoding const encoding,
+    std::filesystem::path const& cacheDirectory,
+    uint64_t const key
+) -> std::optional<std::tuple<CookedTexture, std::filesystem::path>>
+{
+    // The source is only read if the texture was not cooked before.
+    if (std::optional<CookedTexture> cached{
+            CookedTexture::load(cacheDirectory, key)
+        };
+        cached.has_value())
+    {
+        std::optional<std::filesystem::path> sourcePath{
+            gltfImageSourcePath(image, assetRoot)
+        };
+        if (!sourcePath.has_value())
+        {
+            return std::nullopt;
+        }
+        return std::tuple{
+            std::move(cached).value(), std::move(sourcePath).value()
+        };
+    }
+
+    std::optional<GLTFImageSource> sourceResult{
+        loadGLTFImageSource(image, assetRoot)
+    };
+    if (!sourceResult.has_value())
+    {
+        SZG_WARNING("Failed to load image from glTF.");
+        return std::nullopt;
+    }
+    GLTFImageSource& source{sourceResult.value()};
+
+    // KTX2 images from KHR_texture_basisu are already block compressed, or
+    // transcoded straight into blocks.
+    if (CookedTexture::isKTX2(source.bytes))
+    {
+        if (overrides.red.has_value() || overrides.green.has_value()
+            || overrides.blue.has_value() || overrides.alpha.has_value())
+        {
+            SZG_WARNING("Channel overrides cannot be applied to KTX2 images, "
+                        "they are ignored.");
+        }
+
+        std::optional<CookedTexture> ktx2Result{
+            CookedTexture::readKTX2(source.bytes, encoding)
+        };
+        if (!ktx2Result.has_value())
+        {
+            SZG_WARNING("Failed to load KTX2 image from glTF.");
+            return std::nullopt;
+        }
+        if (ktx2Result.value().arrayLayers() != 1)
+        {
+            SZG_WARNING(
+                "KTX2 image from glTF has {} array layers, but glTF textures "
+                "must have one.",
+                ktx2Result.value().arrayLayers()
+            );
+            return std::nullopt;
+        }
+
+        if (!ktx2Result.value().store(cacheDirectory, key))
+        {
+            SZG_WARNING("Failed to cache cooked texture, it will be cooked "
+                        "again next time.");
+        }
+
+        return std::tuple{
+            std::move(ktx2Result).value(), std::move(source.path)
+        };
+    }
+
+    // Throw the file to stbi and hope for the best, it should detect the
+    // file headers properly
+    std::optional<DecodedRGBA> imageResult{decodeRGBA(source.bytes)};
+    if (!imageResult.has_value())
+    {
+        SZG_WARNING("Failed to load image from glTF.");
+        return std::nullopt;
+    }
+    DecodedRGBA const& decoded{imageResult.value()};
+    applyChannelOverrides(decoded.bytes(), overrides);
+
+    CookedTexture cooked{
+        CookedTexture::encode(encoding, decoded.bytes(), decoded.x, decoded.y)
+    };
+    if (!cooked.store(cacheDirectory, key))
+    {
+        SZG_WARNING("Failed to cache cooked texture, it will be cooked again "
+                    "next time.");
+    }
+
+    return std::tuple{std::move(cooked), std::move(source.path)};
+}
+
+auto cookGLTFMeshes(
+    fastgltf::Asset const& gltf,
+    VertexWeldTolerance const weldTolerance,
+    ThreadPool& workers
+) -> std::vector<CookedGLTFMesh>
+{
+    std::vector<CookedGLTFMesh> newMeshes(gltf.meshes.size());
+    std::vector<MeshCookStatistics> meshStatistics(gltf.meshes.size());
+    workers.parallelFor(
+        gltf.meshes.size(),
+        [&](size_t const index)
+    {
+        newMeshes[index] = cookGLTFMesh(
+            gltf,
+            gltf.meshes[index],
+            weldTolerance,
+            workers,
+            meshStatistics[index]
+        );
+    }
+    );
+
+    size_t weldedBytesSaved{0};
+    VertexCacheStatistics statisticsBefore{};
+    VertexCacheStatistics statisticsAfter{};
+    size_t lodLevelCount{0};
+    for (MeshCookStatistics const& statistics : meshStatistics)
+    {
+        weldedBytesSaved += statistics.weldedBytesSaved;
+        statisticsBefore += statistics.before;
+        statisticsAfter += statistics.after;
+        lodLevelCount += statistics.lodLevelCount;
+    }
+
+    SZG_INFO(
+        "Optimized {} triangles for a {} entry vertex cache. ACMR {:.3f} -> "
+        "{:.3f}, ATVR {:.3f} -> {:.3f}",
+        statisticsAfter.triangleCount,
+        MeshOptimization::CACHE_SIZE,
+        statisticsBefore.acmr(),
+        statisticsAfter.acmr(),
+        statisticsBefore.atvr(),
+        statisticsAfter.atvr()
+    );
+    SZG_INFO(
+        "Simplified {} meshes into {} levels of detail.",
+        newMeshes.size(),
+        lodLevelCount
+    );
+    SZG_INFO(
+        "Welding vertices saved {} bytes across {} meshes.",
+        weldedBytesSaved,
+        newMeshes.size()
+    );
+
+    return newMeshes;
+}
+} // namespace syzygy
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "syzygy/assets/meshcache.hpp"
+#include "syzygy/assets/meshsimplification.hpp"
+#include "syzygy/assets/texturecache.hpp"
+#include "syzygy/assets/vertexwelding.hpp"
+#include "syzygy/geometry/geometrytypes.hpp"
+#include "syzygy/platform/filesystemutils.hpp"
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/platform/vulkanusage.hpp"
+#include "syzygy/renderer/gputypes.hpp"
+#include <fastgltf/core.hpp>
+#include <fastgltf/types.hpp>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stb/stb_image.h>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// The CPU side of the asset pipeline, which reads source files and cooks them
+// into the cached formats of MeshCacheFile and CookedTexture. Nothing here
+// needs a device, so it is shared by the editor and the headless cooker, which
+// must agree on how assets are cooked and keyed to share a cache.
+
+namespace syzygy
+{
+struct ThreadPool;
+} // namespace syzygy
+
+namespace syzygy
+{
+// Where cooked assets of one kind, such as "meshes", are cached between runs.
+auto cookedAssetDirectory(std::string const& kind) -> std::filesystem::path;
+
+// Identifies a file by its absolute path, size and last write time, without
+// reading it. Copies of a file have different signatures, so this is for
+// cheap lookups on the main thread, not cache keys.
+auto fileSignature(std::filesystem::path const& path)
+    -> std::optional<uint64_t>;
+
+// The hash of the file's content. It is remembered in the cache under the
+// file's signature, so unchanged files are not read again.
+auto hashFile(std::filesystem::path const& path) -> std::optional<uint64_t>;
+
+// Texels decoded by stbi, kept in the buffer stbi allocated for them rather
+// than copied out.
+struct DecodedRGBA
+{
+    uint32_t x{0};
+    uint32_t y{0};
+    std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> texels{
+        nullptr, &stbi_image_free
+    };
+
+    [[nodiscard]] auto extent() const -> VkExtent2D;
+    [[nodiscard]] auto bytes() const -> std::span<uint8_t>;
+};
+
+// Decodes any format stbi supports, such as PNG, into 8-bit RGBA.
+auto decodeRGBA(std::span<uint8_t const> bytes) -> std::optional<DecodedRGBA>;
+
+// Constants that replace channels of an image when it is cooked.
+struct ImageChannelOverrides
+{
+    std::optional<uint8_t> red{};
+    std::optional<uint8_t> green{};
+    std::optional<uint8_t> blue{};
+    std::optional<uint8_t> alpha{};
+};
+
+// How one of a glTF material's textures is cooked.
+struct GLTFTextureCook
+{
+    size_t textureIndex{0};
+    ImageChannelOverrides overrides{};
+    TextureEncoding encoding{};
+};
+
+// A glTF material's textures organized into syzygy's material format, where
+// the material has them.
+struct GLTFMaterialTextures
+{
+    std::optional<GLTFTextureCook> color{};
+    std::optional<GLTFTextureCook> normal{};
+    // Occlusion, roughness and metallic are packed into one texture. Channels
+    // that the material is missing are overridden.
+    std::optional<GLTFTextureCook> ORM{};
+
+    static auto parse(fastgltf::Material const& material)
+        -> GLTFMaterialTextures;
+};
+
+// A mesh cooked from a glTF, in the layout that MeshCacheFile stores. Surfaces
+// reference materials by their glTF index. Meshes that failed to load have no
+// surfaces.
+struct CookedGLTFMesh
+{
+    std::string name{};
+    AABB bounds{};
+    std::vector<CookedSurface> surfaces{};
+    std::vector<uint32_t> indices{};
+    std::vector<VertexPacked> vertices{};
+    MeshLodChain lodChain{};
+
+    // Points into this mesh, which must outlive the result.
+    [[nodiscard]] auto source() const -> CookedMeshSource;
+};
+
+// Without buffers, only the JSON is parsed and buffers are left as their URIs.
+// That is enough for materials, but not geometry.
+auto loadGLTFAsset(std::filesystem::path const& path, bool loadBuffers)
+    -> fastgltf::Expected<fastgltf::Asset>;
+
+// The external files that a glTF's geometry is read from. Returns nullopt if
+// any buffer is somewhere that cannot be checked for changes, in which case
+// the geometry should not be cooked.
+auto collectGLTFBufferDependencies(
+    fastgltf::Asset const& gltf, std::filesystem::path const& assetRoot
+) -> std::optional<std::vector<CookedDependency>>;
+
+// The local files that a glTF's buffers and images are read from, other than
+// the glTF itself.
+struct GLTFExternalFiles
+{
+    std::vector<std::filesystem::path> buffers{};
+    std::vector<std::filesystem::path> images{};
+
+    static auto collect(
+        fastgltf::Asset const& gltf, std::filesystem::path const& assetRoot
+    ) -> GLTFExternalFiles;
+};
+
+// The image of each of the glTF's textures, preserving glTF indexing. Empty
+// where the texture has no valid image.
+auto gltfTextureSources(fastgltf::Asset const& gltf)
+    -> std::vector<std::optional<std::reference_wrapper<fastgltf::Image const>>>;
+
+auto accessGLTFTexture(
+    std::span<std::optional<std::reference_wrapper<fastgltf::Image const>>>
+        textureSourcesByGLTFIndex,
+    size_t textureIndex
+) -> std::optional<std::reference_wrapper<fastgltf::Image const>>;
+
+// Hashes the encoded bytes of a glTF image without decoding them. External
+// images are mapped rather than read.
+auto hashGLTFImageSource(
+    fastgltf::Image const& image, std::filesystem::path const& assetRoot
+) -> std::optional<uint64_t>;
+
+// Like hashGLTFImageSource, but from the fileSignature of external images.
+// Embedded images are identified by their index and the glTF's signature.
+auto gltfImageSignature(
+    fastgltf::Image const& image,
+    size_t imageIndex,
+    uint64_t gltfSignature,
+    std::filesystem::path const& assetRoot
+) -> std::optional<uint64_t>;
+
+// Identifies a cooked texture by the hash of its source bytes, and everything
+// else that changes the cooked result. This is both the key of the cooked file,
+// and the texture's content hash in the asset library.
+auto cookedTextureKey(
+    uint64_t sourceHash,
+    ImageChannelOverrides overrides,
+    TextureEncoding encoding
+) -> uint64_t;
+
+// Identifies cooked meshes by the hash of their source file, and the weld
+// tolerance that changes the cooked geometry.
+auto cookedMeshKey(uint64_t sourceHash, VertexWeldTolerance weldTolerance)
+    -> uint64_t;
+
+// Reads the block-compressed texture from the cache if it was cooked before.
+// Otherwise, decodes and encodes it, then adds it to the cache. KTX2 images
+// are read or transcoded as CookedTexture::readKTX2 does instead, without the
+// overrides. Also returns the path the image was read from.
+auto cookGLTFImage(
+    fastgltf::Image const& image,
+    ImageChannelOverrides overrides,
+    std::filesystem::path const& assetRoot,
+    TextureEncoding encoding,
+    std::filesystem::path const& cacheDirectory,
+    uint64_t key
+) -> std::optional<std::tuple<CookedTexture, std::filesystem::path>>;
+
+// Welds, optimizes and simplifies every mesh of the glTF, whose buffers must be
+// loaded. Preserves glTF indexing.
+//
+// Meshes, and the primitives within each mesh, are cooked in parallel on the
+// workers. This may be called from one of the workers' own jobs.
+auto cookGLTFMeshes(
+    fastgltf::Asset const& gltf,
+    VertexWeldTolerance weldTolerance,
+    ThreadPool& workers
+) -> std::vector<CookedGLTFMesh>;
+} // namespace syzygy
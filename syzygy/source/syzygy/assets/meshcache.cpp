@@ -0,0 +1,591 @@
+#include "meshcache.hpp"
+
+#include "syzygy/assets/meshsimplification.hpp"
+#include "syzygy/core/log.hpp"
+#include "syzygy/platform/filesystemutils.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <glm/vec3.hpp>
+#include <spdlog/fmt/bundled/core.h>
+#include <system_error>
+#include <utility>
+
+namespace
+{
+// "SZGM", read as a little-endian integer.
+uint32_t constexpr MAGIC{0x4D475A53};
+
+// Geometry is aligned for copying and reading in place from the mapping.
+uint64_t constexpr DATA_ALIGNMENT{16};
+
+// Layout of the file:
+//  FileHeader
+//  DependencyRecord[dependencyCount]
+//  MeshRecord[meshCount]
+//  CookedSurface[surfaceCount], of each mesh's surfaces followed by the
+//  surfaces of its levels of detail
+//  char[stringBytes], of dependency paths and mesh names
+//  Per mesh, VertexPacked[vertexCount] then uint32_t[indexCount], each
+//  aligned to DATA_ALIGNMENT
+struct FileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceHash;
+    uint64_t fileSize;
+    uint32_t dependencyCount;
+    uint32_t meshCount;
+    uint32_t surfaceCount;
+    uint32_t stringBytes;
+};
+static_assert(sizeof(FileHeader) == 40ULL);
+
+struct DependencyRecord
+{
+    uint64_t sizeBytes;
+    int64_t lastWriteTicks;
+    uint32_t pathOffset;
+    uint32_t pathLength;
+};
+static_assert(sizeof(DependencyRecord) == 24ULL);
+
+struct MeshRecord
+{
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t firstSurface;
+    uint32_t surfaceCount;
+    uint64_t vertexOffset;
+    uint64_t vertexCount;
+    uint64_t indexOffset;
+    uint64_t indexCount;
+    glm::vec3 boundsCenter;
+    glm::vec3 boundsHalfExtent;
+    uint32_t lodCount;
+    std::array<float, syzygy::MeshLodChain::MAX_LEVELS> lodErrors;
+    uint32_t padding;
+};
+static_assert(sizeof(MeshRecord) == 96ULL);
+
+static_assert(sizeof(syzygy::CookedSurface) == 52ULL);
+
+auto alignUp(uint64_t const position, uint64_t const alignment) -> uint64_t
+{
+    return (position + alignment - 1) / alignment * alignment;
+}
+
+// Byte offsets of each table, which directly follow the header in order.
+struct TableOffsets
+{
+    uint64_t dependencies;
+    uint64_t meshes;
+    uint64_t surfaces;
+    uint64_t strings;
+    uint64_t end;
+
+    static auto fromHeader(FileHeader const& header) -> TableOffsets
+    {
+        TableOffsets offsets{};
+        offsets.dependencies = sizeof(FileHeader);
+        offsets.meshes = offsets.dependencies
+                       + header.dependencyCount * sizeof(DependencyRecord);
+        offsets.surfaces =
+            offsets.meshes + header.meshCount * sizeof(MeshRecord);
+        offsets.strings = offsets.surfaces
+                        + header.surfaceCount * sizeof(syzygy::CookedSurface);
+        offsets.end = offsets.strings + header.stringBytes;
+        return offsets;
+    }
+};
+
+template <typename T>
+auto readRecord(std::span<uint8_t const> const bytes, uint64_t const offset)
+    -> T
+{
+    T record{};
+    std::memcpy(&record, bytes.subspan(offset, sizeof(T)).data(), sizeof(T));
+    return record;
+}
+
+// Checks that [offset, offset + count * elementSize) lies within the file.
+auto rangeInBounds(
+    uint64_t const fileSize,
+    uint64_t const offset,
+    uint64_t const count,
+    uint64_t const elementSize
+) -> bool
+{
+    if (offset > fileSize)
+    {
+        return false;
+    }
+    return count <= (fileSize - offset) / elementSize;
+}
+
+void writeBytes(
+    std::ofstream& file, uint64_t& position, void const* data, size_t size
+)
+{
+    file.write(
+        static_cast<char const*>(data), static_cast<std::streamsize>(size)
+    );
+    position += size;
+}
+
+void writePadding(std::ofstream& file, uint64_t& position, uint64_t alignment)
+{
+    std::array<char, DATA_ALIGNMENT> constexpr ZEROES{};
+    uint64_t const padding{alignUp(position, alignment) - position};
+    writeBytes(file, position, ZEROES.data(), padding);
+}
+} // namespace
+
+namespace syzygy
+{
+auto CookedDependency::fromFile(
+    std::filesystem::path const& sourceDirectory,
+    std::string const& relativePath
+) -> std::optional<CookedDependency>
+{
+    std::filesystem::path const path{sourceDirectory / relativePath};
+
+    std::error_code error{};
+    uintmax_t const sizeBytes{std::filesystem::file_size(path, error)};
+    if (error)
+    {
+        return std::nullopt;
+    }
+    std::filesystem::file_time_type const lastWrite{
+        std::filesystem::last_write_time(path, error)
+    };
+    if (error)
+    {
+        return std::nullopt;
+    }
+
+    return CookedDependency{
+        .relativePath = relativePath,
+        .sizeBytes = static_cast<uint64_t>(sizeBytes),
+        .lastWriteTicks =
+            static_cast<int64_t>(lastWrite.time_since_epoch().count()),
+    };
+}
+
+MeshCacheFile::MeshCacheFile(MappedFile&& file)
+    : m_file{std::move(file)}
+{
+}
+
+auto MeshCacheFile::cachePath(
+    std::filesystem::path const& cacheDirectory, uint64_t const sourceHash
+) -> std::filesystem::path
+{
+    return cacheDirectory / fmt::format("{:016x}.szgmesh", sourceHash);
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+auto MeshCacheFile::open(
+    std::filesystem::path const& cacheDirectory,
+    uint64_t const sourceHash,
+    std::filesystem::path const& sourceDirectory
+) -> std::optional<MeshCacheFile>
+{
+    std::filesystem::path const path{cachePath(cacheDirectory, sourceHash)};
+
+    std::error_code existsError{};
+    if (!std::filesystem::exists(path, existsError))
+    {
+        return std::nullopt;
+    }
+
+    std::optional<MappedFile> fileResult{
+        MappedFile::open(path, MappedFile::AccessPattern::Sequential)
+    };
+    if (!fileResult.has_value())
+    {
+        SZG_WARNING("Failed to map cooked mesh file at {}", path.string());
+        return std::nullopt;
+    }
+    std::span<uint8_t const> const bytes{fileResult.value().bytes()};
+
+    if (bytes.size() < sizeof(FileHeader))
+    {
+        SZG_WARNING("Cooked mesh file was truncated at {}", path.string());
+        return std::nullopt;
+    }
+    auto const header{readRecord<FileHeader>(bytes, 0)};
+    if (header.magic != MAGIC || header.fileSize != bytes.size())
+    {
+        SZG_WARNING("Cooked mesh file was malformed at {}", path.string());
+        return std::nullopt;
+    }
+    if (header.version != VERSION || header.sourceHash != sourceHash)
+    {
+        SZG_INFO("Cooked mesh file is out of date at {}", path.string());
+        return std::nullopt;
+    }
+
+    auto const offsets{TableOffsets::fromHeader(header)};
+    if (offsets.end > bytes.size())
+    {
+        SZG_WARNING("Cooked mesh file was truncated at {}", path.string());
+        return std::nullopt;
+    }
+
+    for (uint32_t index{0}; index < header.dependencyCount; index++)
+    {
+        auto const record{readRecord<DependencyRecord>(
+            bytes, offsets.dependencies + index * sizeof(DependencyRecord)
+        )};
+        if (!rangeInBounds(
+                header.stringBytes, record.pathOffset, record.pathLength, 1
+            ))
+        {
+            SZG_WARNING("Cooked mesh file was malformed at {}", path.string());
+            return std::nullopt;
+        }
+
+        std::string const relativePath{
+            reinterpret_cast<char const*>(
+                bytes.data() + offsets.strings + record.pathOffset
+            ),
+            record.pathLength
+        };
+        std::optional<CookedDependency> const current{
+            CookedDependency::fromFile(sourceDirectory, relativePath)
+        };
+        if (!current.has_value() || current->sizeBytes != record.sizeBytes
+            || current->lastWriteTicks != record.lastWriteTicks)
+        {
+            SZG_INFO(
+                "Cooked mesh file is out of date, '{}' changed.", relativePath
+            );
+            return std::nullopt;
+        }
+    }
+
+    for (uint32_t index{0}; index < header.meshCount; index++)
+    {
+        auto const record{readRecord<MeshRecord>(
+            bytes, offsets.meshes + index * sizeof(MeshRecord)
+        )};
+
+        // Surfaces of the mesh itself, then of each level of detail.
+        uint64_t const tableSurfaceCount{
+            static_cast<uint64_t>(record.surfaceCount) * (record.lodCount + 1)
+        };
+
+        bool const inBounds{
+            rangeInBounds(
+                header.stringBytes, record.nameOffset, record.nameLength, 1
+            )
+            && record.lodCount <= MeshLodChain::MAX_LEVELS
+            && rangeInBounds(
+                header.surfaceCount, record.firstSurface, tableSurfaceCount, 1
+            )
+            && record.vertexOffset % DATA_ALIGNMENT == 0
+            && rangeInBounds(
+                bytes.size(),
+                record.vertexOffset,
+                record.vertexCount,
+                sizeof(VertexPacked)
+            )
+            && record.indexOffset % DATA_ALIGNMENT == 0
+            && rangeInBounds(
+                bytes.size(),
+                record.indexOffset,
+                record.indexCount,
+                sizeof(uint32_t)
+            )
+        };
+        if (!inBounds)
+        {
+            SZG_WARNING("Cooked mesh file was malformed at {}", path.string());
+            return std::nullopt;
+        }
+
+        for (uint64_t surfaceIndex{0}; surfaceIndex < tableSurfaceCount;
+             surfaceIndex++)
+        {
+            auto const surface{readRecord<CookedSurface>(
+                bytes,
+                offsets.surfaces
+                    + (record.firstSurface + surfaceIndex)
+                          * sizeof(CookedSurface)
+            )};
+            if (!rangeInBounds(
+                    record.indexCount, surface.firstIndex, surface.indexCount, 1
+                ))
+            {
+                SZG_WARNING(
+                    "Cooked mesh file was malformed at {}", path.string()
+                );
+                return std::nullopt;
+            }
+        }
+    }
+
+    return MeshCacheFile{std::move(fileResult).value()};
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+auto MeshCacheFile::cook(
+    std::filesystem::path const& cacheDirectory,
+    uint64_t const sourceHash,
+    std::span<CookedDependency const> const dependencies,
+    std::span<CookedMeshSource const> const meshes
+) -> bool
+{
+    std::error_code directoryError{};
+    std::filesystem::create_directories(cacheDirectory, directoryError);
+    if (directoryError)
+    {
+        SZG_ERROR(
+            "Unable to create mesh cache directory at {}: {}",
+            cacheDirectory.string(),
+            directoryError.message()
+        );
+        return false;
+    }
+
+    // Lay out every table and blob before writing anything.
+
+    std::vector<DependencyRecord> dependencyRecords{};
+    std::vector<MeshRecord> meshRecords{};
+    std::vector<CookedSurface> surfaces{};
+    std::string strings{};
+
+    dependencyRecords.reserve(dependencies.size());
+    for (CookedDependency const& dependency : dependencies)
+    {
+        dependencyRecords.push_back(DependencyRecord{
+            .sizeBytes = dependency.sizeBytes,
+            .lastWriteTicks = dependency.lastWriteTicks,
+            .pathOffset = static_cast<uint32_t>(strings.size()),
+            .pathLength = static_cast<uint32_t>(dependency.relativePath.size()),
+        });
+        strings += dependency.relativePath;
+    }
+
+    meshRecords.reserve(meshes.size());
+    for (CookedMeshSource const& mesh : meshes)
+    {
+        if (mesh.lodErrors.size() > MeshLodChain::MAX_LEVELS
+            || mesh.lodSurfaces.size()
+                   != mesh.lodErrors.size() * mesh.surfaces.size())
+        {
+            SZG_ERROR(
+                "Unable to cook mesh {}, its levels of detail are malformed.",
+                mesh.name
+            );
+            return false;
+        }
+
+        meshRecords.push_back(MeshRecord{
+            .nameOffset = static_cast<uint32_t>(strings.size()),
+            .nameLength = static_cast<uint32_t>(mesh.name.size()),
+            .firstSurface = static_cast<uint32_t>(surfaces.size()),
+            .surfaceCount = static_cast<uint32_t>(mesh.surfaces.size()),
+            .vertexOffset = 0,
+            .vertexCount = mesh.vertices.size(),
+            .indexOffset = 0,
+            .indexCount = mesh.indices.size(),
+            .boundsCenter = mesh.bounds.center,
+            .boundsHalfExtent = mesh.bounds.halfExtent,
+            .lodCount = static_cast<uint32_t>(mesh.lodErrors.size()),
+            .lodErrors = {},
+            .padding = 0,
+        });
+        std::copy(
+            mesh.lodErrors.begin(),
+            mesh.lodErrors.end(),
+            meshRecords.back().lodErrors.begin()
+        );
+        strings += mesh.name;
+        surfaces.insert(
+            surfaces.end(), mesh.surfaces.begin(), mesh.surfaces.end()
+        );
+        surfaces.insert(
+            surfaces.end(), mesh.lodSurfaces.begin(), mesh.lodSurfaces.end()
+        );
+    }
+
+    FileHeader header{
+        .magic = MAGIC,
+        .version = VERSION,
+        .sourceHash = sourceHash,
+        .fileSize = 0,
+        .dependencyCount = static_cast<uint32_t>(dependencyRecords.size()),
+        .meshCount = static_cast<uint32_t>(meshRecords.size()),
+        .surfaceCount = static_cast<uint32_t>(surfaces.size()),
+        .stringBytes = static_cast<uint32_t>(strings.size()),
+    };
+
+    uint64_t dataPosition{TableOffsets::fromHeader(header).end};
+    for (MeshRecord& record : meshRecords)
+    {
+        record.vertexOffset = alignUp(dataPosition, DATA_ALIGNMENT);
+        dataPosition =
+            record.vertexOffset + record.vertexCount * sizeof(VertexPacked);
+
+        record.indexOffset = alignUp(dataPosition, DATA_ALIGNMENT);
+        dataPosition =
+            record.indexOffset + record.indexCount * sizeof(uint32_t);
+    }
+    header.fileSize = dataPosition;
+
+    std::filesystem::path const path{cachePath(cacheDirectory, sourceHash)};
+    std::filesystem::path temporaryPath{path};
+    temporaryPath += ".tmp";
+
+    {
+        std::ofstream file{temporaryPath, std::ios::binary | std::ios::trunc};
+        if (!file.is_open())
+        {
+            SZG_ERROR(
+                "Unable to open cooked mesh file for writing at {}",
+                temporaryPath.string()
+            );
+            return false;
+        }
+
+        uint64_t position{0};
+        writeBytes(file, position, &header, sizeof(FileHeader));
+        writeBytes(
+            file,
+            position,
+            dependencyRecords.data(),
+            dependencyRecords.size() * sizeof(DependencyRecord)
+        );
+        writeBytes(
+            file,
+            position,
+            meshRecords.data(),
+            meshRecords.size() * sizeof(MeshRecord)
+        );
+        writeBytes(
+            file,
+            position,
+            surfaces.data(),
+            surfaces.size() * sizeof(CookedSurface)
+        );
+        writeBytes(file, position, strings.data(), strings.size());
+
+        for (size_t index{0}; index < meshes.size(); index++)
+        {
+            writePadding(file, position, DATA_ALIGNMENT);
+            writeBytes(
+                file,
+                position,
+                meshes[index].vertices.data(),
+                meshes[index].vertices.size_bytes()
+            );
+
+            writePadding(file, position, DATA_ALIGNMENT);
+            writeBytes(
+                file,
+                position,
+                meshes[index].indices.data(),
+                meshes[index].indices.size_bytes()
+            );
+        }
+
+        file.close();
+        if (!file || position != header.fileSize)
+        {
+            SZG_ERROR(
+                "Failed to write cooked mesh file at {}",
+                temporaryPath.string()
+            );
+            std::error_code removeError{};
+            std::filesystem::remove(temporaryPath, removeError);
+            return false;
+        }
+    }
+
+    std::error_code renameError{};
+    std::filesystem::rename(temporaryPath, path, renameError);
+    if (renameError)
+    {
+        SZG_ERROR(
+            "Failed to move cooked mesh file into place at {}: {}",
+            path.string(),
+            renameError.message()
+        );
+        std::error_code removeError{};
+        std::filesystem::remove(temporaryPath, removeError);
+        return false;
+    }
+
+    return true;
+}
+
+auto MeshCacheFile::meshCount() const -> size_t
+{
+    return readRecord<FileHeader>(m_file.bytes(), 0).meshCount;
+}
+
+auto MeshCacheFile::mesh(size_t const index) const -> CookedMeshView
+{
+    std::span<uint8_t const> const bytes{m_file.bytes()};
+
+    auto const header{readRecord<FileHeader>(bytes, 0)};
+    auto const offsets{TableOffsets::fromHeader(header)};
+    uint64_t const recordOffset{offsets.meshes + index * sizeof(MeshRecord)};
+    auto const record{readRecord<MeshRecord>(bytes, recordOffset)};
+
+    CookedSurface const* const surfaces{
+        reinterpret_cast<CookedSurface const*>(bytes.data() + offsets.surfaces)
+        + record.firstSurface
+    };
+
+    // Everything was bounds checked in open, and the mapping is page aligned,
+    // so the tables and blobs can be read in place.
+    return CookedMeshView{
+        .name =
+            std::string_view{
+                reinterpret_cast<char const*>(
+                    bytes.data() + offsets.strings + record.nameOffset
+                ),
+                record.nameLength
+            },
+        .bounds =
+            AABB{
+                .center = record.boundsCenter,
+                .halfExtent = record.boundsHalfExtent,
+            },
+        .surfaces =
+            std::span<CookedSurface const>{surfaces, record.surfaceCount},
+        .vertices =
+            std::span<VertexPacked const>{
+                reinterpret_cast<VertexPacked const*>(
+                    bytes.data() + record.vertexOffset
+                ),
+                record.vertexCount
+            },
+        .indices =
+            std::span<uint32_t const>{
+                reinterpret_cast<uint32_t const*>(
+                    bytes.data() + record.indexOffset
+                ),
+                record.indexCount
+            },
+        .lodSurfaces =
+            std::span<CookedSurface const>{
+                surfaces + record.surfaceCount,
+                static_cast<size_t>(record.surfaceCount) * record.lodCount
+            },
+        .lodErrors =
+            std::span<float const>{
+                reinterpret_cast<float const*>(
+                    bytes.data() + recordOffset
+                    + offsetof(MeshRecord, lodErrors)
+                ),
+                record.lodCount
+            },
+    };
+}
+} // namespace syzygy
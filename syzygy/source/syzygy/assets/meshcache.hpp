@@ -0,0 +1,124 @@
+#pragma once
+
+#include "syzygy/geometry/geometrytypes.hpp"
+#include "syzygy/platform/filesystemutils.hpp"
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/renderer/gputypes.hpp"
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace syzygy
+{
+// A range of a cooked mesh's indices. The material is referenced by its index
+// in the source file, since materials are resolved when the source is loaded.
+struct CookedSurface
+{
+    static int32_t constexpr DEFAULT_MATERIAL{-1};
+
+    uint32_t firstIndex{0};
+    uint32_t indexCount{0};
+    int32_t materialIndex{DEFAULT_MATERIAL};
+
+    // Of the vertices that the indices reference, in mesh space.
+    AABB bounds{};
+    Sphere boundingSphere{};
+};
+
+// A file besides the source that the cooked data was produced from, such as an
+// external glTF buffer. It is compared by size and modification time, so the
+// cache can be validated without reading it.
+struct CookedDependency
+{
+    // Relative to the directory of the source file.
+    std::string relativePath{};
+    uint64_t sizeBytes{0};
+    int64_t lastWriteTicks{0};
+
+    static auto fromFile(
+        std::filesystem::path const& sourceDirectory,
+        std::string const& relativePath
+    ) -> std::optional<CookedDependency>;
+};
+
+// A mesh to be cooked. Meshes that failed to load can be passed with no
+// surfaces, so the source's mesh indexing is preserved.
+struct CookedMeshSource
+{
+    std::string name{};
+    AABB bounds{};
+    std::span<CookedSurface const> surfaces{};
+    std::span<VertexPacked const> vertices{};
+    std::span<uint32_t const> indices{};
+
+    // Levels of detail laid out as in MeshLodChain, with one error per level.
+    std::span<CookedSurface const> lodSurfaces{};
+    std::span<float const> lodErrors{};
+};
+
+// A mesh read from a cooked file, which points into the file's mapped memory.
+struct CookedMeshView
+{
+    std::string_view name{};
+    AABB bounds{};
+    std::span<CookedSurface const> surfaces{};
+    std::span<VertexPacked const> vertices{};
+    std::span<uint32_t const> indices{};
+
+    std::span<CookedSurface const> lodSurfaces{};
+    std::span<float const> lodErrors{};
+};
+
+// A versioned binary container of mesh geometry in its final GPU layout,
+// produced from a source file such as a glTF. It is keyed by a hash of the
+// source file's contents, and loads by mapping it into memory, so its
+// geometry can be copied directly into staging memory without any parsing.
+struct MeshCacheFile
+{
+public:
+    auto operator=(MeshCacheFile&&) -> MeshCacheFile& = delete;
+    MeshCacheFile(MeshCacheFile const&) = delete;
+    auto operator=(MeshCacheFile const&) -> MeshCacheFile& = delete;
+
+    MeshCacheFile(MeshCacheFile&&) noexcept = default;
+    ~MeshCacheFile() = default;
+
+private:
+    explicit MeshCacheFile(MappedFile&& file);
+
+public:
+    // Bump this whenever the layout of the file, or of the data cooked into
+    // it, changes.
+    static uint32_t constexpr VERSION{4};
+
+    static auto cachePath(
+        std::filesystem::path const& cacheDirectory, uint64_t sourceHash
+    ) -> std::filesystem::path;
+
+    // Fails if the file is missing, malformed, from another version, or stale
+    // with respect to the source or its dependencies.
+    static auto open(
+        std::filesystem::path const& cacheDirectory,
+        uint64_t sourceHash,
+        std::filesystem::path const& sourceDirectory
+    ) -> std::optional<MeshCacheFile>;
+
+    // The file is written in full before replacing any existing one, so a
+    // failed cook never leaves a partial file to be loaded.
+    static auto cook(
+        std::filesystem::path const& cacheDirectory,
+        uint64_t sourceHash,
+        std::span<CookedDependency const> dependencies,
+        std::span<CookedMeshSource const> meshes
+    ) -> bool;
+
+    [[nodiscard]] auto meshCount() const -> size_t;
+    [[nodiscard]] auto mesh(size_t index) const -> CookedMeshView;
+
+private:
+    MappedFile m_file;
+};
+} // namespace syzygy
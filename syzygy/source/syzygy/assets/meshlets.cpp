@@ -0,0 +1,209 @@
+#include "meshlets.hpp"
+
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/renderer/gputypes.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace
+{
+uint32_t constexpr NO_MESHLET{std::numeric_limits<uint32_t>::max()};
+uint32_t constexpr TRIANGLE_VERTICES{3};
+
+// Past this, a cone would be too wide to ever cull anything, so none is made.
+float constexpr CONE_MINIMUM_DOT{0.1F};
+// Greater than any dot product of unit vectors, so the cone never culls.
+float constexpr NO_CONE_CUTOFF{2.0F};
+
+auto countNewVertices(
+    std::span<uint32_t const> const triangle,
+    std::span<uint32_t const> const vertexMeshlets,
+    uint32_t const meshlet
+) -> uint32_t
+{
+    uint32_t count{0};
+    for (size_t corner{0}; corner < triangle.size(); corner++)
+    {
+        uint32_t const vertex{triangle[corner]};
+        bool const repeated{
+            std::find(triangle.begin(), triangle.begin() + corner, vertex)
+            != triangle.begin() + corner
+        };
+        if (!repeated && vertexMeshlets[vertex] != meshlet)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+} // namespace
+
+namespace syzygy
+{
+MeshletBuilder::MeshletBuilder(
+    std::span<VertexPacked const> const vertices, float const boundsPadding
+)
+    : m_vertices{vertices}
+    , m_boundsPadding{boundsPadding}
+    , m_vertexMeshlets(vertices.size(), NO_MESHLET)
+{
+}
+
+auto MeshletBuilder::appendSurface(
+    std::span<uint32_t const> const meshIndices,
+    uint32_t const firstIndex,
+    uint32_t const indexCount
+) -> uint32_t
+{
+    size_t const meshletsBefore{m_meshlets.size()};
+    uint32_t const triangleCount{indexCount / TRIANGLE_VERTICES};
+
+    // Meshlets are numbered by where they will be appended.
+    auto meshlet{static_cast<uint32_t>(m_meshlets.size())};
+    uint32_t meshletFirstIndex{firstIndex};
+    uint32_t meshletTriangles{0};
+    uint32_t meshletVertices{0};
+
+    for (uint32_t triangleIndex{0}; triangleIndex < triangleCount;
+         triangleIndex++)
+    {
+        uint32_t const triangleFirstIndex{
+            firstIndex + triangleIndex * TRIANGLE_VERTICES
+        };
+        std::span<uint32_t const> const triangle{
+            meshIndices.subspan(triangleFirstIndex, TRIANGLE_VERTICES)
+        };
+
+        uint32_t newVertices{
+            countNewVertices(triangle, m_vertexMeshlets, meshlet)
+        };
+        if (meshletTriangles + 1 > MAX_TRIANGLES
+            || meshletVertices + newVertices > MAX_VERTICES)
+        {
+            appendMeshlet(
+                meshIndices,
+                meshletFirstIndex,
+                meshletTriangles * TRIANGLE_VERTICES
+            );
+
+            meshlet++;
+            meshletFirstIndex = triangleFirstIndex;
+            meshletTriangles = 0;
+            meshletVertices = 0;
+            newVertices = countNewVertices(triangle, m_vertexMeshlets, meshlet);
+        }
+
+        for (uint32_t const vertex : triangle)
+        {
+            m_vertexMeshlets[vertex] = meshlet;
+        }
+        meshletVertices += newVertices;
+        meshletTriangles++;
+    }
+
+    if (meshletTriangles > 0)
+    {
+        appendMeshlet(
+            meshIndices, meshletFirstIndex, meshletTriangles * TRIANGLE_VERTICES
+        );
+    }
+
+    return static_cast<uint32_t>(m_meshlets.size() - meshletsBefore);
+}
+
+auto MeshletBuilder::meshlets() const -> std::span<MeshletPacked const>
+{
+    return m_meshlets;
+}
+
+void MeshletBuilder::appendMeshlet(
+    std::span<uint32_t const> const meshIndices,
+    uint32_t const firstIndex,
+    uint32_t const indexCount
+)
+{
+    std::span<uint32_t const> const indices{
+        meshIndices.subspan(firstIndex, indexCount)
+    };
+
+    glm::vec3 minimum{std::numeric_limits<float>::max()};
+    glm::vec3 maximum{std::numeric_limits<float>::lowest()};
+    for (uint32_t const vertex : indices)
+    {
+        minimum = glm::min(minimum, m_vertices[vertex].position);
+        maximum = glm::max(maximum, m_vertices[vertex].position);
+    }
+
+    // Not the smallest sphere, but close enough for culling.
+    glm::vec3 const center{(minimum + maximum) * 0.5F};
+    float radius{0.0F};
+    for (uint32_t const vertex : indices)
+    {
+        radius = std::max(
+            radius, glm::length(m_vertices[vertex].position - center)
+        );
+    }
+    radius += m_boundsPadding;
+
+    // See "Optimizing the Graphics Pipeline with Compute" by Wihlidal. The
+    // axis is the average of the normals, and the cone is as wide as the
+    // normal furthest from it.
+    std::vector<glm::vec3> normals{};
+    normals.reserve(indices.size() / TRIANGLE_VERTICES);
+    glm::vec3 normalSum{0.0F};
+    for (size_t index{0}; index + TRIANGLE_VERTICES <= indices.size();
+         index += TRIANGLE_VERTICES)
+    {
+        glm::vec3 const a{m_vertices[indices[index]].position};
+        glm::vec3 const b{m_vertices[indices[index + 1]].position};
+        glm::vec3 const c{m_vertices[indices[index + 2]].position};
+
+        // Front faces are wound so that this points out of them.
+        glm::vec3 const areaNormal{glm::cross(c - a, b - a)};
+        float const length{glm::length(areaNormal)};
+        if (length <= std::numeric_limits<float>::min())
+        {
+            continue;
+        }
+
+        normals.push_back(areaNormal / length);
+        normalSum += normals.back();
+    }
+
+    glm::vec4 coneAxisCutoff{0.0F, 0.0F, 0.0F, NO_CONE_CUTOFF};
+    if (float const sumLength{glm::length(normalSum)};
+        sumLength > std::numeric_limits<float>::min())
+    {
+        glm::vec3 const axis{normalSum / sumLength};
+
+        float minimumDot{1.0F};
+        for (glm::vec3 const& normal : normals)
+        {
+            minimumDot = std::min(minimumDot, glm::dot(normal, axis));
+        }
+
+        coneAxisCutoff = glm::vec4{axis, NO_CONE_CUTOFF};
+        if (minimumDot > CONE_MINIMUM_DOT)
+        {
+            // The cosine of the angle between the cone's edge and the plane
+            // perpendicular to the axis.
+            coneAxisCutoff.w = std::sqrt(1.0F - minimumDot * minimumDot);
+        }
+    }
+
+    m_meshlets.push_back(MeshletPacked{
+        .boundingSphere = glm::vec4{center, radius},
+        .coneAxisCutoff = coneAxisCutoff,
+        .firstIndex = firstIndex,
+        .indexCount = indexCount,
+    });
+}
+} // namespace syzygy
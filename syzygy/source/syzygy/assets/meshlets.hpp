@@ -0,0 +1,55 @@
+#pragma once
+
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/renderer/gputypes.hpp"
+#include <span>
+#include <vector>
+
+namespace syzygy
+{
+// Splits a mesh's surfaces into meshlets, small clusters of triangles that are
+// each bounded so they can be culled on their own.
+//
+// Each meshlet is a consecutive run of a surface's indices, so meshlets are
+// drawn straight from the mesh's index buffer. They are only as coherent as
+// the triangle order, which should already be optimized for locality, such as
+// by MeshOptimization.
+struct MeshletBuilder
+{
+public:
+    // Limits that fit the typical output of a mesh shader workgroup.
+    static uint32_t constexpr MAX_VERTICES{64};
+    static uint32_t constexpr MAX_TRIANGLES{124};
+
+    // boundsPadding is added to every bounding radius, to cover any error in
+    // how the vertex positions are encoded.
+    MeshletBuilder(std::span<VertexPacked const> vertices, float boundsPadding);
+
+    // Appends meshlets that cover the surface, in order, returning how many
+    // were appended. Any trailing indices that do not form a triangle are not
+    // covered.
+    auto appendSurface(
+        std::span<uint32_t const> meshIndices,
+        uint32_t firstIndex,
+        uint32_t indexCount
+    ) -> uint32_t;
+
+    [[nodiscard]] auto meshlets() const -> std::span<MeshletPacked const>;
+
+private:
+    void appendMeshlet(
+        std::span<uint32_t const> meshIndices,
+        uint32_t firstIndex,
+        uint32_t indexCount
+    );
+
+    std::span<VertexPacked const> m_vertices;
+    float m_boundsPadding;
+
+    // The index of the last meshlet each vertex was counted in, to count each
+    // meshlet's distinct vertices.
+    std::vector<uint32_t> m_vertexMeshlets{};
+
+    std::vector<MeshletPacked> m_meshlets{};
+};
+} // namespace syzygy
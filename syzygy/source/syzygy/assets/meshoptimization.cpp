@@ -0,0 +1,618 @@
+#include "meshoptimization.hpp"
+
+#include "syzygy/assets/meshcache.hpp"
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/renderer/gputypes.hpp"
+#include <algorithm>
+#include <array>
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace
+{
+using syzygy::MeshOptimization;
+
+uint32_t constexpr NO_VERTEX{std::numeric_limits<uint32_t>::max()};
+size_t constexpr TRIANGLE_VERTICES{3};
+
+// A FIFO post-transform cache. Rather than holding the cache's entries, it
+// stamps each vertex with when it was inserted, which is enough to know when
+// the vertex would be evicted.
+struct VertexCacheSimulation
+{
+public:
+    explicit VertexCacheSimulation(size_t const vertexCount)
+        : m_timestamps(vertexCount, 0)
+    {
+    }
+
+    // Returns whether the vertex missed the cache.
+    auto reference(uint32_t const vertex) -> bool
+    {
+        if (m_timestamp - m_timestamps[vertex] <= MeshOptimization::CACHE_SIZE)
+        {
+            return false;
+        }
+
+        m_timestamps[vertex] = m_timestamp++;
+        return true;
+    }
+
+    // Returns how many of the triangle's vertices missed the cache.
+    auto referenceTriangle(std::span<uint32_t const> const triangle)
+        -> uint32_t
+    {
+        uint32_t misses{0};
+        for (uint32_t const vertex : triangle)
+        {
+            misses += reference(vertex) ? 1U : 0U;
+        }
+        return misses;
+    }
+
+    // Evicts every vertex, such as between draws.
+    void flush() { m_timestamp += MeshOptimization::CACHE_SIZE + 1; }
+
+private:
+    std::vector<uint32_t> m_timestamps;
+    // Starts far enough ahead of the zeroed stamps that nothing is cached.
+    uint32_t m_timestamp{MeshOptimization::CACHE_SIZE + 1};
+};
+
+auto triangle(std::span<uint32_t const> const indices, size_t const triangle)
+    -> std::span<uint32_t const>
+{
+    return indices.subspan(triangle * TRIANGLE_VERTICES, TRIANGLE_VERTICES);
+}
+
+// A surface's triangles, with vertices renumbered from 0 in the order that
+// they are first referenced. Surfaces are usually a small part of their mesh,
+// so this keeps the per-vertex bookkeeping proportional to the surface.
+struct LocalSurface
+{
+    std::vector<uint32_t> indices{};
+    // Maps the local vertices back into the mesh.
+    std::vector<uint32_t> meshVertices{};
+
+    // meshToLocal must be the size of the mesh's vertices and filled with
+    // NO_VERTEX, and is left that way.
+    static auto create(
+        std::span<uint32_t const> const meshIndices,
+        std::vector<uint32_t>& meshToLocal
+    ) -> LocalSurface
+    {
+        LocalSurface surface{};
+        surface.indices.reserve(meshIndices.size());
+        for (uint32_t const meshVertex : meshIndices)
+        {
+            uint32_t& localVertex{meshToLocal[meshVertex]};
+            if (localVertex == NO_VERTEX)
+            {
+                localVertex =
+                    static_cast<uint32_t>(surface.meshVertices.size());
+                surface.meshVertices.push_back(meshVertex);
+            }
+            surface.indices.push_back(localVertex);
+        }
+
+        for (uint32_t const meshVertex : surface.meshVertices)
+        {
+            meshToLocal[meshVertex] = NO_VERTEX;
+        }
+
+        return surface;
+    }
+
+    [[nodiscard]] auto triangleCount() const -> size_t
+    {
+        return indices.size() / TRIANGLE_VERTICES;
+    }
+
+    void reorderTriangles(std::span<uint32_t const> const order)
+    {
+        std::vector<uint32_t> reordered{};
+        reordered.reserve(indices.size());
+        for (uint32_t const triangleIndex : order)
+        {
+            std::span<uint32_t const> const vertices{
+                triangle(indices, triangleIndex)
+            };
+            reordered.insert(reordered.end(), vertices.begin(), vertices.end());
+        }
+        indices = std::move(reordered);
+    }
+};
+
+// See "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw" by
+// Sander et al. Triangles are emitted as fans around a vertex, then the next
+// fanning vertex is picked from those just emitted, preferring the one that
+// will stay in the cache the longest while its remaining triangles are
+// emitted. When none of them have triangles left, the most recently emitted
+// vertex that still does is picked instead.
+auto tipsify(LocalSurface const& surface) -> std::vector<uint32_t>
+{
+    size_t const vertexCount{surface.meshVertices.size()};
+    size_t const triangleCount{surface.triangleCount()};
+
+    // The triangles around each vertex, packed by vertex.
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t index{0}; index < triangleCount * TRIANGLE_VERTICES; index++)
+    {
+        adjacencyOffsets[surface.indices[index] + 1]++;
+    }
+    std::partial_sum(
+        adjacencyOffsets.begin(),
+        adjacencyOffsets.end(),
+        adjacencyOffsets.begin()
+    );
+
+    // Triangles not yet emitted, per vertex.
+    std::vector<uint32_t> liveTriangles(vertexCount, 0);
+    std::vector<uint32_t> adjacency(adjacencyOffsets.back());
+    for (size_t triangleIndex{0}; triangleIndex < triangleCount;
+         triangleIndex++)
+    {
+        for (uint32_t const vertex : triangle(surface.indices, triangleIndex))
+        {
+            adjacency[adjacencyOffsets[vertex] + liveTriangles[vertex]] =
+                static_cast<uint32_t>(triangleIndex);
+            liveTriangles[vertex]++;
+        }
+    }
+
+    uint32_t constexpr CACHE_SIZE{MeshOptimization::CACHE_SIZE};
+
+    std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+    uint32_t timestamp{CACHE_SIZE + 1};
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnds{};
+    std::vector<uint32_t> candidates{};
+    size_t cursor{0};
+
+    std::vector<uint32_t> order{};
+    order.reserve(triangleCount);
+
+    uint32_t fanningVertex{vertexCount > 0 ? 0 : NO_VERTEX};
+    while (fanningVertex != NO_VERTEX)
+    {
+        candidates.clear();
+        for (uint32_t adjacencyIndex{adjacencyOffsets[fanningVertex]};
+             adjacencyIndex < adjacencyOffsets[fanningVertex + 1];
+             adjacencyIndex++)
+        {
+            uint32_t const triangleIndex{adjacency[adjacencyIndex]};
+            if (emitted[triangleIndex])
+            {
+                continue;
+            }
+
+            for (uint32_t const vertex :
+                 triangle(surface.indices, triangleIndex))
+            {
+                deadEnds.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangles[vertex]--;
+
+                if (timestamp - cacheTimestamps[vertex] > CACHE_SIZE)
+                {
+                    cacheTimestamps[vertex] = timestamp++;
+                }
+            }
+
+            emitted[triangleIndex] = true;
+            order.push_back(triangleIndex);
+        }
+
+        fanningVertex = NO_VERTEX;
+        int64_t bestPriority{-1};
+        for (uint32_t const vertex : candidates)
+        {
+            if (liveTriangles[vertex] == 0)
+            {
+                continue;
+            }
+
+            // Vertices that would be evicted before their remaining triangles
+            // are emitted are no better than any other.
+            int64_t priority{0};
+            uint32_t const age{timestamp - cacheTimestamps[vertex]};
+            if (age + 2 * liveTriangles[vertex] <= CACHE_SIZE)
+            {
+                priority = age;
+            }
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                fanningVertex = vertex;
+            }
+        }
+        if (fanningVertex != NO_VERTEX)
+        {
+            continue;
+        }
+
+        while (!deadEnds.empty() && fanningVertex == NO_VERTEX)
+        {
+            uint32_t const vertex{deadEnds.back()};
+            deadEnds.pop_back();
+            if (liveTriangles[vertex] > 0)
+            {
+                fanningVertex = vertex;
+            }
+        }
+        while (cursor < vertexCount && fanningVertex == NO_VERTEX)
+        {
+            if (liveTriangles[cursor] > 0)
+            {
+                fanningVertex = static_cast<uint32_t>(cursor);
+            }
+            cursor++;
+        }
+    }
+
+    return order;
+}
+
+// Cuts the triangles into clusters, returning the first triangle of each. A
+// triangle that misses the cache on all three vertices has likely jumped to a
+// disjoint part of the surface, and always starts a cluster. Those clusters
+// are cut further at the first triangle where the cluster so far, starting
+// from an empty cache, has reached the threshold ACMR. Any remainder too short
+// to reach it is merged into the previous cluster.
+auto generateClusters(LocalSurface const& surface) -> std::vector<size_t>
+{
+    size_t const triangleCount{surface.triangleCount()};
+
+    std::vector<size_t> disjointStarts{};
+    {
+        VertexCacheSimulation cache{surface.meshVertices.size()};
+        for (size_t triangleIndex{0}; triangleIndex < triangleCount;
+             triangleIndex++)
+        {
+            uint32_t const misses{cache.referenceTriangle(
+                triangle(surface.indices, triangleIndex)
+            )};
+            if (triangleIndex == 0 || misses == TRIANGLE_VERTICES)
+            {
+                disjointStarts.push_back(triangleIndex);
+            }
+        }
+    }
+
+    std::vector<size_t> clusterStarts{};
+    VertexCacheSimulation cache{surface.meshVertices.size()};
+    for (size_t disjointIndex{0}; disjointIndex < disjointStarts.size();
+         disjointIndex++)
+    {
+        size_t const start{disjointStarts[disjointIndex]};
+        size_t const end{
+            disjointIndex + 1 < disjointStarts.size()
+                ? disjointStarts[disjointIndex + 1]
+                : triangleCount
+        };
+
+        cache.flush();
+        size_t disjointMisses{0};
+        for (size_t triangleIndex{start}; triangleIndex < end; triangleIndex++)
+        {
+            disjointMisses += cache.referenceTriangle(
+                triangle(surface.indices, triangleIndex)
+            );
+        }
+        double const thresholdACMR{
+            MeshOptimization::OVERDRAW_ACMR_THRESHOLD
+            * static_cast<double>(disjointMisses)
+            / static_cast<double>(end - start)
+        };
+
+        clusterStarts.push_back(start);
+
+        cache.flush();
+        size_t clusterMisses{0};
+        size_t clusterTriangles{0};
+        for (size_t triangleIndex{start}; triangleIndex < end; triangleIndex++)
+        {
+            clusterMisses += cache.referenceTriangle(
+                triangle(surface.indices, triangleIndex)
+            );
+            clusterTriangles++;
+
+            if (static_cast<double>(clusterMisses)
+                    / static_cast<double>(clusterTriangles)
+                > thresholdACMR)
+            {
+                continue;
+            }
+
+            clusterStarts.push_back(triangleIndex + 1);
+            cache.flush();
+            clusterMisses = 0;
+            clusterTriangles = 0;
+        }
+
+        // Either the last cluster is empty, or it did not reach the threshold.
+        if (clusterStarts.back() != start)
+        {
+            clusterStarts.pop_back();
+        }
+    }
+
+    return clusterStarts;
+}
+
+// See "Triangle Order Optimization for Graphics Hardware Computation Culling"
+// by Nehab et al. Clusters that are further out along their average normal
+// tend to occlude the others, so they are drawn first. This ignores the view,
+// but works well enough for closed and mostly convex surfaces.
+auto sortClustersForOverdraw(
+    LocalSurface const& surface,
+    std::span<size_t const> const clusterStarts,
+    std::span<syzygy::VertexPacked const> const meshVertices
+) -> std::vector<uint32_t>
+{
+    size_t const triangleCount{surface.triangleCount()};
+
+    struct Cluster
+    {
+        size_t start{0};
+        size_t end{0};
+        // Both are weighted by triangle area.
+        glm::vec3 centroid{0.0F};
+        glm::vec3 normal{0.0F};
+        float area{0.0F};
+        float sortKey{0.0F};
+    };
+
+    std::vector<Cluster> clusters{};
+    clusters.reserve(clusterStarts.size());
+
+    glm::vec3 surfaceCentroid{0.0F};
+    float surfaceArea{0.0F};
+    for (size_t clusterIndex{0}; clusterIndex < clusterStarts.size();
+         clusterIndex++)
+    {
+        Cluster cluster{
+            .start = clusterStarts[clusterIndex],
+            .end = clusterIndex + 1 < clusterStarts.size()
+                     ? clusterStarts[clusterIndex + 1]
+                     : triangleCount,
+        };
+
+        for (size_t triangleIndex{cluster.start}; triangleIndex < cluster.end;
+             triangleIndex++)
+        {
+            std::span<uint32_t const> const vertices{
+                triangle(surface.indices, triangleIndex)
+            };
+            std::array<glm::vec3, TRIANGLE_VERTICES> positions{};
+            for (size_t corner{0}; corner < TRIANGLE_VERTICES; corner++)
+            {
+                positions[corner] =
+                    meshVertices[surface.meshVertices[vertices[corner]]]
+                        .position;
+            }
+
+            // Twice the area, which cancels out once normalized.
+            glm::vec3 const areaNormal{glm::cross(
+                positions[1] - positions[0], positions[2] - positions[0]
+            )};
+            float const area{glm::length(areaNormal)};
+
+            float constexpr ONE_THIRD{1.0F / 3.0F};
+            cluster.centroid +=
+                (positions[0] + positions[1] + positions[2]) * ONE_THIRD * area;
+            cluster.normal += areaNormal;
+            cluster.area += area;
+        }
+
+        surfaceCentroid += cluster.centroid;
+        surfaceArea += cluster.area;
+        if (cluster.area > 0.0F)
+        {
+            cluster.centroid /= cluster.area;
+        }
+
+        clusters.push_back(cluster);
+    }
+
+    if (surfaceArea > 0.0F)
+    {
+        surfaceCentroid /= surfaceArea;
+    }
+
+    for (Cluster& cluster : clusters)
+    {
+        float const normalLength{glm::length(cluster.normal)};
+        if (cluster.area <= 0.0F || normalLength <= 0.0F)
+        {
+            continue;
+        }
+
+        cluster.sortKey = glm::dot(
+            cluster.centroid - surfaceCentroid, cluster.normal / normalLength
+        );
+    }
+
+    // Stable, so the cache order survives between clusters with equal keys.
+    std::stable_sort(
+        clusters.begin(),
+        clusters.end(),
+        [](Cluster const& lhs, Cluster const& rhs)
+    { return lhs.sortKey > rhs.sortKey; }
+    );
+
+    std::vector<uint32_t> order{};
+    order.reserve(triangleCount);
+    for (Cluster const& cluster : clusters)
+    {
+        for (size_t triangleIndex{cluster.start}; triangleIndex < cluster.end;
+             triangleIndex++)
+        {
+            order.push_back(static_cast<uint32_t>(triangleIndex));
+        }
+    }
+    return order;
+}
+
+void optimizeTriangleOrder(
+    LocalSurface& surface,
+    std::span<syzygy::VertexPacked const> const meshVertices
+)
+{
+    if (surface.triangleCount() == 0)
+    {
+        return;
+    }
+
+    surface.reorderTriangles(tipsify(surface));
+
+    std::vector<size_t> const clusterStarts{generateClusters(surface)};
+    surface.reorderTriangles(
+        sortClustersForOverdraw(surface, clusterStarts, meshVertices)
+    );
+}
+} // namespace
+
+namespace syzygy
+{
+auto VertexCacheStatistics::acmr() const -> double
+{
+    if (triangleCount == 0)
+    {
+        return 0.0;
+    }
+    return static_cast<double>(transformCount)
+         / static_cast<double>(triangleCount);
+}
+
+auto VertexCacheStatistics::atvr() const -> double
+{
+    if (vertexCount == 0)
+    {
+        return 0.0;
+    }
+    return static_cast<double>(transformCount)
+         / static_cast<double>(vertexCount);
+}
+
+auto VertexCacheStatistics::operator+=(VertexCacheStatistics const& other)
+    -> VertexCacheStatistics&
+{
+    triangleCount += other.triangleCount;
+    vertexCount += other.vertexCount;
+    transformCount += other.transformCount;
+    return *this;
+}
+
+auto MeshOptimization::analyze(
+    std::span<CookedSurface const> const surfaces,
+    std::span<uint32_t const> const indices,
+    size_t const vertexCount
+) -> VertexCacheStatistics
+{
+    VertexCacheStatistics statistics{};
+
+    VertexCacheSimulation cache{vertexCount};
+    std::vector<bool> referenced(vertexCount, false);
+    for (CookedSurface const& surface : surfaces)
+    {
+        size_t const triangleCount{surface.indexCount / TRIANGLE_VERTICES};
+        std::span<uint32_t const> const surfaceIndices{indices.subspan(
+            surface.firstIndex, triangleCount * TRIANGLE_VERTICES
+        )};
+
+        cache.flush();
+        for (uint32_t const vertex : surfaceIndices)
+        {
+            statistics.transformCount += cache.reference(vertex) ? 1 : 0;
+            if (!referenced[vertex])
+            {
+                referenced[vertex] = true;
+                statistics.vertexCount++;
+            }
+        }
+        statistics.triangleCount += triangleCount;
+    }
+
+    return statistics;
+}
+
+auto MeshOptimization::optimize(
+    std::span<CookedSurface const> const surfaces,
+    std::vector<uint32_t>& indices,
+    std::vector<VertexPacked>& vertices
+) -> std::optional<MeshOptimization>
+{
+    for (CookedSurface const& surface : surfaces)
+    {
+        if (static_cast<size_t>(surface.firstIndex) + surface.indexCount
+            > indices.size())
+        {
+            return std::nullopt;
+        }
+    }
+    if (std::any_of(
+            indices.begin(),
+            indices.end(),
+            [&](uint32_t const index) { return index >= vertices.size(); }
+        ))
+    {
+        return std::nullopt;
+    }
+
+    MeshOptimization result{
+        .before = analyze(surfaces, indices, vertices.size()),
+    };
+
+    std::vector<uint32_t> meshToLocal(vertices.size(), NO_VERTEX);
+    for (CookedSurface const& surface : surfaces)
+    {
+        // Any trailing indices that do not form a triangle are left alone.
+        std::span<uint32_t> const surfaceIndices{
+            std::span<uint32_t>{indices}.subspan(
+                surface.firstIndex,
+                surface.indexCount / TRIANGLE_VERTICES * TRIANGLE_VERTICES
+            )
+        };
+
+        LocalSurface localSurface{
+            LocalSurface::create(surfaceIndices, meshToLocal)
+        };
+        optimizeTriangleOrder(localSurface, vertices);
+
+        std::transform(
+            localSurface.indices.begin(),
+            localSurface.indices.end(),
+            surfaceIndices.begin(),
+            [&](uint32_t const localVertex)
+        { return localSurface.meshVertices[localVertex]; }
+        );
+    }
+
+    // Vertices are fetched in roughly the order they are first referenced, so
+    // they are laid out in that order.
+    std::vector<uint32_t>& oldToNew{meshToLocal};
+    std::vector<VertexPacked> reorderedVertices{};
+    reorderedVertices.reserve(vertices.size());
+    for (uint32_t& index : indices)
+    {
+        if (oldToNew[index] == NO_VERTEX)
+        {
+            oldToNew[index] = static_cast<uint32_t>(reorderedVertices.size());
+            reorderedVertices.push_back(vertices[index]);
+        }
+        index = oldToNew[index];
+    }
+    vertices = std::move(reorderedVertices);
+
+    result.after = analyze(surfaces, indices, vertices.size());
+
+    return result;
+}
+} // namespace syzygy
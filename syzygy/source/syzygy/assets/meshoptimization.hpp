@@ -0,0 +1,69 @@
+#pragma once
+
+#include "syzygy/platform/integer.hpp"
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace syzygy
+{
+struct CookedSurface;
+struct VertexPacked;
+
+// How well a mesh's indices reuse a simulated FIFO post-transform cache, with
+// each surface drawn separately.
+struct VertexCacheStatistics
+{
+    size_t triangleCount{0};
+    // Distinct vertices referenced by the indices.
+    size_t vertexCount{0};
+    // Vertices that missed the cache and had to be shaded.
+    size_t transformCount{0};
+
+    // Average cache miss ratio, transforms per triangle. This is 3 at worst,
+    // and approaches 0.5 for large regular meshes.
+    [[nodiscard]] auto acmr() const -> double;
+    // Average transform to vertex ratio, which is 1 at best.
+    [[nodiscard]] auto atvr() const -> double;
+
+    auto operator+=(VertexCacheStatistics const&) -> VertexCacheStatistics&;
+};
+
+// Reorders a mesh's geometry to be cheaper to draw, without changing what is
+// drawn.
+struct MeshOptimization
+{
+    // Entries of the simulated cache, which is also the size the triangle order
+    // is optimized for.
+    static uint32_t constexpr CACHE_SIZE{16};
+
+    // Triangles are grouped into clusters that are sorted to reduce overdraw,
+    // and clusters are cut as small as possible while the ACMR of each stays
+    // within this factor of the unclustered order.
+    static float constexpr OVERDRAW_ACMR_THRESHOLD{1.05F};
+
+    VertexCacheStatistics before{};
+    VertexCacheStatistics after{};
+
+    [[nodiscard]] static auto analyze(
+        std::span<CookedSurface const> surfaces,
+        std::span<uint32_t const> indices,
+        size_t vertexCount
+    ) -> VertexCacheStatistics;
+
+    // Within each surface, triangles are reordered for the post-transform
+    // cache with Tipsify, then clustered and sorted so that outward facing
+    // clusters draw first. Then vertices are reordered by first use for fetch
+    // locality, and any that are unreferenced are removed. Surfaces keep their
+    // ranges of indices.
+    //
+    // Triangles must have counter-clockwise front faces, as in glTF.
+    //
+    // Fails without modifying anything if a surface or index is out of bounds.
+    static auto optimize(
+        std::span<CookedSurface const> surfaces,
+        std::vector<uint32_t>& indices,
+        std::vector<VertexPacked>& vertices
+    ) -> std::optional<MeshOptimization>;
+};
+} // namespace syzygy
@@ -0,0 +1,665 @@
+#include "meshsimplification.hpp"
+
+#include "syzygy/assets/meshcache.hpp"
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/renderer/gputypes.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace
+{
+size_t constexpr TRIANGLE_VERTICES{3};
+uint32_t constexpr TRIANGLE_EDGES{3};
+
+// Each pass of collapses stops once costs pass the cost at this fraction of
+// the sorted candidates, so that expensive collapses wait until cheaper ones
+// have been tried again.
+size_t constexpr PASS_CANDIDATE_DIVISOR{3};
+
+// The sum of squared distances from a point to a set of planes, each weighted
+// by the area of the triangle it came from. This is accumulated in doubles,
+// since large and small triangles are summed together.
+struct Quadric
+{
+    // p'Ap + 2b'p + c, where A is symmetric.
+    double a00{0.0};
+    double a01{0.0};
+    double a02{0.0};
+    double a11{0.0};
+    double a12{0.0};
+    double a22{0.0};
+
+    double b0{0.0};
+    double b1{0.0};
+    double b2{0.0};
+
+    double c{0.0};
+
+    // The total area of the triangles.
+    double weight{0.0};
+
+    static auto fromTriangle(glm::vec3 a, glm::vec3 b, glm::vec3 c) -> Quadric;
+
+    auto operator+=(Quadric const& other) -> Quadric&;
+
+    // The average squared distance to the planes, weighted by area.
+    [[nodiscard]] auto error(glm::vec3 position) const -> double;
+};
+
+auto Quadric::fromTriangle(
+    glm::vec3 const a, glm::vec3 const b, glm::vec3 const c
+) -> Quadric
+{
+    glm::vec3 const areaNormal{glm::cross(b - a, c - a)};
+    auto const length{static_cast<double>(glm::length(areaNormal))};
+    if (length <= 0.0)
+    {
+        return Quadric{};
+    }
+
+    double const area{length * 0.5};
+    double const x{areaNormal.x / length};
+    double const y{areaNormal.y / length};
+    double const z{areaNormal.z / length};
+    double const d{-(x * a.x + y * a.y + z * a.z)};
+
+    return Quadric{
+        .a00 = area * x * x,
+        .a01 = area * x * y,
+        .a02 = area * x * z,
+        .a11 = area * y * y,
+        .a12 = area * y * z,
+        .a22 = area * z * z,
+        .b0 = area * x * d,
+        .b1 = area * y * d,
+        .b2 = area * z * d,
+        .c = area * d * d,
+        .weight = area,
+    };
+}
+
+auto Quadric::operator+=(Quadric const& other) -> Quadric&
+{
+    a00 += other.a00;
+    a01 += other.a01;
+    a02 += other.a02;
+    a11 += other.a11;
+    a12 += other.a12;
+    a22 += other.a22;
+    b0 += other.b0;
+    b1 += other.b1;
+    b2 += other.b2;
+    c += other.c;
+    weight += other.weight;
+    return *this;
+}
+
+auto Quadric::error(glm::vec3 const position) const -> double
+{
+    if (weight <= 0.0)
+    {
+        return 0.0;
+    }
+
+    auto const x{static_cast<double>(position.x)};
+    auto const y{static_cast<double>(position.y)};
+    auto const z{static_cast<double>(position.z)};
+
+    double const quadratic{
+        a00 * x * x + a11 * y * y + a22 * z * z
+        + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+    };
+    double const linear{2.0 * (b0 * x + b1 * y + b2 * z)};
+
+    // Rounding can push a true zero slightly negative.
+    return std::max((quadratic + linear + c) / weight, 0.0);
+}
+
+auto edgeKey(uint32_t const a, uint32_t const b) -> uint64_t
+{
+    uint32_t constexpr HIGH_SHIFT{32};
+    return (static_cast<uint64_t>(std::min(a, b)) << HIGH_SHIFT)
+         | static_cast<uint64_t>(std::max(a, b));
+}
+
+auto edgeStart(uint64_t const key) -> uint32_t
+{
+    uint32_t constexpr HIGH_SHIFT{32};
+    return static_cast<uint32_t>(key >> HIGH_SHIFT);
+}
+
+auto edgeEnd(uint64_t const key) -> uint32_t
+{
+    return static_cast<uint32_t>(key);
+}
+
+// Simplifies one surface, whose vertices are renumbered from 0 in sorted order.
+// Surfaces are usually a small part of their mesh, so this keeps the
+// per-vertex bookkeeping proportional to the surface.
+struct SurfaceSimplifier
+{
+public:
+    SurfaceSimplifier(
+        std::span<uint32_t const> surfaceIndices,
+        std::span<syzygy::VertexPacked const> vertices
+    );
+
+    // Collapses edges until at most targetTriangles remain, or until no more
+    // edges can be collapsed.
+    void simplify(size_t targetTriangles);
+
+    [[nodiscard]] auto triangleCount() const -> size_t;
+
+    // The furthest the surface has moved, as the error of the most expensive
+    // collapse so far.
+    [[nodiscard]] auto error() const -> float;
+
+    // Appends the current triangles, indexing the mesh's vertices.
+    void appendIndices(std::vector<uint32_t>& meshIndices) const;
+
+private:
+    struct Collapse
+    {
+        uint32_t from{0};
+        uint32_t to{0};
+        double cost{0.0};
+    };
+
+    void lockBordersAndSeams();
+
+    [[nodiscard]] auto collectCollapses() const -> std::vector<Collapse>;
+
+    // Whether moving from onto to would turn over, or flatten, any triangle
+    // around from that is not removed by the collapse.
+    [[nodiscard]] auto collapseFlips(
+        Collapse const& collapse, std::span<uint32_t const> triangles
+    ) const -> bool;
+
+    std::vector<uint32_t> m_indices{};
+    // Maps the local vertices back into the mesh.
+    std::vector<uint32_t> m_meshVertices{};
+    std::vector<glm::vec3> m_positions{};
+    std::vector<Quadric> m_quadrics{};
+    std::vector<bool> m_locked{};
+
+    double m_squaredError{0.0};
+};
+
+SurfaceSimplifier::SurfaceSimplifier(
+    std::span<uint32_t const> const surfaceIndices,
+    std::span<syzygy::VertexPacked const> const vertices
+)
+    : m_meshVertices(surfaceIndices.begin(), surfaceIndices.end())
+{
+    std::sort(m_meshVertices.begin(), m_meshVertices.end());
+    m_meshVertices.erase(
+        std::unique(m_meshVertices.begin(), m_meshVertices.end()),
+        m_meshVertices.end()
+    );
+
+    m_positions.reserve(m_meshVertices.size());
+    for (uint32_t const meshVertex : m_meshVertices)
+    {
+        m_positions.push_back(vertices[meshVertex].position);
+    }
+
+    auto const localVertex{[&](uint32_t const meshVertex)
+    {
+        return static_cast<uint32_t>(
+            std::lower_bound(
+                m_meshVertices.begin(), m_meshVertices.end(), meshVertex
+            )
+            - m_meshVertices.begin()
+        );
+    }};
+
+    // Degenerate triangles draw nothing, so they are dropped up front.
+    m_indices.reserve(surfaceIndices.size());
+    for (size_t index{0}; index + TRIANGLE_VERTICES <= surfaceIndices.size();
+         index += TRIANGLE_VERTICES)
+    {
+        uint32_t const a{localVertex(surfaceIndices[index])};
+        uint32_t const b{localVertex(surfaceIndices[index + 1])};
+        uint32_t const c{localVertex(surfaceIndices[index + 2])};
+        if (a == b || b == c || c == a)
+        {
+            continue;
+        }
+        m_indices.insert(m_indices.end(), {a, b, c});
+    }
+
+    m_quadrics.resize(m_meshVertices.size());
+    for (size_t index{0}; index < m_indices.size(); index += TRIANGLE_VERTICES)
+    {
+        Quadric const quadric{Quadric::fromTriangle(
+            m_positions[m_indices[index]],
+            m_positions[m_indices[index + 1]],
+            m_positions[m_indices[index + 2]]
+        )};
+        for (size_t corner{0}; corner < TRIANGLE_VERTICES; corner++)
+        {
+            m_quadrics[m_indices[index + corner]] += quadric;
+        }
+    }
+
+    lockBordersAndSeams();
+}
+
+void SurfaceSimplifier::lockBordersAndSeams()
+{
+    // Vertices are grouped by position, so that seams are found and so that
+    // borders are found regardless of how the vertices are split.
+
+    std::vector<uint32_t> byPosition(m_positions.size());
+    std::iota(byPosition.begin(), byPosition.end(), 0);
+    std::sort(
+        byPosition.begin(),
+        byPosition.end(),
+        [&](uint32_t const lhs, uint32_t const rhs)
+    {
+        glm::vec3 const& left{m_positions[lhs]};
+        glm::vec3 const& right{m_positions[rhs]};
+        if (left.x != right.x)
+        {
+            return left.x < right.x;
+        }
+        if (left.y != right.y)
+        {
+            return left.y < right.y;
+        }
+        return left.z < right.z;
+    }
+    );
+
+    std::vector<uint32_t> positionIds(m_positions.size(), 0);
+    std::vector<bool> lockedPositions{};
+    for (size_t begin{0}; begin < byPosition.size();)
+    {
+        size_t end{begin + 1};
+        while (end < byPosition.size()
+               && m_positions[byPosition[end]]
+                      == m_positions[byPosition[begin]])
+        {
+            end++;
+        }
+
+        for (size_t member{begin}; member < end; member++)
+        {
+            positionIds[byPosition[member]] =
+                static_cast<uint32_t>(lockedPositions.size());
+        }
+        // Several vertices at one position make a seam.
+        lockedPositions.push_back(end - begin > 1);
+
+        begin = end;
+    }
+
+    // An edge that is not shared by exactly two triangles is on a border, or
+    // is non-manifold.
+    std::vector<uint64_t> edges{};
+    edges.reserve(m_indices.size());
+    for (size_t index{0}; index < m_indices.size(); index += TRIANGLE_VERTICES)
+    {
+        for (uint32_t edge{0}; edge < TRIANGLE_EDGES; edge++)
+        {
+            uint32_t const start{positionIds[m_indices[index + edge]]};
+            uint32_t const end{
+                positionIds[m_indices[index + (edge + 1) % TRIANGLE_EDGES]]
+            };
+            if (start != end)
+            {
+                edges.push_back(edgeKey(start, end));
+            }
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+
+    for (size_t begin{0}; begin < edges.size();)
+    {
+        size_t end{begin + 1};
+        while (end < edges.size() && edges[end] == edges[begin])
+        {
+            end++;
+        }
+
+        if (end - begin != 2)
+        {
+            lockedPositions[edgeStart(edges[begin])] = true;
+            lockedPositions[edgeEnd(edges[begin])] = true;
+        }
+
+        begin = end;
+    }
+
+    m_locked.resize(m_positions.size());
+    for (size_t vertex{0}; vertex < m_positions.size(); vertex++)
+    {
+        m_locked[vertex] = lockedPositions[positionIds[vertex]];
+    }
+}
+
+auto SurfaceSimplifier::collectCollapses() const -> std::vector<Collapse>
+{
+    std::vector<uint64_t> edges{};
+    edges.reserve(m_indices.size());
+    for (size_t index{0}; index < m_indices.size(); index += TRIANGLE_VERTICES)
+    {
+        for (uint32_t edge{0}; edge < TRIANGLE_EDGES; edge++)
+        {
+            edges.push_back(edgeKey(
+                m_indices[index + edge],
+                m_indices[index + (edge + 1) % TRIANGLE_EDGES]
+            ));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    std::vector<Collapse> collapses{};
+    collapses.reserve(edges.size());
+    for (uint64_t const edge : edges)
+    {
+        uint32_t const a{edgeStart(edge)};
+        uint32_t const b{edgeEnd(edge)};
+        if (m_locked[a] && m_locked[b])
+        {
+            continue;
+        }
+
+        Quadric combined{m_quadrics[a]};
+        combined += m_quadrics[b];
+
+        Collapse const aOntoB{
+            .from = a,
+            .to = b,
+            .cost = combined.error(m_positions[b]),
+        };
+        Collapse const bOntoA{
+            .from = b,
+            .to = a,
+            .cost = combined.error(m_positions[a]),
+        };
+
+        if (m_locked[a])
+        {
+            collapses.push_back(bOntoA);
+        }
+        else if (m_locked[b])
+        {
+            collapses.push_back(aOntoB);
+        }
+        else
+        {
+            collapses.push_back(aOntoB.cost <= bOntoA.cost ? aOntoB : bOntoA);
+        }
+    }
+
+    return collapses;
+}
+
+auto SurfaceSimplifier::collapseFlips(
+    Collapse const& collapse, std::span<uint32_t const> const triangles
+) const -> bool
+{
+    for (uint32_t const triangle : triangles)
+    {
+        std::span<uint32_t const> const corners{
+            std::span{m_indices}.subspan(
+                triangle * TRIANGLE_VERTICES, TRIANGLE_VERTICES
+            )
+        };
+        if (std::find(corners.begin(), corners.end(), collapse.to)
+            != corners.end())
+        {
+            // Removed by the collapse.
+            continue;
+        }
+
+        glm::vec3 const a{m_positions[corners[0]]};
+        glm::vec3 const b{m_positions[corners[1]]};
+        glm::vec3 const c{m_positions[corners[2]]};
+
+        glm::vec3 const target{m_positions[collapse.to]};
+        auto const moved{[&](uint32_t const vertex, glm::vec3 const position)
+        { return vertex == collapse.from ? target : position; }};
+
+        glm::vec3 const before{glm::cross(b - a, c - a)};
+        glm::vec3 const after{glm::cross(
+            moved(corners[1], b) - moved(corners[0], a),
+            moved(corners[2], c) - moved(corners[0], a)
+        )};
+        if (glm::dot(before, after) <= 0.0F)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void SurfaceSimplifier::simplify(size_t const targetTriangles)
+{
+    while (triangleCount() > targetTriangles)
+    {
+        std::vector<Collapse> collapses{collectCollapses()};
+        if (collapses.empty())
+        {
+            return;
+        }
+        std::sort(
+            collapses.begin(),
+            collapses.end(),
+            [](Collapse const& lhs, Collapse const& rhs)
+        { return lhs.cost < rhs.cost; }
+        );
+        double const passCostLimit{
+            collapses[collapses.size() / PASS_CANDIDATE_DIVISOR].cost
+        };
+
+        // The triangles around each vertex, which only change at the end of
+        // the pass.
+        std::vector<uint32_t> triangleOffsets(m_positions.size() + 1, 0);
+        for (uint32_t const vertex : m_indices)
+        {
+            triangleOffsets[vertex + 1]++;
+        }
+        std::partial_sum(
+            triangleOffsets.begin(),
+            triangleOffsets.end(),
+            triangleOffsets.begin()
+        );
+        std::vector<uint32_t> vertexTriangles(m_indices.size());
+        {
+            std::vector<uint32_t> cursors(
+                triangleOffsets.begin(), triangleOffsets.end() - 1
+            );
+            for (size_t index{0}; index < m_indices.size(); index++)
+            {
+                vertexTriangles[cursors[m_indices[index]]++] =
+                    static_cast<uint32_t>(index / TRIANGLE_VERTICES);
+            }
+        }
+
+        // A vertex is touched once any triangle around it changes, after which
+        // its triangles and quadric are stale until the next pass.
+        std::vector<bool> touched(m_positions.size(), false);
+        std::vector<uint32_t> remap(m_positions.size());
+        std::iota(remap.begin(), remap.end(), 0);
+
+        size_t triangles{triangleCount()};
+        size_t collapsed{0};
+        for (Collapse const& collapse : collapses)
+        {
+            if (triangles <= targetTriangles
+                || (collapsed > 0 && collapse.cost > passCostLimit))
+            {
+                break;
+            }
+            if (touched[collapse.from] || touched[collapse.to])
+            {
+                continue;
+            }
+
+            std::span<uint32_t const> const fromTriangles{
+                std::span{vertexTriangles}.subspan(
+                    triangleOffsets[collapse.from],
+                    triangleOffsets[collapse.from + 1]
+                        - triangleOffsets[collapse.from]
+                )
+            };
+            if (collapseFlips(collapse, fromTriangles))
+            {
+                continue;
+            }
+
+            for (uint32_t const triangle : fromTriangles)
+            {
+                bool removed{false};
+                for (size_t corner{0}; corner < TRIANGLE_VERTICES; corner++)
+                {
+                    uint32_t const vertex{
+                        m_indices[triangle * TRIANGLE_VERTICES + corner]
+                    };
+                    touched[vertex] = true;
+                    removed = removed || vertex == collapse.to;
+                }
+                triangles -= removed ? 1 : 0;
+            }
+
+            remap[collapse.from] = collapse.to;
+            m_quadrics[collapse.to] += m_quadrics[collapse.from];
+            m_squaredError = std::max(m_squaredError, collapse.cost);
+            collapsed++;
+        }
+
+        if (collapsed == 0)
+        {
+            return;
+        }
+
+        // No collapse was onto a vertex that also moved, so one lookup is
+        // enough.
+        size_t kept{0};
+        for (size_t index{0}; index < m_indices.size();
+             index += TRIANGLE_VERTICES)
+        {
+            uint32_t const a{remap[m_indices[index]]};
+            uint32_t const b{remap[m_indices[index + 1]]};
+            uint32_t const c{remap[m_indices[index + 2]]};
+            if (a == b || b == c || c == a)
+            {
+                continue;
+            }
+            m_indices[kept++] = a;
+            m_indices[kept++] = b;
+            m_indices[kept++] = c;
+        }
+        m_indices.resize(kept);
+    }
+}
+
+auto SurfaceSimplifier::triangleCount() const -> size_t
+{
+    return m_indices.size() / TRIANGLE_VERTICES;
+}
+
+auto SurfaceSimplifier::error() const -> float
+{
+    return static_cast<float>(std::sqrt(m_squaredError));
+}
+
+void SurfaceSimplifier::appendIndices(std::vector<uint32_t>& meshIndices) const
+{
+    meshIndices.reserve(meshIndices.size() + m_indices.size());
+    for (uint32_t const vertex : m_indices)
+    {
+        meshIndices.push_back(m_meshVertices[vertex]);
+    }
+}
+} // namespace
+
+namespace syzygy
+{
+auto MeshLodChain::levelCount() const -> size_t { return errors.size(); }
+
+auto MeshLodChain::build(
+    std::span<CookedSurface const> const surfaces,
+    std::vector<uint32_t>& indices,
+    std::span<VertexPacked const> const vertices
+) -> MeshLodChain
+{
+    for (CookedSurface const& surface : surfaces)
+    {
+        if (static_cast<size_t>(surface.firstIndex) + surface.indexCount
+            > indices.size())
+        {
+            return MeshLodChain{};
+        }
+    }
+    if (std::any_of(
+            indices.begin(),
+            indices.end(),
+            [&](uint32_t const index) { return index >= vertices.size(); }
+        ))
+    {
+        return MeshLodChain{};
+    }
+
+    std::vector<SurfaceSimplifier> simplifiers{};
+    simplifiers.reserve(surfaces.size());
+    size_t previousTriangles{0};
+    for (CookedSurface const& surface : surfaces)
+    {
+        simplifiers.emplace_back(
+            std::span{indices}.subspan(surface.firstIndex, surface.indexCount),
+            vertices
+        );
+        previousTriangles += simplifiers.back().triangleCount();
+    }
+
+    MeshLodChain chain{};
+    while (chain.levelCount() < MAX_LEVELS)
+    {
+        size_t levelTriangles{0};
+        float levelError{0.0F};
+        for (SurfaceSimplifier& simplifier : simplifiers)
+        {
+            simplifier.simplify(static_cast<size_t>(
+                static_cast<float>(simplifier.triangleCount()) * LEVEL_REDUCTION
+            ));
+            levelTriangles += simplifier.triangleCount();
+            levelError = std::max(levelError, simplifier.error());
+        }
+
+        if (levelTriangles == 0
+            || static_cast<float>(levelTriangles)
+                   > static_cast<float>(previousTriangles) * MINIMUM_REDUCTION)
+        {
+            break;
+        }
+
+        for (size_t surface{0}; surface < surfaces.size(); surface++)
+        {
+            auto const firstIndex{static_cast<uint32_t>(indices.size())};
+            simplifiers[surface].appendIndices(indices);
+            auto const indexCount{
+                static_cast<uint32_t>(indices.size() - firstIndex)
+            };
+            chain.surfaces.push_back(CookedSurface{
+                .firstIndex = firstIndex,
+                .indexCount = indexCount,
+                .materialIndex = surfaces[surface].materialIndex,
+            });
+        }
+        chain.errors.push_back(levelError);
+        previousTriangles = levelTriangles;
+    }
+
+    return chain;
+}
+} // namespace syzygy
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "syzygy/assets/meshcache.hpp"
+#include "syzygy/platform/integer.hpp"
+#include <span>
+#include <vector>
+
+namespace syzygy
+{
+struct VertexPacked;
+
+// Coarser levels of detail of a mesh, made by simplifying each of its surfaces.
+// Levels are drawn from the mesh's own vertices, with their indices appended
+// after the mesh's indices.
+struct MeshLodChain
+{
+    // Levels besides the mesh itself, so a mesh has at most this plus one LODs.
+    static size_t constexpr MAX_LEVELS{4};
+
+    // Each level aims for this fraction of the previous level's triangles.
+    static float constexpr LEVEL_REDUCTION{0.5F};
+
+    // The chain ends at the first level that keeps more than this fraction of
+    // the previous level's triangles, since it would save too little to be
+    // worth drawing.
+    static float constexpr MINIMUM_REDUCTION{0.8F};
+
+    // Every level's surfaces, concatenated. Each level has one surface per
+    // surface of the mesh, in the same order and with the same material.
+    std::vector<CookedSurface> surfaces{};
+
+    // For each level, roughly how far its surfaces deviate from the mesh's, in
+    // the same space as the vertex positions. This only grows with each level.
+    std::vector<float> errors{};
+
+    [[nodiscard]] auto levelCount() const -> size_t;
+
+    // Surfaces are simplified by collapsing edges in order of the quadric error
+    // of Garland and Heckbert, onto whichever endpoint is cheaper, so no
+    // vertices are added. Vertices on the border of a surface, or on a seam
+    // where several vertices share a position, are never moved, so that levels
+    // keep their outlines and their attributes do not tear.
+    //
+    // Triangles must already be ordered for drawing, as the levels keep that
+    // order. Fails with no levels if a surface or index is out of bounds.
+    static auto build(
+        std::span<CookedSurface const> surfaces,
+        std::vector<uint32_t>& indices,
+        std::span<VertexPacked const> vertices
+    ) -> MeshLodChain;
+};
+} // namespace syzygy
@@ -0,0 +1,234 @@
+#include "mipchain.hpp"
+
+#include "syzygy/assets/texelkernels.hpp"
+#include "syzygy/platform/integer.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace
+{
+size_t constexpr RGBA_CHANNELS{4};
+float constexpr CHANNEL_MAX{255.0F};
+
+auto toByte(float const normalized) -> uint8_t
+{
+    return static_cast<uint8_t>(
+        std::lround(std::clamp(normalized, 0.0F, 1.0F) * CHANNEL_MAX)
+    );
+}
+
+// With srgb, color channels are decoded to linear space.
+void decodeRow(
+    syzygy::TexelKernels const& kernels,
+    std::span<uint8_t const> const rgba,
+    bool const srgb,
+    std::span<float> const linear
+)
+{
+    if (srgb)
+    {
+        kernels.srgbToLinear(rgba, linear);
+        return;
+    }
+    for (size_t index{0}; index < rgba.size(); index++)
+    {
+        linear[index] = static_cast<float>(rgba[index]) / CHANNEL_MAX;
+    }
+}
+
+// The source texels that a destination texel covers along one axis. Each
+// covers two, except when the source has one, and the last covers three when
+// the source is odd, so that no texel is dropped.
+struct AxisTaps
+{
+    std::array<uint32_t, 3> indices{};
+    uint32_t count{0};
+};
+
+auto axisTaps(uint32_t const destination, uint32_t const sourceSize)
+    -> AxisTaps
+{
+    if (sourceSize == 1)
+    {
+        return AxisTaps{.indices = {0, 0, 0}, .count = 1};
+    }
+
+    AxisTaps taps{
+        .indices = {destination * 2, destination * 2 + 1, 0},
+        .count = 2,
+    };
+    if (sourceSize % 2 == 1 && destination * 2 + 3 == sourceSize)
+    {
+        taps.indices[2] = destination * 2 + 2;
+        taps.count = 3;
+    }
+    return taps;
+}
+
+void encodeRow(
+    syzygy::TexelKernels const& kernels,
+    std::span<float const> const linear,
+    bool const srgb,
+    std::span<uint8_t> const rgba
+)
+{
+    if (srgb)
+    {
+        kernels.linearToSRGB(linear, rgba);
+        return;
+    }
+    for (size_t index{0}; index < linear.size(); index++)
+    {
+        rgba[index] = toByte(linear[index]);
+    }
+}
+} // namespace
+
+namespace syzygy
+{
+auto MipChain::levelCount(uint32_t width, uint32_t height) -> uint32_t
+{
+    uint32_t levels{1};
+    while (width > 1 || height > 1)
+    {
+        width = std::max(width / 2, 1U);
+        height = std::max(height / 2, 1U);
+        levels++;
+    }
+    return levels;
+}
+
+// Each destination texel averages the 2x2 source texels it covers. Along an
+// odd source edge, the last destination texel also covers the trailing row or
+// column, averaging up to 3x3 texels with equal weights.
+//
+// Source rows are converted to linear floats, and averaged rows converted back,
+// with TexelKernels.
+void MipChain::downsample(
+    std::span<uint8_t const> const source,
+    uint32_t const sourceWidth,
+    uint32_t const sourceHeight,
+    bool const srgb,
+    std::span<uint8_t> const destination
+)
+{
+    uint32_t const width{std::max(sourceWidth / 2, 1U)};
+    uint32_t const height{std::max(sourceHeight / 2, 1U)};
+    assert(
+        destination.size()
+        >= static_cast<size_t>(width) * height * RGBA_CHANNELS
+    );
+
+    TexelKernels const& kernels{TexelKernels::best()};
+
+    size_t const sourceRowValues{
+        static_cast<size_t>(sourceWidth) * RGBA_CHANNELS
+    };
+    size_t const rowValues{static_cast<size_t>(width) * RGBA_CHANNELS};
+
+    std::array<std::vector<float>, 3> sourceRows{
+        std::vector<float>(sourceRowValues),
+        std::vector<float>(sourceRowValues),
+        std::vector<float>(sourceRowValues),
+    };
+    std::vector<float> averaged(rowValues);
+
+    for (uint32_t y{0}; y < height; y++)
+    {
+        AxisTaps const rows{axisTaps(y, sourceHeight)};
+        for (uint32_t row{0}; row < rows.count; row++)
+        {
+            decodeRow(
+                kernels,
+                source.subspan(
+                    rows.indices[row] * sourceRowValues, sourceRowValues
+                ),
+                srgb,
+                sourceRows[row]
+            );
+        }
+
+        for (uint32_t x{0}; x < width; x++)
+        {
+            AxisTaps const columns{axisTaps(x, sourceWidth)};
+            float const weight{
+                1.0F / static_cast<float>(rows.count * columns.count)
+            };
+            for (size_t channel{0}; channel < RGBA_CHANNELS; channel++)
+            {
+                float sum{0.0F};
+                for (uint32_t row{0}; row < rows.count; row++)
+                {
+                    for (uint32_t column{0}; column < columns.count; column++)
+                    {
+                        sum += sourceRows[row]
+                                         [columns.indices[column]
+                                              * RGBA_CHANNELS
+                                          + channel];
+                    }
+                }
+                averaged[x * RGBA_CHANNELS + channel] = sum * weight;
+            }
+        }
+
+        encodeRow(
+            kernels,
+            averaged,
+            srgb,
+            destination.subspan(y * rowValues, rowValues)
+        );
+    }
+}
+
+auto MipChain::chainBytes(uint32_t width, uint32_t height) -> size_t
+{
+    size_t bytes{static_cast<size_t>(width) * height * RGBA_CHANNELS};
+    while (width > 1 || height > 1)
+    {
+        width = std::max(width / 2, 1U);
+        height = std::max(height / 2, 1U);
+        bytes += static_cast<size_t>(width) * height * RGBA_CHANNELS;
+    }
+    return bytes;
+}
+
+auto MipChain::generate(
+    std::span<uint8_t const> const rgba,
+    uint32_t const width,
+    uint32_t const height,
+    bool const srgb
+) -> std::vector<Level>
+{
+    assert(rgba.size() >= static_cast<size_t>(width) * height * RGBA_CHANNELS);
+
+    std::vector<Level> levels{};
+    levels.reserve(levelCount(width, height) - 1);
+
+    std::span<uint8_t const> source{rgba};
+    uint32_t sourceWidth{width};
+    uint32_t sourceHeight{height};
+    while (sourceWidth > 1 || sourceHeight > 1)
+    {
+        Level level{
+            .width = std::max(sourceWidth / 2, 1U),
+            .height = std::max(sourceHeight / 2, 1U),
+        };
+        level.rgba.resize(
+            static_cast<size_t>(level.width) * level.height * RGBA_CHANNELS
+        );
+        downsample(source, sourceWidth, sourceHeight, srgb, level.rgba);
+        levels.push_back(std::move(level));
+
+        source = levels.back().rgba;
+        sourceWidth = levels.back().width;
+        sourceHeight = levels.back().height;
+    }
+
+    return levels;
+}
+} // namespace syzygy
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "syzygy/platform/integer.hpp"
+#include <span>
+#include <vector>
+
+namespace syzygy
+{
+// Mip levels of an 8-bit RGBA image, each half the size of the last down to
+// 1x1, produced with a box filter. Odd edges are folded into the last texel
+// rather than dropped.
+struct MipChain
+{
+    struct Level
+    {
+        uint32_t width{0};
+        uint32_t height{0};
+        std::vector<uint8_t> rgba{};
+    };
+
+    // Including the full resolution level.
+    [[nodiscard]] static auto levelCount(uint32_t width, uint32_t height)
+        -> uint32_t;
+
+    // The size in bytes of every level, including level 0, packed back to back.
+    [[nodiscard]] static auto chainBytes(uint32_t width, uint32_t height)
+        -> size_t;
+
+    // Writes the level below the source into destination, which must have room
+    // for it. This allows levels to be written in place, such as into staging
+    // memory.
+    static void downsample(
+        std::span<uint8_t const> source,
+        uint32_t sourceWidth,
+        uint32_t sourceHeight,
+        bool srgb,
+        std::span<uint8_t> destination
+    );
+
+    // Returns every level below the source, which is level 0. With srgb, color
+    // channels are averaged in linear space, while alpha is always linear.
+    static auto generate(
+        std::span<uint8_t const> rgba,
+        uint32_t width,
+        uint32_t height,
+        bool srgb
+    ) -> std::vector<Level>;
+};
+} // namespace syzygy
@@ -0,0 +1,355 @@
+#include "texelkernels.hpp"
+
+#include "syzygy/assets/texelkernelsdetail.hpp"
+#include "syzygy/platform/cpufeatures.hpp"
+#include "syzygy/platform/integer.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <span>
+
+namespace
+{
+using detail_texelkernels::CHANNEL_MAX;
+using detail_texelkernels::NORMAL_SCALE;
+using detail_texelkernels::RGB_CHANNELS;
+using detail_texelkernels::RGBA_CHANNELS;
+using detail_texelkernels::SRGB_ENCODE_MIN;
+
+auto srgbToLinear(double const encoded) -> double
+{
+    // NOLINTBEGIN(readability-magic-numbers)
+    return encoded <= 0.04045 ? encoded / 12.92
+                              : std::pow((encoded + 0.055) / 1.055, 2.4);
+    // NOLINTEND(readability-magic-numbers)
+}
+
+auto bucketOf(float const clamped) -> size_t
+{
+    return (std::bit_cast<uint32_t>(clamped)
+            - std::bit_cast<uint32_t>(SRGB_ENCODE_MIN))
+        >> detail_texelkernels::SRGB_BUCKET_SHIFT;
+}
+
+auto loadTexel(uint8_t const* const bytes) -> uint32_t
+{
+    uint32_t texel{0};
+    std::memcpy(&texel, bytes, sizeof(texel));
+    return texel;
+}
+
+void storeTexel(uint8_t* const bytes, uint32_t const texel)
+{
+    std::memcpy(bytes, &texel, sizeof(texel));
+}
+
+void overrideChannels(
+    std::span<uint8_t> const rgba, uint32_t const keepMask, uint32_t const fill
+)
+{
+    uint32_t const fillMasked{fill & ~keepMask};
+    for (size_t offset{0}; offset + RGBA_CHANNELS <= rgba.size();
+         offset += RGBA_CHANNELS)
+    {
+        uint8_t* const texel{rgba.data() + offset};
+        storeTexel(texel, (loadTexel(texel) & keepMask) | fillMasked);
+    }
+}
+
+void expandRGBToRGBA(
+    std::span<uint8_t const> const rgb,
+    std::span<uint8_t> const rgba,
+    uint8_t const alpha
+)
+{
+    size_t const texels{rgb.size() / RGB_CHANNELS};
+    assert(rgba.size() >= texels * RGBA_CHANNELS);
+
+    for (size_t texel{0}; texel < texels; texel++)
+    {
+        uint8_t const* const source{rgb.data() + texel * RGB_CHANNELS};
+        uint8_t* const destination{rgba.data() + texel * RGBA_CHANNELS};
+        destination[0] = source[0];
+        destination[1] = source[1];
+        destination[2] = source[2];
+        destination[3] = alpha;
+    }
+}
+
+void packORM(
+    std::span<uint8_t const> const occlusion,
+    std::span<uint8_t const> const roughnessMetallic,
+    std::span<uint8_t> const orm
+)
+{
+    // NOLINTBEGIN(readability-magic-numbers)
+    uint32_t constexpr OCCLUSION_MASK{0x000000FFU};
+    uint32_t constexpr ROUGHNESS_METALLIC_MASK{0x00FFFF00U};
+    uint32_t constexpr OPAQUE_ALPHA{0xFF000000U};
+    // NOLINTEND(readability-magic-numbers)
+
+    assert(
+        occlusion.size() == orm.size() && roughnessMetallic.size() == orm.size()
+    );
+    for (size_t offset{0}; offset + RGBA_CHANNELS <= orm.size();
+         offset += RGBA_CHANNELS)
+    {
+        storeTexel(
+            orm.data() + offset,
+            (loadTexel(occlusion.data() + offset) & OCCLUSION_MASK)
+                | (loadTexel(roughnessMetallic.data() + offset)
+                   & ROUGHNESS_METALLIC_MASK)
+                | OPAQUE_ALPHA
+        );
+    }
+}
+
+// The order of operations is mirrored exactly by the vectorized kernels, so
+// every version rounds identically.
+auto encodeNormalComponent(float const component) -> uint8_t
+{
+    float const encoded{std::nearbyint(component * NORMAL_SCALE + NORMAL_SCALE)
+    };
+    return static_cast<uint8_t>(std::clamp(encoded, 0.0F, CHANNEL_MAX));
+}
+
+void renormalizeNormals(std::span<uint8_t> const rgba)
+{
+    for (size_t offset{0}; offset + RGBA_CHANNELS <= rgba.size();
+         offset += RGBA_CHANNELS)
+    {
+        uint8_t* const texel{rgba.data() + offset};
+
+        float const x{static_cast<float>(texel[0]) / NORMAL_SCALE - 1.0F};
+        float const y{static_cast<float>(texel[1]) / NORMAL_SCALE - 1.0F};
+        float const z{static_cast<float>(texel[2]) / NORMAL_SCALE - 1.0F};
+
+        // Components are never exactly 0, so this is never 0.
+        float const inverseLength{1.0F / std::sqrt(x * x + y * y + z * z)};
+
+        texel[0] = encodeNormalComponent(x * inverseLength);
+        texel[1] = encodeNormalComponent(y * inverseLength);
+        texel[2] = encodeNormalComponent(z * inverseLength);
+    }
+}
+
+void srgbToLinearTexels(
+    std::span<uint8_t const> const rgba, std::span<float> const linear
+)
+{
+    assert(linear.size() >= rgba.size());
+
+    std::array<float, detail_texelkernels::CHANNEL_VALUES> const& decode{
+        detail_texelkernels::srgbDecodeTable()
+    };
+    for (size_t offset{0}; offset + RGBA_CHANNELS <= rgba.size();
+         offset += RGBA_CHANNELS)
+    {
+        for (size_t channel{0}; channel < RGB_CHANNELS; channel++)
+        {
+            linear[offset + channel] = decode[rgba[offset + channel]];
+        }
+        linear[offset + RGB_CHANNELS] =
+            static_cast<float>(rgba[offset + RGB_CHANNELS]) / CHANNEL_MAX;
+    }
+}
+
+auto encodeSRGB(float const linear) -> uint8_t
+{
+    std::array<float, detail_texelkernels::SRGB_THRESHOLD_COUNT> const&
+        thresholds{detail_texelkernels::srgbEncodeThresholds()};
+    std::array<int32_t, detail_texelkernels::SRGB_BUCKET_COUNT> const& buckets{
+        detail_texelkernels::srgbEncodeBuckets()
+    };
+
+    // Written as the vectorized min and max are, so NaN becomes 0.
+    float const clampedLow{
+        linear > SRGB_ENCODE_MIN ? linear : SRGB_ENCODE_MIN
+    };
+    float const clamped{clampedLow < 1.0F ? clampedLow : 1.0F};
+
+    // A branchless binary search within the bucket, counting thresholds not
+    // above the value.
+    uint32_t index{static_cast<uint32_t>(buckets[bucketOf(clamped)])};
+    for (uint32_t step{detail_texelkernels::SRGB_BUCKET_SEARCH_STEP}; step > 0;
+         step /= 2)
+    {
+        index += clamped >= thresholds[index + step - 1] ? step : 0;
+    }
+    return static_cast<uint8_t>(index);
+}
+
+auto encodeUNORM(float const value) -> uint8_t
+{
+    // Written as the vectorized min and max are, so NaN becomes 0.
+    float const clampedLow{value > 0.0F ? value : 0.0F};
+    float const clamped{clampedLow < 1.0F ? clampedLow : 1.0F};
+    return static_cast<uint8_t>(std::nearbyint(clamped * CHANNEL_MAX));
+}
+
+void linearToSRGBTexels(
+    std::span<float const> const linear, std::span<uint8_t> const rgba
+)
+{
+    assert(rgba.size() >= linear.size());
+
+    for (size_t offset{0}; offset + RGBA_CHANNELS <= linear.size();
+         offset += RGBA_CHANNELS)
+    {
+        for (size_t channel{0}; channel < RGB_CHANNELS; channel++)
+        {
+            rgba[offset + channel] = encodeSRGB(linear[offset + channel]);
+        }
+        rgba[offset + RGB_CHANNELS] =
+            encodeUNORM(linear[offset + RGB_CHANNELS]);
+    }
+}
+} // namespace
+
+namespace detail_texelkernels
+{
+auto srgbDecodeTable() -> std::array<float, CHANNEL_VALUES> const&
+{
+    static std::array<float, CHANNEL_VALUES> const table{[]()
+    {
+        std::array<float, CHANNEL_VALUES> values{};
+        for (size_t value{0}; value < CHANNEL_VALUES; value++)
+        {
+            values[value] = static_cast<float>(
+                srgbToLinear(static_cast<double>(value) / CHANNEL_MAX)
+            );
+        }
+        return values;
+    }()};
+    return table;
+}
+
+auto srgbEncodeThresholds() -> std::array<float, SRGB_THRESHOLD_COUNT> const&
+{
+    static std::array<float, SRGB_THRESHOLD_COUNT> const table{[]()
+    {
+        std::array<float, SRGB_THRESHOLD_COUNT> values{};
+        values.fill(std::numeric_limits<float>::infinity());
+        for (size_t value{0}; value < CHANNEL_VALUES - 1; value++)
+        {
+            values[value] = static_cast<float>(
+                srgbToLinear((static_cast<double>(value) + 0.5) / CHANNEL_MAX)
+            );
+        }
+        return values;
+    }()};
+    return table;
+}
+
+auto srgbEncodeBuckets() -> std::array<int32_t, SRGB_BUCKET_COUNT> const&
+{
+    static std::array<int32_t, SRGB_BUCKET_COUNT> const table{[]()
+    {
+        std::array<float, SRGB_THRESHOLD_COUNT> const& thresholds{
+            srgbEncodeThresholds()
+        };
+        auto const countNotAbove{[&](float const value)
+        {
+            return static_cast<int32_t>(
+                std::upper_bound(
+                    thresholds.begin(), thresholds.end(), value
+                )
+                - thresholds.begin()
+            );
+        }};
+
+        std::array<int32_t, SRGB_BUCKET_COUNT> starts{};
+        for (size_t bucket{0}; bucket < SRGB_BUCKET_COUNT; bucket++)
+        {
+            uint32_t const lowerBits{
+                std::bit_cast<uint32_t>(SRGB_ENCODE_MIN)
+                + static_cast<uint32_t>(bucket << SRGB_BUCKET_SHIFT)
+            };
+            starts[bucket] = countNotAbove(std::bit_cast<float>(lowerBits));
+
+            [[maybe_unused]] uint32_t const upperBits{
+                lowerBits + (1U << SRGB_BUCKET_SHIFT) - 1
+            };
+            assert(
+                countNotAbove(std::bit_cast<float>(upperBits)) - starts[bucket]
+                < static_cast<int32_t>(SRGB_BUCKET_SEARCH_STEP * 2)
+            );
+        }
+        return starts;
+    }()};
+    return table;
+}
+
+auto scalarKernels() -> syzygy::TexelKernels
+{
+    return syzygy::TexelKernels{
+        .overrideChannels = &overrideChannels,
+        .expandRGBToRGBA = &expandRGBToRGBA,
+        .packORM = &packORM,
+        .renormalizeNormals = &renormalizeNormals,
+        .srgbToLinear = &srgbToLinearTexels,
+        .linearToSRGB = &linearToSRGBTexels,
+    };
+}
+} // namespace detail_texelkernels
+
+namespace syzygy
+{
+auto TexelKernels::forInstructionSet(InstructionSet const instructionSet)
+    -> std::optional<TexelKernels>
+{
+    CPUFeatures const& features{CPUFeatures::detect()};
+
+    switch (instructionSet)
+    {
+    case InstructionSet::Scalar:
+        return detail_texelkernels::scalarKernels();
+    case InstructionSet::SSE41:
+        if (!features.sse41)
+        {
+            return std::nullopt;
+        }
+        return detail_texelkernels::sse41Kernels();
+    case InstructionSet::AVX2:
+        if (!features.avx2)
+        {
+            return std::nullopt;
+        }
+        return detail_texelkernels::avx2Kernels();
+    }
+
+    return std::nullopt;
+}
+
+auto TexelKernels::bestInstructionSet() -> InstructionSet
+{
+    static InstructionSet const best{[]()
+    {
+        CPUFeatures const& features{CPUFeatures::detect()};
+        if (features.avx2)
+        {
+            return InstructionSet::AVX2;
+        }
+        if (features.sse41)
+        {
+            return InstructionSet::SSE41;
+        }
+        return InstructionSet::Scalar;
+    }()};
+    return best;
+}
+
+auto TexelKernels::best() -> TexelKernels const&
+{
+    static TexelKernels const kernels{
+        forInstructionSet(bestInstructionSet())
+            .value_or(detail_texelkernels::scalarKernels())
+    };
+    return kernels;
+}
+} // namespace syzygy
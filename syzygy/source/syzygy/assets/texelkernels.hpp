@@ -0,0 +1,67 @@
+#pragma once
+
+#include "syzygy/platform/integer.hpp"
+#include <optional>
+#include <span>
+
+namespace syzygy
+{
+// Conversions over tightly packed 8-bit texels, run when textures are
+// imported. Each kernel has a scalar, SSE4.1 and AVX2 version, which produce
+// identical results. Use TexelKernels::best to get the fastest that the CPU
+// supports.
+//
+// Spans must all cover the same number of texels.
+struct TexelKernels
+{
+    enum class InstructionSet
+    {
+        Scalar,
+        SSE41,
+        AVX2,
+    };
+
+    // RGBA texels are read as little-endian 32-bit values, so red is the
+    // lowest byte. Bytes that are zero in keepMask are replaced by fill.
+    void (*overrideChannels)(
+        std::span<uint8_t> rgba, uint32_t keepMask, uint32_t fill
+    ){nullptr};
+
+    void (*expandRGBToRGBA)(
+        std::span<uint8_t const> rgb, std::span<uint8_t> rgba, uint8_t alpha
+    ){nullptr};
+
+    // Packs glTF occlusion and roughness-metallic maps into one ORM map.
+    // Red is from occlusion, green and blue from roughnessMetallic, and alpha
+    // is opaque.
+    void (*packORM)(
+        std::span<uint8_t const> occlusion,
+        std::span<uint8_t const> roughnessMetallic,
+        std::span<uint8_t> orm
+    ){nullptr};
+
+    // Rescales unsigned-encoded tangent space normals in the RGB channels to
+    // unit length, such as after they were averaged into a mip level. Alpha is
+    // kept as is.
+    void (*renormalizeNormals)(std::span<uint8_t> rgba){nullptr};
+
+    // Decodes RGB from sRGB, while alpha is only rescaled into [0, 1].
+    void (*srgbToLinear)(
+        std::span<uint8_t const> rgba, std::span<float> linear
+    ){nullptr};
+
+    // The inverse of srgbToLinear, rounding to the nearest 8-bit value. Values
+    // outside of [0, 1] are clamped.
+    void (*linearToSRGB)(
+        std::span<float const> linear, std::span<uint8_t> rgba
+    ){nullptr};
+
+    // Fails if the CPU does not support the instruction set.
+    static auto forInstructionSet(InstructionSet)
+        -> std::optional<TexelKernels>;
+
+    // Picked once, by querying the CPU.
+    static auto best() -> TexelKernels const&;
+    static auto bestInstructionSet() -> InstructionSet;
+};
+} // namespace syzygy
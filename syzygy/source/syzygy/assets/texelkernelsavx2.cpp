@@ -0,0 +1,364 @@
+#include "syzygy/assets/texelkernels.hpp"
+#include "syzygy/assets/texelkernelsdetail.hpp"
+#include "syzygy/platform/integer.hpp"
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <immintrin.h>
+#include <span>
+
+// Each function that uses intrinsics enables AVX2 for itself, so these must
+// only be called once the CPU is known to support it. FMA is deliberately left
+// off so that products are rounded the same as in the other versions.
+
+namespace
+{
+using detail_texelkernels::CHANNEL_MAX;
+using detail_texelkernels::NORMAL_SCALE;
+using detail_texelkernels::RGB_CHANNELS;
+using detail_texelkernels::RGBA_CHANNELS;
+
+size_t constexpr VECTOR_BYTES{sizeof(__m256i)};
+size_t constexpr VECTOR_TEXELS{VECTOR_BYTES / RGBA_CHANNELS};
+size_t constexpr VECTOR_FLOATS{VECTOR_BYTES / sizeof(float)};
+
+SZG_TARGET_AVX2 auto load(uint8_t const* const bytes) -> __m256i
+{
+    return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(bytes));
+}
+
+SZG_TARGET_AVX2 void store(uint8_t* const bytes, __m256i const value)
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(bytes), value);
+}
+
+SZG_TARGET_AVX2 void overrideChannels(
+    std::span<uint8_t> const rgba, uint32_t const keepMask, uint32_t const fill
+)
+{
+    __m256i const keep{_mm256_set1_epi32(static_cast<int32_t>(keepMask))};
+    __m256i const fillMasked{
+        _mm256_set1_epi32(static_cast<int32_t>(fill & ~keepMask))
+    };
+
+    size_t offset{0};
+    for (; offset + VECTOR_BYTES <= rgba.size(); offset += VECTOR_BYTES)
+    {
+        uint8_t* const texels{rgba.data() + offset};
+        store(
+            texels,
+            _mm256_or_si256(_mm256_and_si256(load(texels), keep), fillMasked)
+        );
+    }
+
+    detail_texelkernels::scalarKernels().overrideChannels(
+        rgba.subspan(offset), keepMask, fill
+    );
+}
+
+SZG_TARGET_AVX2 void expandRGBToRGBA(
+    std::span<uint8_t const> const rgb,
+    std::span<uint8_t> const rgba,
+    uint8_t const alpha
+)
+{
+    size_t const texels{rgb.size() / RGB_CHANNELS};
+    assert(rgba.size() >= texels * RGBA_CHANNELS);
+
+    size_t constexpr HALF_TEXELS{VECTOR_TEXELS / 2};
+    size_t constexpr HALF_BYTES{HALF_TEXELS * RGB_CHANNELS};
+    size_t constexpr LOAD_BYTES{sizeof(__m128i)};
+
+    // NOLINTBEGIN(readability-magic-numbers)
+    // Spreads 4 RGB texels across 4 RGBA texels in each 128-bit lane, zeroing
+    // alpha.
+    __m256i const spread{_mm256_setr_epi8(
+        0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+        0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1
+    )};
+    uint32_t const alphaTexel{static_cast<uint32_t>(alpha) << 24U};
+    // NOLINTEND(readability-magic-numbers)
+    __m256i const alphaBytes{
+        _mm256_set1_epi32(static_cast<int32_t>(alphaTexel))
+    };
+
+    // Each lane is loaded separately, since shuffles cannot cross lanes. The
+    // second load reads 4 bytes past the 24 that are used.
+    size_t texel{0};
+    for (; (texel * RGB_CHANNELS) + HALF_BYTES + LOAD_BYTES <= rgb.size();
+         texel += VECTOR_TEXELS)
+    {
+        uint8_t const* const source{rgb.data() + texel * RGB_CHANNELS};
+        __m256i const lanes{_mm256_inserti128_si256(
+            _mm256_castsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<__m128i const*>(source))
+            ),
+            _mm_loadu_si128(
+                reinterpret_cast<__m128i const*>(source + HALF_BYTES)
+            ),
+            1
+        )};
+        store(
+            rgba.data() + texel * RGBA_CHANNELS,
+            _mm256_or_si256(_mm256_shuffle_epi8(lanes, spread), alphaBytes)
+        );
+    }
+
+    detail_texelkernels::scalarKernels().expandRGBToRGBA(
+        rgb.subspan(texel * RGB_CHANNELS),
+        rgba.subspan(texel * RGBA_CHANNELS),
+        alpha
+    );
+}
+
+SZG_TARGET_AVX2 void packORM(
+    std::span<uint8_t const> const occlusion,
+    std::span<uint8_t const> const roughnessMetallic,
+    std::span<uint8_t> const orm
+)
+{
+    assert(
+        occlusion.size() == orm.size() && roughnessMetallic.size() == orm.size()
+    );
+
+    // NOLINTBEGIN(readability-magic-numbers)
+    __m256i const occlusionMask{_mm256_set1_epi32(0x000000FF)};
+    __m256i const roughnessMetallicMask{_mm256_set1_epi32(0x00FFFF00)};
+    __m256i const opaqueAlpha{
+        _mm256_set1_epi32(static_cast<int32_t>(0xFF000000U))
+    };
+    // NOLINTEND(readability-magic-numbers)
+
+    size_t offset{0};
+    for (; offset + VECTOR_BYTES <= orm.size(); offset += VECTOR_BYTES)
+    {
+        __m256i const packed{_mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_and_si256(
+                    load(occlusion.data() + offset), occlusionMask
+                ),
+                _mm256_and_si256(
+                    load(roughnessMetallic.data() + offset),
+                    roughnessMetallicMask
+                )
+            ),
+            opaqueAlpha
+        )};
+        store(orm.data() + offset, packed);
+    }
+
+    detail_texelkernels::scalarKernels().packORM(
+        occlusion.subspan(offset),
+        roughnessMetallic.subspan(offset),
+        orm.subspan(offset)
+    );
+}
+
+// Decodes the channel at shift into [-1, 1].
+SZG_TARGET_AVX2 auto decodeNormalComponent(
+    __m256i const texels, int32_t const shift
+) -> __m256
+{
+    // NOLINTNEXTLINE(readability-magic-numbers)
+    __m256i const byteMask{_mm256_set1_epi32(0xFF)};
+    __m256i const channel{
+        _mm256_and_si256(_mm256_srli_epi32(texels, shift), byteMask)
+    };
+    __m256 const scale{_mm256_set1_ps(NORMAL_SCALE)};
+    return _mm256_sub_ps(
+        _mm256_div_ps(_mm256_cvtepi32_ps(channel), scale), _mm256_set1_ps(1.0F)
+    );
+}
+
+// Encodes the rescaled component back into the channel at shift.
+SZG_TARGET_AVX2 auto encodeNormalComponent(
+    __m256 const component, __m256 const inverseLength, int32_t const shift
+) -> __m256i
+{
+    // NOLINTNEXTLINE(readability-magic-numbers)
+    __m256i const byteMask{_mm256_set1_epi32(0xFF)};
+    __m256 const scale{_mm256_set1_ps(NORMAL_SCALE)};
+    __m256i const encoded{_mm256_cvtps_epi32(_mm256_add_ps(
+        _mm256_mul_ps(_mm256_mul_ps(component, inverseLength), scale), scale
+    ))};
+    __m256i const clamped{_mm256_min_epi32(
+        _mm256_max_epi32(encoded, _mm256_setzero_si256()), byteMask
+    )};
+    return _mm256_slli_epi32(clamped, shift);
+}
+
+// Mirrors the scalar kernel's order of operations, so rounding is identical.
+SZG_TARGET_AVX2 auto renormalizeTexels(__m256i const texels) -> __m256i
+{
+    // NOLINTNEXTLINE(readability-magic-numbers)
+    __m256i const alphaMask{
+        _mm256_set1_epi32(static_cast<int32_t>(0xFF000000U))
+    };
+
+    // NOLINTBEGIN(readability-magic-numbers)
+    __m256 const x{decodeNormalComponent(texels, 0)};
+    __m256 const y{decodeNormalComponent(texels, 8)};
+    __m256 const z{decodeNormalComponent(texels, 16)};
+    // NOLINTEND(readability-magic-numbers)
+
+    __m256 const lengthSquared{_mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)),
+        _mm256_mul_ps(z, z)
+    )};
+    __m256 const inverseLength{
+        _mm256_div_ps(_mm256_set1_ps(1.0F), _mm256_sqrt_ps(lengthSquared))
+    };
+
+    // NOLINTBEGIN(readability-magic-numbers)
+    return _mm256_or_si256(
+        _mm256_or_si256(
+            encodeNormalComponent(x, inverseLength, 0),
+            encodeNormalComponent(y, inverseLength, 8)
+        ),
+        _mm256_or_si256(
+            encodeNormalComponent(z, inverseLength, 16),
+            _mm256_and_si256(texels, alphaMask)
+        )
+    );
+    // NOLINTEND(readability-magic-numbers)
+}
+
+SZG_TARGET_AVX2 void renormalizeNormals(std::span<uint8_t> const rgba)
+{
+    size_t offset{0};
+    for (; offset + VECTOR_BYTES <= rgba.size(); offset += VECTOR_BYTES)
+    {
+        uint8_t* const texels{rgba.data() + offset};
+        store(texels, renormalizeTexels(load(texels)));
+    }
+
+    detail_texelkernels::scalarKernels().renormalizeNormals(
+        rgba.subspan(offset)
+    );
+}
+
+// Alpha is the last of every four lanes.
+int32_t constexpr ALPHA_LANES{0b10001000};
+
+SZG_TARGET_AVX2 void srgbToLinear(
+    std::span<uint8_t const> const rgba, std::span<float> const linear
+)
+{
+    assert(linear.size() >= rgba.size());
+
+    float const* const decode{detail_texelkernels::srgbDecodeTable().data()};
+    __m256 const channelMax{_mm256_set1_ps(CHANNEL_MAX)};
+
+    // Two texels at a time, as eight floats.
+    size_t offset{0};
+    for (; offset + VECTOR_FLOATS <= rgba.size(); offset += VECTOR_FLOATS)
+    {
+        int64_t packed{0};
+        std::memcpy(&packed, rgba.data() + offset, sizeof(packed));
+        __m256i const channels{_mm256_cvtepu8_epi32(_mm_cvtsi64_si128(packed))};
+
+        __m256 const colors{_mm256_i32gather_ps(decode, channels, sizeof(float))
+        };
+        __m256 const unorm{
+            _mm256_div_ps(_mm256_cvtepi32_ps(channels), channelMax)
+        };
+        _mm256_storeu_ps(
+            linear.data() + offset, _mm256_blend_ps(colors, unorm, ALPHA_LANES)
+        );
+    }
+
+    detail_texelkernels::scalarKernels().srgbToLinear(
+        rgba.subspan(offset), linear.subspan(offset)
+    );
+}
+
+SZG_TARGET_AVX2 void linearToSRGB(
+    std::span<float const> const linear, std::span<uint8_t> const rgba
+)
+{
+    assert(rgba.size() >= linear.size());
+
+    float const* const thresholds{
+        detail_texelkernels::srgbEncodeThresholds().data()
+    };
+    int32_t const* const buckets{
+        detail_texelkernels::srgbEncodeBuckets().data()
+    };
+    __m256 const zero{_mm256_setzero_ps()};
+    __m256 const one{_mm256_set1_ps(1.0F)};
+    __m256 const channelMax{_mm256_set1_ps(CHANNEL_MAX)};
+    __m256 const encodeMin{
+        _mm256_set1_ps(detail_texelkernels::SRGB_ENCODE_MIN)
+    };
+
+    // The scalar kernel's search, on two texels at once. Alpha is searched
+    // too, then replaced.
+    size_t offset{0};
+    for (; offset + VECTOR_FLOATS <= linear.size(); offset += VECTOR_FLOATS)
+    {
+        __m256 const values{_mm256_loadu_ps(linear.data() + offset)};
+        __m256 const clamped{
+            _mm256_min_ps(_mm256_max_ps(values, encodeMin), one)
+        };
+
+        __m256i const bucket{_mm256_srli_epi32(
+            _mm256_sub_epi32(
+                _mm256_castps_si256(clamped), _mm256_castps_si256(encodeMin)
+            ),
+            detail_texelkernels::SRGB_BUCKET_SHIFT
+        )};
+        __m256i index{_mm256_i32gather_epi32(buckets, bucket, sizeof(int32_t))};
+        for (uint32_t step{detail_texelkernels::SRGB_BUCKET_SEARCH_STEP};
+             step > 0;
+             step /= 2)
+        {
+            __m256i const probe{_mm256_add_epi32(
+                index, _mm256_set1_epi32(static_cast<int32_t>(step - 1))
+            )};
+            __m256 const threshold{
+                _mm256_i32gather_ps(thresholds, probe, sizeof(float))
+            };
+            __m256i const above{_mm256_castps_si256(
+                _mm256_cmp_ps(clamped, threshold, _CMP_GE_OQ)
+            )};
+            __m256i const stride{_mm256_set1_epi32(static_cast<int32_t>(step))};
+            index = _mm256_add_epi32(index, _mm256_and_si256(above, stride));
+        }
+
+        __m256i const alpha{_mm256_cvtps_epi32(_mm256_mul_ps(
+            _mm256_min_ps(_mm256_max_ps(values, zero), one), channelMax
+        ))};
+        __m256i const encoded{_mm256_blend_epi32(index, alpha, ALPHA_LANES)};
+
+        // Packing works within each lane, leaving one texel in the low bytes of
+        // each.
+        __m256i const packed{_mm256_packus_epi16(
+            _mm256_packus_epi32(encoded, encoded), _mm256_setzero_si256()
+        )};
+        std::array<int32_t, 2> const texels{
+            _mm256_cvtsi256_si32(packed),
+            _mm_cvtsi128_si32(_mm256_extracti128_si256(packed, 1)),
+        };
+        std::memcpy(rgba.data() + offset, texels.data(), sizeof(texels));
+    }
+
+    detail_texelkernels::scalarKernels().linearToSRGB(
+        linear.subspan(offset), rgba.subspan(offset)
+    );
+}
+} // namespace
+
+namespace detail_texelkernels
+{
+auto avx2Kernels() -> syzygy::TexelKernels
+{
+    return syzygy::TexelKernels{
+        .overrideChannels = &overrideChannels,
+        .expandRGBToRGBA = &expandRGBToRGBA,
+        .packORM = &packORM,
+        .renormalizeNormals = &renormalizeNormals,
+        .srgbToLinear = &srgbToLinear,
+        .linearToSRGB = &linearToSRGB,
+    };
+}
+} // namespace detail_texelkernels
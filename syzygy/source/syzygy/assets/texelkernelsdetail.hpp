@@ -0,0 +1,69 @@
+#pragma once
+
+#include "syzygy/assets/texelkernels.hpp"
+#include "syzygy/platform/integer.hpp"
+#include <array>
+#include <bit>
+
+// Shared between the translation units of TexelKernels, each of which is
+// written for a different instruction set.
+
+// Instruction sets are enabled per function rather than per translation unit.
+// Otherwise the inline functions and templates that a translation unit
+// instantiates, such as std::span's, would be compiled for the instruction set
+// too, and the linker could keep those copies for the whole program. MSVC
+// allows intrinsics without enabling them.
+#if defined(__GNUC__) || defined(__clang__)
+#define SZG_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define SZG_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SZG_TARGET_SSE41
+#define SZG_TARGET_AVX2
+#endif
+namespace detail_texelkernels
+{
+size_t constexpr RGBA_CHANNELS{4};
+size_t constexpr RGB_CHANNELS{3};
+size_t constexpr CHANNEL_VALUES{256};
+
+// Unsigned-encoded normal components map [0, 255] onto [-1, 1].
+float constexpr NORMAL_SCALE{127.5F};
+float constexpr CHANNEL_MAX{255.0F};
+
+// Linear values of each 8-bit sRGB value.
+auto srgbDecodeTable() -> std::array<float, CHANNEL_VALUES> const&;
+
+// Encoding to sRGB counts how many of the linear values halfway between
+// consecutive sRGB values are not above the input. To avoid a full binary
+// search, inputs are bucketed by their exponent and top mantissa bits, and
+// each bucket stores the count at its lower bound. Then only a few thresholds
+// remain to be searched.
+//
+// Inputs are first clamped to [SRGB_ENCODE_MIN, 1], which is below the first
+// threshold so it does not change the result.
+float constexpr SRGB_ENCODE_MIN{0x1.0P-13F};
+uint32_t constexpr SRGB_BUCKET_SHIFT{19};
+size_t constexpr SRGB_BUCKET_COUNT{
+    ((std::bit_cast<uint32_t>(1.0F) - std::bit_cast<uint32_t>(SRGB_ENCODE_MIN))
+     >> SRGB_BUCKET_SHIFT)
+    + 1
+};
+// The search in each bucket starts with this step and halves it, so it covers
+// up to twice this minus one thresholds. Buckets are checked to contain no more
+// when the tables are built.
+uint32_t constexpr SRGB_BUCKET_SEARCH_STEP{4};
+size_t constexpr SRGB_THRESHOLD_COUNT{
+    CHANNEL_VALUES - 1 + SRGB_BUCKET_SEARCH_STEP * 2 - 1
+};
+
+// Padded with infinity, so searches past the last threshold stay in bounds.
+auto srgbEncodeThresholds() -> std::array<float, SRGB_THRESHOLD_COUNT> const&;
+
+// The index of the first threshold each bucket searches from. These are
+// integers so they can be gathered.
+auto srgbEncodeBuckets() -> std::array<int32_t, SRGB_BUCKET_COUNT> const&;
+
+auto scalarKernels() -> syzygy::TexelKernels;
+auto sse41Kernels() -> syzygy::TexelKernels;
+auto avx2Kernels() -> syzygy::TexelKernels;
+} // namespace detail_texelkernels
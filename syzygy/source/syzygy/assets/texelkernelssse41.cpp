@@ -0,0 +1,343 @@
+#include "syzygy/assets/texelkernels.hpp"
+#include "syzygy/assets/texelkernelsdetail.hpp"
+#include "syzygy/platform/integer.hpp"
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <smmintrin.h>
+#include <span>
+
+// Each function that uses intrinsics enables SSE4.1 for itself, so these must
+// only be called once the CPU is known to support it.
+
+namespace
+{
+using detail_texelkernels::CHANNEL_MAX;
+using detail_texelkernels::NORMAL_SCALE;
+using detail_texelkernels::RGB_CHANNELS;
+using detail_texelkernels::RGBA_CHANNELS;
+
+size_t constexpr VECTOR_BYTES{sizeof(__m128i)};
+size_t constexpr VECTOR_TEXELS{VECTOR_BYTES / RGBA_CHANNELS};
+
+SZG_TARGET_SSE41 auto load(uint8_t const* const bytes) -> __m128i
+{
+    return _mm_loadu_si128(reinterpret_cast<__m128i const*>(bytes));
+}
+
+SZG_TARGET_SSE41 void store(uint8_t* const bytes, __m128i const value)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes), value);
+}
+
+SZG_TARGET_SSE41 void overrideChannels(
+    std::span<uint8_t> const rgba, uint32_t const keepMask, uint32_t const fill
+)
+{
+    __m128i const keep{_mm_set1_epi32(static_cast<int32_t>(keepMask))};
+    __m128i const fillMasked{
+        _mm_set1_epi32(static_cast<int32_t>(fill & ~keepMask))
+    };
+
+    size_t offset{0};
+    for (; offset + VECTOR_BYTES <= rgba.size(); offset += VECTOR_BYTES)
+    {
+        uint8_t* const texels{rgba.data() + offset};
+        store(
+            texels, _mm_or_si128(_mm_and_si128(load(texels), keep), fillMasked)
+        );
+    }
+
+    detail_texelkernels::scalarKernels().overrideChannels(
+        rgba.subspan(offset), keepMask, fill
+    );
+}
+
+SZG_TARGET_SSE41 void expandRGBToRGBA(
+    std::span<uint8_t const> const rgb,
+    std::span<uint8_t> const rgba,
+    uint8_t const alpha
+)
+{
+    size_t const texels{rgb.size() / RGB_CHANNELS};
+    assert(rgba.size() >= texels * RGBA_CHANNELS);
+
+    // NOLINTBEGIN(readability-magic-numbers)
+    // Spreads 4 RGB texels across 4 RGBA texels, zeroing alpha.
+    __m128i const spread{_mm_setr_epi8(
+        0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1
+    )};
+    // NOLINTEND(readability-magic-numbers)
+    // NOLINTNEXTLINE(readability-magic-numbers)
+    uint32_t const alphaTexel{static_cast<uint32_t>(alpha) << 24U};
+    __m128i const alphaBytes{_mm_set1_epi32(static_cast<int32_t>(alphaTexel))};
+
+    // Each load reads 16 bytes, of which only 12 are used.
+    size_t texel{0};
+    for (; (texel * RGB_CHANNELS) + VECTOR_BYTES <= rgb.size();
+         texel += VECTOR_TEXELS)
+    {
+        __m128i const source{load(rgb.data() + texel * RGB_CHANNELS)};
+        store(
+            rgba.data() + texel * RGBA_CHANNELS,
+            _mm_or_si128(_mm_shuffle_epi8(source, spread), alphaBytes)
+        );
+    }
+
+    detail_texelkernels::scalarKernels().expandRGBToRGBA(
+        rgb.subspan(texel * RGB_CHANNELS),
+        rgba.subspan(texel * RGBA_CHANNELS),
+        alpha
+    );
+}
+
+SZG_TARGET_SSE41 void packORM(
+    std::span<uint8_t const> const occlusion,
+    std::span<uint8_t const> const roughnessMetallic,
+    std::span<uint8_t> const orm
+)
+{
+    assert(
+        occlusion.size() == orm.size() && roughnessMetallic.size() == orm.size()
+    );
+
+    // NOLINTBEGIN(readability-magic-numbers)
+    __m128i const occlusionMask{_mm_set1_epi32(0x000000FF)};
+    __m128i const roughnessMetallicMask{_mm_set1_epi32(0x00FFFF00)};
+    __m128i const opaqueAlpha{_mm_set1_epi32(static_cast<int32_t>(0xFF000000U))
+    };
+    // NOLINTEND(readability-magic-numbers)
+
+    size_t offset{0};
+    for (; offset + VECTOR_BYTES <= orm.size(); offset += VECTOR_BYTES)
+    {
+        __m128i const packed{_mm_or_si128(
+            _mm_or_si128(
+                _mm_and_si128(load(occlusion.data() + offset), occlusionMask),
+                _mm_and_si128(
+                    load(roughnessMetallic.data() + offset),
+                    roughnessMetallicMask
+                )
+            ),
+            opaqueAlpha
+        )};
+        store(orm.data() + offset, packed);
+    }
+
+    detail_texelkernels::scalarKernels().packORM(
+        occlusion.subspan(offset),
+        roughnessMetallic.subspan(offset),
+        orm.subspan(offset)
+    );
+}
+
+// Decodes the channel at shift into [-1, 1].
+SZG_TARGET_SSE41 auto decodeNormalComponent(
+    __m128i const texels, int32_t const shift
+) -> __m128
+{
+    // NOLINTNEXTLINE(readability-magic-numbers)
+    __m128i const byteMask{_mm_set1_epi32(0xFF)};
+    __m128i const channel{
+        _mm_and_si128(_mm_srli_epi32(texels, shift), byteMask)
+    };
+    return _mm_sub_ps(
+        _mm_div_ps(_mm_cvtepi32_ps(channel), _mm_set1_ps(NORMAL_SCALE)),
+        _mm_set1_ps(1.0F)
+    );
+}
+
+// Encodes the rescaled component back into the channel at shift.
+SZG_TARGET_SSE41 auto encodeNormalComponent(
+    __m128 const component, __m128 const inverseLength, int32_t const shift
+) -> __m128i
+{
+    // NOLINTNEXTLINE(readability-magic-numbers)
+    __m128i const byteMask{_mm_set1_epi32(0xFF)};
+    __m128 const scale{_mm_set1_ps(NORMAL_SCALE)};
+    __m128i const encoded{_mm_cvtps_epi32(_mm_add_ps(
+        _mm_mul_ps(_mm_mul_ps(component, inverseLength), scale), scale
+    ))};
+    __m128i const clamped{
+        _mm_min_epi32(_mm_max_epi32(encoded, _mm_setzero_si128()), byteMask)
+    };
+    return _mm_slli_epi32(clamped, shift);
+}
+
+// Mirrors the scalar kernel's order of operations, so rounding is identical.
+SZG_TARGET_SSE41 auto renormalizeTexels(__m128i const texels) -> __m128i
+{
+    // NOLINTNEXTLINE(readability-magic-numbers)
+    __m128i const alphaMask{_mm_set1_epi32(static_cast<int32_t>(0xFF000000U))};
+
+    // NOLINTBEGIN(readability-magic-numbers)
+    __m128 const x{decodeNormalComponent(texels, 0)};
+    __m128 const y{decodeNormalComponent(texels, 8)};
+    __m128 const z{decodeNormalComponent(texels, 16)};
+    // NOLINTEND(readability-magic-numbers)
+
+    __m128 const lengthSquared{_mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)
+    )};
+    __m128 const inverseLength{
+        _mm_div_ps(_mm_set1_ps(1.0F), _mm_sqrt_ps(lengthSquared))
+    };
+
+    // NOLINTBEGIN(readability-magic-numbers)
+    return _mm_or_si128(
+        _mm_or_si128(
+            encodeNormalComponent(x, inverseLength, 0),
+            encodeNormalComponent(y, inverseLength, 8)
+        ),
+        _mm_or_si128(
+            encodeNormalComponent(z, inverseLength, 16),
+            _mm_and_si128(texels, alphaMask)
+        )
+    );
+    // NOLINTEND(readability-magic-numbers)
+}
+
+SZG_TARGET_SSE41 void renormalizeNormals(std::span<uint8_t> const rgba)
+{
+    size_t offset{0};
+    for (; offset + VECTOR_BYTES <= rgba.size(); offset += VECTOR_BYTES)
+    {
+        uint8_t* const texels{rgba.data() + offset};
+        store(texels, renormalizeTexels(load(texels)));
+    }
+
+    detail_texelkernels::scalarKernels().renormalizeNormals(
+        rgba.subspan(offset)
+    );
+}
+
+SZG_TARGET_SSE41 void srgbToLinear(
+    std::span<uint8_t const> const rgba, std::span<float> const linear
+)
+{
+    assert(linear.size() >= rgba.size());
+
+    std::array<float, detail_texelkernels::CHANNEL_VALUES> const& decode{
+        detail_texelkernels::srgbDecodeTable()
+    };
+    __m128 const channelMax{_mm_set1_ps(CHANNEL_MAX)};
+
+    // Without gathers, colors are looked up one at a time. Alpha is converted
+    // alongside them, then blended in.
+    size_t offset{0};
+    for (; offset + RGBA_CHANNELS <= rgba.size(); offset += RGBA_CHANNELS)
+    {
+        uint8_t const* const texel{rgba.data() + offset};
+
+        int32_t packed{0};
+        std::memcpy(&packed, texel, sizeof(packed));
+        __m128 const unorm{_mm_div_ps(
+            _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed))),
+            channelMax
+        )};
+        __m128 const colors{_mm_setr_ps(
+            decode[texel[0]], decode[texel[1]], decode[texel[2]], 0.0F
+        )};
+
+        // NOLINTNEXTLINE(readability-magic-numbers)
+        __m128 const blended{_mm_blend_ps(colors, unorm, 0b1000)};
+        _mm_storeu_ps(linear.data() + offset, blended);
+    }
+}
+
+// Without gathers, each lane is looked up separately.
+SZG_TARGET_SSE41 auto gather(int32_t const* const table, __m128i const indices)
+    -> __m128i
+{
+    alignas(VECTOR_BYTES) std::array<int32_t, RGBA_CHANNELS> lanes{};
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes.data()), indices);
+    return _mm_setr_epi32(
+        table[lanes[0]], table[lanes[1]], table[lanes[2]], table[lanes[3]]
+    );
+}
+
+SZG_TARGET_SSE41 auto gather(float const* const table, __m128i const indices)
+    -> __m128
+{
+    alignas(VECTOR_BYTES) std::array<int32_t, RGBA_CHANNELS> lanes{};
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes.data()), indices);
+    return _mm_setr_ps(
+        table[lanes[0]], table[lanes[1]], table[lanes[2]], table[lanes[3]]
+    );
+}
+
+SZG_TARGET_SSE41 void linearToSRGB(
+    std::span<float const> const linear, std::span<uint8_t> const rgba
+)
+{
+    assert(rgba.size() >= linear.size());
+
+    float const* const thresholds{
+        detail_texelkernels::srgbEncodeThresholds().data()
+    };
+    int32_t const* const buckets{
+        detail_texelkernels::srgbEncodeBuckets().data()
+    };
+    __m128 const zero{_mm_setzero_ps()};
+    __m128 const one{_mm_set1_ps(1.0F)};
+    __m128 const channelMax{_mm_set1_ps(CHANNEL_MAX)};
+    __m128 const encodeMin{_mm_set1_ps(detail_texelkernels::SRGB_ENCODE_MIN)};
+
+    // The scalar kernel's search, on all four channels at once. Alpha is
+    // searched too, then replaced.
+    size_t offset{0};
+    for (; offset + RGBA_CHANNELS <= linear.size(); offset += RGBA_CHANNELS)
+    {
+        __m128 const values{_mm_loadu_ps(linear.data() + offset)};
+        __m128 const clamped{_mm_min_ps(_mm_max_ps(values, encodeMin), one)};
+
+        __m128i const bucket{_mm_srli_epi32(
+            _mm_sub_epi32(
+                _mm_castps_si128(clamped), _mm_castps_si128(encodeMin)
+            ),
+            detail_texelkernels::SRGB_BUCKET_SHIFT
+        )};
+        __m128i index{gather(buckets, bucket)};
+        for (uint32_t step{detail_texelkernels::SRGB_BUCKET_SEARCH_STEP};
+             step > 0;
+             step /= 2)
+        {
+            __m128i const probe{_mm_add_epi32(
+                index, _mm_set1_epi32(static_cast<int32_t>(step - 1))
+            )};
+            __m128i const above{_mm_castps_si128(
+                _mm_cmpge_ps(clamped, gather(thresholds, probe))
+            )};
+            __m128i const stride{_mm_set1_epi32(static_cast<int32_t>(step))};
+            index = _mm_add_epi32(index, _mm_and_si128(above, stride));
+        }
+
+        __m128i const alpha{_mm_cvtps_epi32(
+            _mm_mul_ps(_mm_min_ps(_mm_max_ps(values, zero), one), channelMax)
+        )};
+        // NOLINTNEXTLINE(readability-magic-numbers)
+        __m128i const encoded{_mm_blend_epi16(index, alpha, 0b11000000)};
+
+        __m128i const packed{_mm_packus_epi16(
+            _mm_packus_epi32(encoded, encoded), _mm_setzero_si128()
+        )};
+        int32_t const texel{_mm_cvtsi128_si32(packed)};
+        std::memcpy(rgba.data() + offset, &texel, sizeof(texel));
+    }
+}
+} // namespace
+
+namespace detail_texelkernels
+{
+auto sse41Kernels() -> syzygy::TexelKernels
+{
+    return syzygy::TexelKernels{
+        .overrideChannels = &overrideChannels,
+        .expandRGBToRGBA = &expandRGBToRGBA,
+        .packORM = &packORM,
+        .renormalizeNormals = &renormalizeNormals,
+        .srgbToLinear = &srgbToLinear,
+        .linearToSRGB = &linearToSRGB,
+    };
+}
+} // namespace detail_texelkernels
@@ -0,0 +1,784 @@
+#include "texturecache.hpp"
+
+#include "syzygy/assets/blockcompression.hpp"
+#include "syzygy/assets/mipchain.hpp"
+#include "syzygy/assets/texelkernels.hpp"
+#include "syzygy/core/log.hpp"
+#include "syzygy/platform/filesystemutils.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <spdlog/fmt/bundled/core.h>
+#include <system_error>
+#include <thread>
+#include <transcoder/basisu_transcoder.h>
+#include <utility>
+#include <zstd/zstd.h>
+
+namespace
+{
+// "SZGT", read as a little-endian integer.
+uint32_t constexpr MAGIC{0x54475A53};
+
+// The texel data directly follows the header.
+struct FileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t mipLevels;
+    uint32_t arrayLayers;
+    uint32_t padding;
+    uint64_t dataBytes;
+};
+static_assert(sizeof(FileHeader) == 40ULL);
+
+auto cachePath(
+    std::filesystem::path const& cacheDirectory, uint64_t const key
+) -> std::filesystem::path
+{
+    return cacheDirectory / fmt::format("{:016x}.szgtex", key);
+}
+
+// The texels covered by each block, and the size of the block.
+struct BlockShape
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t bytes;
+};
+
+auto blockShape(VkFormat const format) -> std::optional<BlockShape>
+{
+    switch (format)
+    {
+    case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+    case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+    case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+    case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+    case VK_FORMAT_BC4_UNORM_BLOCK:
+    case VK_FORMAT_BC4_SNORM_BLOCK:
+        return BlockShape{.width = 4, .height = 4, .bytes = 8};
+    case VK_FORMAT_BC2_UNORM_BLOCK:
+    case VK_FORMAT_BC2_SRGB_BLOCK:
+    case VK_FORMAT_BC3_UNORM_BLOCK:
+    case VK_FORMAT_BC3_SRGB_BLOCK:
+    case VK_FORMAT_BC5_UNORM_BLOCK:
+    case VK_FORMAT_BC5_SNORM_BLOCK:
+    case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+    case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+    case VK_FORMAT_BC7_UNORM_BLOCK:
+    case VK_FORMAT_BC7_SRGB_BLOCK:
+    case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+    case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
+        return BlockShape{.width = 4, .height = 4, .bytes = 16};
+    case VK_FORMAT_ASTC_5x4_UNORM_BLOCK:
+    case VK_FORMAT_ASTC_5x4_SRGB_BLOCK:
+        return BlockShape{.width = 5, .height = 4, .bytes = 16};
+    case VK_FORMAT_ASTC_5x5_UNORM_BLOCK:
+    case VK_FORMAT_ASTC_5x5_SRGB_BLOCK:
+        return BlockShape{.width = 5, .height = 5, .bytes = 16};
+    case VK_FORMAT_ASTC_6x5_UNORM_BLOCK:
+    case VK_FORMAT_ASTC_6x5_SRGB_BLOCK:
+        return BlockShape{.width = 6, .height = 5, .bytes = 16};
+    case VK_FORMAT_ASTC_6x6_UNORM_BLOCK:
+    case VK_FORMAT_ASTC_6x6_SRGB_BLOCK:
+        return BlockShape{.width = 6, .height = 6, .bytes = 16};
+    case VK_FORMAT_ASTC_8x5_UNORM_BLOCK:
+    case VK_FORMAT_ASTC_8x5_SRGB_BLOCK:
+        return BlockShape{.width = 8, .height = 5, .bytes = 16};
+    case VK_FORMAT_ASTC_8x6_UNORM_BLOCK:
+    case VK_FORMAT_ASTC_8x6_SRGB_BLOCK:
+        return BlockShape{.width = 8, .height = 6, .bytes = 16};
+    case VK_FORMAT_ASTC_8x8_UNORM_BLOCK:
+    case VK_FORMAT_ASTC_8x8_SRGB_BLOCK:
+        return BlockShape{.width = 8, .height = 8, .bytes = 16};
+    case VK_FORMAT_ASTC_10x5_UNORM_BLOCK:
+    case VK_FORMAT_ASTC_10x5_SRGB_BLOCK:
+        return BlockShape{.width = 10, .height = 5, .bytes = 16};
+    case VK_FORMAT_ASTC_10x6_UNORM_BLOCK:
+    case VK_FORMAT_ASTC_10x6_SRGB_BLOCK:
+        return BlockShape{.width = 10, .height = 6, .bytes = 16};
+    case VK_FORMAT_ASTC_10x8_UNORM_BLOCK:
+    case VK_FORMAT_ASTC_10x8_SRGB_BLOCK:
+        return BlockShape{.width = 10, .height = 8, .bytes = 16};
+    case VK_FORMAT_ASTC_10x10_UNORM_BLOCK:
+    case VK_FORMAT_ASTC_10x10_SRGB_BLOCK:
+        return BlockShape{.width = 10, .height = 10, .bytes = 16};
+    case VK_FORMAT_ASTC_12x10_UNORM_BLOCK:
+    case VK_FORMAT_ASTC_12x10_SRGB_BLOCK:
+        return BlockShape{.width = 12, .height = 10, .bytes = 16};
+    case VK_FORMAT_ASTC_12x12_UNORM_BLOCK:
+    case VK_FORMAT_ASTC_12x12_SRGB_BLOCK:
+        return BlockShape{.width = 12, .height = 12, .bytes = 16};
+    default:
+        return std::nullopt;
+    }
+}
+
+// The size of one array layer of a mip level.
+auto levelBytes(
+    VkFormat const format, VkExtent2D const extent, uint32_t const mipLevel
+) -> size_t
+{
+    std::optional<BlockShape> const shape{blockShape(format)};
+    if (!shape.has_value())
+    {
+        return 0;
+    }
+
+    uint32_t const width{std::max(extent.width >> mipLevel, 1U)};
+    uint32_t const height{std::max(extent.height >> mipLevel, 1U)};
+    size_t const blocksX{(width + shape->width - 1) / shape->width};
+    size_t const blocksY{(height + shape->height - 1) / shape->height};
+    return blocksX * blocksY * shape->bytes;
+}
+
+auto expectedBytes(
+    VkFormat const format,
+    VkExtent2D const extent,
+    uint32_t const mipLevels,
+    uint32_t const arrayLayers
+) -> size_t
+{
+    size_t bytes{0};
+    for (uint32_t mipLevel{0}; mipLevel < mipLevels; mipLevel++)
+    {
+        bytes += levelBytes(format, extent, mipLevel) * arrayLayers;
+    }
+    return bytes;
+}
+
+// Offsets of mip levels that are packed back to back, starting from level 0 at
+// firstOffset.
+auto packedLevelOffsets(
+    VkFormat const format,
+    VkExtent2D const extent,
+    uint32_t const mipLevels,
+    uint32_t const arrayLayers,
+    size_t const firstOffset
+) -> std::vector<size_t>
+{
+    std::vector<size_t> offsets{};
+    offsets.reserve(mipLevels);
+
+    size_t offset{firstOffset};
+    for (uint32_t mipLevel{0}; mipLevel < mipLevels; mipLevel++)
+    {
+        offsets.push_back(offset);
+        offset += levelBytes(format, extent, mipLevel) * arrayLayers;
+    }
+    return offsets;
+}
+
+std::array<uint8_t, 12> constexpr KTX2_IDENTIFIER{
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+};
+
+// The level index directly follows the header, with an entry for each mip
+// level starting from level 0.
+struct KTX2Header
+{
+    std::array<uint8_t, 12> identifier;
+    uint32_t vkFormat;
+    uint32_t typeSize;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t layerCount;
+    uint32_t faceCount;
+    uint32_t levelCount;
+    uint32_t supercompressionScheme;
+    uint32_t dfdByteOffset;
+    uint32_t dfdByteLength;
+    uint32_t kvdByteOffset;
+    uint32_t kvdByteLength;
+    uint64_t sgdByteOffset;
+    uint64_t sgdByteLength;
+};
+static_assert(sizeof(KTX2Header) == 80ULL);
+
+struct KTX2Level
+{
+    uint64_t byteOffset;
+    uint64_t byteLength;
+    uint64_t uncompressedByteLength;
+};
+static_assert(sizeof(KTX2Level) == 24ULL);
+
+enum class KTX2Supercompression : uint32_t
+{
+    None = 0,
+    BasisLZ = 1,
+    Zstandard = 2,
+    ZLIB = 3,
+};
+
+// Transcodes every level, layer and face of a KTX2 file with a Basis Universal
+// payload, packed back to back in the same order as a KTX2 file's levels. The
+// layout is what the file's header describes, which the payload must agree
+// with.
+auto transcodeBasis(
+    std::span<uint8_t const> const file,
+    VkFormat const format,
+    VkExtent2D const extent,
+    uint32_t const mipLevels,
+    uint32_t const arrayLayers
+) -> std::optional<std::vector<uint8_t>>
+{
+    static std::once_flag initialized{};
+    std::call_once(initialized, []() { basist::basisu_transcoder_init(); });
+
+    if (file.size() > std::numeric_limits<uint32_t>::max())
+    {
+        SZG_WARNING("KTX2 file is too large to transcode.");
+        return std::nullopt;
+    }
+
+    basist::ktx2_transcoder transcoder{};
+    if (!transcoder.init(file.data(), static_cast<uint32_t>(file.size()))
+        || !transcoder.start_transcoding())
+    {
+        SZG_WARNING("Failed to start transcoding Basis Universal payload.");
+        return std::nullopt;
+    }
+
+    // UASTC takes x and y from red and green, which is how glTF stores normal
+    // maps. ETC1S always takes them from red and alpha.
+    bool const normal{format == VK_FORMAT_BC5_UNORM_BLOCK};
+    basist::transcoder_texture_format const target{
+        normal ? basist::transcoder_texture_format::cTFBC5_RG
+               : basist::transcoder_texture_format::cTFBC7_RGBA
+    };
+    int const channel0{normal ? 0 : -1};
+    int const channel1{normal ? 1 : -1};
+
+    uint32_t const layers{std::max(transcoder.get_layers(), 1U)};
+    uint32_t const faces{transcoder.get_faces()};
+    if (transcoder.get_width() != extent.width
+        || transcoder.get_height() != extent.height
+        || transcoder.get_levels() != mipLevels
+        || layers * faces != arrayLayers)
+    {
+        SZG_WARNING("Basis Universal payload disagrees with its KTX2 header.");
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> bytes(
+        expectedBytes(format, extent, mipLevels, arrayLayers)
+    );
+    size_t offset{0};
+    for (uint32_t mipLevel{0}; mipLevel < mipLevels; mipLevel++)
+    {
+        size_t const imageBytes{levelBytes(format, extent, mipLevel)};
+        auto const imageBlocks{static_cast<uint32_t>(
+            imageBytes / syzygy::BlockCompression::BLOCK_BYTES
+        )};
+        for (uint32_t layer{0}; layer < layers; layer++)
+        {
+            for (uint32_t face{0}; face < faces; face++)
+            {
+                if (!transcoder.transcode_image_level(
+                        mipLevel,
+                        layer,
+                        face,
+                        bytes.data() + offset,
+                        imageBlocks,
+                        target,
+                        0,
+                        0,
+                        0,
+                        channel0,
+                        channel1
+                    ))
+                {
+                    SZG_WARNING(
+                        "Failed to transcode level {}, layer {}, face {} of "
+                        "Basis Universal payload.",
+                        mipLevel,
+                        layer,
+                        face
+                    );
+                    return std::nullopt;
+                }
+                offset += imageBytes;
+            }
+        }
+    }
+
+    return bytes;
+}
+} // namespace
+
+namespace syzygy
+{
+auto CookedTexture::encodedFormat(TextureEncoding const encoding) -> VkFormat
+{
+    switch (encoding)
+    {
+    case TextureEncoding::Color:
+        return VK_FORMAT_BC7_SRGB_BLOCK;
+    case TextureEncoding::Normal:
+        return VK_FORMAT_BC5_UNORM_BLOCK;
+    case TextureEncoding::OcclusionRoughnessMetallic:
+        return VK_FORMAT_BC7_UNORM_BLOCK;
+    }
+    return VK_FORMAT_UNDEFINED;
+}
+
+auto CookedTexture::encode(
+    TextureEncoding const encoding,
+    std::span<uint8_t const> const rgba,
+    uint32_t const width,
+    uint32_t const height
+) -> CookedTexture
+{
+    CookedTexture texture{};
+    texture.m_format = encodedFormat(encoding);
+    texture.m_extent = VkExtent2D{.width = width, .height = height};
+    texture.m_mipLevels = MipChain::levelCount(width, height);
+    texture.m_levelOffsets.reserve(texture.m_mipLevels);
+
+    auto const encodeLevel{
+        [&](std::span<uint8_t const> levelRGBA,
+            uint32_t levelWidth,
+            uint32_t levelHeight)
+    {
+        std::vector<uint8_t> const blocks{
+            encoding == TextureEncoding::Normal
+                ? BlockCompression::encodeBC5(
+                      levelRGBA, levelWidth, levelHeight
+                  )
+                : BlockCompression::encodeBC7(
+                      levelRGBA, levelWidth, levelHeight
+                  )
+        };
+        texture.m_levelOffsets.push_back(texture.m_encodedBytes.size());
+        texture.m_encodedBytes.insert(
+            texture.m_encodedBytes.end(), blocks.begin(), blocks.end()
+        );
+    }
+    };
+
+    texture.m_encodedBytes.reserve(expectedBytes(
+        texture.m_format, texture.m_extent, texture.m_mipLevels, 1
+    ));
+
+    encodeLevel(rgba, width, height);
+    for (MipChain::Level& level : MipChain::generate(
+             rgba, width, height, encoding == TextureEncoding::Color
+         ))
+    {
+        // Averaging shortens normals, which would flatten shading at a
+        // distance.
+        if (encoding == TextureEncoding::Normal)
+        {
+            TexelKernels::best().renormalizeNormals(level.rgba);
+        }
+        encodeLevel(level.rgba, level.width, level.height);
+    }
+
+    return texture;
+}
+
+auto CookedTexture::isKTX2(std::span<uint8_t const> const file) -> bool
+{
+    return file.size() >= KTX2_IDENTIFIER.size()
+        && std::equal(
+               KTX2_IDENTIFIER.begin(), KTX2_IDENTIFIER.end(), file.begin()
+        );
+}
+
+auto CookedTexture::readKTX2(
+    std::span<uint8_t const> const file, TextureEncoding const encoding
+) -> std::optional<CookedTexture>
+{
+    return fromKTX2(file, encoding, std::nullopt);
+}
+
+auto CookedTexture::openKTX2(
+    std::filesystem::path const& path, TextureEncoding const encoding
+) -> std::optional<CookedTexture>
+{
+    std::optional<MappedFile> fileResult{
+        MappedFile::open(path, MappedFile::AccessPattern::Sequential)
+    };
+    if (!fileResult.has_value())
+    {
+        SZG_WARNING("Failed to map KTX2 file at {}", path.string());
+        return std::nullopt;
+    }
+
+    std::span<uint8_t const> const file{fileResult.value().bytes()};
+    return fromKTX2(file, encoding, std::move(fileResult));
+}
+
+auto CookedTexture::fromKTX2(
+    std::span<uint8_t const> const file,
+    TextureEncoding const encoding,
+    std::optional<MappedFile>&& mapping
+) -> std::optional<CookedTexture>
+{
+    if (!isKTX2(file) || file.size() < sizeof(KTX2Header))
+    {
+        SZG_WARNING("File is not a KTX2 file.");
+        return std::nullopt;
+    }
+    KTX2Header header{};
+    std::memcpy(&header, file.data(), sizeof(KTX2Header));
+
+    if (header.pixelWidth == 0 || header.pixelHeight == 0
+        || header.pixelDepth > 1)
+    {
+        SZG_WARNING("KTX2 file is not a 2D texture, which is unsupported.");
+        return std::nullopt;
+    }
+    if (header.faceCount != 1 && header.faceCount != 6)
+    {
+        SZG_WARNING("KTX2 file has {} faces.", header.faceCount);
+        return std::nullopt;
+    }
+
+    VkExtent2D const extent{
+        .width = header.pixelWidth,
+        .height = header.pixelHeight,
+    };
+    // A level count of 0 asks for mip levels to be generated, which block
+    // compressed payloads cannot be.
+    uint32_t const mipLevels{std::max(header.levelCount, 1U)};
+    uint32_t const arrayLayers{
+        std::max(header.layerCount, 1U) * header.faceCount
+    };
+    if (mipLevels > MipChain::levelCount(extent.width, extent.height))
+    {
+        SZG_WARNING("KTX2 file has too many mip levels for its extent.");
+        return std::nullopt;
+    }
+
+    size_t const levelIndexBytes{mipLevels * sizeof(KTX2Level)};
+    if (file.size() < sizeof(KTX2Header) + levelIndexBytes)
+    {
+        SZG_WARNING("KTX2 file was truncated.");
+        return std::nullopt;
+    }
+    std::vector<KTX2Level> levelIndex(mipLevels);
+    std::memcpy(
+        levelIndex.data(), file.data() + sizeof(KTX2Header), levelIndexBytes
+    );
+    for (KTX2Level const& level : levelIndex)
+    {
+        if (level.byteOffset > file.size()
+            || level.byteLength > file.size() - level.byteOffset)
+        {
+            SZG_WARNING("KTX2 file was truncated.");
+            return std::nullopt;
+        }
+    }
+
+    CookedTexture texture{};
+    texture.m_extent = extent;
+    texture.m_mipLevels = mipLevels;
+    texture.m_arrayLayers = arrayLayers;
+
+    if (header.vkFormat == VK_FORMAT_UNDEFINED)
+    {
+        texture.m_format = encodedFormat(encoding);
+
+        std::optional<std::vector<uint8_t>> transcodeResult{transcodeBasis(
+            file, texture.m_format, extent, mipLevels, arrayLayers
+        )};
+        if (!transcodeResult.has_value())
+        {
+            return std::nullopt;
+        }
+        texture.m_encodedBytes = std::move(transcodeResult).value();
+        texture.m_levelOffsets = packedLevelOffsets(
+            texture.m_format, extent, mipLevels, arrayLayers, 0
+        );
+        return texture;
+    }
+
+    texture.m_format = static_cast<VkFormat>(header.vkFormat);
+    if (!blockShape(texture.m_format).has_value())
+    {
+        SZG_WARNING(
+            "KTX2 file has format {}, but only block compressed formats are "
+            "supported.",
+            header.vkFormat
+        );
+        return std::nullopt;
+    }
+
+    auto const supercompression{
+        static_cast<KTX2Supercompression>(header.supercompressionScheme)
+    };
+    if (supercompression != KTX2Supercompression::None
+        && supercompression != KTX2Supercompression::Zstandard)
+    {
+        SZG_WARNING(
+            "KTX2 file has unsupported supercompression scheme {}.",
+            header.supercompressionScheme
+        );
+        return std::nullopt;
+    }
+    bool const zstandard{supercompression == KTX2Supercompression::Zstandard};
+
+    for (uint32_t mipLevel{0}; mipLevel < mipLevels; mipLevel++)
+    {
+        KTX2Level const& level{levelIndex[mipLevel]};
+        uint64_t const uncompressedBytes{
+            zstandard ? level.uncompressedByteLength : level.byteLength
+        };
+        if (uncompressedBytes
+            != levelBytes(texture.m_format, extent, mipLevel) * arrayLayers)
+        {
+            SZG_WARNING(
+                "KTX2 file has the wrong size for mip level {}.", mipLevel
+            );
+            return std::nullopt;
+        }
+    }
+
+    // Levels are stored smallest first, with padding, so the offsets come from
+    // the index.
+    if (!zstandard && mapping.has_value())
+    {
+        texture.m_mapping.emplace(std::move(mapping).value());
+        for (KTX2Level const& level : levelIndex)
+        {
+            texture.m_levelOffsets.push_back(level.byteOffset);
+        }
+        return texture;
+    }
+
+    texture.m_levelOffsets = packedLevelOffsets(
+        texture.m_format, extent, mipLevels, arrayLayers, 0
+    );
+    texture.m_encodedBytes.resize(texture.byteCount());
+    for (uint32_t mipLevel{0}; mipLevel < mipLevels; mipLevel++)
+    {
+        KTX2Level const& level{levelIndex[mipLevel]};
+        std::span<uint8_t const> const source{
+            file.subspan(level.byteOffset, level.byteLength)
+        };
+        uint8_t* const destination{
+            texture.m_encodedBytes.data() + texture.m_levelOffsets[mipLevel]
+        };
+
+        if (!zstandard)
+        {
+            std::copy(source.begin(), source.end(), destination);
+            continue;
+        }
+
+        size_t const decompressedBytes{ZSTD_decompress(
+            destination,
+            level.uncompressedByteLength,
+            source.data(),
+            source.size()
+        )};
+        if (ZSTD_isError(decompressedBytes) != 0U
+            || decompressedBytes != level.uncompressedByteLength)
+        {
+            SZG_WARNING(
+                "Failed to decompress mip level {} of KTX2 file.", mipLevel
+            );
+            return std::nullopt;
+        }
+    }
+
+    return texture;
+}
+
+auto CookedTexture::load(
+    std::filesystem::path const& cacheDirectory, uint64_t const key
+) -> std::optional<CookedTexture>
+{
+    std::filesystem::path const path{cachePath(cacheDirectory, key)};
+
+    std::error_code existsError{};
+    if (!std::filesystem::exists(path, existsError))
+    {
+        return std::nullopt;
+    }
+
+    std::optional<MappedFile> fileResult{
+        MappedFile::open(path, MappedFile::AccessPattern::Sequential)
+    };
+    if (!fileResult.has_value())
+    {
+        SZG_WARNING("Failed to map cooked texture at {}", path.string());
+        return std::nullopt;
+    }
+    std::span<uint8_t const> const bytes{fileResult.value().bytes()};
+
+    FileHeader header{};
+    if (bytes.size() < sizeof(FileHeader))
+    {
+        SZG_WARNING("Cooked texture was truncated at {}", path.string());
+        return std::nullopt;
+    }
+    std::memcpy(&header, bytes.data(), sizeof(FileHeader));
+
+    if (header.magic != MAGIC || header.version != VERSION)
+    {
+        SZG_INFO("Cooked texture is out of date at {}", path.string());
+        return std::nullopt;
+    }
+
+    auto const format{static_cast<VkFormat>(header.format)};
+    VkExtent2D const extent{.width = header.width, .height = header.height};
+    bool const validLayout{
+        header.mipLevels >= 1
+        && header.mipLevels <= MipChain::levelCount(extent.width, extent.height)
+        && header.arrayLayers >= 1
+    };
+    size_t const dataBytes{
+        validLayout ? expectedBytes(
+                          format, extent, header.mipLevels, header.arrayLayers
+                      )
+                    : 0
+    };
+    if (dataBytes == 0
+        || header.dataBytes != dataBytes
+        || bytes.size() != sizeof(FileHeader) + dataBytes)
+    {
+        SZG_WARNING("Cooked texture was malformed at {}", path.string());
+        return std::nullopt;
+    }
+
+    CookedTexture texture{};
+    texture.m_format = format;
+    texture.m_extent = extent;
+    texture.m_mipLevels = header.mipLevels;
+    texture.m_arrayLayers = header.arrayLayers;
+    texture.m_mapping.emplace(std::move(fileResult).value());
+    texture.m_levelOffsets = packedLevelOffsets(
+        format, extent, header.mipLevels, header.arrayLayers, sizeof(FileHeader)
+    );
+    return texture;
+}
+
+auto CookedTexture::store(
+    std::filesystem::path const& cacheDirectory, uint64_t const key
+) const -> bool
+{
+    std::error_code directoryError{};
+    std::filesystem::create_directories(cacheDirectory, directoryError);
+    if (directoryError)
+    {
+        SZG_ERROR(
+            "Unable to create texture cache directory at {}: {}",
+            cacheDirectory.string(),
+            directoryError.message()
+        );
+        return false;
+    }
+
+    FileHeader const header{
+        .magic = MAGIC,
+        .version = VERSION,
+        .format = static_cast<uint32_t>(m_format),
+        .width = m_extent.width,
+        .height = m_extent.height,
+        .mipLevels = m_mipLevels,
+        .arrayLayers = m_arrayLayers,
+        .padding = 0,
+        .dataBytes = byteCount(),
+    };
+
+    std::filesystem::path const path{cachePath(cacheDirectory, key)};
+
+    // Decode workers may cook the same texture at once, so each writes its
+    // own temporary file.
+    std::filesystem::path temporaryPath{path};
+    temporaryPath += fmt::format(
+        ".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id())
+    );
+
+    {
+        std::ofstream file{temporaryPath, std::ios::binary | std::ios::trunc};
+        file.write(
+            reinterpret_cast<char const*>(&header), sizeof(FileHeader)
+        );
+        for (std::span<uint8_t const> const level : levels())
+        {
+            file.write(
+                reinterpret_cast<char const*>(level.data()),
+                static_cast<std::streamsize>(level.size())
+            );
+        }
+        file.close();
+
+        if (!file)
+        {
+            SZG_ERROR(
+                "Failed to write cooked texture at {}", temporaryPath.string()
+            );
+            std::error_code removeError{};
+            std::filesystem::remove(temporaryPath, removeError);
+            return false;
+        }
+    }
+
+    std::error_code renameError{};
+    std::filesystem::rename(temporaryPath, path, renameError);
+    if (renameError)
+    {
+        SZG_ERROR(
+            "Failed to move cooked texture into place at {}: {}",
+            path.string(),
+            renameError.message()
+        );
+        std::error_code removeError{};
+        std::filesystem::remove(temporaryPath, removeError);
+        return false;
+    }
+
+    return true;
+}
+
+auto CookedTexture::format() const -> VkFormat { return m_format; }
+
+auto CookedTexture::extent() const -> VkExtent2D { return m_extent; }
+
+auto CookedTexture::mipLevels() const -> uint32_t { return m_mipLevels; }
+
+auto CookedTexture::arrayLayers() const -> uint32_t { return m_arrayLayers; }
+
+auto CookedTexture::byteCount() const -> size_t
+{
+    return expectedBytes(m_format, m_extent, m_mipLevels, m_arrayLayers);
+}
+
+auto CookedTexture::levels() const -> std::vector<std::span<uint8_t const>>
+{
+    std::span<uint8_t const> const bytes{storage()};
+
+    std::vector<std::span<uint8_t const>> levels{};
+    levels.reserve(m_mipLevels);
+    for (uint32_t mipLevel{0}; mipLevel < m_mipLevels; mipLevel++)
+    {
+        size_t const size{
+            levelBytes(m_format, m_extent, mipLevel) * m_arrayLayers
+        };
+        levels.push_back(bytes.subspan(m_levelOffsets[mipLevel], size));
+    }
+    return levels;
+}
+
+auto CookedTexture::storage() const -> std::span<uint8_t const>
+{
+    if (m_mapping.has_value())
+    {
+        return m_mapping.value().bytes();
+    }
+    return m_encodedBytes;
+}
+} // namespace syzygy
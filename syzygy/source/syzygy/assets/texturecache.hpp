@@ -0,0 +1,121 @@
+#pragma once
+
+#include "syzygy/platform/filesystemutils.hpp"
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/platform/vulkanusage.hpp"
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace syzygy
+{
+// How a texture is block compressed, based on how it is sampled.
+enum class TextureEncoding : uint32_t
+{
+    // BC7 with sRGB decoding.
+    Color,
+    // BC5, so only x and y are kept and z must be reconstructed.
+    Normal,
+    // BC7 with linear decoding.
+    OcclusionRoughnessMetallic,
+};
+
+// Block-compressed texel data with a mip chain, ready to be copied into an
+// image of its format. It is either freshly encoded, transcoded from a KTX2
+// file, or read in place from a file that is mapped into memory.
+//
+// Cached files are keyed by the caller, typically by a hash of the source
+// image and everything that affects how it is encoded.
+struct CookedTexture
+{
+public:
+    auto operator=(CookedTexture&&) -> CookedTexture& = delete;
+    CookedTexture(CookedTexture const&) = delete;
+    auto operator=(CookedTexture const&) -> CookedTexture& = delete;
+
+    CookedTexture(CookedTexture&&) noexcept = default;
+    ~CookedTexture() = default;
+
+private:
+    CookedTexture() = default;
+
+public:
+    // Bump this whenever the file layout, the encoders or the mip filter
+    // change.
+    static uint32_t constexpr VERSION{5};
+
+    static auto encodedFormat(TextureEncoding) -> VkFormat;
+
+    // The source is 8-bit RGBA, tightly packed. Mip levels are generated from
+    // the source before encoding.
+    static auto encode(
+        TextureEncoding,
+        std::span<uint8_t const> rgba,
+        uint32_t width,
+        uint32_t height
+    ) -> CookedTexture;
+
+    // Checks only for the identifier that begins every KTX2 file.
+    static auto isKTX2(std::span<uint8_t const> file) -> bool;
+
+    // Payloads that are already block compressed, as BCn or ASTC, keep the
+    // format, mip levels and array layers of the file. Basis Universal
+    // payloads, either ETC1S or UASTC, are transcoded to the encoding's
+    // format, since every device supports BC. Cube map faces become array
+    // layers.
+    //
+    // The texels are copied out of the file, so it need not outlive the
+    // texture.
+    static auto readKTX2(std::span<uint8_t const> file, TextureEncoding)
+        -> std::optional<CookedTexture>;
+
+    // As readKTX2, but the file is mapped into memory and payloads that need
+    // no transcoding or decompression are read from it in place.
+    static auto openKTX2(std::filesystem::path const&, TextureEncoding)
+        -> std::optional<CookedTexture>;
+
+    // Fails if the file is missing, malformed or from another version.
+    static auto load(
+        std::filesystem::path const& cacheDirectory, uint64_t key
+    ) -> std::optional<CookedTexture>;
+
+    // Safe to call from several threads, even with the same key. The file is
+    // written in full before replacing any existing one.
+    auto store(std::filesystem::path const& cacheDirectory, uint64_t key) const
+        -> bool;
+
+    [[nodiscard]] auto format() const -> VkFormat;
+    [[nodiscard]] auto extent() const -> VkExtent2D;
+    [[nodiscard]] auto mipLevels() const -> uint32_t;
+    [[nodiscard]] auto arrayLayers() const -> uint32_t;
+
+    // The total size of every mip level.
+    [[nodiscard]] auto byteCount() const -> size_t;
+
+    // Every mip level starting from level 0, each holding every array layer
+    // in turn, tightly packed.
+    [[nodiscard]] auto levels() const -> std::vector<std::span<uint8_t const>>;
+
+private:
+    static auto fromKTX2(
+        std::span<uint8_t const> file,
+        TextureEncoding,
+        std::optional<MappedFile>&& mapping
+    ) -> std::optional<CookedTexture>;
+
+    [[nodiscard]] auto storage() const -> std::span<uint8_t const>;
+
+    VkFormat m_format{VK_FORMAT_UNDEFINED};
+    VkExtent2D m_extent{};
+    uint32_t m_mipLevels{1};
+    uint32_t m_arrayLayers{1};
+
+    std::vector<uint8_t> m_encodedBytes{};
+    std::optional<MappedFile> m_mapping{};
+
+    // Where each mip level starts within the storage, which is either the
+    // mapping or the encoded bytes.
+    std::vector<size_t> m_levelOffsets{};
+};
+} // namespace syzygy
@@ -0,0 +1,410 @@
+#include "textureresidency.hpp"
+
+#include "syzygy/assets/assetpool.hpp"
+#include "syzygy/core/log.hpp"
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/renderer/image.hpp"
+#include "syzygy/renderer/imageview.hpp"
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace
+{
+auto imageBytes(syzygy::ImageView& data) -> VkDeviceSize
+{
+    std::optional<VmaAllocationInfo> const allocationInfo{
+        data.image().fetchAllocationInfo()
+    };
+    return allocationInfo.has_value() ? allocationInfo.value().size : 0;
+}
+
+struct DeviceLocalMemory
+{
+    VkDeviceSize usage{0};
+    VkDeviceSize budget{0};
+};
+
+// Without VK_EXT_memory_budget, VMA estimates the budget from the heap sizes
+// and its own allocations.
+auto queryDeviceLocalMemory(VmaAllocator const allocator) -> DeviceLocalMemory
+{
+    VkPhysicalDeviceMemoryProperties const* properties{nullptr};
+    vmaGetMemoryProperties(allocator, &properties);
+
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+    vmaGetHeapBudgets(allocator, budgets.data());
+
+    DeviceLocalMemory memory{};
+    for (uint32_t heap{0}; heap < properties->memoryHeapCount; heap++)
+    {
+        if ((properties->memoryHeaps[heap].flags
+             & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+            == 0)
+        {
+            continue;
+        }
+
+        memory.usage += budgets[heap].usage;
+        memory.budget += budgets[heap].budget;
+    }
+
+    return memory;
+}
+
+auto mebibytes(int64_t const bytes) -> double
+{
+    double constexpr BYTES_PER_MEBIBYTE{1024.0 * 1024.0};
+    return static_cast<double>(bytes) / BYTES_PER_MEBIBYTE;
+}
+} // namespace
+
+namespace syzygy
+{
+void TextureResidency::track(
+    std::weak_ptr<Asset<ImageView>> texture,
+    TextureStreamSource source,
+    AssetShared<ImageView> const& fallback
+)
+{
+    std::shared_ptr<Asset<ImageView>> const asset{texture.lock()};
+    if (asset == nullptr || fallback == nullptr || fallback->data == nullptr)
+    {
+        return;
+    }
+
+    m_textures.insert_or_assign(
+        asset.get(),
+        TrackedTexture{
+            .texture = std::move(texture),
+            .source = std::move(source),
+            .fallback = fallback->data,
+            .lastUsedFrame = m_frame,
+        }
+    );
+}
+
+void TextureResidency::markUsed(PooledAssetPtr<ImageView> const& texture)
+{
+    Asset<ImageView> const* const asset{texture.get()};
+    if (asset == nullptr)
+    {
+        return;
+    }
+
+    auto const iterator{m_textures.find(asset)};
+    if (iterator == m_textures.end())
+    {
+        return;
+    }
+
+    iterator->second.lastUsedFrame = m_frame;
+}
+
+void TextureResidency::retire(std::shared_ptr<ImageView>&& data)
+{
+    if (data == nullptr)
+    {
+        return;
+    }
+
+    // Data that is still shared, such as a fallback, is not released by this.
+    VkDeviceSize const bytes{data.use_count() == 1 ? imageBytes(*data) : 0};
+
+    m_retired.push_back(RetiredData{
+        .data = std::move(data),
+        .bytes = bytes,
+        .frame = m_frame,
+    });
+}
+
+void TextureResidency::installed(
+    Asset<ImageView> const& texture, uint32_t const firstLevel
+)
+{
+    auto const iterator{m_textures.find(&texture)};
+    if (iterator == m_textures.end() || texture.data == nullptr)
+    {
+        return;
+    }
+    TrackedTexture& tracked{iterator->second};
+
+    Image& image{texture.data->image()};
+
+    tracked.firstLevel = firstLevel;
+    tracked.residentBytes = imageBytes(*texture.data);
+    tracked.fullBytes = tracked.residentBytes << (2U * firstLevel);
+
+    uint32_t const fullMipLevels{image.mipLevels() + firstLevel};
+    uint32_t const fullExtent{
+        std::max(image.extent2D().width, image.extent2D().height) << firstLevel
+    };
+    tracked.maximumFirstLevel = 0;
+    while (tracked.maximumFirstLevel + 1 < fullMipLevels
+           && (fullExtent >> (tracked.maximumFirstLevel + 1))
+                  >= MINIMUM_REDUCED_EXTENT)
+    {
+        tracked.maximumFirstLevel++;
+    }
+
+    tracked.streamingBytes = 0;
+    tracked.evicted = false;
+    tracked.streaming = false;
+}
+
+void TextureResidency::streamFailed(Asset<ImageView> const& texture)
+{
+    m_textures.erase(&texture);
+}
+
+void TextureResidency::untrack(Asset<ImageView> const& texture)
+{
+    m_textures.erase(&texture);
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+auto TextureResidency::update(VmaAllocator const allocator)
+    -> std::vector<TextureStreamRequest>
+{
+    m_frame++;
+    releaseRetired();
+    std::erase_if(
+        m_textures,
+        [](auto const& entry) { return entry.second.texture.expired(); }
+    );
+
+    DeviceLocalMemory const memory{queryDeviceLocalMemory(allocator)};
+    auto const limit{static_cast<int64_t>(
+        static_cast<double>(memory.budget) * m_budgetFraction
+    )};
+
+    // The usage once swapped out data is released and streams are installed,
+    // so that neither is acted on twice.
+    auto projectedUsage{static_cast<int64_t>(memory.usage)};
+    for (RetiredData const& retired : m_retired)
+    {
+        projectedUsage -= static_cast<int64_t>(retired.bytes);
+    }
+    for (auto const& [key, tracked] : m_textures)
+    {
+        if (tracked.streaming && tracked.fullBytes > 0)
+        {
+            projectedUsage += static_cast<int64_t>(tracked.streamingBytes)
+                            - static_cast<int64_t>(tracked.residentBytes);
+        }
+    }
+
+    std::vector<TextureStreamRequest> requests{};
+    auto const requestStream{[&](TrackedTexture& tracked,
+                                 uint32_t const firstLevel)
+    {
+        tracked.streaming = true;
+        tracked.streamingBytes = bytesFromLevel(tracked, firstLevel);
+        projectedUsage += static_cast<int64_t>(tracked.streamingBytes)
+                        - static_cast<int64_t>(tracked.residentBytes);
+
+        requests.push_back(TextureStreamRequest{
+            .texture = tracked.texture,
+            .source = tracked.source,
+            .firstLevel = firstLevel,
+        });
+    }};
+
+    std::vector<TrackedTexture*> resident{};
+    std::vector<TrackedTexture*> demanded{};
+    for (auto& [key, tracked] : m_textures)
+    {
+        if (tracked.streaming)
+        {
+            continue;
+        }
+
+        if (!tracked.evicted)
+        {
+            resident.push_back(&tracked);
+        }
+        // Used in the last frame, while missing some or all of its levels.
+        if ((tracked.evicted || tracked.firstLevel > 0)
+            && tracked.lastUsedFrame + 1 >= m_frame)
+        {
+            demanded.push_back(&tracked);
+        }
+    }
+
+    size_t evictions{0};
+    size_t reductions{0};
+    int64_t const overage{projectedUsage - limit};
+    if (overage > 0)
+    {
+        std::sort(
+            resident.begin(),
+            resident.end(),
+            [](TrackedTexture const* lhs, TrackedTexture const* rhs)
+        { return lhs->lastUsedFrame < rhs->lastUsedFrame; }
+        );
+
+        for (TrackedTexture* const tracked : resident)
+        {
+            if (projectedUsage <= limit)
+            {
+                break;
+            }
+
+            std::shared_ptr<Asset<ImageView>> const asset{
+                tracked->texture.lock()
+            };
+            if (asset == nullptr)
+            {
+                continue;
+            }
+
+            if (tracked->lastUsedFrame + EVICTION_FRAMES < m_frame)
+            {
+                projectedUsage -= static_cast<int64_t>(tracked->residentBytes);
+                evict(*tracked, *asset);
+                evictions++;
+            }
+            else if (tracked->firstLevel < tracked->maximumFirstLevel
+                     && requests.size() < MAX_STREAMS_PER_FRAME)
+            {
+                requestStream(*tracked, tracked->firstLevel + 1);
+                reductions++;
+            }
+        }
+
+        if (evictions > 0 || reductions > 0)
+        {
+            SZG_INFO(
+                "TextureResidency: {:.1f} MiB over budget, evicted {} "
+                "textures and dropped the top mip of {}.",
+                mebibytes(overage),
+                evictions,
+                reductions
+            );
+        }
+    }
+    m_stats.evictions += evictions;
+    m_stats.reductions += reductions;
+
+    // Evicted textures come back first, since they are drawn with fallbacks.
+    std::sort(
+        demanded.begin(),
+        demanded.end(),
+        [](TrackedTexture const* lhs, TrackedTexture const* rhs)
+    { return lhs->evicted && !rhs->evicted; }
+    );
+
+    auto const restoreLimit{static_cast<int64_t>(
+        static_cast<double>(limit) * (1.0 - RESTORE_HEADROOM)
+    )};
+    for (TrackedTexture* const tracked : demanded)
+    {
+        if (requests.size() >= MAX_STREAMS_PER_FRAME)
+        {
+            break;
+        }
+        if (tracked->streaming)
+        {
+            // Reduced just now.
+            continue;
+        }
+
+        int64_t const headroom{
+            restoreLimit - projectedUsage
+            + static_cast<int64_t>(tracked->residentBytes)
+        };
+
+        uint32_t const coarsestLevel{
+            tracked->evicted ? tracked->maximumFirstLevel
+                             : tracked->firstLevel - 1
+        };
+        std::optional<uint32_t> level{};
+        for (uint32_t candidate{0}; candidate <= coarsestLevel; candidate++)
+        {
+            if (static_cast<int64_t>(bytesFromLevel(*tracked, candidate))
+                <= headroom)
+            {
+                level = candidate;
+                break;
+            }
+        }
+
+        // Evicted textures are needed regardless, so they return as small as
+        // they can be.
+        if (!level.has_value() && tracked->evicted)
+        {
+            level = coarsestLevel;
+        }
+        if (!level.has_value())
+        {
+            continue;
+        }
+
+        requestStream(*tracked, level.value());
+        m_stats.restreams++;
+    }
+
+    m_stats.tracked = m_textures.size();
+    m_stats.evicted = 0;
+    m_stats.reduced = 0;
+    m_stats.streaming = 0;
+    m_stats.residentBytes = 0;
+    for (auto const& [key, tracked] : m_textures)
+    {
+        m_stats.evicted += tracked.evicted ? 1 : 0;
+        m_stats.reduced += !tracked.evicted && tracked.firstLevel > 0 ? 1 : 0;
+        m_stats.streaming += tracked.streaming ? 1 : 0;
+        m_stats.residentBytes += tracked.residentBytes;
+    }
+    m_stats.usageBytes = memory.usage;
+    m_stats.budgetBytes = memory.budget;
+
+    return requests;
+}
+
+void TextureResidency::setBudgetFraction(float const fraction)
+{
+    m_budgetFraction = std::clamp(fraction, 0.0F, 1.0F);
+}
+
+auto TextureResidency::budgetFraction() const -> float
+{
+    return m_budgetFraction;
+}
+
+auto TextureResidency::stats() const -> TextureResidencyStats const&
+{
+    return m_stats;
+}
+
+auto TextureResidency::frame() const -> uint64_t { return m_frame; }
+
+void TextureResidency::releaseRetired()
+{
+    std::erase_if(
+        m_retired,
+        [&](RetiredData const& retired)
+    { return retired.frame + RETIRE_FRAMES <= m_frame; }
+    );
+}
+
+void TextureResidency::evict(TrackedTexture& tracked, Asset<ImageView>& asset)
+{
+    retire(std::move(asset.data));
+    asset.data = tracked.fallback;
+
+    tracked.evicted = true;
+    tracked.firstLevel = 0;
+    tracked.residentBytes = 0;
+}
+
+auto TextureResidency::bytesFromLevel(
+    TrackedTexture const& tracked, uint32_t const firstLevel
+) -> VkDeviceSize
+{
+    uint32_t constexpr MAXIMUM_SHIFT{63};
+    return tracked.fullBytes >> std::min(2U * firstLevel, MAXIMUM_SHIFT);
+}
+} // namespace syzygy
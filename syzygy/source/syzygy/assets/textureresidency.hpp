@@ -0,0 +1,188 @@
+#pragma once
+
+#include "syzygy/assets/assetstypes.hpp"
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/platform/vulkanusage.hpp"
+#include <filesystem>
+#include <memory>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace syzygy
+{
+struct ImageView;
+} // namespace syzygy
+
+namespace syzygy
+{
+// A texture cooked into the texture cache, see CookedTexture.
+struct CookedTextureSource
+{
+    std::filesystem::path cacheDirectory{};
+    uint64_t key{0};
+};
+
+// An image file that is decoded into 8-bit RGBA.
+struct ImageFileSource
+{
+    std::filesystem::path path{};
+    VkFormat format{VK_FORMAT_UNDEFINED};
+};
+
+// Where a texture's texels can be read from again, once its device memory has
+// been released.
+using TextureStreamSource = std::variant<CookedTextureSource, ImageFileSource>;
+
+// A texture to read from its source and upload again. The top mip levels,
+// before firstLevel, are left out.
+struct TextureStreamRequest
+{
+    AssetPtr<ImageView> texture{};
+    TextureStreamSource source{};
+    uint32_t firstLevel{0};
+};
+
+struct TextureResidencyStats
+{
+    size_t tracked{0};
+    size_t evicted{0};
+    // Resident without their top mip levels.
+    size_t reduced{0};
+    size_t streaming{0};
+
+    VkDeviceSize residentBytes{0};
+    // Of the device local heaps, as reported by VMA.
+    VkDeviceSize usageBytes{0};
+    VkDeviceSize budgetBytes{0};
+
+    // Totals since the library was created.
+    size_t evictions{0};
+    size_t reductions{0};
+    size_t restreams{0};
+};
+
+// Keeps textures within the device's memory budget, which VMA reads from
+// VK_EXT_memory_budget when the device supports it.
+//
+// Each frame, the textures sampled by materials are marked as used. When the
+// device local heaps are over budget, textures are released from least to most
+// recently used. Those that have gone unused for a few frames are evicted
+// entirely, and swapped to their fallback, such as the default color map.
+// Those still in use instead have their top mip level dropped, down to a
+// minimum size. Textures that are used again while evicted or reduced are
+// streamed back in from their source, as budget allows.
+//
+// Device memory that was swapped out is only released once every frame that
+// could have sampled it has completed.
+struct TextureResidency
+{
+public:
+    // How many frames a texture must go unused before it can be evicted.
+    static uint64_t constexpr EVICTION_FRAMES{8};
+    // How many frames swapped out data is kept alive for. This covers every
+    // frame in flight, plus the one being recorded. Material descriptor sets
+    // that are replaced are retired for as long, see MaterialDescriptors.
+    static uint64_t constexpr RETIRE_FRAMES{3};
+    // Reduced textures keep at least this many texels along their longest
+    // side.
+    static uint32_t constexpr MINIMUM_REDUCED_EXTENT{128};
+    // Restored textures must leave this fraction of the budget free, so that
+    // they are not immediately reduced again.
+    static float constexpr RESTORE_HEADROOM{0.1F};
+    // Bounds the staging memory and decoding that streaming takes per frame.
+    static size_t constexpr MAX_STREAMS_PER_FRAME{4};
+
+    // The texture's data is swapped with the fallback's while it is evicted.
+    // Its first upload counts as streaming in, so it is only managed once that
+    // upload is installed.
+    void track(
+        std::weak_ptr<Asset<ImageView>> texture,
+        TextureStreamSource source,
+        AssetShared<ImageView> const& fallback
+    );
+
+    // Called with the textures of every material that is bound this frame.
+    void markUsed(PooledAssetPtr<ImageView> const&);
+
+    // Holds onto data that was swapped out of an asset, until no frame in
+    // flight can be sampling it.
+    void retire(std::shared_ptr<ImageView>&& data);
+
+    // Call once new data, missing its levels before firstLevel, is swapped
+    // into the texture.
+    void installed(Asset<ImageView> const& texture, uint32_t firstLevel);
+
+    // The texture keeps whatever data it has, and is no longer managed.
+    void streamFailed(Asset<ImageView> const& texture);
+
+    // The texture is no longer managed, such as when it is unloaded. Textures
+    // are tracked by address, so this must be called before its pool slot can
+    // be reused.
+    void untrack(Asset<ImageView> const& texture);
+
+    // Call once per frame, after waiting on the frame's fence. Evicts
+    // textures when over budget, then returns the textures that should be
+    // streamed in. Those are not requested again until installed, or until
+    // their stream fails.
+    auto update(VmaAllocator) -> std::vector<TextureStreamRequest>;
+
+    // The fraction of the device local budget that may be in use before
+    // textures are evicted.
+    void setBudgetFraction(float);
+    [[nodiscard]] auto budgetFraction() const -> float;
+
+    [[nodiscard]] auto stats() const -> TextureResidencyStats const&;
+
+    // Counts calls to update, so it advances once per frame.
+    [[nodiscard]] auto frame() const -> uint64_t;
+
+private:
+    struct TrackedTexture
+    {
+        std::weak_ptr<Asset<ImageView>> texture{};
+        TextureStreamSource source{};
+        std::shared_ptr<ImageView> fallback{};
+
+        uint64_t lastUsedFrame{0};
+
+        // Of the data currently swapped in, which is none while evicted.
+        uint32_t firstLevel{0};
+        VkDeviceSize residentBytes{0};
+        // Estimated from the resident data, assuming each level is a quarter
+        // of the one before it.
+        VkDeviceSize fullBytes{0};
+        // How many levels can be dropped before reaching the minimum extent.
+        uint32_t maximumFirstLevel{0};
+        // The estimated size of the data being streamed in.
+        VkDeviceSize streamingBytes{0};
+
+        bool evicted{false};
+        // The first upload is treated as a stream.
+        bool streaming{true};
+    };
+
+    struct RetiredData
+    {
+        std::shared_ptr<ImageView> data{};
+        VkDeviceSize bytes{0};
+        uint64_t frame{0};
+    };
+
+    void releaseRetired();
+    void evict(TrackedTexture&, Asset<ImageView>&);
+
+    // The estimated size of the texture without its levels before firstLevel.
+    [[nodiscard]] static auto bytesFromLevel(
+        TrackedTexture const&, uint32_t firstLevel
+    ) -> VkDeviceSize;
+
+    uint64_t m_frame{0};
+    float m_budgetFraction{0.9F};
+
+    std::unordered_map<Asset<ImageView> const*, TrackedTexture> m_textures{};
+    std::vector<RetiredData> m_retired{};
+
+    TextureResidencyStats m_stats{};
+};
+} // namespace syzygy
@@ -0,0 +1,191 @@
+#include "vertexwelding.hpp"
+
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/renderer/gputypes.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+uint32_t constexpr NO_VERTEX{std::numeric_limits<uint32_t>::max()};
+
+// Beyond this, cells are too small for the coordinate to be meaningful.
+double constexpr MAXIMUM_CELL_COORDINATE{static_cast<double>(1ULL << 52U)};
+
+using CellCoordinates = std::array<int64_t, 3>;
+
+// Positions that cannot be placed in the grid, such as when welding exact
+// duplicates, are keyed by their bits instead. This can only place them in a
+// cell with unrelated vertices, which only costs extra comparisons.
+auto cellCoordinate(float const value, float const cellSize) -> int64_t
+{
+    if (cellSize > 0.0F)
+    {
+        double const cell{std::floor(
+            static_cast<double>(value) / static_cast<double>(cellSize)
+        )};
+        if (std::isfinite(cell) && std::abs(cell) < MAXIMUM_CELL_COORDINATE)
+        {
+            return static_cast<int64_t>(cell);
+        }
+    }
+
+    // Adding zero turns -0 into +0, so that they are keyed together.
+    return std::bit_cast<int32_t>(value + 0.0F);
+}
+
+auto cellHash(CellCoordinates const& cell) -> uint64_t
+{
+    // Large odd constants, to spread each coordinate across the bits.
+    std::array<uint64_t, 3> constexpr MULTIPLIERS{
+        0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL
+    };
+
+    uint64_t hash{0};
+    for (size_t axis{0}; axis < cell.size(); axis++)
+    {
+        hash ^= static_cast<uint64_t>(cell[axis]) * MULTIPLIERS[axis];
+        hash = std::rotl(hash, 21);
+    }
+    return hash;
+}
+
+auto withinTolerance(
+    glm::vec3 const& lhs, glm::vec3 const& rhs, float const tolerance
+) -> bool
+{
+    return std::abs(lhs.x - rhs.x) <= tolerance
+        && std::abs(lhs.y - rhs.y) <= tolerance
+        && std::abs(lhs.z - rhs.z) <= tolerance;
+}
+
+auto weldable(
+    syzygy::VertexPacked const& lhs,
+    syzygy::VertexPacked const& rhs,
+    syzygy::VertexWeldTolerance const& tolerance
+) -> bool
+{
+    return withinTolerance(lhs.position, rhs.position, tolerance.position)
+        && withinTolerance(lhs.normal, rhs.normal, tolerance.normal)
+        && std::abs(lhs.uv_x - rhs.uv_x) <= tolerance.uv
+        && std::abs(lhs.uv_y - rhs.uv_y) <= tolerance.uv
+        && lhs.color.x == rhs.color.x && lhs.color.y == rhs.color.y
+        && lhs.color.z == rhs.color.z && lhs.color.w == rhs.color.w;
+}
+} // namespace
+
+namespace syzygy
+{
+auto VertexWelding::bytesSaved() const -> size_t
+{
+    return (vertexCount - weldedVertexCount) * sizeof(VertexPacked);
+}
+
+auto VertexWelding::weld(
+    VertexWeldTolerance const tolerance,
+    std::vector<uint32_t>& indices,
+    std::vector<VertexPacked>& vertices
+) -> std::optional<VertexWelding>
+{
+    std::vector<bool> referenced(vertices.size(), false);
+    for (uint32_t const index : indices)
+    {
+        if (index >= vertices.size())
+        {
+            return std::nullopt;
+        }
+        referenced[index] = true;
+    }
+
+    // With no tolerance, a vertex can only match within its own cell.
+    int64_t const neighborRadius{tolerance.position > 0.0F ? 1 : 0};
+
+    std::vector<VertexPacked> weldedVertices{};
+    // Chains the kept vertices of each cell, from the head stored in cells.
+    std::vector<uint32_t> nextInCell{};
+    std::unordered_map<uint64_t, uint32_t> cells{};
+
+    std::vector<uint32_t> remap(vertices.size(), NO_VERTEX);
+    for (size_t vertexIndex{0}; vertexIndex < vertices.size(); vertexIndex++)
+    {
+        if (!referenced[vertexIndex])
+        {
+            continue;
+        }
+        VertexPacked const& vertex{vertices[vertexIndex]};
+
+        CellCoordinates const cell{
+            cellCoordinate(vertex.position.x, tolerance.position),
+            cellCoordinate(vertex.position.y, tolerance.position),
+            cellCoordinate(vertex.position.z, tolerance.position),
+        };
+
+        uint32_t match{NO_VERTEX};
+        for (int64_t x{-neighborRadius}; x <= neighborRadius; x++)
+        {
+            for (int64_t y{-neighborRadius}; y <= neighborRadius; y++)
+            {
+                for (int64_t z{-neighborRadius};
+                     z <= neighborRadius && match == NO_VERTEX;
+                     z++)
+                {
+                    auto const head{cells.find(cellHash(CellCoordinates{
+                        cell[0] + x, cell[1] + y, cell[2] + z
+                    }))};
+                    if (head == cells.end())
+                    {
+                        continue;
+                    }
+
+                    for (uint32_t candidate{head->second};
+                         candidate != NO_VERTEX;
+                         candidate = nextInCell[candidate])
+                    {
+                        if (weldable(
+                                weldedVertices[candidate], vertex, tolerance
+                            ))
+                        {
+                            match = candidate;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (match == NO_VERTEX)
+        {
+            match = static_cast<uint32_t>(weldedVertices.size());
+            weldedVertices.push_back(vertex);
+
+            auto const [head, inserted]{cells.try_emplace(cellHash(cell), match)
+            };
+            nextInCell.push_back(inserted ? NO_VERTEX : head->second);
+            head->second = match;
+        }
+
+        remap[vertexIndex] = match;
+    }
+
+    for (uint32_t& index : indices)
+    {
+        index = remap[index];
+    }
+
+    VertexWelding const result{
+        .vertexCount = vertices.size(),
+        .weldedVertexCount = weldedVertices.size(),
+    };
+    vertices = std::move(weldedVertices);
+
+    return result;
+}
+} // namespace syzygy
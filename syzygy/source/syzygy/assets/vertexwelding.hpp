@@ -0,0 +1,44 @@
+#pragma once
+
+#include "syzygy/platform/integer.hpp"
+#include <optional>
+#include <vector>
+
+namespace syzygy
+{
+struct VertexPacked;
+
+// How far apart each attribute of two vertices may be, per component, for
+// them to be welded. Zero only welds exact duplicates.
+struct VertexWeldTolerance
+{
+    float position{0.0F};
+    float normal{0.0F};
+    float uv{0.0F};
+};
+
+// Merges duplicated vertices of a mesh, such as those shared between glTF
+// primitives, or emitted by exporters that duplicate vertices per triangle.
+struct VertexWelding
+{
+    size_t vertexCount{0};
+    size_t weldedVertexCount{0};
+
+    // In the layout of VertexPacked.
+    [[nodiscard]] auto bytesSaved() const -> size_t;
+
+    // Vertices are found by hashing their positions into a grid of cells as
+    // wide as the position tolerance, then compared with every vertex already
+    // kept in the neighboring cells. A vertex is welded into the first kept
+    // vertex that is within tolerance in position, normal and uv, and that has
+    // the same color. Indices are rewritten to match, and unreferenced vertices
+    // are removed. Kept vertices stay in their original order.
+    //
+    // Fails without modifying anything if an index is out of bounds.
+    static auto weld(
+        VertexWeldTolerance tolerance,
+        std::vector<uint32_t>& indices,
+        std::vector<VertexPacked>& vertices
+    ) -> std::optional<VertexWelding>;
+};
+} // namespace syzygy
@@ -0,0 +1,100 @@
+#include "hash.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+
+namespace
+{
+uint64_t constexpr PRIME_1{0x9E3779B185EBCA87ULL};
+uint64_t constexpr PRIME_2{0xC2B2AE3D27D4EB4FULL};
+uint64_t constexpr PRIME_3{0x165667B19E3779F9ULL};
+uint64_t constexpr PRIME_4{0x85EBCA77C2B2AE63ULL};
+uint64_t constexpr PRIME_5{0x27D4EB2F165667C5ULL};
+
+// Little-endian, as on every platform this runs on.
+template <typename T> auto read(uint8_t const* const bytes) -> uint64_t
+{
+    T value{};
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+auto round(uint64_t accumulator, uint64_t const input) -> uint64_t
+{
+    accumulator += input * PRIME_2;
+    accumulator = std::rotl(accumulator, 31);
+    return accumulator * PRIME_1;
+}
+
+auto mergeRound(uint64_t accumulator, uint64_t const lane) -> uint64_t
+{
+    accumulator ^= round(0, lane);
+    return accumulator * PRIME_1 + PRIME_4;
+}
+} // namespace
+
+auto syzygy::ContentHash::hash(
+    std::span<uint8_t const> const bytes, uint64_t const seed
+) -> uint64_t
+{
+    size_t constexpr STRIPE_BYTES{32};
+
+    uint8_t const* cursor{bytes.data()};
+    uint8_t const* const end{bytes.data() + bytes.size()};
+
+    uint64_t hash{};
+    if (bytes.size() >= STRIPE_BYTES)
+    {
+        // Four independent lanes, so the multiplies can overlap.
+        uint64_t lane0{seed + PRIME_1 + PRIME_2};
+        uint64_t lane1{seed + PRIME_2};
+        uint64_t lane2{seed};
+        uint64_t lane3{seed - PRIME_1};
+        for (; end - cursor >= static_cast<ptrdiff_t>(STRIPE_BYTES);
+             cursor += STRIPE_BYTES)
+        {
+            lane0 = round(lane0, read<uint64_t>(cursor));
+            lane1 = round(lane1, read<uint64_t>(cursor + 8));
+            lane2 = round(lane2, read<uint64_t>(cursor + 16));
+            lane3 = round(lane3, read<uint64_t>(cursor + 24));
+        }
+
+        hash = std::rotl(lane0, 1) + std::rotl(lane1, 7)
+             + std::rotl(lane2, 12) + std::rotl(lane3, 18);
+        hash = mergeRound(hash, lane0);
+        hash = mergeRound(hash, lane1);
+        hash = mergeRound(hash, lane2);
+        hash = mergeRound(hash, lane3);
+    }
+    else
+    {
+        hash = seed + PRIME_5;
+    }
+
+    hash += bytes.size();
+
+    for (; end - cursor >= 8; cursor += 8)
+    {
+        hash ^= round(0, read<uint64_t>(cursor));
+        hash = std::rotl(hash, 27) * PRIME_1 + PRIME_4;
+    }
+    if (end - cursor >= 4)
+    {
+        hash ^= read<uint32_t>(cursor) * PRIME_1;
+        hash = std::rotl(hash, 23) * PRIME_2 + PRIME_3;
+        cursor += 4;
+    }
+    for (; cursor != end; cursor++)
+    {
+        hash ^= *cursor * PRIME_5;
+        hash = std::rotl(hash, 11) * PRIME_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME_2;
+    hash ^= hash >> 29;
+    hash *= PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
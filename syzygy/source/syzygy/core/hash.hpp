@@ -0,0 +1,19 @@
+#pragma once
+
+#include "syzygy/platform/integer.hpp"
+#include <span>
+
+namespace syzygy
+{
+// 64-bit xxHash (XXH64), which consumes eight bytes at a time. Not
+// cryptographic, this is for identifying content such as source files that
+// have already been processed.
+struct ContentHash
+{
+    static uint64_t constexpr SEED{0};
+
+    // Pass the result of a previous call as the seed to hash bytes in pieces.
+    static auto hash(std::span<uint8_t const> bytes, uint64_t seed = SEED)
+        -> uint64_t;
+};
+} // namespace syzygy
@@ -3,7 +3,6 @@
 #include <spdlog/common.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
-#include <spdlog/sinks/wincolor_sink.h>
 #include <spdlog/spdlog.h>
 #include <vector>
 
@@ -17,9 +16,9 @@ void Logger::initLogging()
 {
     spdlog::set_pattern("[%T] [%^%=7l%$] %v");
 
-    auto consoleSink{std::make_shared<spdlog::sinks::stdout_color_sink_st>()};
+    auto consoleSink{std::make_shared<spdlog::sinks::stdout_color_sink_mt>()};
     auto fileSink{
-        std::make_shared<spdlog::sinks::basic_file_sink_st>("Syzygy.log", true)
+        std::make_shared<spdlog::sinks::basic_file_sink_mt>("Syzygy.log", true)
     };
 
     consoleSink->set_pattern("[%T] %^%=8l%$: %v");
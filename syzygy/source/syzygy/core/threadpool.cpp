@@ -0,0 +1,133 @@
+#include "threadpool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace syzygy
+{
+ThreadPool::ThreadPool(size_t const workerCount)
+{
+    size_t const clampedCount{std::max(workerCount, size_t{1})};
+
+    m_workers.reserve(clampedCount);
+    for (size_t index{0}; index < clampedCount; index++)
+    {
+        m_workers.emplace_back([this](std::stop_token const& stopToken)
+        { workerLoop(stopToken); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    for (std::jthread& worker : m_workers)
+    {
+        worker.request_stop();
+    }
+    m_queueCondition.notify_all();
+
+    // Joining here instead of relying on member destruction order, so no
+    // worker can touch the queue once it starts being torn down.
+    m_workers.clear();
+}
+
+auto ThreadPool::defaultWorkerCount() -> size_t
+{
+    size_t const hardwareThreads{std::thread::hardware_concurrency()};
+
+    return std::max(hardwareThreads, size_t{2}) - 1;
+}
+
+auto ThreadPool::workerCount() const -> size_t { return m_workers.size(); }
+
+void ThreadPool::parallelFor(
+    size_t const count, std::function<void(size_t)> const& body
+)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    // Shared with the helper jobs, which may only start once every index has
+    // been claimed and this call has returned. Those jobs find nothing left to
+    // claim, so they never touch the body.
+    struct Loop
+    {
+        size_t count{0};
+        std::function<void(size_t)> const* body{nullptr};
+
+        std::atomic<size_t> nextIndex{0};
+        std::atomic<size_t> finishedCount{0};
+
+        std::mutex finishedMutex{};
+        std::condition_variable finished{};
+    };
+    auto loop{std::make_shared<Loop>()};
+    loop->count = count;
+    loop->body = &body;
+
+    auto const work{[](Loop& loop)
+    {
+        for (size_t index{loop.nextIndex.fetch_add(1)}; index < loop.count;
+             index = loop.nextIndex.fetch_add(1))
+        {
+            (*loop.body)(index);
+
+            if (loop.finishedCount.fetch_add(1) + 1 == loop.count)
+            {
+                std::lock_guard<std::mutex> const lock{loop.finishedMutex};
+                loop.finished.notify_all();
+            }
+        }
+    }};
+
+    size_t const helperCount{std::min(workerCount(), count - 1)};
+    for (size_t helper{0}; helper < helperCount; helper++)
+    {
+        enqueue([loop, work]() { work(*loop); });
+    }
+
+    work(*loop);
+
+    std::unique_lock<std::mutex> lock{loop->finishedMutex};
+    loop->finished.wait(
+        lock, [&]() { return loop->finishedCount.load() == loop->count; }
+    );
+}
+
+void ThreadPool::enqueue(std::function<void()>&& job)
+{
+    {
+        std::lock_guard<std::mutex> const lock{m_queueMutex};
+        m_queue.push_back(std::move(job));
+    }
+    m_queueCondition.notify_one();
+}
+
+void ThreadPool::workerLoop(std::stop_token const& stopToken)
+{
+    while (!stopToken.stop_requested())
+    {
+        std::function<void()> job{};
+
+        {
+            std::unique_lock<std::mutex> lock{m_queueMutex};
+            if (!m_queueCondition.wait(
+                    lock, stopToken, [&]() { return !m_queue.empty(); }
+                ))
+            {
+                return;
+            }
+
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        job();
+    }
+}
+} // namespace syzygy
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "syzygy/platform/integer.hpp"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace syzygy
+{
+// A fixed-size set of worker threads that execute submitted jobs in FIFO
+// order. Jobs that are still queued when the pool is destroyed are discarded,
+// and their futures report a broken promise.
+struct ThreadPool
+{
+public:
+    ThreadPool(ThreadPool&&) = delete;
+    auto operator=(ThreadPool&&) -> ThreadPool& = delete;
+    ThreadPool(ThreadPool const&) = delete;
+    auto operator=(ThreadPool const&) -> ThreadPool& = delete;
+
+    explicit ThreadPool(size_t workerCount);
+    ~ThreadPool();
+
+    // One less than the hardware concurrency, so the owning thread keeps a
+    // core. Always at least 1.
+    static auto defaultWorkerCount() -> size_t;
+
+    [[nodiscard]] auto workerCount() const -> size_t;
+
+    template <typename Job>
+    auto submit(Job&& job) -> std::future<std::invoke_result_t<Job>>
+    {
+        using Result = std::invoke_result_t<Job>;
+
+        // std::function requires copyable callables, so the move-only
+        // packaged_task is shared instead.
+        auto task{std::make_shared<std::packaged_task<Result()>>(
+            std::forward<Job>(job)
+        )};
+        std::future<Result> future{task->get_future()};
+
+        enqueue([task]() { (*task)(); });
+
+        return future;
+    }
+
+    // Calls body once for each index in [0, count), spread across the workers,
+    // and returns once every call has finished. The calling thread works on
+    // the indices too, and never waits on a queued job, so this is safe to
+    // call from a job of this same pool, including nested inside another
+    // parallelFor.
+    void parallelFor(size_t count, std::function<void(size_t)> const& body);
+
+private:
+    void enqueue(std::function<void()>&& job);
+    void workerLoop(std::stop_token const& stopToken);
+
+    std::mutex m_queueMutex{};
+    std::condition_variable_any m_queueCondition{};
+    std::deque<std::function<void()>> m_queue{};
+
+    std::vector<std::jthread> m_workers{};
+};
+} // namespace syzygy
@@ -25,6 +25,8 @@
 #include "syzygy/renderer/scene.hpp"
 #include "syzygy/renderer/scenetexture.hpp"
 #include "syzygy/renderer/shaders.hpp"
+#include "syzygy/renderer/uploadqueue.hpp"
+#include "syzygy/renderer/vertexencoding.hpp"
 #include "syzygy/renderer/vulkanstructs.hpp"
 #include "syzygy/ui/dockinglayout.hpp"
 #include "syzygy/ui/hud.hpp"
@@ -471,8 +473,23 @@ auto run() -> EditorResult
         return EditorResult::ERROR;
     }
 
+    std::optional<UploadQueue> uploadQueueResult{UploadQueue::create(
+        graphicsContext.device(),
+        graphicsContext.allocator(),
+        graphicsContext.transferQueue(),
+        graphicsContext.transferQueueFamily(),
+        graphicsContext.universalQueue(),
+        graphicsContext.universalQueueFamily()
+    )};
+    if (!uploadQueueResult.has_value())
+    {
+        SZG_ERROR("Failed to create upload queue.");
+        return EditorResult::ERROR;
+    }
+    UploadQueue& uploadQueue{uploadQueueResult.value()};
+
     std::optional<AssetLibrary> assetLibraryResult{
-        AssetLibrary::loadDefaultAssets(graphicsContext, submissionQueue)
+        AssetLibrary::loadDefaultAssets(graphicsContext, uploadQueue)
     };
     if (!assetLibraryResult.has_value())
     {
@@ -514,7 +531,6 @@ auto run() -> EditorResult
         scene.addMeshInstance(
             graphicsContext.device(),
             graphicsContext.allocator(),
-            graphicsContext.descriptorAllocator(),
             assetLibrary.defaultMesh(AssetLibrary::DefaultMeshAssets::Cube),
             InstanceAnimation::None,
             "Model_1",
@@ -527,7 +543,6 @@ auto run() -> EditorResult
         scene.addMeshInstance(
             graphicsContext.device(),
             graphicsContext.allocator(),
-            graphicsContext.descriptorAllocator(),
             assetLibrary.defaultMesh(AssetLibrary::DefaultMeshAssets::Cube),
             InstanceAnimation::None,
             "Model_2",
@@ -547,7 +562,6 @@ auto run() -> EditorResult
         scene.addMeshInstance(
             graphicsContext.device(),
             graphicsContext.allocator(),
-            graphicsContext.descriptorAllocator(),
             assetLibrary.defaultMesh(AssetLibrary::DefaultMeshAssets::Plane),
             InstanceAnimation::None,
             "Floor",
@@ -636,15 +650,41 @@ auto run() -> EditorResult
             return EditorResult::ERROR;
         }
 
-        assetLibrary.processTasks(graphicsContext, submissionQueue);
+        uploadQueue.collect();
+        assetLibrary.setBatchUploads(configuration.batchAssetUploads);
+        if (!configuration.compactMeshVertices)
+        {
+            assetLibrary.setMeshVertexFormat(VertexFormat::Full);
+        }
+        else
+        {
+            assetLibrary.setMeshVertexFormat(
+                configuration.quantizeMeshPositions ? VertexFormat::Quantized
+                                                    : VertexFormat::Compact
+            );
+        }
+        assetLibrary.setVertexWeldTolerance(VertexWeldTolerance{
+            .position = configuration.weldPositionTolerance,
+            .normal = configuration.weldNormalTolerance,
+            .uv = configuration.weldUVTolerance,
+        });
+        assetLibrary.textureResidency().setBudgetFraction(
+            configuration.textureMemoryBudget
+        );
+        assetLibrary.setHotReload(configuration.hotReloadAssets);
+        assetLibrary.processTasks(graphicsContext, uploadQueue);
 
         DockingLayout const& dockingLayout{uiLayer.begin()};
         if (uiLayer.HUDMenuItem("Tools", "Load Mesh (.glTF / .glb / .bin)"))
         {
             assetLibrary.loadMeshesDialog(
-                mainWindow, graphicsContext, submissionQueue
+                mainWindow, graphicsContext, uploadQueue
             );
         }
+        if (uiLayer.HUDMenuItem("Tools", "Unload Unused Assets"))
+        {
+            assetLibrary.unloadUnused(scene.geometry());
+        }
 
         editorConfigurationWindow(
             "Editor Configuration",
@@ -714,8 +754,10 @@ auto run() -> EditorResult
             {
                 instance.prepareDescriptors(
                     graphicsContext.device(),
-                    graphicsContext.descriptorAllocator()
+                    graphicsContext.descriptorAllocator(),
+                    assetLibrary.textureResidency().frame()
                 );
+                instance.markTexturesUsed(assetLibrary.textureResidency());
             }
             renderer.recordDraw(
                 currentFrame.mainCommandBuffer,
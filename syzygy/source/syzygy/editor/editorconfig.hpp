@@ -11,5 +11,20 @@ enum class GammaTransferFunction
 struct EditorConfiguration
 {
     GammaTransferFunction transferFunction{GammaTransferFunction::sRGB};
+    bool batchAssetUploads{true};
+    // Applies to meshes loaded afterwards.
+    bool compactMeshVertices{false};
+    // Only when compactMeshVertices is set.
+    bool quantizeMeshPositions{false};
+    // Per component tolerances for welding glTF vertices, applying to meshes
+    // loaded afterwards. Zero only welds exact duplicates.
+    float weldPositionTolerance{0.0F};
+    float weldNormalTolerance{0.0F};
+    float weldUVTolerance{0.0F};
+    // The fraction of the device's memory budget that may be in use before
+    // textures are evicted.
+    float textureMemoryBudget{0.9F};
+    // Updates assets in place when the files they were imported from change.
+    bool hotReloadAssets{true};
 };
 } // namespace syzygy
\ No newline at end of file
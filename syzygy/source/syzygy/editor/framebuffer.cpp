@@ -1,5 +1,6 @@
 #include "framebuffer.hpp"
 
+#include "syzygy/assets/textureresidency.hpp"
 #include "syzygy/core/deletionqueue.hpp"
 #include "syzygy/core/log.hpp"
 #include "syzygy/platform/vulkanmacros.hpp"
@@ -132,6 +133,10 @@ auto FrameBuffer::create(VkDevice const device, uint32_t const queueFamilyIndex)
     frameBuffer.m_device = device;
 
     size_t constexpr FRAMES_IN_FLIGHT{2};
+    static_assert(
+        FRAMES_IN_FLIGHT < TextureResidency::RETIRE_FRAMES,
+        "Retired textures and descriptor sets would be reused while in use."
+    );
 
     for (size_t i{0}; i < FRAMES_IN_FLIGHT; i++)
     {
@@ -12,6 +12,7 @@
 
 namespace
 {
+// Without a surface, a software device is preferred over any GPU.
 auto selectPhysicalDevice(
     vkb::Instance const& instance, VkSurfaceKHR const surface
 ) -> vkb::Result<vkb::PhysicalDevice>
@@ -22,16 +23,25 @@ auto selectPhysicalDevice(
     };
 
     VkPhysicalDeviceVulkan12Features const features12{
+        // Meshlet culling draws with counts written on the device.
+        .drawIndirectCount = VK_TRUE,
+
         .descriptorIndexing = VK_TRUE,
 
         .descriptorBindingPartiallyBound = VK_TRUE,
         .runtimeDescriptorArray = VK_TRUE,
 
+        .timelineSemaphore = VK_TRUE,
         .bufferDeviceAddress = VK_TRUE,
     };
 
+    // Cooked glTF textures are BC5 and BC7. Culled meshlets are drawn
+    // indirectly, each with its instance as the first instance.
     VkPhysicalDeviceFeatures const features{
+        .multiDrawIndirect = VK_TRUE,
+        .drawIndirectFirstInstance = VK_TRUE,
         .wideLines = VK_TRUE,
+        .textureCompressionBC = VK_TRUE,
     };
 
     VkPhysicalDeviceShaderObjectFeaturesEXT const shaderObjectFeature{
@@ -41,29 +51,50 @@ auto selectPhysicalDevice(
         .shaderObject = VK_TRUE,
     };
 
-    return vkb::PhysicalDeviceSelector{instance}
-        .set_minimum_version(1, 3)
+    vkb::PhysicalDeviceSelector selector{instance};
+    selector.set_minimum_version(1, 3)
         .set_required_features_13(features13)
         .set_required_features_12(features12)
         .set_required_features(features)
         .add_required_extension_features(shaderObjectFeature)
-        .add_required_extension(VK_EXT_SHADER_OBJECT_EXTENSION_NAME)
-        .set_surface(surface)
-        .select();
+        .add_required_extension(VK_EXT_SHADER_OBJECT_EXTENSION_NAME);
+
+    if (surface != VK_NULL_HANDLE)
+    {
+        selector.set_surface(surface);
+    }
+    else
+    {
+        selector.prefer_gpu_device_type(vkb::PreferredDeviceType::cpu);
+    }
+
+    return selector.select();
 }
 
+// With memoryBudget, VMA reads the heap budgets from VK_EXT_memory_budget,
+// which must be enabled on the device.
 auto createAllocator(
     VkPhysicalDevice const physicalDevice,
     VkDevice const device,
-    VkInstance const instance
+    VkInstance const instance,
+    bool const memoryBudget
 ) -> std::optional<VmaAllocator>
 {
+    VmaAllocatorCreateFlags flags{
+        VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT
+    };
+    if (memoryBudget)
+    {
+        flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    }
+
     std::optional<VmaAllocator> allocatorResult{std::in_place};
     VmaAllocatorCreateInfo const allocatorInfo{
-        .flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT,
+        .flags = flags,
         .physicalDevice = physicalDevice,
         .device = device,
         .instance = instance,
+        .vulkanApiVersion = VK_API_VERSION_1_3,
     };
 
     if (VkResult const createResult{
@@ -92,6 +123,9 @@ GraphicsContext::GraphicsContext(GraphicsContext&& other) noexcept
     m_universalQueue = std::exchange(other.m_universalQueue, VK_NULL_HANDLE);
     m_universalQueueFamily = std::exchange(other.m_universalQueueFamily, 0);
 
+    m_transferQueue = std::exchange(other.m_transferQueue, VK_NULL_HANDLE);
+    m_transferQueueFamily = std::exchange(other.m_transferQueueFamily, 0);
+
     m_allocator = std::exchange(other.m_allocator, VK_NULL_HANDLE);
     m_descriptorAllocator = std::move(other.m_descriptorAllocator);
 }
@@ -101,6 +135,19 @@ GraphicsContext::~GraphicsContext() { destroy(); }
 auto GraphicsContext::create(PlatformWindow const& window)
     -> std::optional<GraphicsContext>
 {
+    return create(&window);
+}
+
+auto GraphicsContext::createHeadless() -> std::optional<GraphicsContext>
+{
+    return create(nullptr);
+}
+
+auto GraphicsContext::create(PlatformWindow const* const window)
+    -> std::optional<GraphicsContext>
+{
+    bool const headless{window == nullptr};
+
     std::optional<GraphicsContext> graphicsResult{
         std::in_place, GraphicsContext{}
     };
@@ -112,13 +159,18 @@ auto GraphicsContext::create(PlatformWindow const& window)
         return std::nullopt;
     }
 
+    vkb::InstanceBuilder instanceBuilder{};
+    instanceBuilder.set_app_name("Syzygy")
+        .set_headless(headless)
+        .require_api_version(1, 3, 0);
+    if (!headless)
+    {
+        instanceBuilder.request_validation_layers()
+            .use_default_debug_messenger();
+    }
+
     vkb::Result<vkb::Instance> const instanceBuildResult{
-        vkb::InstanceBuilder{}
-            .set_app_name("Syzygy")
-            .request_validation_layers()
-            .use_default_debug_messenger()
-            .require_api_version(1, 3, 0)
-            .build()
+        instanceBuilder.build()
     };
     if (!instanceBuildResult.has_value())
     {
@@ -134,13 +186,19 @@ auto GraphicsContext::create(PlatformWindow const& window)
     graphics.m_debugMessenger = instance.debug_messenger;
     graphics.m_instance = instance.instance;
 
-    if (VkResult const surfaceResult{glfwCreateWindowSurface(
-            instance.instance, window.handle(), nullptr, &graphics.m_surface
-        )};
-        surfaceResult != VK_SUCCESS)
+    if (!headless)
     {
-        SZG_LOG_VK(surfaceResult, "Failed to create surface via GLFW.");
-        return std::nullopt;
+        if (VkResult const surfaceResult{glfwCreateWindowSurface(
+                instance.instance,
+                window->handle(),
+                nullptr,
+                &graphics.m_surface
+            )};
+            surfaceResult != VK_SUCCESS)
+        {
+            SZG_LOG_VK(surfaceResult, "Failed to create surface via GLFW.");
+            return std::nullopt;
+        }
     }
 
     vkb::Result<vkb::PhysicalDevice> physicalDeviceResult{
@@ -151,9 +209,20 @@ auto GraphicsContext::create(PlatformWindow const& window)
         SZG_LOG_VKB(physicalDeviceResult, "Failed to select physical device.");
         return std::nullopt;
     }
-    vkb::PhysicalDevice const& physicalDevice{physicalDeviceResult.value()};
+    vkb::PhysicalDevice& physicalDevice{physicalDeviceResult.value()};
     graphics.m_physicalDevice = physicalDevice.physical_device;
 
+    // Textures are evicted to stay within the budget this reports. Without it,
+    // VMA estimates the budget from the heap sizes.
+    bool const memoryBudget{physicalDevice.enable_extension_if_present(
+        VK_EXT_MEMORY_BUDGET_EXTENSION_NAME
+    )};
+    if (!memoryBudget)
+    {
+        SZG_INFO("VK_EXT_memory_budget is not supported, memory budgets will "
+                 "be estimated.");
+    }
+
     vkb::Result<vkb::Device> const deviceBuildResult{
         vkb::DeviceBuilder{physicalDevice}.build()
     };
@@ -195,8 +264,30 @@ auto GraphicsContext::create(PlatformWindow const& window)
         return std::nullopt;
     }
 
+    // Uploads are done on a transfer-only family when possible, so they can
+    // overlap with rendering.
+    if (vkb::Result<VkQueue> const transferQueueResult{
+            device.get_dedicated_queue(vkb::QueueType::transfer)
+        };
+        transferQueueResult.has_value())
+    {
+        graphics.m_transferQueue = transferQueueResult.value();
+        graphics.m_transferQueueFamily =
+            device.get_dedicated_queue_index(vkb::QueueType::transfer).value();
+    }
+    else
+    {
+        SZG_INFO("No dedicated transfer queue, falling back to the graphics "
+                 "queue for uploads.");
+        graphics.m_transferQueue = graphics.m_universalQueue;
+        graphics.m_transferQueueFamily = graphics.m_universalQueueFamily;
+    }
+
     if (std::optional<VmaAllocator> const allocatorResult{createAllocator(
-            graphics.m_physicalDevice, graphics.m_device, graphics.m_instance
+            graphics.m_physicalDevice,
+            graphics.m_device,
+            graphics.m_instance,
+            memoryBudget
         )};
         allocatorResult.has_value())
     {
@@ -264,6 +355,14 @@ auto GraphicsContext::universalQueueFamily() const -> uint32_t
     return m_universalQueueFamily;
 }
 
+// NOLINTNEXTLINE(readability-make-member-function-const)
+auto GraphicsContext::transferQueue() -> VkQueue { return m_transferQueue; }
+
+auto GraphicsContext::transferQueueFamily() const -> uint32_t
+{
+    return m_transferQueueFamily;
+}
+
 // NOLINTNEXTLINE(readability-make-member-function-const)
 auto GraphicsContext::allocator() -> VmaAllocator { return m_allocator; }
 
@@ -285,6 +384,9 @@ void GraphicsContext::destroy()
     m_universalQueue = VK_NULL_HANDLE;
     m_universalQueueFamily = 0;
 
+    m_transferQueue = VK_NULL_HANDLE;
+    m_transferQueueFamily = 0;
+
     if (m_device != VK_NULL_HANDLE)
     {
         vkDestroyDevice(m_device, nullptr);
@@ -293,8 +395,17 @@ void GraphicsContext::destroy()
 
     if (m_instance != VK_NULL_HANDLE)
     {
-        vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
-        vkDestroyDebugUtilsMessengerEXT(m_instance, m_debugMessenger, nullptr);
+        // Headless instances have neither, nor the extensions to destroy them.
+        if (m_surface != VK_NULL_HANDLE)
+        {
+            vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
+        }
+        if (m_debugMessenger != VK_NULL_HANDLE)
+        {
+            vkDestroyDebugUtilsMessengerEXT(
+                m_instance, m_debugMessenger, nullptr
+            );
+        }
         vkDestroyInstance(m_instance, nullptr);
     }
     else if (m_surface != VK_NULL_HANDLE || m_debugMessenger != VK_NULL_HANDLE)
@@ -26,6 +26,11 @@ public:
 
     static auto create(PlatformWindow const&) -> std::optional<GraphicsContext>;
 
+    // Without a surface, so nothing can be presented, and without validation
+    // layers. A software device is preferred, so tools such as benchmarks can
+    // run on machines without a GPU and compare their results between them.
+    static auto createHeadless() -> std::optional<GraphicsContext>;
+
     auto instance() -> VkInstance;
     auto surface() -> VkSurfaceKHR;
     auto physicalDevice() -> VkPhysicalDevice;
@@ -33,6 +38,11 @@ public:
     auto universalQueue() -> VkQueue;
     [[nodiscard]] auto universalQueueFamily() const -> uint32_t;
 
+    // A queue from a transfer-only family if the device has one, otherwise the
+    // universal queue.
+    auto transferQueue() -> VkQueue;
+    [[nodiscard]] auto transferQueueFamily() const -> uint32_t;
+
     auto allocator() -> VmaAllocator;
     auto descriptorAllocator() -> syzygy::DescriptorAllocator&;
 
@@ -40,6 +50,10 @@ private:
     GraphicsContext() = default;
     void destroy();
 
+    // Headless when there is no window.
+    static auto create(PlatformWindow const* window)
+        -> std::optional<GraphicsContext>;
+
     VkInstance m_instance{VK_NULL_HANDLE};
     VkDebugUtilsMessengerEXT m_debugMessenger{VK_NULL_HANDLE};
     VkSurfaceKHR m_surface{VK_NULL_HANDLE};
@@ -49,6 +63,9 @@ private:
     VkQueue m_universalQueue{VK_NULL_HANDLE};
     uint32_t m_universalQueueFamily{};
 
+    VkQueue m_transferQueue{VK_NULL_HANDLE};
+    uint32_t m_transferQueueFamily{};
+
     VmaAllocator m_allocator{VK_NULL_HANDLE};
     std::unique_ptr<syzygy::DescriptorAllocator> m_descriptorAllocator{};
 };
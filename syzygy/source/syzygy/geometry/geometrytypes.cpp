@@ -1,6 +1,7 @@
 #include "geometrytypes.hpp"
 
 #include <glm/common.hpp>
+#include <glm/geometric.hpp>
 
 namespace syzygy
 {
@@ -32,4 +33,10 @@ auto AABB::collectVertices() const -> Vertices
 }
 auto AABB::min() const -> glm::vec3 { return center - glm::abs(halfExtent); }
 auto AABB::max() const -> glm::vec3 { return center + glm::abs(halfExtent); }
+auto Sphere::circumscribe(AABB const& box) -> Sphere
+{
+    return Sphere{
+        .center = box.center, .radius = glm::length(box.halfExtent)
+    };
+}
 } // namespace syzygy
\ No newline at end of file
@@ -36,4 +36,13 @@ struct AABB
     glm::vec3 halfExtent;
 };
 
+struct Sphere
+{
+    // The smallest sphere that contains the box.
+    static auto circumscribe(AABB const& box) -> Sphere;
+
+    glm::vec3 center;
+    float radius;
+};
+
 } // namespace syzygy
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "cpufeatures.hpp"
+
+#include "syzygy/platform/integer.hpp"
+#include <array>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace
+{
+struct CPUIDRegisters
+{
+    uint32_t eax{0};
+    uint32_t ebx{0};
+    uint32_t ecx{0};
+    uint32_t edx{0};
+};
+
+auto cpuid(uint32_t const leaf, uint32_t const subleaf) -> CPUIDRegisters
+{
+#if defined(_MSC_VER)
+    std::array<int32_t, 4> registers{};
+    __cpuidex(
+        registers.data(),
+        static_cast<int32_t>(leaf),
+        static_cast<int32_t>(subleaf)
+    );
+    return CPUIDRegisters{
+        .eax = static_cast<uint32_t>(registers[0]),
+        .ebx = static_cast<uint32_t>(registers[1]),
+        .ecx = static_cast<uint32_t>(registers[2]),
+        .edx = static_cast<uint32_t>(registers[3]),
+    };
+#else
+    CPUIDRegisters registers{};
+    __cpuid_count(
+        leaf,
+        subleaf,
+        registers.eax,
+        registers.ebx,
+        registers.ecx,
+        registers.edx
+    );
+    return registers;
+#endif
+}
+
+// The register state that the OS has enabled, from XCR0.
+auto enabledRegisterState() -> uint64_t
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t low{0};
+    uint32_t high{0};
+    __asm__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return (static_cast<uint64_t>(high) << 32U) | low;
+#endif
+}
+
+auto detectFeatures() -> syzygy::CPUFeatures
+{
+    // NOLINTBEGIN(readability-magic-numbers)
+    uint32_t constexpr SSE41_BIT{1U << 19U};
+    uint32_t constexpr OSXSAVE_BIT{1U << 27U};
+    uint32_t constexpr AVX_BIT{1U << 28U};
+    uint32_t constexpr AVX2_BIT{1U << 5U};
+    // SSE and AVX state, so xmm and ymm registers are preserved.
+    uint64_t constexpr YMM_STATE{0b110U};
+    // NOLINTEND(readability-magic-numbers)
+
+    syzygy::CPUFeatures features{};
+
+    uint32_t const maxLeaf{cpuid(0, 0).eax};
+    if (maxLeaf < 1)
+    {
+        return features;
+    }
+
+    CPUIDRegisters const leaf1{cpuid(1, 0)};
+    features.sse41 = (leaf1.ecx & SSE41_BIT) != 0;
+
+    bool const osSavesYMM{
+        (leaf1.ecx & OSXSAVE_BIT) != 0 && (leaf1.ecx & AVX_BIT) != 0
+        && (enabledRegisterState() & YMM_STATE) == YMM_STATE
+    };
+    if (maxLeaf >= 7 && osSavesYMM)
+    {
+        features.avx2 = (cpuid(7, 0).ebx & AVX2_BIT) != 0;
+    }
+
+    return features;
+}
+} // namespace
+
+namespace syzygy
+{
+auto CPUFeatures::detect() -> CPUFeatures const&
+{
+    static CPUFeatures const features{detectFeatures()};
+    return features;
+}
+} // namespace syzygy
@@ -0,0 +1,16 @@
+#pragma once
+
+namespace syzygy
+{
+// Instruction set extensions that code can dispatch on at runtime. Extensions
+// that use wider registers, such as AVX2, are only reported if the OS also
+// saves those registers on context switches.
+struct CPUFeatures
+{
+    bool sse41{false};
+    bool avx2{false};
+
+    // Queried once with CPUID, then cached.
+    static auto detect() -> CPUFeatures const&;
+};
+} // namespace syzygy
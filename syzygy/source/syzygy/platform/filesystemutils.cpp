@@ -1,5 +1,7 @@
 #include "filesystemutils.hpp"
 
+#include <utility>
+
 auto syzygy::ensureAbsolutePath(
     std::filesystem::path const& path, std::filesystem::path const& root
 ) -> std::filesystem::path
@@ -11,3 +13,22 @@ auto syzygy::ensureAbsolutePath(
 
     return root / path;
 }
+
+namespace syzygy
+{
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    m_fileHandle = std::exchange(other.m_fileHandle, nullptr);
+    m_mappingHandle = std::exchange(other.m_mappingHandle, nullptr);
+
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+}
+
+MappedFile::~MappedFile() { destroy(); }
+
+auto MappedFile::bytes() const -> std::span<uint8_t const>
+{
+    return std::span<uint8_t const>{m_data, m_size};
+}
+} // namespace syzygy
@@ -1,6 +1,9 @@
 #pragma once
 
+#include "syzygy/platform/integer.hpp"
 #include <filesystem>
+#include <optional>
+#include <span>
 
 namespace syzygy
 {
@@ -8,4 +11,49 @@ auto ensureAbsolutePath(
     std::filesystem::path const& path,
     std::filesystem::path const& root = std::filesystem::current_path()
 ) -> std::filesystem::path;
+
+// A read-only view of a file's bytes, mapped into the address space. Pages are
+// read from disk by the OS as they are first touched, so only the parts of the
+// file that are accessed are loaded.
+struct MappedFile
+{
+public:
+    auto operator=(MappedFile&&) -> MappedFile& = delete;
+    MappedFile(MappedFile const&) = delete;
+    auto operator=(MappedFile const&) -> MappedFile& = delete;
+
+    MappedFile(MappedFile&&) noexcept;
+    ~MappedFile();
+
+private:
+    MappedFile() = default;
+    void destroy();
+
+public:
+    // Hints how the bytes will be read, so the OS can read ahead of accesses.
+    enum class AccessPattern
+    {
+        // Pages are only read from disk once they are touched.
+        Random,
+        // The whole file is expected to be read front to back, such as when it
+        // is decoded or copied. It is prefetched in large reads when mapped.
+        Sequential,
+    };
+
+    // Fails for empty files, which cannot be mapped.
+    static auto open(
+        std::filesystem::path const& path,
+        AccessPattern pattern = AccessPattern::Random
+    ) -> std::optional<MappedFile>;
+
+    [[nodiscard]] auto bytes() const -> std::span<uint8_t const>;
+
+private:
+    // Native handles, kept opaque so platform headers stay out of this one.
+    void* m_fileHandle{nullptr};
+    void* m_mappingHandle{nullptr};
+
+    uint8_t const* m_data{nullptr};
+    size_t m_size{0};
+};
 } // namespace syzygy
@@ -0,0 +1,42 @@
+#include "filewatcher.hpp"
+
+#include "syzygy/platform/filesystemutils.hpp"
+#include <chrono>
+#include <filesystem>
+#include <vector>
+
+namespace syzygy
+{
+auto FileWatcher::normalize(std::filesystem::path const& path)
+    -> std::filesystem::path
+{
+    return ensureAbsolutePath(path).lexically_normal();
+}
+
+auto FileWatcher::poll() -> std::vector<std::filesystem::path>
+{
+    std::vector<std::filesystem::path> modified{};
+    readChanges(modified);
+
+    auto const now{std::chrono::steady_clock::now()};
+    for (std::filesystem::path& path : modified)
+    {
+        m_modified.insert_or_assign(std::move(path), now);
+    }
+
+    std::vector<std::filesystem::path> quiet{};
+    for (auto iterator{m_modified.begin()}; iterator != m_modified.end();)
+    {
+        if (now - iterator->second < QUIET_PERIOD)
+        {
+            iterator++;
+            continue;
+        }
+
+        quiet.push_back(iterator->first);
+        iterator = m_modified.erase(iterator);
+    }
+
+    return quiet;
+}
+} // namespace syzygy
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace syzygy
+{
+// Reports files that were modified on disk, such as assets edited in another
+// program. Files are watched through their directories, with reads of the
+// directories' changes that are left pending and checked without blocking.
+//
+// Editors and exporters tend to write a file in several steps, so a file is
+// only reported once it has gone unmodified for QUIET_PERIOD.
+struct FileWatcher
+{
+public:
+    auto operator=(FileWatcher&&) -> FileWatcher& = delete;
+    FileWatcher(FileWatcher const&) = delete;
+    auto operator=(FileWatcher const&) -> FileWatcher& = delete;
+
+    FileWatcher();
+    FileWatcher(FileWatcher&&) noexcept;
+    ~FileWatcher();
+
+private:
+    void destroy();
+
+public:
+    static std::chrono::milliseconds constexpr QUIET_PERIOD{250};
+
+    // Returns if the file is watched, which it may already have been. The file
+    // does not need to exist yet.
+    auto watch(std::filesystem::path const& path) -> bool;
+
+    // Call regularly, such as once per frame, since this never blocks. Returns
+    // the watched files that were modified and have since gone quiet, as the
+    // absolute and normalized paths they are watched under.
+    auto poll() -> std::vector<std::filesystem::path>;
+
+    // How files are identified, which poll reports them as.
+    static auto normalize(std::filesystem::path const& path)
+        -> std::filesystem::path;
+
+private:
+    // The native handles and pending read of one directory.
+    struct WatchedDirectory;
+
+    // Appends the watched files that were modified since the last call, and
+    // starts the next read of each directory.
+    void readChanges(std::vector<std::filesystem::path>& modified);
+
+    std::vector<std::unique_ptr<WatchedDirectory>> m_directories{};
+
+    // When each file was last modified, until it is reported.
+    std::map<std::filesystem::path, std::chrono::steady_clock::time_point>
+        m_modified{};
+};
+} // namespace syzygy
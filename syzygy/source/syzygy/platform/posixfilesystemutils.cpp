@@ -0,0 +1,87 @@
+#include "filesystemutils.hpp"
+
+#include "syzygy/core/log.hpp"
+#include <cerrno>
+#include <fcntl.h>
+#include <filesystem>
+#include <optional>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace syzygy
+{
+void MappedFile::destroy()
+{
+    if (m_data != nullptr)
+    {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+
+    m_fileHandle = nullptr;
+    m_mappingHandle = nullptr;
+    m_data = nullptr;
+    m_size = 0;
+}
+
+auto MappedFile::open(
+    std::filesystem::path const& path, AccessPattern const pattern
+) -> std::optional<MappedFile>
+{
+    std::optional<MappedFile> fileResult{MappedFile{}};
+    MappedFile& file{fileResult.value()};
+
+    int const descriptor{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (descriptor < 0)
+    {
+        SZG_ERROR(
+            "Unable to open file for mapping at {}, error {}",
+            path.string(),
+            errno
+        );
+        return std::nullopt;
+    }
+
+    // The mapping keeps its own reference to the file, so no native handles
+    // are kept once it is made.
+    struct stat status{};
+    if (fstat(descriptor, &status) != 0 || status.st_size <= 0)
+    {
+        close(descriptor);
+        SZG_ERROR("File to map was empty or unreadable at {}", path.string());
+        return std::nullopt;
+    }
+    file.m_size = static_cast<size_t>(status.st_size);
+
+    void* const view{
+        mmap(nullptr, file.m_size, PROT_READ, MAP_PRIVATE, descriptor, 0)
+    };
+    close(descriptor);
+    if (view == MAP_FAILED)
+    {
+        SZG_ERROR(
+            "Unable to map view of file {}, error {}", path.string(), errno
+        );
+        return std::nullopt;
+    }
+    file.m_data = static_cast<uint8_t const*>(view);
+
+    if (pattern == AccessPattern::Sequential)
+    {
+        // Reads ahead aggressively, and starts reading the whole view now
+        // rather than one page at a time as it is touched. These are only
+        // hints, so failure is not an error.
+        if (madvise(view, file.m_size, MADV_SEQUENTIAL) != 0
+            || madvise(view, file.m_size, MADV_WILLNEED) != 0)
+        {
+            SZG_WARNING(
+                "Unable to prefetch mapped file {}, error {}",
+                path.string(),
+                errno
+            );
+        }
+    }
+
+    return fileResult;
+}
+} // namespace syzygy
@@ -0,0 +1,115 @@
+#include "filesystemutils.hpp"
+
+#include "syzygy/core/log.hpp"
+#include <Windows.h>
+#include <filesystem>
+#include <optional>
+
+namespace syzygy
+{
+void MappedFile::destroy()
+{
+    if (m_data != nullptr)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mappingHandle != nullptr)
+    {
+        CloseHandle(m_mappingHandle);
+    }
+    if (m_fileHandle != nullptr)
+    {
+        CloseHandle(m_fileHandle);
+    }
+
+    m_fileHandle = nullptr;
+    m_mappingHandle = nullptr;
+    m_data = nullptr;
+    m_size = 0;
+}
+
+auto MappedFile::open(
+    std::filesystem::path const& path, AccessPattern const pattern
+) -> std::optional<MappedFile>
+{
+    std::optional<MappedFile> fileResult{MappedFile{}};
+    MappedFile& file{fileResult.value()};
+
+    HANDLE const fileHandle{CreateFileW(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        pattern == AccessPattern::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN
+                                             : FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    )};
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        SZG_ERROR(
+            "Unable to open file for mapping at {}, error {}",
+            path.string(),
+            GetLastError()
+        );
+        return std::nullopt;
+    }
+    file.m_fileHandle = fileHandle;
+
+    LARGE_INTEGER fileSize{};
+    if (GetFileSizeEx(fileHandle, &fileSize) == 0 || fileSize.QuadPart <= 0)
+    {
+        SZG_ERROR("File to map was empty or unreadable at {}", path.string());
+        return std::nullopt;
+    }
+    file.m_size = static_cast<size_t>(fileSize.QuadPart);
+
+    HANDLE const mappingHandle{
+        CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr)
+    };
+    if (mappingHandle == nullptr)
+    {
+        SZG_ERROR(
+            "Unable to create file mapping for {}, error {}",
+            path.string(),
+            GetLastError()
+        );
+        return std::nullopt;
+    }
+    file.m_mappingHandle = mappingHandle;
+
+    void const* const view{MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0)
+    };
+    if (view == nullptr)
+    {
+        SZG_ERROR(
+            "Unable to map view of file {}, error {}",
+            path.string(),
+            GetLastError()
+        );
+        return std::nullopt;
+    }
+    file.m_data = static_cast<uint8_t const*>(view);
+
+    if (pattern == AccessPattern::Sequential)
+    {
+        // Faults in the whole view with a few large reads, rather than one
+        // small read per page as it is touched. This is only a hint, so
+        // failure is not an error.
+        WIN32_MEMORY_RANGE_ENTRY range{
+            .VirtualAddress = const_cast<void*>(view),
+            .NumberOfBytes = file.m_size,
+        };
+        if (PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0) == 0)
+        {
+            SZG_WARNING(
+                "Unable to prefetch mapped file {}, error {}",
+                path.string(),
+                GetLastError()
+            );
+        }
+    }
+
+    return fileResult;
+}
+} // namespace syzygy
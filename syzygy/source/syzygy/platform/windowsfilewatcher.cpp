@@ -0,0 +1,258 @@
+#include "filewatcher.hpp"
+
+#include "syzygy/core/log.hpp"
+#include "syzygy/platform/integer.hpp"
+#include <Windows.h>
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace syzygy
+{
+struct FileWatcher::WatchedDirectory
+{
+public:
+    auto operator=(WatchedDirectory&&) -> WatchedDirectory& = delete;
+    WatchedDirectory(WatchedDirectory const&) = delete;
+    auto operator=(WatchedDirectory const&) -> WatchedDirectory& = delete;
+    // The pending read refers to this by address, so it cannot be moved.
+    WatchedDirectory(WatchedDirectory&&) = delete;
+
+    WatchedDirectory() = default;
+    ~WatchedDirectory()
+    {
+        if (handle == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+
+        if (reading)
+        {
+            // The buffer must outlive the read, so wait for it to be
+            // cancelled.
+            CancelIoEx(handle, &overlapped);
+            DWORD bytes{0};
+            GetOverlappedResult(handle, &overlapped, &bytes, TRUE);
+        }
+        CloseHandle(handle);
+    }
+
+    // Saves that replace the file, by renaming a temporary file over it, are
+    // reported as a change of name.
+    static DWORD constexpr NOTIFY_FILTER{
+        FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME
+    };
+
+    auto beginRead() -> bool
+    {
+        overlapped = OVERLAPPED{};
+        reading = ReadDirectoryChangesW(
+                      handle,
+                      buffer.data(),
+                      static_cast<DWORD>(sizeof(buffer)),
+                      FALSE,
+                      NOTIFY_FILTER,
+                      nullptr,
+                      &overlapped,
+                      nullptr
+                  )
+               != 0;
+        return reading;
+    }
+
+    // Names are compared without case, as the file system does. Returns the
+    // name the file is watched under.
+    auto findWatched(std::wstring_view const name) const
+        -> std::filesystem::path const*
+    {
+        auto const iterator{std::find_if(
+            fileNames.begin(),
+            fileNames.end(),
+            [&](std::filesystem::path const& fileName)
+        {
+            std::wstring const& watched{fileName.native()};
+            return CompareStringOrdinal(
+                       watched.c_str(),
+                       static_cast<int>(watched.size()),
+                       name.data(),
+                       static_cast<int>(name.size()),
+                       TRUE
+                   )
+                == CSTR_EQUAL;
+        }
+        )};
+        return iterator == fileNames.end() ? nullptr : &*iterator;
+    }
+
+    std::filesystem::path path{};
+    // The names of the watched files within the directory.
+    std::vector<std::filesystem::path> fileNames{};
+
+    HANDLE handle{INVALID_HANDLE_VALUE};
+    OVERLAPPED overlapped{};
+    bool reading{false};
+    // Written by the pending read. Changes are written as
+    // FILE_NOTIFY_INFORMATION, which must be DWORD aligned.
+    std::array<DWORD, 4096> buffer{};
+};
+
+FileWatcher::FileWatcher() = default;
+
+FileWatcher::FileWatcher(FileWatcher&& other) noexcept
+{
+    m_directories = std::exchange(other.m_directories, {});
+    m_modified = std::exchange(other.m_modified, {});
+}
+
+FileWatcher::~FileWatcher() { destroy(); }
+
+void FileWatcher::destroy()
+{
+    m_directories.clear();
+    m_modified.clear();
+}
+
+auto FileWatcher::watch(std::filesystem::path const& path) -> bool
+{
+    std::filesystem::path const file{normalize(path)};
+    std::filesystem::path const directoryPath{file.parent_path()};
+
+    auto directoryIterator{std::find_if(
+        m_directories.begin(),
+        m_directories.end(),
+        [&](std::unique_ptr<WatchedDirectory> const& directory)
+    { return directory->path == directoryPath; }
+    )};
+    if (directoryIterator == m_directories.end())
+    {
+        HANDLE const handle{CreateFileW(
+            directoryPath.c_str(),
+            FILE_LIST_DIRECTORY,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+            nullptr
+        )};
+        if (handle == INVALID_HANDLE_VALUE)
+        {
+            SZG_WARNING(
+                "Unable to open directory {} for watching, error {}",
+                directoryPath.string(),
+                GetLastError()
+            );
+            return false;
+        }
+
+        auto directory{std::make_unique<WatchedDirectory>()};
+        directory->path = directoryPath;
+        directory->handle = handle;
+        if (!directory->beginRead())
+        {
+            SZG_WARNING(
+                "Unable to watch directory {}, error {}",
+                directoryPath.string(),
+                GetLastError()
+            );
+            return false;
+        }
+
+        m_directories.push_back(std::move(directory));
+        directoryIterator = std::prev(m_directories.end());
+    }
+
+    WatchedDirectory& directory{**directoryIterator};
+    if (directory.findWatched(file.filename().native()) == nullptr)
+    {
+        directory.fileNames.push_back(file.filename());
+    }
+
+    return true;
+}
+
+void FileWatcher::readChanges(std::vector<std::filesystem::path>& modified)
+{
+    for (std::unique_ptr<WatchedDirectory> const& directory : m_directories)
+    {
+        if (!directory->reading)
+        {
+            // The last read failed, such as when the directory was briefly
+            // removed.
+            directory->beginRead();
+            continue;
+        }
+
+        DWORD bytes{0};
+        if (GetOverlappedResult(
+                directory->handle, &directory->overlapped, &bytes, FALSE
+            )
+            == 0)
+        {
+            if (DWORD const error{GetLastError()};
+                error != ERROR_IO_INCOMPLETE)
+            {
+                SZG_WARNING(
+                    "Failed to read changes to directory {}, error {}",
+                    directory->path.string(),
+                    error
+                );
+                directory->reading = false;
+            }
+            continue;
+        }
+        directory->reading = false;
+
+        if (bytes == 0)
+        {
+            // Too many changes to fit in the buffer, so which files changed is
+            // unknown.
+            for (std::filesystem::path const& fileName : directory->fileNames)
+            {
+                modified.push_back(directory->path / fileName);
+            }
+        }
+        else
+        {
+            auto const* const bufferBytes{
+                reinterpret_cast<uint8_t const*>(directory->buffer.data())
+            };
+            for (size_t offset{0};;)
+            {
+                auto const* const change{
+                    reinterpret_cast<FILE_NOTIFY_INFORMATION const*>(
+                        bufferBytes + offset
+                    )
+                };
+
+                std::wstring_view const name{
+                    change->FileName, change->FileNameLength / sizeof(WCHAR)
+                };
+                std::filesystem::path const* const fileName{
+                    directory->findWatched(name)
+                };
+                if (fileName != nullptr
+                    && (change->Action == FILE_ACTION_MODIFIED
+                        || change->Action == FILE_ACTION_ADDED
+                        || change->Action == FILE_ACTION_RENAMED_NEW_NAME))
+                {
+                    modified.push_back(directory->path / *fileName);
+                }
+
+                if (change->NextEntryOffset == 0)
+                {
+                    break;
+                }
+                offset += change->NextEntryOffset;
+            }
+        }
+
+        directory->beginRead();
+    }
+}
+} // namespace syzygy
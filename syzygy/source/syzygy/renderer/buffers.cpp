@@ -364,4 +364,128 @@ void StagedBuffer::recordTotalCopyBarrier(
 }
 
 auto StagedBuffer::isDirty() const -> bool { return m_dirty; }
-} // namespace syzygy
\ No newline at end of file
+
+auto StagingRing::allocate(
+    VkDevice const device,
+    VmaAllocator const allocator,
+    VkDeviceSize const capacity
+) -> std::optional<StagingRing>
+{
+    VkDeviceSize const alignedCapacity{
+        std::max(
+            (capacity + MAX_ALIGNMENT - 1) / MAX_ALIGNMENT, VkDeviceSize{1}
+        )
+        * MAX_ALIGNMENT
+    };
+
+    auto buffer{std::make_unique<AllocatedBuffer>(AllocatedBuffer::allocate(
+        device,
+        allocator,
+        alignedCapacity,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VMA_MEMORY_USAGE_CPU_ONLY,
+        VMA_ALLOCATION_CREATE_MAPPED_BIT
+    ))};
+    if (!buffer->isMapped())
+    {
+        SZG_ERROR("Failed to map staging ring.");
+        return std::nullopt;
+    }
+
+    return StagingRing{std::move(buffer)};
+}
+
+auto StagingRing::reserve(
+    VkDeviceSize const size, VkDeviceSize const alignment
+) -> std::optional<Reservation>
+{
+    assert(
+        alignment > 0 && (alignment & (alignment - 1)) == 0
+        && alignment <= MAX_ALIGNMENT
+        && "Staging alignment must be a power of two no greater than "
+           "MAX_ALIGNMENT."
+    );
+
+    VkDeviceSize const ringCapacity{capacity()};
+    if (size == 0 || size > ringCapacity)
+    {
+        return std::nullopt;
+    }
+
+    // The capacity is a multiple of the alignment, so aligned positions are
+    // also aligned offsets.
+    uint64_t start{(m_head + alignment - 1) & ~(alignment - 1)};
+    if (start % ringCapacity + size > ringCapacity)
+    {
+        // Skip the space left before the end, so the reservation is
+        // contiguous.
+        start = (start / ringCapacity + 1) * ringCapacity;
+    }
+
+    if (start + size - m_tail > ringCapacity)
+    {
+        return std::nullopt;
+    }
+
+    m_head = start + size;
+
+    VkDeviceSize const offset{start % ringCapacity};
+    return Reservation{
+        .buffer = m_buffer->buffer(),
+        .offset = offset,
+        .bytes = m_buffer->mappedBytes().subspan(offset, size),
+    };
+}
+
+void StagingRing::commit(uint64_t const releaseValue)
+{
+    if (m_head == m_committedHead)
+    {
+        return;
+    }
+
+    assert(
+        (m_committedRegions.empty()
+         || m_committedRegions.back().releaseValue <= releaseValue)
+        && "Staging ring values must not decrease."
+    );
+
+    m_committedRegions.push_back(CommittedRegion{
+        .end = m_head,
+        .releaseValue = releaseValue,
+    });
+    m_committedHead = m_head;
+}
+
+void StagingRing::cancel() { m_head = m_committedHead; }
+
+void StagingRing::reclaim(uint64_t const completedValue)
+{
+    while (!m_committedRegions.empty()
+           && m_committedRegions.front().releaseValue <= completedValue)
+    {
+        m_tail = m_committedRegions.front().end;
+        m_committedRegions.pop_front();
+    }
+}
+
+auto StagingRing::oldestCommittedValue() const -> std::optional<uint64_t>
+{
+    if (m_committedRegions.empty())
+    {
+        return std::nullopt;
+    }
+
+    return m_committedRegions.front().releaseValue;
+}
+
+auto StagingRing::capacity() const -> VkDeviceSize
+{
+    return m_buffer->bufferSize();
+}
+
+auto StagingRing::bytesInUse() const -> VkDeviceSize
+{
+    return m_head - m_tail;
+}
+} // namespace syzygy
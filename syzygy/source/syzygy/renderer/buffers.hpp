@@ -3,8 +3,11 @@
 #include "syzygy/core/log.hpp"
 #include "syzygy/platform/integer.hpp"
 #include "syzygy/platform/vulkanusage.hpp"
+#include "syzygy/renderer/vertexencoding.hpp"
 #include <cassert>
+#include <deque>
 #include <memory>
+#include <optional>
 #include <span>
 #include <utility>
 
@@ -303,10 +306,19 @@ struct GPUMeshBuffers
     GPUMeshBuffers() = delete;
 
     explicit GPUMeshBuffers(
-        AllocatedBuffer&& indexBuffer, AllocatedBuffer&& vertexBuffer
+        AllocatedBuffer&& indexBuffer,
+        VkIndexType const indexType,
+        AllocatedBuffer&& vertexBuffer,
+        VertexEncoding const& vertexEncoding,
+        AllocatedBuffer&& meshletBuffer,
+        uint32_t const meshletCount
     )
         : m_indexBuffer(std::move(indexBuffer))
+        , m_indexType(indexType)
         , m_vertexBuffer(std::move(vertexBuffer))
+        , m_vertexEncoding(vertexEncoding)
+        , m_meshletBuffer(std::move(meshletBuffer))
+        , m_meshletCount(meshletCount)
     {
     }
 
@@ -325,15 +337,116 @@ struct GPUMeshBuffers
         return m_indexBuffer.deviceAddress();
     }
     auto indexBuffer() -> VkBuffer { return m_indexBuffer.buffer(); }
+    [[nodiscard]] auto indexType() const -> VkIndexType { return m_indexType; }
 
     auto vertexAddress() -> VkDeviceAddress
     {
         return m_vertexBuffer.deviceAddress();
     }
     auto vertexBuffer() -> VkBuffer { return m_vertexBuffer.buffer(); }
+    [[nodiscard]] auto vertexEncoding() const -> VertexEncoding const&
+    {
+        return m_vertexEncoding;
+    }
+
+    // MeshletPacked for every surface, which index into the index buffer.
+    auto meshletAddress() -> VkDeviceAddress
+    {
+        return m_meshletBuffer.deviceAddress();
+    }
+    [[nodiscard]] auto meshletCount() const -> uint32_t
+    {
+        return m_meshletCount;
+    }
 
 private:
     AllocatedBuffer m_indexBuffer;
+    VkIndexType m_indexType;
     AllocatedBuffer m_vertexBuffer;
+    VertexEncoding m_vertexEncoding;
+    AllocatedBuffer m_meshletBuffer;
+    uint32_t m_meshletCount;
+};
+
+// A persistently mapped host buffer that is sub-allocated as a ring, for
+// staging host to device copies without an allocation per copy.
+//
+// Reservations are tagged by StagingRing::commit with a monotonically
+// increasing value, such as a timeline semaphore value signaled once the
+// copies reading them are done. StagingRing::reclaim frees them in order once
+// that value is reached.
+struct StagingRing
+{
+public:
+    StagingRing() = delete;
+
+    StagingRing(StagingRing&& other) noexcept = default;
+    auto operator=(StagingRing&& other) noexcept -> StagingRing& = default;
+
+    StagingRing(StagingRing const& other) = delete;
+    auto operator=(StagingRing const& other) -> StagingRing& = delete;
+
+    ~StagingRing() noexcept = default;
+
+    // The capacity is rounded up to a multiple of MAX_ALIGNMENT.
+    static auto allocate(
+        VkDevice device, VmaAllocator allocator, VkDeviceSize capacity
+    ) -> std::optional<StagingRing>;
+
+    static VkDeviceSize constexpr MAX_ALIGNMENT{256};
+
+    struct Reservation
+    {
+        VkBuffer buffer{VK_NULL_HANDLE};
+        VkDeviceSize offset{0};
+        std::span<uint8_t> bytes{};
+    };
+
+    // The alignment must be a power of two, no greater than MAX_ALIGNMENT.
+    // Reservations are contiguous. Returns std::nullopt if there is not
+    // enough free space, until older reservations are reclaimed.
+    auto reserve(VkDeviceSize size, VkDeviceSize alignment)
+        -> std::optional<Reservation>;
+
+    // Tags every reservation since the last commit with releaseValue. The
+    // value must be no less than any previously committed value.
+    void commit(uint64_t releaseValue);
+
+    // Frees every reservation since the last commit, such as when the copies
+    // that would read them failed to submit.
+    void cancel();
+
+    // Frees committed reservations whose value is at most completedValue.
+    void reclaim(uint64_t completedValue);
+
+    // The value of the oldest committed reservation that is not yet freed.
+    [[nodiscard]] auto oldestCommittedValue() const -> std::optional<uint64_t>;
+
+    [[nodiscard]] auto capacity() const -> VkDeviceSize;
+
+    // Includes padding lost to alignment and wrapping.
+    [[nodiscard]] auto bytesInUse() const -> VkDeviceSize;
+
+private:
+    explicit StagingRing(std::unique_ptr<AllocatedBuffer>&& buffer)
+        : m_buffer{std::move(buffer)}
+    {
+    }
+
+    struct CommittedRegion
+    {
+        uint64_t end{0};
+        uint64_t releaseValue{0};
+    };
+
+    std::unique_ptr<AllocatedBuffer> m_buffer;
+
+    // Positions increase monotonically and are taken modulo the capacity to
+    // get offsets into the buffer. Bytes in [m_tail, m_head) are in use.
+    uint64_t m_tail{0};
+    uint64_t m_committedHead{0};
+    uint64_t m_head{0};
+
+    std::deque<CommittedRegion> m_committedRegions{};
 };
-} // namespace syzygy
\ No newline at end of file
+} // namespace syzygy
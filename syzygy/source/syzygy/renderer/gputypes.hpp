@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <glm/mat4x4.hpp>
 #include <glm/vec4.hpp>
 
@@ -124,4 +125,73 @@ struct VertexPacked
 };
 // NOLINTNEXTLINE(readability-magic-numbers)
 static_assert(sizeof(VertexPacked) == 48ULL);
+
+// VertexPacked with a 16-bit snorm octahedral normal, half-precision UVs, and
+// unorm8 color.
+struct VertexCompactPacked
+{
+    glm::vec3 position;
+    uint32_t normalOctahedral;
+
+    uint32_t uv;
+    uint32_t color;
+};
+// NOLINTNEXTLINE(readability-magic-numbers)
+static_assert(sizeof(VertexCompactPacked) == 24ULL);
+
+// VertexCompactPacked with each position component quantized to unorm16
+// against the mesh's bounds. To fit, the normal drops to 8-bit snorm
+// octahedral, in the high half of positionZNormal.
+struct VertexQuantizedPacked
+{
+    uint32_t positionXY;
+    uint32_t positionZNormal;
+    uint32_t uv;
+    uint32_t color;
+};
+// NOLINTNEXTLINE(readability-magic-numbers)
+static_assert(sizeof(VertexQuantizedPacked) == 16ULL);
+
+// A run of a surface's triangles, bounded in mesh space for culling.
+struct MeshletPacked
+{
+    // xyz is the center and w the radius.
+    glm::vec4 boundingSphere;
+
+    // Every triangle's front face normal lies in a cone around the unit axis
+    // xyz. All of them face away from a viewer looking along direction v when
+    // dot(v, axis) >= w. w is greater than 1 when the normals are too spread
+    // out for this to happen.
+    glm::vec4 coneAxisCutoff;
+
+    uint32_t firstIndex;
+    uint32_t indexCount;
+
+    // NOLINTNEXTLINE(modernize-avoid-c-arrays, readability-magic-numbers)
+    uint8_t padding0[8]{};
+};
+// NOLINTNEXTLINE(readability-magic-numbers)
+static_assert(sizeof(MeshletPacked) == 48ULL);
+
+// A view that meshlets are culled against, such as a camera or shadow map.
+struct MeshletCullViewPacked
+{
+    // Normals point inward, so a point p is inside when dot(xyz, p) + w >= 0
+    // for every plane.
+    std::array<glm::vec4, 6> frustumPlanes;
+
+    // For perspective views xyz is the eye's position and w is 1. For
+    // orthographic views xyz is the view direction and w is 0.
+    glm::vec4 eye;
+
+    // Meshlets are culled when they entirely face away from the eye if this is
+    // positive, or entirely face toward it if negative. 0 disables culling by
+    // facing.
+    float facingCull;
+
+    // NOLINTNEXTLINE(modernize-avoid-c-arrays, readability-magic-numbers)
+    uint8_t padding0[12]{};
+};
+// NOLINTNEXTLINE(readability-magic-numbers)
+static_assert(sizeof(MeshletCullViewPacked) == 128ULL);
 } // namespace syzygy
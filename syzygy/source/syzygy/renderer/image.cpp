@@ -3,15 +3,20 @@
 #include "syzygy/core/log.hpp"
 #include "syzygy/platform/vulkanmacros.hpp"
 #include "syzygy/renderer/imageoperations.hpp"
+#include "syzygy/renderer/vulkanstructs.hpp"
+#include <algorithm>
 #include <spdlog/fmt/bundled/core.h>
 #include <spdlog/fmt/bundled/format.h>
 #include <utility>
+#include <vector>
 
 namespace syzygy
 {
 Image::Image(Image&& other) noexcept
 {
     m_memory = std::exchange(other.m_memory, ImageMemory{});
+    m_recordedLayout =
+        std::exchange(other.m_recordedLayout, VK_IMAGE_LAYOUT_UNDEFINED);
 }
 
 Image::~Image() { destroy(); }
@@ -83,8 +88,8 @@ auto Image::allocate(
         .format = parameters.format,
         .extent = extent3D,
 
-        .mipLevels = 1,
-        .arrayLayers = 1,
+        .mipLevels = parameters.mipLevels,
+        .arrayLayers = parameters.arrayLayers,
 
         .samples = VK_SAMPLE_COUNT_1_BIT,
 
@@ -158,6 +163,16 @@ auto Image::format() const -> VkFormat
     return m_memory.imageCreateInfo.format;
 }
 
+auto Image::mipLevels() const -> uint32_t
+{
+    return m_memory.imageCreateInfo.mipLevels;
+}
+
+auto Image::arrayLayers() const -> uint32_t
+{
+    return m_memory.imageCreateInfo.arrayLayers;
+}
+
 // NOLINTNEXTLINE(readability-make-member-function-const)
 auto Image::image() -> VkImage { return m_memory.image; }
 
@@ -188,6 +203,77 @@ void Image::recordTransitionBarriered(
     m_recordedLayout = dst;
 }
 
+void Image::setExpectedLayout(VkImageLayout const layout)
+{
+    m_recordedLayout = layout;
+}
+
+void Image::recordCopyFromBuffer(
+    VkCommandBuffer const cmd,
+    VkBuffer const src,
+    VkDeviceSize const srcOffset,
+    VkImageAspectFlags const aspectMask
+)
+{
+    VkBufferImageCopy const copyRegion{
+        .bufferOffset = srcOffset,
+        .bufferRowLength = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource = imageSubresourceLayers(aspectMask),
+        .imageOffset = VkOffset3D{.x = 0, .y = 0, .z = 0},
+        .imageExtent = extent3D(),
+    };
+
+    vkCmdCopyBufferToImage(
+        cmd,
+        src,
+        m_memory.image,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1,
+        &copyRegion
+    );
+}
+
+void Image::recordCopyFromBuffer(
+    VkCommandBuffer const cmd,
+    VkBuffer const src,
+    std::span<VkDeviceSize const> const mipOffsets,
+    VkImageAspectFlags const aspectMask
+)
+{
+    std::vector<VkBufferImageCopy> copyRegions{};
+    copyRegions.reserve(mipOffsets.size());
+
+    VkExtent3D const baseExtent{extent3D()};
+    for (uint32_t mipLevel{0}; mipLevel < mipOffsets.size(); mipLevel++)
+    {
+        copyRegions.push_back(VkBufferImageCopy{
+            .bufferOffset = mipOffsets[mipLevel],
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource = imageSubresourceLayers(
+                aspectMask, mipLevel, 0, arrayLayers()
+            ),
+            .imageOffset = VkOffset3D{.x = 0, .y = 0, .z = 0},
+            .imageExtent =
+                VkExtent3D{
+                    .width = std::max(baseExtent.width >> mipLevel, 1U),
+                    .height = std::max(baseExtent.height >> mipLevel, 1U),
+                    .depth = 1,
+                },
+        });
+    }
+
+    vkCmdCopyBufferToImage(
+        cmd,
+        src,
+        m_memory.image,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        static_cast<uint32_t>(copyRegions.size()),
+        copyRegions.data()
+    );
+}
+
 void Image::recordCopyEntire(
     VkCommandBuffer const cmd,
     Image& src,
@@ -1,8 +1,10 @@
 #pragma once
 
+#include "syzygy/platform/integer.hpp"
 #include "syzygy/platform/vulkanusage.hpp"
 #include <memory>
 #include <optional>
+#include <span>
 
 namespace syzygy
 {
@@ -22,6 +24,8 @@ struct ImageAllocationParameters
 {
     VkExtent2D extent{};
     VkFormat format{VK_FORMAT_UNDEFINED};
+    uint32_t mipLevels{1};
+    uint32_t arrayLayers{1};
     VkImageUsageFlags usageFlags{0};
     VkImageLayout initialLayout{VK_IMAGE_LAYOUT_UNDEFINED};
     VkImageTiling tiling{VK_IMAGE_TILING_OPTIMAL};
@@ -55,6 +59,8 @@ public:
 
     [[nodiscard]] auto aspectRatio() const -> std::optional<double>;
     [[nodiscard]] auto format() const -> VkFormat;
+    [[nodiscard]] auto mipLevels() const -> uint32_t;
+    [[nodiscard]] auto arrayLayers() const -> uint32_t;
 
     // WARNING: Do not destroy this image. Be careful of implicit layout
     // transitions, which may break the guarantee of Image::expectedLayout.
@@ -66,6 +72,29 @@ public:
         VkCommandBuffer, VkImageLayout dst, VkImageAspectFlags
     );
 
+    // For transitions that were recorded externally, such as alongside a queue
+    // family ownership transfer.
+    void setExpectedLayout(VkImageLayout);
+
+    // Assumes the image is in TRANSFER_DST_OPTIMAL. Copies the entire image
+    // from tightly packed texels starting at srcOffset.
+    void recordCopyFromBuffer(
+        VkCommandBuffer,
+        VkBuffer src,
+        VkDeviceSize srcOffset,
+        VkImageAspectFlags
+    );
+
+    // Assumes the image is in TRANSFER_DST_OPTIMAL. Copies one mip level per
+    // offset, starting from level 0, from tightly packed texels. Each level
+    // holds every array layer in turn.
+    void recordCopyFromBuffer(
+        VkCommandBuffer,
+        VkBuffer src,
+        std::span<VkDeviceSize const> mipOffsets,
+        VkImageAspectFlags
+    );
+
     // Assumes images are in TRANSFER_[DST/SRC]_OPTIMAL.
     static void recordCopyEntire(
         VkCommandBuffer, Image& src, Image& dst, VkImageAspectFlags
@@ -5,14 +5,22 @@
 #include "syzygy/renderer/image.hpp"
 #include <spdlog/fmt/bundled/core.h>
 #include <spdlog/fmt/bundled/format.h>
+#include <atomic>
 #include <utility>
 
+namespace
+{
+// Zero is left unused so default-constructed records never match a view.
+std::atomic<uint64_t> nextImageViewID{1};
+} // namespace
+
 namespace syzygy
 {
 ImageView::ImageView(ImageView&& other) noexcept
 {
     m_image = std::move(other.m_image);
     m_memory = std::exchange(other.m_memory, ImageViewMemory{});
+    m_id = std::exchange(other.m_id, 0);
 }
 
 ImageView::~ImageView() { destroy(); }
@@ -91,6 +99,7 @@ auto ImageView::allocate(
         .viewCreateInfo = imageViewInfo,
         .view = view,
     };
+    finalView.m_id = nextImageViewID.fetch_add(1, std::memory_order_relaxed);
 
     return std::make_unique<ImageView>(std::move(finalView));
 }
@@ -98,6 +107,8 @@ auto ImageView::allocate(
 // NOLINTNEXTLINE(readability-make-member-function-const)
 auto ImageView::view() -> VkImageView { return m_memory.view; }
 
+auto ImageView::id() const -> uint64_t { return m_id; }
+
 auto ImageView::image() -> Image& { return *m_image; }
 
 auto ImageView::image() const -> Image const& { return *m_image; }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "syzygy/platform/integer.hpp"
 #include "syzygy/platform/vulkanusage.hpp"
 #include "syzygy/renderer/image.hpp"
 #include <memory>
@@ -73,6 +74,10 @@ public:
     // WARNING: Do not destroy this image view.
     auto view() -> VkImageView;
 
+    // Unique for the lifetime of the program, unlike the VkImageView handle
+    // which the driver may hand out again once this view is destroyed.
+    [[nodiscard]] auto id() const -> uint64_t;
+
     auto image() -> Image&;
     [[nodiscard]] auto image() const -> Image const&;
 
@@ -86,5 +91,6 @@ private:
     // shared_ptr, or we make a new image view class.
     std::unique_ptr<Image> m_image{};
     ImageViewMemory m_memory{};
+    uint64_t m_id{0};
 };
 } // namespace syzygy
\ No newline at end of file
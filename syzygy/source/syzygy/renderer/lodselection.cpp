@@ -0,0 +1,155 @@
+#include "lodselection.hpp"
+
+#include "syzygy/assets/assets.hpp"
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/renderer/buffers.hpp"
+#include "syzygy/renderer/gputypes.hpp"
+#include "syzygy/renderer/pipelines.hpp"
+#include "syzygy/renderer/scene.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/geometric.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <limits>
+#include <span>
+
+namespace
+{
+size_t constexpr TRIANGLE_VERTICES{3};
+
+auto countTriangles(std::span<syzygy::GeometrySurface const> const surfaces)
+    -> size_t
+{
+    size_t triangles{0};
+    for (syzygy::GeometrySurface const& surface : surfaces)
+    {
+        triangles += surface.indexCount / TRIANGLE_VERTICES;
+    }
+    return triangles;
+}
+
+// How many pixels a unit of length in the mesh's space covers, at most, across
+// the instances.
+auto pixelsPerMeshUnit(
+    syzygy::CameraPacked const& camera,
+    float const viewportHeight,
+    syzygy::AABB const& meshBounds,
+    std::span<glm::mat4x4 const> const models
+) -> float
+{
+    // Only perspective projections write the depth into w.
+    bool const orthographic{camera.projection[3][3] != 0.0F};
+
+    // Per unit of depth for perspective projections.
+    float const pixelsPerViewUnit{
+        std::abs(camera.projection[1][1]) * viewportHeight * 0.5F
+    };
+    glm::vec3 const eye{camera.position};
+    float const meshRadius{glm::length(meshBounds.halfExtent)};
+
+    float maximumPixels{0.0F};
+    for (glm::mat4x4 const& model : models)
+    {
+        float const scale{std::max({
+            glm::length(glm::vec3{model[0]}),
+            glm::length(glm::vec3{model[1]}),
+            glm::length(glm::vec3{model[2]}),
+        })};
+
+        if (orthographic)
+        {
+            maximumPixels = std::max(maximumPixels, scale * pixelsPerViewUnit);
+            continue;
+        }
+
+        glm::vec3 const center{model * glm::vec4{meshBounds.center, 1.0F}};
+        float const distance{
+            glm::length(center - eye) - meshRadius * scale
+        };
+        if (distance <= std::numeric_limits<float>::epsilon())
+        {
+            // The camera is within the bounds, so nothing can be coarsened.
+            return std::numeric_limits<float>::max();
+        }
+
+        maximumPixels =
+            std::max(maximumPixels, scale * pixelsPerViewUnit / distance);
+    }
+
+    return maximumPixels;
+}
+} // namespace
+
+namespace syzygy
+{
+void LodSelection::select(
+    CameraPacked const& camera,
+    float const viewportHeight,
+    float const pixelErrorThreshold,
+    std::span<MeshInstanced const> const geometry,
+    std::span<RenderOverride> const renderOverrides
+)
+{
+    m_levels.resize(geometry.size(), 0);
+    m_statistics = LodStatistics{};
+
+    for (size_t index{0};
+         index < std::min(geometry.size(), renderOverrides.size());
+         index++)
+    {
+        MeshInstanced const& instance{geometry[index]};
+        RenderOverride& renderOverride{renderOverrides[index]};
+        if (!renderOverride.render || !instance.getMesh().has_value())
+        {
+            continue;
+        }
+
+        Mesh const& mesh{*instance.getMesh().value().get().data};
+        std::span<glm::mat4x4 const> const models{
+            instance.models->readValidStaged()
+        };
+
+        float const pixelsPerUnit{
+            pixelsPerMeshUnit(camera, viewportHeight, mesh.vertexBounds, models)
+        };
+        auto const pixelError{[&](size_t const level)
+        {
+            return level == 0 ? 0.0F
+                              : mesh.lods[level - 1].error * pixelsPerUnit;
+        }};
+
+        size_t level{std::min(m_levels[index], mesh.lods.size())};
+        if (pixelError(level) > pixelErrorThreshold * (1.0F + HYSTERESIS))
+        {
+            while (level > 0 && pixelError(level) > pixelErrorThreshold)
+            {
+                level--;
+            }
+        }
+        while (level < mesh.lods.size()
+               && pixelError(level + 1)
+                      <= pixelErrorThreshold * (1.0F - HYSTERESIS))
+        {
+            level++;
+        }
+
+        m_levels[index] = level;
+        renderOverride.lod = static_cast<uint32_t>(level);
+
+        m_statistics.trianglesDrawn +=
+            countTriangles(lodSurfaces(mesh, level)) * models.size();
+        m_statistics.trianglesFullDetail +=
+            countTriangles(mesh.surfaces) * models.size();
+    }
+}
+
+void LodSelection::reset()
+{
+    m_levels.clear();
+    m_statistics = LodStatistics{};
+}
+
+auto LodSelection::statistics() const -> LodStatistics { return m_statistics; }
+} // namespace syzygy
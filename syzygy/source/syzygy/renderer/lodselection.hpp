@@ -0,0 +1,60 @@
+#pragma once
+
+#include "syzygy/platform/integer.hpp"
+#include <span>
+#include <vector>
+
+namespace syzygy
+{
+struct CameraPacked;
+struct MeshInstanced;
+struct RenderOverride;
+} // namespace syzygy
+
+namespace syzygy
+{
+// Triangles drawn from the selected levels of detail, against how many would be
+// drawn with every mesh in full.
+struct LodStatistics
+{
+    size_t trianglesDrawn{0};
+    size_t trianglesFullDetail{0};
+};
+
+// Chooses a level of detail for each batch of instanced geometry. A batch
+// draws the coarsest level whose error, projected from the mesh's bounds,
+// covers at most a threshold of pixels. Every instance in a batch draws the
+// same level, chosen for the instance that needs the most detail.
+//
+// Levels are kept between frames, and only change once the projected error
+// crosses the threshold by some margin, so that geometry near the threshold
+// does not pop between levels.
+struct LodSelection
+{
+public:
+    // The margin, as a fraction of the threshold.
+    static float constexpr HYSTERESIS{0.25F};
+
+    // Writes the selected levels into the render overrides, which are
+    // parallel to geometry. Geometry that is not rendered is skipped, and keeps
+    // its level for when it is rendered again.
+    void select(
+        CameraPacked const& camera,
+        float viewportHeight,
+        float pixelErrorThreshold,
+        std::span<MeshInstanced const> geometry,
+        std::span<RenderOverride> renderOverrides
+    );
+
+    // Forgets every level and the statistics, for when nothing is selected.
+    void reset();
+
+    // Of the geometry in the last selection.
+    [[nodiscard]] auto statistics() const -> LodStatistics;
+
+private:
+    // Indexed like the geometry of the last selection.
+    std::vector<size_t> m_levels{};
+    LodStatistics m_statistics{};
+};
+} // namespace syzygy
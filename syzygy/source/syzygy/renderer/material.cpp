@@ -1,10 +1,13 @@
 #include "material.hpp"
 
+#include "syzygy/assets/assetpool.hpp"
+#include "syzygy/assets/textureresidency.hpp"
 #include "syzygy/core/log.hpp"
 #include "syzygy/platform/vulkanmacros.hpp"
 #include "syzygy/renderer/descriptors.hpp"
 #include "syzygy/renderer/imageview.hpp"
 #include "syzygy/renderer/vulkanstructs.hpp"
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <memory>
@@ -19,6 +22,8 @@ syzygy::MaterialDescriptors::MaterialDescriptors(MaterialDescriptors&& other
     m_sampler = std::exchange(other.m_sampler, VK_NULL_HANDLE);
     m_colorLayout = std::exchange(other.m_colorLayout, VK_NULL_HANDLE);
     m_colorSet = std::exchange(other.m_colorSet, VK_NULL_HANDLE);
+    m_retiredSets = std::exchange(other.m_retiredSets, {});
+    m_writtenViews = std::exchange(other.m_writtenViews, {});
 }
 
 syzygy::MaterialDescriptors::~MaterialDescriptors() { destroy(); }
@@ -53,6 +58,8 @@ void syzygy::MaterialDescriptors::destroy()
     }
 
     m_colorSet = VK_NULL_HANDLE;
+    m_retiredSets.clear();
+    m_writtenViews = {};
 
     m_device = VK_NULL_HANDLE;
 }
@@ -112,12 +119,15 @@ auto syzygy::MaterialDescriptors::create(
     }
 
     {
-        VkSamplerCreateInfo const samplerInfo{samplerCreateInfo(
+        VkSamplerCreateInfo samplerInfo{samplerCreateInfo(
             static_cast<VkFlags>(0),
             VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK,
             VK_FILTER_LINEAR,
             VK_SAMPLER_ADDRESS_MODE_REPEAT
         )};
+        // Material textures have full mip chains, which are all sampled
+        // trilinearly.
+        samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
 
         SZG_TRY_VK(
             vkCreateSampler(
@@ -135,34 +145,61 @@ auto syzygy::MaterialDescriptors::create(
     return descriptorsResult;
 }
 
-void syzygy::MaterialDescriptors::write(MaterialData const& material) const
+void syzygy::MaterialDescriptors::write(
+    DescriptorAllocator& descriptorAllocator,
+    MaterialData const& material,
+    uint64_t const frame
+)
 {
     // TODO: Figure out better fallbacks/defaults for when assets are
     // unexpectadly deleted.
-    assert(
-        !material.color.expired() && !material.normal.expired()
-        && !material.ORM.expired()
-    );
+    Asset<ImageView> const* const color{material.color.get()};
+    Asset<ImageView> const* const normal{material.normal.get()};
+    Asset<ImageView> const* const ORM{material.ORM.get()};
+    assert(color != nullptr && normal != nullptr && ORM != nullptr);
 
     VkDescriptorImageInfo const colorImageInfo{
         .sampler = m_sampler,
-        .imageView = material.color.lock()->data->view(),
+        .imageView = color->data->view(),
         .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
     };
     VkDescriptorImageInfo const normalMapInfo{
         .sampler = m_sampler,
-        .imageView = material.normal.lock()->data->view(),
+        .imageView = normal->data->view(),
         .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
     };
     VkDescriptorImageInfo const ormMapInfo{
         .sampler = m_sampler,
-        .imageView = material.ORM.lock()->data->view(),
+        .imageView = ORM->data->view(),
         .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
     };
     std::array<VkDescriptorImageInfo, 3> imageInfos{
         colorImageInfo, normalMapInfo, ormMapInfo
     };
 
+    // A set that was never written has never been bound either, so it is
+    // safe to write in place.
+    if (m_writtenViews != std::array<uint64_t, 3>{})
+    {
+        m_retiredSets.push_back(RetiredSet{.set = m_colorSet, .frame = frame});
+
+        auto const reusable{std::find_if(
+            m_retiredSets.begin(),
+            m_retiredSets.end(),
+            [&](RetiredSet const& retired)
+        { return retired.frame + TextureResidency::RETIRE_FRAMES <= frame; }
+        )};
+        if (reusable != m_retiredSets.end())
+        {
+            m_colorSet = reusable->set;
+            m_retiredSets.erase(reusable);
+        }
+        else
+        {
+            m_colorSet = descriptorAllocator.allocate(m_device, m_colorLayout);
+        }
+    }
+
     VkWriteDescriptorSet const writeInfo{
         .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
         .pNext = nullptr,
@@ -177,6 +214,30 @@ void syzygy::MaterialDescriptors::write(MaterialData const& material) const
     };
 
     vkUpdateDescriptorSets(m_device, 1, &writeInfo, 0, nullptr);
+
+    m_writtenViews = {
+        color->data->id(),
+        normal->data->id(),
+        ORM->data->id(),
+    };
+}
+
+auto syzygy::MaterialDescriptors::isCurrent(MaterialData const& material) const
+    -> bool
+{
+    auto const viewOf{[](PooledAssetPtr<ImageView> const& texture) -> uint64_t
+    {
+        Asset<ImageView> const* const asset{texture.get()};
+        if (asset == nullptr || asset->data == nullptr)
+        {
+            return 0;
+        }
+        return asset->data->id();
+    }};
+
+    return m_writtenViews[0] == viewOf(material.color)
+        && m_writtenViews[1] == viewOf(material.normal)
+        && m_writtenViews[2] == viewOf(material.ORM);
 }
 
 void syzygy::MaterialDescriptors::bind(
@@ -3,7 +3,9 @@
 #include "syzygy/assets/assetstypes.hpp"
 #include "syzygy/platform/integer.hpp"
 #include "syzygy/platform/vulkanusage.hpp"
+#include <array>
 #include <optional>
+#include <vector>
 
 namespace syzygy
 {
@@ -13,12 +15,13 @@ struct ImageView;
 
 namespace syzygy
 {
+// Textures are held by handle, since materials are resolved every frame.
 struct MaterialData
 {
     // Occlusion Roughness Metallic texture, stored RGB in that respective order
-    AssetPtr<ImageView> ORM{};
-    AssetPtr<ImageView> normal{};
-    AssetPtr<ImageView> color{};
+    PooledAssetPtr<ImageView> ORM{};
+    PooledAssetPtr<ImageView> normal{};
+    PooledAssetPtr<ImageView> color{};
 };
 
 struct MaterialDescriptors
@@ -41,7 +44,20 @@ public:
 
     // Public methods go here
 
-    void write(MaterialData const&) const;
+    // The sets are not UPDATE_AFTER_BIND, so one that a frame in flight has
+    // bound cannot be rewritten. Each write instead goes to a different set,
+    // and the replaced set is retired on the same frame count as textures,
+    // see TextureResidency::RETIRE_FRAMES. Retired sets are reused once old
+    // enough, otherwise more are allocated.
+    void write(DescriptorAllocator&, MaterialData const&, uint64_t frame);
+
+    // Whether the image views last written match those currently held by the
+    // material's assets. Asset data can be swapped in place, e.g. when a
+    // placeholder texture finishes loading, which leaves the set stale. Views
+    // are compared by ImageView::id, since VkImageView handles may be reused.
+    [[nodiscard]] auto isCurrent(MaterialData const&) const -> bool;
+
+    // Binds the set from the most recent write.
     void bind(VkCommandBuffer, VkPipelineLayout, uint32_t colorSet) const;
 
 private:
@@ -54,5 +70,15 @@ private:
 
     VkDescriptorSetLayout m_colorLayout{VK_NULL_HANDLE};
     VkDescriptorSet m_colorSet{VK_NULL_HANDLE};
+
+    struct RetiredSet
+    {
+        VkDescriptorSet set{VK_NULL_HANDLE};
+        uint64_t frame{0};
+    };
+    std::vector<RetiredSet> m_retiredSets{};
+
+    // ImageView::id of color, normal, ORM in binding order
+    std::array<uint64_t, 3> m_writtenViews{};
 };
 } // namespace syzygy
\ No newline at end of file
@@ -8,13 +8,18 @@
 #include "syzygy/renderer/image.hpp"
 #include "syzygy/renderer/imageview.hpp"
 #include "syzygy/renderer/pipelines.hpp"
+#include "syzygy/renderer/pipelines/meshletculling.hpp"
 #include "syzygy/renderer/scene.hpp"
 #include "syzygy/renderer/shaders.hpp"
+#include "syzygy/renderer/surfaceculling.hpp"
+#include "syzygy/renderer/vertexencoding.hpp"
 #include "syzygy/renderer/vulkanstructs.hpp"
 #include <filesystem>
 #include <functional>
 #include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
 #include <memory>
+#include <span>
 #include <spdlog/fmt/bundled/core.h>
 #include <utility>
 
@@ -680,7 +685,10 @@ void OffscreenPassGraphicsPipeline::recordDrawCommands(
     uint32_t const projViewIndex,
     TStagedBuffer<glm::mat4x4> const& projViewMatrices,
     std::span<MeshInstanced const> const geometry,
-    std::span<RenderOverride const> const renderOverrides
+    std::span<RenderOverride const> const renderOverrides,
+    MeshletCullingPass const& meshletCulling,
+    SurfaceCulling const& surfaceCulling,
+    size_t const cullViewIndex
 ) const
 {
     VkAttachmentLoadOp const depthLoadOp{
@@ -746,11 +754,13 @@ void OffscreenPassGraphicsPipeline::recordDrawCommands(
         }
 
         bool render{instance.render};
+        size_t lod{0};
         if (index < renderOverrides.size())
         {
             RenderOverride const& renderOverride{renderOverrides[index]};
 
             render = renderOverride.render;
+            lod = renderOverride.lod;
         }
 
         if (!render || !instance.getMesh().has_value())
@@ -759,16 +769,23 @@ void OffscreenPassGraphicsPipeline::recordDrawCommands(
         }
 
         Mesh const& meshAsset{*instance.getMesh().value().get().data};
+        std::span<GeometrySurface const> const surfaces{
+            lodSurfaces(meshAsset, lod)
+        };
         TStagedBuffer<glm::mat4x4> const& models{*instance.models};
 
         GPUMeshBuffers& meshBuffers{*meshAsset.meshBuffers};
 
         { // Vertex push constant
+            VertexEncoding const& encoding{meshBuffers.vertexEncoding()};
             VertexPushConstant const vertexPushConstant{
                 .vertexBufferAddress = meshBuffers.vertexAddress(),
                 .modelBufferAddress = models.deviceAddress(),
                 .projViewBufferAddress = projViewMatrices.deviceAddress(),
                 .projViewIndex = projViewIndex,
+                .vertexFormat = static_cast<uint32_t>(encoding.format),
+                .positionOffset = glm::vec4{encoding.positionOffset, 0.0F},
+                .positionScale = glm::vec4{encoding.positionScale, 0.0F},
             };
             vkCmdPushConstants(
                 cmd,
@@ -780,24 +797,28 @@ void OffscreenPassGraphicsPipeline::recordDrawCommands(
             );
         }
 
-        for (size_t surfaceIndex{0}; surfaceIndex < meshAsset.surfaces.size();
+        for (size_t surfaceIndex{0}; surfaceIndex < surfaces.size();
              surfaceIndex++)
         {
-            GeometrySurface const& drawnSurface{meshAsset.surfaces[surfaceIndex]
-            };
+            if (!surfaceCulling.visible(cullViewIndex, index, surfaceIndex))
+            {
+                continue;
+            }
+
+            GeometrySurface const& drawnSurface{surfaces[surfaceIndex]};
 
             // Bind the entire index buffer of the mesh, but only draw a
             // single surface.
             vkCmdBindIndexBuffer(
-                cmd, meshBuffers.indexBuffer(), 0, VK_INDEX_TYPE_UINT32
+                cmd, meshBuffers.indexBuffer(), 0, meshBuffers.indexType()
             );
-            vkCmdDrawIndexed(
+            meshletCulling.recordDrawSurface(
                 cmd,
-                drawnSurface.indexCount,
-                models.deviceSize(),
-                drawnSurface.firstIndex,
-                0,
-                0
+                cullViewIndex,
+                index,
+                surfaceIndex,
+                drawnSurface,
+                static_cast<uint32_t>(models.deviceSize())
             );
         }
     }
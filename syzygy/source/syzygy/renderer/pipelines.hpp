@@ -5,6 +5,7 @@
 #include "syzygy/platform/vulkanusage.hpp"
 #include "syzygy/renderer/shaders.hpp"
 #include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
 #include <optional>
 #include <set>
 #include <span>
@@ -17,6 +18,8 @@ struct CameraPacked;
 struct ImageView;
 template <typename T> struct TStagedBuffer;
 struct MeshInstanced;
+struct MeshletCullingPass;
+struct SurfaceCulling;
 struct VertexPacked;
 } // namespace syzygy
 
@@ -34,6 +37,8 @@ auto computeDispatchCount(uint32_t invocations, uint32_t workgroupSize)
 struct RenderOverride
 {
     bool render{false};
+    // The level of detail to draw, see lodSurfaces.
+    uint32_t lod{0};
 };
 
 struct DrawResultsGraphics
@@ -129,7 +134,10 @@ public:
         uint32_t projViewIndex,
         TStagedBuffer<glm::mat4x4> const& projViewMatrices,
         std::span<syzygy::MeshInstanced const> geometry,
-        std::span<RenderOverride const> renderOverrides
+        std::span<RenderOverride const> renderOverrides,
+        MeshletCullingPass const& meshletCulling,
+        SurfaceCulling const& surfaceCulling,
+        size_t cullViewIndex
     ) const;
 
     void cleanup(VkDevice device);
@@ -147,7 +155,12 @@ private:
 
         VkDeviceAddress projViewBufferAddress{};
         uint32_t projViewIndex{0};
-        uint8_t padding0[4]{}; // NOLINT(modernize-avoid-c-arrays)
+        // See VertexEncoding. Only xyz of the position terms are used.
+        uint32_t vertexFormat{0};
+
+        glm::vec4 positionOffset{0.0F};
+
+        glm::vec4 positionScale{1.0F};
     };
 
 public:
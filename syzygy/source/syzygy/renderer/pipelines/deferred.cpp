@@ -13,13 +13,17 @@
 #include "syzygy/renderer/rendercommands.hpp"
 #include "syzygy/renderer/scene.hpp"
 #include "syzygy/renderer/scenetexture.hpp"
+#include "syzygy/renderer/vertexencoding.hpp"
 #include "syzygy/renderer/vulkanstructs.hpp"
 #include <array>
 #include <filesystem>
 #include <functional>
 #include <glm/mat4x4.hpp>
 #include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
 #include <optional>
+#include <span>
 #include <spdlog/fmt/bundled/core.h>
 #include <string>
 #include <utility>
@@ -176,6 +180,8 @@ DeferredShadingPipeline::DeferredShadingPipeline(
             );
     }
 
+    m_meshletCulling = std::make_unique<MeshletCullingPass>(device, allocator);
+
     uint32_t constexpr SHADOWMAP_SIZE{8192};
     size_t constexpr SHADOWMAP_COUNT{10};
 
@@ -402,13 +408,15 @@ auto collectGeometryCullFlags(
 
     for (syzygy::MeshInstanced const& instance : meshes)
     {
+        std::optional<syzygy::AssetRef<syzygy::Mesh>> const mesh{
+            instance.getMesh()
+        };
         syzygy::RenderOverride const override{
-            .render =
-                instance.render && instance.getMesh().has_value()
-                && instance.getMesh().value().get().data != nullptr
-                && instance.getMesh().value().get().data->meshBuffers != nullptr
-                && instance.models != nullptr
-                && instance.modelInverseTransposes != nullptr
+            .render = instance.render && mesh.has_value()
+                   && mesh.value().get().data != nullptr
+                   && mesh.value().get().data->meshBuffers != nullptr
+                   && instance.models != nullptr
+                   && instance.modelInverseTransposes != nullptr
         };
 
         renderOverrides.push_back(override);
@@ -477,18 +485,89 @@ void DeferredShadingPipeline::recordDrawCommands(
         collectGeometryCullFlags(cmd, GBUFFER_ACCESS_STAGES, sceneGeometry)
     };
 
-    { // Shadow maps
-        m_shadowPassArray.recordInitialize(
-            cmd,
-            m_configuration.shadowPassParameters,
-            directionalLights.readValidStaged(),
-            m_spotLights->readValidStaged()
+    std::span<CameraPacked const> const stagedCameras{
+        cameras.readValidStaged()
+    };
+
+    // Levels are selected for the camera, and reused for the shadow maps.
+    if (m_configuration.lodSelection && viewCameraIndex < stagedCameras.size())
+    {
+        m_lodSelection.select(
+            stagedCameras[viewCameraIndex],
+            static_cast<float>(drawRect.extent.height),
+            m_configuration.lodPixelError,
+            sceneGeometry,
+            renderOverrides
         );
+    }
+    else
+    {
+        m_lodSelection.reset();
+    }
+
+    m_shadowPassArray.recordInitialize(
+        cmd,
+        m_configuration.shadowPassParameters,
+        directionalLights.readValidStaged(),
+        m_spotLights->readValidStaged()
+    );
+
+    // The camera is the first view, followed by each shadow map.
+    size_t constexpr CAMERA_CULL_VIEW_INDEX{0};
+    size_t constexpr FIRST_SHADOW_CULL_VIEW_INDEX{1};
+
+    std::vector<MeshletCullingPass::View> cullViews{};
+    if (viewCameraIndex < stagedCameras.size())
+    {
+        CameraPacked const& camera{stagedCameras[viewCameraIndex]};
+
+        // Only perspective projections write the depth into w.
+        bool const orthographic{camera.projection[3][3] != 0.0F};
+
+        cullViews.push_back(MeshletCullingPass::makeView(
+            camera.projection * camera.view,
+            orthographic ? glm::vec4{glm::vec3{camera.forwardWorld}, 0.0F}
+                         : glm::vec4{glm::vec3{camera.position}, 1.0F},
+            1.0F,
+            false
+        ));
+        std::span<MeshletCullingPass::View const> const shadowCullViews{
+            m_shadowPassArray.cullViews()
+        };
+        cullViews.insert(
+            cullViews.end(), shadowCullViews.begin(), shadowCullViews.end()
+        );
+    }
+
+    // Before meshlet culling, which skips the surfaces culled here.
+    if (m_configuration.surfaceCulling && !cullViews.empty())
+    {
+        m_surfaceCulling.cull(cullViews, sceneGeometry, renderOverrides);
+    }
+    else
+    {
+        m_surfaceCulling.reset();
+    }
 
-        m_shadowPassArray.recordDrawCommands(
-            cmd, sceneGeometry, renderOverrides
+    if (m_configuration.meshletCulling && !cullViews.empty())
+    {
+        m_meshletCulling->recordCullCommands(
+            cmd, cullViews, sceneGeometry, renderOverrides, m_surfaceCulling
         );
     }
+    else
+    {
+        m_meshletCulling->reset();
+    }
+
+    m_shadowPassArray.recordDrawCommands(
+        cmd,
+        sceneGeometry,
+        renderOverrides,
+        *m_meshletCulling,
+        m_surfaceCulling,
+        FIRST_SHADOW_CULL_VIEW_INDEX
+    );
 
     { // Prepare GBuffer resources
         m_gBuffer.recordTransitionImages(
@@ -626,11 +705,13 @@ void DeferredShadingPipeline::recordDrawCommands(
             MeshInstanced const& instance{sceneGeometry[index]};
 
             bool render{instance.render};
+            size_t lod{0};
             if (index < renderOverrides.size())
             {
                 RenderOverride const& renderOverride{renderOverrides[index]};
 
                 render = renderOverride.render;
+                lod = renderOverride.lod;
             }
 
             if (!render || !instance.getMesh().has_value())
@@ -638,6 +719,9 @@ void DeferredShadingPipeline::recordDrawCommands(
                 continue;
             }
             Mesh const& meshAsset{*instance.getMesh().value().get().data};
+            std::span<GeometrySurface const> const surfaces{
+                lodSurfaces(meshAsset, lod)
+            };
 
             TStagedBuffer<glm::mat4x4> const& models{*instance.models};
             TStagedBuffer<glm::mat4x4> const& modelInverseTransposes{
@@ -647,6 +731,7 @@ void DeferredShadingPipeline::recordDrawCommands(
             GPUMeshBuffers& meshBuffers{*meshAsset.meshBuffers};
 
             { // Vertex push constant
+                VertexEncoding const& encoding{meshBuffers.vertexEncoding()};
                 GBufferVertexPushConstant const vertexPushConstant{
                     .vertexBuffer = meshBuffers.vertexAddress(),
                     .modelBuffer = models.deviceAddress(),
@@ -654,6 +739,9 @@ void DeferredShadingPipeline::recordDrawCommands(
                         modelInverseTransposes.deviceAddress(),
                     .cameraBuffer = cameras.deviceAddress(),
                     .cameraIndex = viewCameraIndex,
+                    .vertexFormat = static_cast<uint32_t>(encoding.format),
+                    .positionOffset = glm::vec4{encoding.positionOffset, 0.0F},
+                    .positionScale = glm::vec4{encoding.positionScale, 0.0F},
                 };
                 vkCmdPushConstants(
                     cmd,
@@ -669,14 +757,18 @@ void DeferredShadingPipeline::recordDrawCommands(
                 instance.getMeshDescriptors()
             };
             for (size_t surfaceIndex{0};
-                 surfaceIndex < std::min(
-                     meshAsset.surfaces.size(), surfaceDescriptors.size()
-                 );
+                 surfaceIndex
+                 < std::min(surfaces.size(), surfaceDescriptors.size());
                  surfaceIndex++)
             {
-                GeometrySurface const& drawnSurface{
-                    meshAsset.surfaces[surfaceIndex]
-                };
+                if (!m_surfaceCulling.visible(
+                        CAMERA_CULL_VIEW_INDEX, index, surfaceIndex
+                    ))
+                {
+                    continue;
+                }
+
+                GeometrySurface const& drawnSurface{surfaces[surfaceIndex]};
                 MaterialDescriptors const& descriptors{
                     surfaceDescriptors[surfaceIndex]
                 };
@@ -686,15 +778,18 @@ void DeferredShadingPipeline::recordDrawCommands(
                 // Bind the entire index buffer of the mesh, but only draw a
                 // single surface.
                 vkCmdBindIndexBuffer(
-                    cmd, meshBuffers.indexBuffer(), 0, VK_INDEX_TYPE_UINT32
-                );
-                vkCmdDrawIndexed(
                     cmd,
-                    drawnSurface.indexCount,
-                    models.deviceSize(),
-                    drawnSurface.firstIndex,
+                    meshBuffers.indexBuffer(),
                     0,
-                    0
+                    meshBuffers.indexType()
+                );
+                m_meshletCulling->recordDrawSurface(
+                    cmd,
+                    CAMERA_CULL_VIEW_INDEX,
+                    index,
+                    surfaceIndex,
+                    drawnSurface,
+                    static_cast<uint32_t>(models.deviceSize())
                 );
             }
         }
@@ -798,12 +893,24 @@ auto DeferredShadingPipeline::shadowMaps() -> ShadowPassArray const&
     return m_shadowPassArray;
 }
 
+auto DeferredShadingPipeline::lodStatistics() const -> LodStatistics
+{
+    return m_lodSelection.statistics();
+}
+
+auto DeferredShadingPipeline::surfaceCullingStatistics() const
+    -> SurfaceCullingStatistics
+{
+    return m_surfaceCulling.statistics();
+}
+
 void DeferredShadingPipeline::cleanup(
     VkDevice const device, VmaAllocator const allocator
 )
 {
     m_shadowPassArray.cleanup(device, allocator);
     m_gBuffer.cleanup(device);
+    m_meshletCulling->cleanup(device);
 
     m_spotLights.reset();
 
@@ -5,8 +5,11 @@
 #include "syzygy/renderer/buffers.hpp"
 #include "syzygy/renderer/gbuffer.hpp"
 #include "syzygy/renderer/gputypes.hpp"
+#include "syzygy/renderer/lodselection.hpp"
+#include "syzygy/renderer/pipelines/meshletculling.hpp"
 #include "syzygy/renderer/shaders.hpp"
 #include "syzygy/renderer/shadowpass.hpp"
+#include "syzygy/renderer/surfaceculling.hpp"
 #include <glm/vec2.hpp>
 #include <memory>
 #include <span>
@@ -45,6 +48,9 @@ public:
 
     [[nodiscard]] auto gbuffer() -> GBuffer const&;
     [[nodiscard]] auto shadowMaps() -> ShadowPassArray const&;
+    [[nodiscard]] auto lodStatistics() const -> LodStatistics;
+    [[nodiscard]] auto surfaceCullingStatistics() const
+        -> SurfaceCullingStatistics;
 
     void cleanup(VkDevice device, VmaAllocator allocator);
 
@@ -56,6 +62,12 @@ private:
 
     GBuffer m_gBuffer{};
 
+    std::unique_ptr<MeshletCullingPass> m_meshletCulling{};
+
+    SurfaceCulling m_surfaceCulling{};
+
+    LodSelection m_lodSelection{};
+
     struct GBufferVertexPushConstant
     {
         VkDeviceAddress vertexBuffer{};
@@ -65,9 +77,14 @@ private:
         VkDeviceAddress cameraBuffer{};
 
         uint32_t cameraIndex{0};
-
+        // See VertexEncoding. Only xyz of the position terms are used.
+        uint32_t vertexFormat{0};
         // NOLINTNEXTLINE(modernize-avoid-c-arrays, readability-magic-numbers)
-        uint8_t padding0[12]{};
+        uint8_t padding0[8]{};
+
+        glm::vec4 positionOffset{0.0F};
+
+        glm::vec4 positionScale{1.0F};
     };
 
     ShaderObjectReflected m_gBufferVertexShader{
@@ -109,6 +126,16 @@ public:
     struct Configuration
     {
         ShadowPassParameters shadowPassParameters{};
+        // Cull each surface against each view by its bounds on the host, for
+        // both the GBuffer and the shadow maps.
+        bool surfaceCulling{true};
+        // Cull meshlets against each view on the device before drawing, for
+        // both the GBuffer and the shadow maps.
+        bool meshletCulling{true};
+        // Draw each mesh's coarsest level of detail whose error covers at most
+        // lodPixelError pixels.
+        bool lodSelection{true};
+        float lodPixelError{1.0F};
     };
 
     [[nodiscard]] auto getConfiguration() const -> Configuration;
@@ -0,0 +1,529 @@
+#include "meshletculling.hpp"
+
+#include "syzygy/assets/assets.hpp"
+#include "syzygy/assets/assetstypes.hpp"
+#include "syzygy/core/log.hpp"
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/platform/vulkanmacros.hpp"
+#include "syzygy/renderer/pipelines.hpp"
+#include "syzygy/renderer/scene.hpp"
+#include "syzygy/renderer/surfaceculling.hpp"
+#include <algorithm>
+#include <array>
+#include <glm/geometric.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+#include <limits>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace
+{
+auto createLayout(
+    VkDevice const device,
+    std::span<VkPushConstantRange const> const ranges
+) -> VkPipelineLayout
+{
+    VkPipelineLayoutCreateInfo const layoutCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .pNext = nullptr,
+
+        .flags = 0,
+
+        .setLayoutCount = 0,
+        .pSetLayouts = nullptr,
+
+        .pushConstantRangeCount = static_cast<uint32_t>(ranges.size()),
+        .pPushConstantRanges = ranges.data(),
+    };
+
+    VkPipelineLayout layout{VK_NULL_HANDLE};
+    VkResult const result{
+        vkCreatePipelineLayout(device, &layoutCreateInfo, nullptr, &layout)
+    };
+    if (result != VK_SUCCESS)
+    {
+        SZG_LOG_VK(result, "Creating shader object pipeline layout");
+        return VK_NULL_HANDLE;
+    }
+    return layout;
+}
+
+void recordBufferBarrier(
+    VkCommandBuffer const cmd,
+    VkBuffer const buffer,
+    VkPipelineStageFlags2 const srcStageMask,
+    VkAccessFlags2 const srcAccessMask,
+    VkPipelineStageFlags2 const dstStageMask,
+    VkAccessFlags2 const dstAccessMask
+)
+{
+    VkBufferMemoryBarrier2 const bufferMemoryBarrier{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+        .pNext = nullptr,
+
+        .srcStageMask = srcStageMask,
+        .srcAccessMask = srcAccessMask,
+
+        .dstStageMask = dstStageMask,
+        .dstAccessMask = dstAccessMask,
+
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+
+        .buffer = buffer,
+        .offset = 0,
+        .size = VK_WHOLE_SIZE,
+    };
+
+    VkDependencyInfo const dependency{
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .pNext = nullptr,
+
+        .dependencyFlags = 0,
+
+        .memoryBarrierCount = 0,
+        .pMemoryBarriers = nullptr,
+
+        .bufferMemoryBarrierCount = 1,
+        .pBufferMemoryBarriers = &bufferMemoryBarrier,
+
+        .imageMemoryBarrierCount = 0,
+        .pImageMemoryBarriers = nullptr,
+    };
+
+    vkCmdPipelineBarrier2(cmd, &dependency);
+}
+
+// Gribb and Hartmann, "Fast Extraction of Viewing Frustum Planes from the
+// World-View-Projection Matrix".
+auto extractFrustumPlanes(glm::mat4x4 const& projView)
+    -> std::array<glm::vec4, 6>
+{
+    glm::vec4 const row0{
+        projView[0][0], projView[1][0], projView[2][0], projView[3][0]
+    };
+    glm::vec4 const row1{
+        projView[0][1], projView[1][1], projView[2][1], projView[3][1]
+    };
+    glm::vec4 const row2{
+        projView[0][2], projView[1][2], projView[2][2], projView[3][2]
+    };
+    glm::vec4 const row3{
+        projView[0][3], projView[1][3], projView[2][3], projView[3][3]
+    };
+
+    std::array<glm::vec4, 6> planes{
+        row3 + row0, row3 - row0, row3 + row1, row3 - row1, row2, row3 - row2
+    };
+    for (glm::vec4& plane : planes)
+    {
+        float const length{glm::length(glm::vec3{plane})};
+        if (length <= std::numeric_limits<float>::min())
+        {
+            // Such as the far plane of an infinite projection, which contains
+            // everything.
+            plane = glm::vec4{0.0F, 0.0F, 0.0F, 1.0F};
+            continue;
+        }
+        plane /= length;
+    }
+
+    return planes;
+}
+} // namespace
+
+namespace syzygy
+{
+MeshletCullingPass::MeshletCullingPass(
+    VkDevice const device, VmaAllocator const allocator
+)
+{
+    m_views = std::make_unique<TStagedBuffer<MeshletCullViewPacked>>(
+        TStagedBuffer<MeshletCullViewPacked>::allocate(
+            device, static_cast<VkBufferUsageFlags>(0), allocator, VIEW_CAPACITY
+        )
+    );
+
+    m_drawBuffer =
+        std::make_unique<AllocatedBuffer>(AllocatedBuffer::allocate(
+            device,
+            allocator,
+            DRAW_CAPACITY * sizeof(VkDrawIndexedIndirectCommand),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+                | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
+                | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+            VMA_MEMORY_USAGE_GPU_ONLY,
+            0
+        ));
+    m_countBuffer =
+        std::make_unique<AllocatedBuffer>(AllocatedBuffer::allocate(
+            device,
+            allocator,
+            COUNT_CAPACITY * sizeof(uint32_t),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+                | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
+                | VK_BUFFER_USAGE_TRANSFER_DST_BIT
+                | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+            VMA_MEMORY_USAGE_GPU_ONLY,
+            0
+        ));
+
+    VkPushConstantRange const pushConstantRange{
+        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+        .offset = 0,
+        .size = sizeof(CullPushConstant),
+    };
+
+    if (std::optional<ShaderObjectReflected> shaderResult{loadShaderObject(
+            device,
+            "shaders/culling/meshlets.comp.spv",
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            static_cast<VkFlags>(0),
+            {},
+            pushConstantRange,
+            {}
+        )};
+        shaderResult.has_value())
+    {
+        m_cullShader = std::move(shaderResult).value();
+
+        size_t const loadedPushConstantSize{
+            m_cullShader.reflectionData().defaultEntryPointHasPushConstant()
+                ? m_cullShader.reflectionData()
+                      .defaultPushConstant()
+                      .type.paddedSizeBytes
+                : 0
+        };
+        if (loadedPushConstantSize != sizeof(CullPushConstant))
+        {
+            SZG_WARNING(
+                "Loaded Shader \"{}\" had a push constant of size {}, while "
+                "implementation expects {}.",
+                m_cullShader.name(),
+                loadedPushConstantSize,
+                sizeof(CullPushConstant)
+            );
+        }
+    }
+    else
+    {
+        SZG_ERROR("Failed to load meshlet culling shader object.");
+    }
+
+    std::array<VkPushConstantRange, 1> const pushConstantRanges{
+        pushConstantRange
+    };
+    m_cullLayout = createLayout(device, pushConstantRanges);
+}
+
+auto MeshletCullingPass::makeView(
+    glm::mat4x4 const& projView,
+    glm::vec4 const eye,
+    float const facingCull,
+    bool const shadowCastersOnly
+) -> View
+{
+    return View{
+        .packed =
+            MeshletCullViewPacked{
+                .frustumPlanes = extractFrustumPlanes(projView),
+                .eye = eye,
+                .facingCull = facingCull,
+            },
+        .shadowCastersOnly = shadowCastersOnly,
+    };
+}
+
+void MeshletCullingPass::recordCullCommands(
+    VkCommandBuffer const cmd,
+    std::span<View const> const views,
+    std::span<MeshInstanced const> const geometry,
+    std::span<RenderOverride const> const renderOverrides,
+    SurfaceCulling const& surfaceCulling
+)
+{
+    reset();
+
+    size_t const viewCount{std::min(views.size(), VIEW_CAPACITY)};
+    if (views.size() > VIEW_CAPACITY)
+    {
+        SZG_WARNING("Too many views for meshlet culling, some are not culled.");
+    }
+
+    m_geometryCount = geometry.size();
+    m_drawListRanges.resize(viewCount * geometry.size());
+
+    std::vector<CullPushConstant> dispatches{};
+    uint32_t drawCount{0};
+    bool full{false};
+
+    for (size_t viewIndex{0}; viewIndex < viewCount; viewIndex++)
+    {
+        View const& view{views[viewIndex]};
+        m_views->push(view.packed);
+
+        for (size_t index{0}; index < geometry.size(); index++)
+        {
+            MeshInstanced const& instance{geometry[index]};
+
+            bool render{instance.render};
+            size_t lod{0};
+            if (index < renderOverrides.size())
+            {
+                render = renderOverrides[index].render;
+                lod = renderOverrides[index].lod;
+            }
+            if (!render || !instance.getMesh().has_value()
+                || (view.shadowCastersOnly && !instance.castsShadow))
+            {
+                continue;
+            }
+
+            Mesh const& meshAsset{*instance.getMesh().value().get().data};
+            std::span<GeometrySurface const> const surfaces{
+                lodSurfaces(meshAsset, lod)
+            };
+            GPUMeshBuffers& meshBuffers{*meshAsset.meshBuffers};
+            TStagedBuffer<glm::mat4x4> const& models{*instance.models};
+            auto const instanceCount{
+                static_cast<uint32_t>(models.deviceSize())
+            };
+
+            // Culled surfaces get an empty list, so they are not drawn.
+            // Surfaces drawn instanced need no list either.
+            auto const instanced{[&](size_t const surfaceIndex)
+            {
+                return surfaceCulling.visible(viewIndex, index, surfaceIndex)
+                    && surfaces[surfaceIndex].meshletCount
+                           <= MAX_INSTANCED_MESHLETS;
+            }};
+            auto const surfaceDrawCapacity{[&](size_t const surfaceIndex)
+            {
+                return surfaceCulling.visible(viewIndex, index, surfaceIndex)
+                            && !instanced(surfaceIndex)
+                         ? surfaces[surfaceIndex].meshletCount * instanceCount
+                         : 0U;
+            }};
+
+            size_t requiredDraws{0};
+            for (size_t surfaceIndex{0}; surfaceIndex < surfaces.size();
+                 surfaceIndex++)
+            {
+                requiredDraws += surfaceDrawCapacity(surfaceIndex);
+            }
+            if (m_drawLists.size() + surfaces.size() > COUNT_CAPACITY
+                || drawCount + requiredDraws > DRAW_CAPACITY)
+            {
+                full = true;
+                continue;
+            }
+
+            m_drawListRanges[viewIndex * m_geometryCount + index] =
+                DrawListRange{
+                    .firstList = static_cast<uint32_t>(m_drawLists.size()),
+                    .count = static_cast<uint32_t>(surfaces.size()),
+                };
+
+            for (size_t surfaceIndex{0}; surfaceIndex < surfaces.size();
+                 surfaceIndex++)
+            {
+                GeometrySurface const& surface{surfaces[surfaceIndex]};
+                DrawList const drawList{
+                    .firstDraw = drawCount,
+                    .drawCapacity = surfaceDrawCapacity(surfaceIndex),
+                    .countIndex = static_cast<uint32_t>(m_drawLists.size()),
+                    .instanced = instanced(surfaceIndex),
+                };
+                m_drawLists.push_back(drawList);
+                drawCount += drawList.drawCapacity;
+
+                if (drawList.drawCapacity == 0)
+                {
+                    continue;
+                }
+
+                dispatches.push_back(CullPushConstant{
+                    .meshletBuffer = meshBuffers.meshletAddress(),
+                    .modelBuffer = models.deviceAddress(),
+                    .viewBuffer = m_views->deviceAddress(),
+                    .drawBuffer = m_drawBuffer->deviceAddress(),
+                    .countBuffer = m_countBuffer->deviceAddress(),
+                    .viewIndex = static_cast<uint32_t>(viewIndex),
+                    .firstMeshlet = surface.firstMeshlet,
+                    .meshletCount = surface.meshletCount,
+                    .instanceCount = instanceCount,
+                    .firstDraw = drawList.firstDraw,
+                    .countIndex = drawList.countIndex,
+                });
+            }
+        }
+    }
+
+    if (full)
+    {
+        SZG_WARNING(
+            "Meshlet culling buffers are full, some geometry is not culled."
+        );
+    }
+
+    if (m_drawLists.empty())
+    {
+        return;
+    }
+
+    m_views->recordCopyToDevice(cmd);
+    m_views->recordTotalCopyBarrier(
+        cmd,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        VK_ACCESS_2_SHADER_STORAGE_READ_BIT
+    );
+
+    // The previous results may still be in use by indirect draws.
+    recordBufferBarrier(
+        cmd,
+        m_countBuffer->buffer(),
+        VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+        VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT,
+        VK_PIPELINE_STAGE_2_CLEAR_BIT,
+        VK_ACCESS_2_TRANSFER_WRITE_BIT
+    );
+    recordBufferBarrier(
+        cmd,
+        m_drawBuffer->buffer(),
+        VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+        VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT
+    );
+
+    vkCmdFillBuffer(
+        cmd,
+        m_countBuffer->buffer(),
+        0,
+        m_drawLists.size() * sizeof(uint32_t),
+        0
+    );
+    recordBufferBarrier(
+        cmd,
+        m_countBuffer->buffer(),
+        VK_PIPELINE_STAGE_2_CLEAR_BIT,
+        VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        VK_ACCESS_2_SHADER_STORAGE_READ_BIT
+            | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT
+    );
+
+    VkShaderStageFlagBits const computeStage{VK_SHADER_STAGE_COMPUTE_BIT};
+    VkShaderEXT const shader{m_cullShader.shaderObject()};
+    vkCmdBindShadersEXT(cmd, 1, &computeStage, &shader);
+
+    uint32_t constexpr WORKGROUP_SIZE{64};
+    for (CullPushConstant const& pushConstant : dispatches)
+    {
+        vkCmdPushConstants(
+            cmd,
+            m_cullLayout,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            0,
+            sizeof(CullPushConstant),
+            &pushConstant
+        );
+        vkCmdDispatch(
+            cmd,
+            computeDispatchCount(
+                pushConstant.meshletCount * pushConstant.instanceCount,
+                WORKGROUP_SIZE
+            ),
+            1,
+            1
+        );
+    }
+
+    VkShaderEXT const unboundHandle{VK_NULL_HANDLE};
+    vkCmdBindShadersEXT(cmd, 1, &computeStage, &unboundHandle);
+
+    recordBufferBarrier(
+        cmd,
+        m_drawBuffer->buffer(),
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+        VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT
+    );
+    recordBufferBarrier(
+        cmd,
+        m_countBuffer->buffer(),
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+        VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT
+    );
+}
+
+void MeshletCullingPass::reset()
+{
+    m_views->clearStaged();
+    m_geometryCount = 0;
+    m_drawListRanges.clear();
+    m_drawLists.clear();
+}
+
+void MeshletCullingPass::recordDrawSurface(
+    VkCommandBuffer const cmd,
+    size_t const viewIndex,
+    size_t const geometryIndex,
+    size_t const surfaceIndex,
+    GeometrySurface const& surface,
+    uint32_t const instanceCount
+) const
+{
+    size_t const rangeIndex{viewIndex * m_geometryCount + geometryIndex};
+    if (geometryIndex >= m_geometryCount
+        || rangeIndex >= m_drawListRanges.size()
+        || surfaceIndex >= m_drawListRanges[rangeIndex].count)
+    {
+        vkCmdDrawIndexed(
+            cmd, surface.indexCount, instanceCount, surface.firstIndex, 0, 0
+        );
+        return;
+    }
+
+    DrawList const& drawList{
+        m_drawLists[m_drawListRanges[rangeIndex].firstList + surfaceIndex]
+    };
+    if (drawList.instanced)
+    {
+        vkCmdDrawIndexed(
+            cmd, surface.indexCount, instanceCount, surface.firstIndex, 0, 0
+        );
+        return;
+    }
+    if (drawList.drawCapacity == 0)
+    {
+        return;
+    }
+
+    vkCmdDrawIndexedIndirectCount(
+        cmd,
+        m_drawBuffer->buffer(),
+        drawList.firstDraw * sizeof(VkDrawIndexedIndirectCommand),
+        m_countBuffer->buffer(),
+        drawList.countIndex * sizeof(uint32_t),
+        drawList.drawCapacity,
+        sizeof(VkDrawIndexedIndirectCommand)
+    );
+}
+
+void MeshletCullingPass::cleanup(VkDevice const device)
+{
+    m_views.reset();
+    m_drawBuffer.reset();
+    m_countBuffer.reset();
+
+    vkDestroyPipelineLayout(device, m_cullLayout, nullptr);
+    m_cullShader.cleanup(device);
+}
+} // namespace syzygy
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/platform/vulkanusage.hpp"
+#include "syzygy/renderer/buffers.hpp"
+#include "syzygy/renderer/gputypes.hpp"
+#include "syzygy/renderer/pipelines.hpp"
+#include "syzygy/renderer/shaders.hpp"
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace syzygy
+{
+struct GeometrySurface;
+struct MeshInstanced;
+struct SurfaceCulling;
+} // namespace syzygy
+
+namespace syzygy
+{
+// Culls the meshlets of scene geometry on the device, once per view, into
+// compacted lists of indirect draws. Each surface of each instance in each
+// view gets its own list, so draws keep their per-surface state.
+//
+// Every surviving meshlet of every instance is its own draw, so surfaces with
+// few meshlets are not culled, and are instead drawn whole with one instanced
+// draw. This keeps geometry such as thousands of instanced cubes to one draw.
+struct MeshletCullingPass
+{
+public:
+    MeshletCullingPass(VkDevice device, VmaAllocator allocator);
+
+    struct View
+    {
+        MeshletCullViewPacked packed{};
+        // Geometry that does not cast shadows is not culled for this view.
+        bool shadowCastersOnly{false};
+    };
+
+    // The frustum is extracted from projView, which must have a depth range
+    // of [0,1]. See MeshletCullViewPacked for eye and facingCull.
+    [[nodiscard]] static auto makeView(
+        glm::mat4x4 const& projView,
+        glm::vec4 eye,
+        float facingCull,
+        bool shadowCastersOnly
+    ) -> View;
+
+    // Replaces all previous results. This must be recorded outside of
+    // rendering, and before any surface is drawn with recordDrawSurface.
+    //
+    // Geometry is skipped where the corresponding render override is false,
+    // and when the buffers are full, in which case it is drawn whole. Surfaces
+    // that surfaceCulling culled from a view, which must have been culled
+    // against the same views, are neither culled nor drawn.
+    void recordCullCommands(
+        VkCommandBuffer cmd,
+        std::span<View const> views,
+        std::span<MeshInstanced const> geometry,
+        std::span<RenderOverride const> renderOverrides,
+        SurfaceCulling const& surfaceCulling
+    );
+
+    // Discards all results, so every surface is drawn whole.
+    void reset();
+
+    // Draws whatever survived culling of a surface of the geometry at
+    // geometryIndex, as passed to recordCullCommands. The mesh's index buffer
+    // must be bound. Surfaces that were not culled, including those with too
+    // few meshlets, are drawn whole with instanceCount instances.
+    void recordDrawSurface(
+        VkCommandBuffer cmd,
+        size_t viewIndex,
+        size_t geometryIndex,
+        size_t surfaceIndex,
+        GeometrySurface const& surface,
+        uint32_t instanceCount
+    ) const;
+
+    void cleanup(VkDevice device);
+
+private:
+    static size_t constexpr VIEW_CAPACITY{32};
+    static size_t constexpr DRAW_CAPACITY{1U << 18U};
+    static size_t constexpr COUNT_CAPACITY{1U << 14U};
+    // Surfaces with at most this many meshlets skip meshlet culling, since
+    // it would turn one instanced draw into one draw per instance.
+    static uint32_t constexpr MAX_INSTANCED_MESHLETS{1};
+
+    struct CullPushConstant
+    {
+        VkDeviceAddress meshletBuffer{};
+        VkDeviceAddress modelBuffer{};
+        VkDeviceAddress viewBuffer{};
+        VkDeviceAddress drawBuffer{};
+        VkDeviceAddress countBuffer{};
+
+        uint32_t viewIndex{0};
+        uint32_t firstMeshlet{0};
+        uint32_t meshletCount{0};
+        uint32_t instanceCount{0};
+
+        uint32_t firstDraw{0};
+        uint32_t countIndex{0};
+    };
+
+    // The draws and count for one surface of one instance in one view.
+    struct DrawList
+    {
+        uint32_t firstDraw{0};
+        uint32_t drawCapacity{0};
+        uint32_t countIndex{0};
+        // Drawn whole and instanced, without being culled.
+        bool instanced{false};
+    };
+
+    // The draw lists of every surface of one instance in one view, with a
+    // count of 0 if it was not culled.
+    struct DrawListRange
+    {
+        uint32_t firstList{0};
+        uint32_t count{0};
+    };
+
+    std::unique_ptr<TStagedBuffer<MeshletCullViewPacked>> m_views{};
+    std::unique_ptr<AllocatedBuffer> m_drawBuffer{};
+    std::unique_ptr<AllocatedBuffer> m_countBuffer{};
+
+    size_t m_geometryCount{0};
+    // Indexed by viewIndex * m_geometryCount + geometryIndex.
+    std::vector<DrawListRange> m_drawListRanges{};
+    std::vector<DrawList> m_drawLists{};
+
+    ShaderObjectReflected m_cullShader{ShaderObjectReflected::makeInvalid()};
+    VkPipelineLayout m_cullLayout{VK_NULL_HANDLE};
+};
+} // namespace syzygy
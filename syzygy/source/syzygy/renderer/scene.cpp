@@ -8,6 +8,7 @@
 #include "syzygy/geometry/geometrystatics.hpp"
 #include "syzygy/platform/integer.hpp"
 #include "syzygy/renderer/lights.hpp"
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <functional>
@@ -157,7 +158,6 @@ auto Scene::geometry() -> std::span<MeshInstanced> { return m_geometry; }
 void Scene::addMeshInstance(
     VkDevice const device,
     VmaAllocator const allocator,
-    DescriptorAllocator& descriptorAllocator,
     std::optional<AssetPtr<Mesh>> const& mesh,
     InstanceAnimation const animation,
     std::string const& name,
@@ -176,7 +176,6 @@ void Scene::addMeshInstance(
         instance.setMesh(mesh.value());
     }
 
-    instance.prepareDescriptors(device, descriptorAllocator);
     instance.animation = animation;
 
     instance.originals.insert(
@@ -236,7 +235,6 @@ void Scene::addSpotlight(glm::vec3 const color, Transform const transform)
 auto Scene::defaultScene(
     VkDevice const device,
     VmaAllocator const allocator,
-    DescriptorAllocator& descriptorAllocator,
     std::optional<AssetPtr<Mesh>> const& initialMesh
 ) -> Scene
 {
@@ -252,7 +250,6 @@ auto Scene::defaultScene(
         scene.addMeshInstance(
             device,
             allocator,
-            descriptorAllocator,
             initialMesh,
             InstanceAnimation::None,
             "Floor",
@@ -273,7 +270,6 @@ auto Scene::defaultScene(
         scene.addMeshInstance(
             device,
             allocator,
-            descriptorAllocator,
             initialMesh,
             InstanceAnimation::None,
             "Floating",
@@ -335,7 +331,6 @@ auto Scene::defaultScene(
 auto Scene::diagonalWaveScene(
     VkDevice const device,
     VmaAllocator const allocator,
-    DescriptorAllocator& descriptorAllocator,
     std::optional<AssetPtr<Mesh>> const& initialMesh
 ) -> Scene
 {
@@ -354,7 +349,6 @@ auto Scene::diagonalWaveScene(
         scene.addMeshInstance(
             device,
             allocator,
-            descriptorAllocator,
             initialMesh,
             InstanceAnimation::None,
             "Floor",
@@ -387,7 +381,6 @@ auto Scene::diagonalWaveScene(
         scene.addMeshInstance(
             device,
             allocator,
-            descriptorAllocator,
             initialMesh,
             InstanceAnimation::Diagonal_Wave,
             "DiagonalWave",
@@ -795,11 +788,13 @@ auto Camera::projection(float const aspectRatio) const -> glm::mat4x4
 
 void MeshInstanced::setMesh(AssetPtr<Mesh> meshAsset)
 {
-    m_mesh = std::move(meshAsset);
     m_surfaceDescriptorsDirty = true;
 
-    if (AssetShared<Mesh> const pMesh{m_mesh.lock()};
-        pMesh != nullptr && pMesh->data != nullptr)
+    AssetShared<Mesh> const pMesh{meshAsset.lock()};
+    m_meshPool = pMesh != nullptr ? pMesh->pool : nullptr;
+    m_mesh = pMesh != nullptr ? pMesh->handle : AssetHandle<Mesh>{};
+
+    if (pMesh != nullptr && pMesh->data != nullptr)
     {
         Mesh const& mesh{*pMesh->data};
         AABB const meshBounds{mesh.vertexBounds};
@@ -820,17 +815,22 @@ void MeshInstanced::setMesh(AssetPtr<Mesh> meshAsset)
 }
 
 void MeshInstanced::prepareDescriptors(
-    VkDevice const device, DescriptorAllocator& descriptorAllocator
+    VkDevice const device,
+    DescriptorAllocator& descriptorAllocator,
+    uint64_t const frame
 )
 {
-    if (!m_surfaceDescriptorsDirty || m_mesh.lock() == nullptr
-        || m_mesh.lock()->data == nullptr)
+    std::optional<AssetRef<Mesh>> const meshRef{getMesh()};
+    if (!meshRef.has_value() || meshRef.value().get().data == nullptr)
     {
         return;
     }
 
-    Mesh const& mesh{*m_mesh.lock()->data};
+    Mesh const& mesh{*meshRef.value().get().data};
 
+    // Even if nothing about this instance changed, the textures behind the
+    // materials may have been swapped in place, so each surface is checked.
+    bool const forceWrite{m_surfaceDescriptorsDirty};
     m_surfaceDescriptorsDirty = false;
 
     while (m_surfaceDescriptors.size() < mesh.surfaces.size())
@@ -843,6 +843,7 @@ void MeshInstanced::prepareDescriptors(
             SZG_ERROR(
                 "Failed to allocate MaterialDescriptors while setting mesh."
             );
+            m_meshPool = nullptr;
             m_mesh = {};
             return;
         }
@@ -854,39 +855,74 @@ void MeshInstanced::prepareDescriptors(
 
     for (size_t index{0}; index < mesh.surfaces.size(); index++)
     {
-        GeometrySurface const& surface{mesh.surfaces[index]};
-        MaterialDescriptors const& descriptors{m_surfaceDescriptors[index]};
-        MaterialData const& overrides{m_surfaceMaterialOverrides[index]};
-
-        MaterialData const activeMaterials{
-            .ORM = overrides.ORM.lock() != nullptr ? overrides.ORM
-                                                   : surface.material.ORM,
-            .normal = overrides.normal.lock() != nullptr
-                        ? overrides.normal
-                        : surface.material.normal,
-            .color = overrides.color.lock() != nullptr ? overrides.color
-                                                       : surface.material.color,
-        };
+        MaterialDescriptors& descriptors{m_surfaceDescriptors[index]};
+        MaterialData const materials{activeMaterials(mesh, index)};
 
-        descriptors.write(activeMaterials);
+        if (forceWrite || !descriptors.isCurrent(materials))
+        {
+            descriptors.write(descriptorAllocator, materials, frame);
+        }
     }
 }
 
+void MeshInstanced::markTexturesUsed(TextureResidency& residency) const
+{
+    std::optional<AssetRef<Mesh>> const meshRef{getMesh()};
+    if (!meshRef.has_value() || meshRef.value().get().data == nullptr)
+    {
+        return;
+    }
+
+    Mesh const& mesh{*meshRef.value().get().data};
+    size_t const surfaceCount{
+        std::min(mesh.surfaces.size(), m_surfaceMaterialOverrides.size())
+    };
+    for (size_t index{0}; index < surfaceCount; index++)
+    {
+        MaterialData const materials{activeMaterials(mesh, index)};
+
+        residency.markUsed(materials.color);
+        residency.markUsed(materials.normal);
+        residency.markUsed(materials.ORM);
+    }
+}
+
+auto MeshInstanced::activeMaterials(Mesh const& mesh, size_t const surface)
+    const -> MaterialData
+{
+    MaterialData const& base{mesh.surfaces[surface].material};
+    MaterialData const& overrides{m_surfaceMaterialOverrides[surface]};
+
+    return MaterialData{
+        .ORM = overrides.ORM.get() != nullptr ? overrides.ORM : base.ORM,
+        .normal = overrides.normal.get() != nullptr ? overrides.normal
+                                                    : base.normal,
+        .color = overrides.color.get() != nullptr ? overrides.color
+                                                  : base.color,
+    };
+}
+
 auto MeshInstanced::getMesh() const -> std::optional<AssetRef<Mesh>>
 {
-    if (m_mesh.lock() == nullptr)
+    if (m_meshPool == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    Asset<Mesh> const* const mesh{m_meshPool->get(m_mesh)};
+    if (mesh == nullptr)
     {
         return std::nullopt;
     }
 
-    return *m_mesh.lock();
+    return *mesh;
 }
 
 auto MeshInstanced::getMaterialOverrides() const
     -> std::span<MaterialData const>
 {
-    std::shared_ptr<Asset<Mesh> const> const mesh{m_mesh.lock()};
-    if (mesh == nullptr || mesh->data == nullptr)
+    std::optional<AssetRef<Mesh>> const meshRef{getMesh()};
+    if (!meshRef.has_value() || meshRef.value().get().data == nullptr)
     {
         return {};
     }
@@ -894,7 +930,9 @@ auto MeshInstanced::getMaterialOverrides() const
     return std::span<MaterialData const>{
         m_surfaceMaterialOverrides.begin(),
         m_surfaceMaterialOverrides.begin()
-            + static_cast<std::int64_t>(mesh->data->surfaces.size())
+            + static_cast<std::int64_t>(
+                meshRef.value().get().data->surfaces.size()
+            )
     };
 }
 
@@ -123,8 +123,15 @@ struct MeshInstanced
     std::unique_ptr<TStagedBuffer<glm::mat4x4>> modelInverseTransposes{};
 
     void setMesh(AssetPtr<Mesh>);
-    void prepareDescriptors(VkDevice, DescriptorAllocator&);
-
+    // Sets replaced by this frame's writes are retired against frame, which
+    // should be TextureResidency::frame.
+    void prepareDescriptors(VkDevice, DescriptorAllocator&, uint64_t frame);
+    // Marks the textures of the materials that prepareDescriptors binds as
+    // used this frame.
+    void markTexturesUsed(TextureResidency&) const;
+
+    // A lookup into the mesh's pool by handle, without reference counting, so
+    // it is cheap enough to call per instance in per-frame loops.
     [[nodiscard]] auto getMesh() const -> std::optional<AssetRef<Mesh>>;
 
     // Returns only as many overrides as there are surfaces in the current mesh
@@ -137,12 +144,17 @@ struct MeshInstanced
         -> std::span<MaterialDescriptors const>;
 
 private:
+    // The surface's material, with any overrides applied.
+    [[nodiscard]] auto activeMaterials(Mesh const&, size_t surface) const
+        -> MaterialData;
+
     bool m_surfaceDescriptorsDirty{false};
 
     // The mesh will use the materials in this structure first, then defer to
     // the base asset's materials.
     std::vector<MaterialData> m_surfaceMaterialOverrides{};
-    AssetPtr<Mesh> m_mesh{};
+    AssetPool<Mesh> const* m_meshPool{nullptr};
+    AssetHandle<Mesh> m_mesh{};
     std::vector<MaterialDescriptors> m_surfaceDescriptors{};
 };
 // NOLINTEND(misc-non-private-member-variables-in-classes)
@@ -186,7 +198,6 @@ public:
     void addMeshInstance(
         VkDevice,
         VmaAllocator,
-        DescriptorAllocator&,
         std::optional<AssetPtr<Mesh>> const&,
         InstanceAnimation,
         std::string const& name,
@@ -198,13 +209,11 @@ public:
     static auto defaultScene(
         VkDevice,
         VmaAllocator,
-        DescriptorAllocator&,
         std::optional<AssetPtr<Mesh>> const& initialMesh
     ) -> Scene;
     static auto diagonalWaveScene(
         VkDevice,
         VmaAllocator,
-        DescriptorAllocator&,
         std::optional<AssetPtr<Mesh>> const& initialMesh
     ) -> Scene;
 
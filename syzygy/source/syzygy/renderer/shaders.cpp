@@ -555,7 +555,7 @@ auto loadShaderObject(
         ShaderObjectReflected::fromBytecodeReflected(
             device,
             file.path.filename().string(),
-            file.fileBytes,
+            file.fileBytes(),
             stage,
             nextStage,
             layouts,
@@ -587,7 +587,7 @@ auto loadShaderObject(
         ShaderObjectReflected::fromBytecode(
             device,
             file.path.filename().string(),
-            file.fileBytes,
+            file.fileBytes(),
             stage,
             nextStage,
             layouts,
@@ -635,7 +635,7 @@ auto loadShaderModule(VkDevice const device, std::string const& path)
 
     return std::optional<ShaderModuleReflected>{
         ShaderModuleReflected::FromBytecode(
-            device, file.path.filename().string(), file.fileBytes
+            device, file.path.filename().string(), file.fileBytes()
         )
     };
 }
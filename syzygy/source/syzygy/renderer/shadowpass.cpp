@@ -10,6 +10,8 @@
 #include "syzygy/renderer/pipelines.hpp"
 #include "syzygy/renderer/rendercommands.hpp"
 #include "syzygy/renderer/vulkanstructs.hpp"
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
 #include <utility>
 
 namespace syzygy
@@ -201,17 +203,36 @@ void ShadowPassArray::recordInitialize(
 
         TStagedBuffer<glm::mat4x4>& projViewMatrices{*m_projViewMatrices};
         projViewMatrices.clearStaged();
+        m_cullViews.clear();
+
+        // Shadow maps are drawn with front faces culled, so meshlets are
+        // culled when they entirely face the light.
+        float constexpr FACING_CULL{-1.0F};
 
         size_t shadowMapCount{0};
         for (DirectionalLightPacked const& light : directionalLights)
         {
-            projViewMatrices.push(light.projection * light.view);
+            glm::mat4x4 const projView{light.projection * light.view};
+            projViewMatrices.push(projView);
+            m_cullViews.push_back(MeshletCullingPass::makeView(
+                projView,
+                glm::vec4{glm::vec3{light.forward}, 0.0F},
+                FACING_CULL,
+                true
+            ));
 
             shadowMapCount += 1;
         }
         for (SpotLightPacked const& light : spotLights)
         {
-            projViewMatrices.push(light.projection * light.view);
+            glm::mat4x4 const projView{light.projection * light.view};
+            projViewMatrices.push(projView);
+            m_cullViews.push_back(MeshletCullingPass::makeView(
+                projView,
+                glm::vec4{glm::vec3{light.position}, 1.0F},
+                FACING_CULL,
+                true
+            ));
 
             shadowMapCount += 1;
         }
@@ -222,6 +243,7 @@ void ShadowPassArray::recordInitialize(
             projViewMatrices.pop(
                 projViewMatrices.stagedSize() - m_shadowmaps.size()
             );
+            m_cullViews.resize(m_shadowmaps.size());
         }
 
         projViewMatrices.recordCopyToDevice(cmd);
@@ -247,10 +269,19 @@ void ShadowPassArray::recordInitialize(
     }
 }
 
+auto ShadowPassArray::cullViews() const
+    -> std::span<MeshletCullingPass::View const>
+{
+    return m_cullViews;
+}
+
 void ShadowPassArray::recordDrawCommands(
     VkCommandBuffer const cmd,
     std::span<MeshInstanced const> const geometry,
-    std::span<RenderOverride const> const renderOverrides
+    std::span<RenderOverride const> const renderOverrides,
+    MeshletCullingPass const& meshletCulling,
+    SurfaceCulling const& surfaceCulling,
+    size_t const firstCullViewIndex
 )
 {
     for (size_t i{0}; i < m_projViewMatrices->deviceSize(); i++)
@@ -264,7 +295,10 @@ void ShadowPassArray::recordDrawCommands(
             i,
             *m_projViewMatrices,
             geometry,
-            renderOverrides
+            renderOverrides,
+            meshletCulling,
+            surfaceCulling,
+            firstCullViewIndex + i
         );
     }
 }
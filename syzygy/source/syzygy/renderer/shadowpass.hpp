@@ -5,6 +5,7 @@
 #include "syzygy/renderer/buffers.hpp"
 #include "syzygy/renderer/imageview.hpp"
 #include "syzygy/renderer/pipelines.hpp"
+#include "syzygy/renderer/pipelines/meshletculling.hpp"
 #include <glm/mat4x4.hpp>
 #include <memory>
 #include <optional>
@@ -17,6 +18,7 @@ struct DescriptorAllocator;
 struct DirectionalLightPacked;
 struct SpotLightPacked;
 struct MeshInstanced;
+struct SurfaceCulling;
 } // namespace syzygy
 
 namespace syzygy
@@ -52,10 +54,20 @@ public:
         std::span<syzygy::SpotLightPacked const> spotLights
     );
 
+    // The views for culling what is drawn into each active shadow map, in
+    // order. These are updated by recordInitialize.
+    [[nodiscard]] auto cullViews() const
+        -> std::span<MeshletCullingPass::View const>;
+
+    // Shadow map i is drawn with the culling results of view
+    // firstCullViewIndex + i.
     void recordDrawCommands(
         VkCommandBuffer cmd,
         std::span<syzygy::MeshInstanced const> geometry,
-        std::span<RenderOverride const> renderOverrides
+        std::span<RenderOverride const> renderOverrides,
+        MeshletCullingPass const& meshletCulling,
+        SurfaceCulling const& surfaceCulling,
+        size_t firstCullViewIndex
     );
 
     // Transitions all the shadow map VkImages, with a total memory barrier.
@@ -77,6 +89,7 @@ private:
     // Each of these staged values represents
     // a shadow map we are going to write
     std::unique_ptr<TStagedBuffer<glm::mat4x4>> m_projViewMatrices{};
+    std::vector<MeshletCullingPass::View> m_cullViews{};
 
     VmaAllocator m_allocator{VK_NULL_HANDLE};
 
@@ -0,0 +1,202 @@
+#include "surfaceculling.hpp"
+
+#include "syzygy/assets/assets.hpp"
+#include "syzygy/geometry/geometrytypes.hpp"
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/renderer/buffers.hpp"
+#include "syzygy/renderer/pipelines.hpp"
+#include "syzygy/renderer/pipelines/meshletculling.hpp"
+#include "syzygy/renderer/scene.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <span>
+#include <vector>
+
+namespace
+{
+using FrustumPlanes = std::array<glm::vec4, 6>;
+
+auto planeDistance(glm::vec4 const& plane, glm::vec3 const& point) -> float
+{
+    return glm::dot(glm::vec3{plane}, point) + plane.w;
+}
+
+// The bounds are in mesh space, and placed by the model. The box is only tested
+// when the sphere intersects the frustum without being contained by it.
+auto intersectsFrustum(
+    FrustumPlanes const& planes,
+    glm::mat4x4 const& model,
+    syzygy::AABB const& bounds,
+    syzygy::Sphere const& sphere
+) -> bool
+{
+    float const scale{std::max({
+        glm::length(glm::vec3{model[0]}),
+        glm::length(glm::vec3{model[1]}),
+        glm::length(glm::vec3{model[2]}),
+    })};
+    glm::vec3 const sphereCenter{model * glm::vec4{sphere.center, 1.0F}};
+    float const sphereRadius{sphere.radius * scale};
+
+    bool sphereContained{true};
+    for (glm::vec4 const& plane : planes)
+    {
+        float const distance{planeDistance(plane, sphereCenter)};
+        if (distance < -sphereRadius)
+        {
+            return false;
+        }
+        sphereContained &= distance >= sphereRadius;
+    }
+    if (sphereContained)
+    {
+        return true;
+    }
+
+    // The box stays oriented by the model, so its extent along each plane's
+    // normal is the sum of the projections of its transformed half axes.
+    glm::vec3 const boxCenter{model * glm::vec4{bounds.center, 1.0F}};
+    glm::vec3 const halfExtent{glm::abs(bounds.halfExtent)};
+    for (glm::vec4 const& plane : planes)
+    {
+        glm::vec3 const normal{plane};
+        float const radius{
+            std::abs(glm::dot(normal, glm::vec3{model[0]})) * halfExtent.x
+            + std::abs(glm::dot(normal, glm::vec3{model[1]})) * halfExtent.y
+            + std::abs(glm::dot(normal, glm::vec3{model[2]})) * halfExtent.z
+        };
+        if (planeDistance(plane, boxCenter) < -radius)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+} // namespace
+
+namespace syzygy
+{
+void SurfaceCulling::cull(
+    std::span<MeshletCullingPass::View const> const views,
+    std::span<MeshInstanced const> const geometry,
+    std::span<RenderOverride const> const renderOverrides
+)
+{
+    reset();
+
+    m_geometryCount = geometry.size();
+    m_ranges.resize(views.size() * geometry.size());
+
+    // The models of an instance whose mesh intersects the view as a whole,
+    // which are the only ones its surfaces need to be tested under.
+    std::vector<glm::mat4x4> intersectingModels{};
+
+    for (size_t viewIndex{0}; viewIndex < views.size(); viewIndex++)
+    {
+        MeshletCullingPass::View const& view{views[viewIndex]};
+        FrustumPlanes const& planes{view.packed.frustumPlanes};
+
+        size_t& surfaceCount{
+            view.shadowCastersOnly ? m_statistics.shadowSurfaces
+                                   : m_statistics.cameraSurfaces
+        };
+        size_t& culledCount{
+            view.shadowCastersOnly ? m_statistics.shadowSurfacesCulled
+                                   : m_statistics.cameraSurfacesCulled
+        };
+
+        for (size_t index{0}; index < geometry.size(); index++)
+        {
+            MeshInstanced const& instance{geometry[index]};
+
+            bool render{instance.render};
+            size_t lod{0};
+            if (index < renderOverrides.size())
+            {
+                render = renderOverrides[index].render;
+                lod = renderOverrides[index].lod;
+            }
+            if (!render || !instance.getMesh().has_value()
+                || (view.shadowCastersOnly && !instance.castsShadow))
+            {
+                continue;
+            }
+
+            Mesh const& mesh{*instance.getMesh().value().get().data};
+            std::span<GeometrySurface const> const surfaces{
+                lodSurfaces(mesh, lod)
+            };
+
+            Sphere const meshSphere{Sphere::circumscribe(mesh.vertexBounds)};
+            intersectingModels.clear();
+            for (glm::mat4x4 const& model : instance.models->readValidStaged())
+            {
+                if (intersectsFrustum(
+                        planes, model, mesh.vertexBounds, meshSphere
+                    ))
+                {
+                    intersectingModels.push_back(model);
+                }
+            }
+
+            m_ranges[viewIndex * m_geometryCount + index] = SurfaceRange{
+                .first = m_visible.size(),
+                .count = surfaces.size(),
+            };
+            for (GeometrySurface const& surface : surfaces)
+            {
+                bool const visible{std::any_of(
+                    intersectingModels.begin(),
+                    intersectingModels.end(),
+                    [&](glm::mat4x4 const& model)
+                {
+                    return intersectsFrustum(
+                        planes, model, surface.bounds, surface.boundingSphere
+                    );
+                }
+                )};
+                m_visible.push_back(visible);
+
+                surfaceCount++;
+                culledCount += visible ? 0 : 1;
+            }
+        }
+    }
+}
+
+void SurfaceCulling::reset()
+{
+    m_geometryCount = 0;
+    m_ranges.clear();
+    m_visible.clear();
+    m_statistics = SurfaceCullingStatistics{};
+}
+
+auto SurfaceCulling::visible(
+    size_t const viewIndex,
+    size_t const geometryIndex,
+    size_t const surfaceIndex
+) const -> bool
+{
+    size_t const rangeIndex{viewIndex * m_geometryCount + geometryIndex};
+    if (geometryIndex >= m_geometryCount || rangeIndex >= m_ranges.size()
+        || surfaceIndex >= m_ranges[rangeIndex].count)
+    {
+        return true;
+    }
+
+    return m_visible[m_ranges[rangeIndex].first + surfaceIndex];
+}
+
+auto SurfaceCulling::statistics() const -> SurfaceCullingStatistics
+{
+    return m_statistics;
+}
+} // namespace syzygy
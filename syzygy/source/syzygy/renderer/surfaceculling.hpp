@@ -0,0 +1,69 @@
+#pragma once
+
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/renderer/pipelines/meshletculling.hpp"
+#include <span>
+#include <vector>
+
+namespace syzygy
+{
+struct MeshInstanced;
+} // namespace syzygy
+
+namespace syzygy
+{
+// Surfaces tested and culled across the views of the last cull, split between
+// the camera and the shadow maps.
+struct SurfaceCullingStatistics
+{
+    size_t cameraSurfaces{0};
+    size_t cameraSurfacesCulled{0};
+    size_t shadowSurfaces{0};
+    size_t shadowSurfacesCulled{0};
+};
+
+// Culls each surface of scene geometry on the host, against the same views as
+// MeshletCullingPass. A surface is culled from a view when its bounds, under
+// every instance's model, lie outside the view's frustum. Each instance's
+// sphere is tested first, and the box only when the sphere intersects.
+//
+// This is coarser than meshlet culling, but skips the draws and culling
+// dispatches of whole surfaces, such as the parts of a large multi-material
+// model that are out of view.
+struct SurfaceCulling
+{
+public:
+    // Views that only draw shadow casters count towards the shadow statistics,
+    // and the rest towards the camera's.
+    void cull(
+        std::span<MeshletCullingPass::View const> views,
+        std::span<MeshInstanced const> geometry,
+        std::span<RenderOverride const> renderOverrides
+    );
+
+    // Forgets every result and the statistics, so every surface is visible.
+    void reset();
+
+    // Indices are as passed to the last cull. Surfaces that were not tested
+    // are visible.
+    [[nodiscard]] auto visible(
+        size_t viewIndex, size_t geometryIndex, size_t surfaceIndex
+    ) const -> bool;
+
+    [[nodiscard]] auto statistics() const -> SurfaceCullingStatistics;
+
+private:
+    // The results of every surface of one instance in one view.
+    struct SurfaceRange
+    {
+        size_t first{0};
+        size_t count{0};
+    };
+
+    size_t m_geometryCount{0};
+    // Indexed by viewIndex * m_geometryCount + geometryIndex.
+    std::vector<SurfaceRange> m_ranges{};
+    std::vector<bool> m_visible{};
+    SurfaceCullingStatistics m_statistics{};
+};
+} // namespace syzygy
@@ -0,0 +1,753 @@
+#include "uploadqueue.hpp"
+
+#include "syzygy/core/deletionqueue.hpp"
+#include "syzygy/core/log.hpp"
+#include "syzygy/platform/vulkanmacros.hpp"
+#include "syzygy/renderer/vulkanstructs.hpp"
+#include <utility>
+#include <vector>
+
+namespace
+{
+auto createTimelineSemaphore(VkDevice const device)
+    -> std::optional<VkSemaphore>
+{
+    VkSemaphoreTypeCreateInfo const typeInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .pNext = nullptr,
+
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = 0,
+    };
+    VkSemaphoreCreateInfo semaphoreInfo{syzygy::semaphoreCreateInfo()};
+    semaphoreInfo.pNext = &typeInfo;
+
+    VkSemaphore semaphore{VK_NULL_HANDLE};
+    SZG_TRY_VK(
+        vkCreateSemaphore(device, &semaphoreInfo, nullptr, &semaphore),
+        "Failed to create timeline semaphore.",
+        std::nullopt
+    );
+
+    return semaphore;
+}
+
+auto createCommandPool(VkDevice const device, uint32_t const queueFamilyIndex)
+    -> std::optional<VkCommandPool>
+{
+    VkCommandPoolCreateInfo const commandPoolInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .queueFamilyIndex = queueFamilyIndex,
+    };
+
+    VkCommandPool pool{VK_NULL_HANDLE};
+    SZG_TRY_VK(
+        vkCreateCommandPool(device, &commandPoolInfo, nullptr, &pool),
+        "Failed to allocate command pool.",
+        std::nullopt
+    );
+
+    return pool;
+}
+
+void recordBarriers(
+    VkCommandBuffer const cmd,
+    std::span<VkBufferMemoryBarrier2 const> const bufferBarriers,
+    std::span<VkImageMemoryBarrier2 const> const imageBarriers
+)
+{
+    if (bufferBarriers.empty() && imageBarriers.empty())
+    {
+        return;
+    }
+
+    VkDependencyInfo const dependencyInfo{
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .pNext = nullptr,
+
+        .dependencyFlags = 0,
+
+        .memoryBarrierCount = 0,
+        .pMemoryBarriers = nullptr,
+
+        .bufferMemoryBarrierCount =
+            static_cast<uint32_t>(bufferBarriers.size()),
+        .pBufferMemoryBarriers = bufferBarriers.data(),
+
+        .imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size()),
+        .pImageMemoryBarriers = imageBarriers.data(),
+    };
+
+    vkCmdPipelineBarrier2(cmd, &dependencyInfo);
+}
+} // namespace
+
+namespace syzygy
+{
+UploadQueue::UploadQueue(UploadQueue&& other) noexcept
+{
+    m_device = std::exchange(other.m_device, VK_NULL_HANDLE);
+    m_allocator = std::exchange(other.m_allocator, VK_NULL_HANDLE);
+
+    m_transferQueue = std::exchange(other.m_transferQueue, VK_NULL_HANDLE);
+    m_transferQueueFamily = std::exchange(other.m_transferQueueFamily, 0);
+    m_universalQueue = std::exchange(other.m_universalQueue, VK_NULL_HANDLE);
+    m_universalQueueFamily = std::exchange(other.m_universalQueueFamily, 0);
+
+    m_transferPool = std::exchange(other.m_transferPool, CommandPool{});
+    m_acquirePool = std::exchange(other.m_acquirePool, CommandPool{});
+
+    m_transferTimeline =
+        std::exchange(other.m_transferTimeline, VK_NULL_HANDLE);
+    m_transferValue = std::exchange(other.m_transferValue, 0);
+
+    m_completionTimeline =
+        std::exchange(other.m_completionTimeline, VK_NULL_HANDLE);
+    m_completionValue = std::exchange(other.m_completionValue, 0);
+
+    m_inFlight = std::move(other.m_inFlight);
+
+    m_stagingRing = std::exchange(other.m_stagingRing, std::nullopt);
+    m_pendingOversizedStaging = std::move(other.m_pendingOversizedStaging);
+}
+
+UploadQueue::~UploadQueue() { destroy(); }
+
+void UploadQueue::destroy()
+{
+    if (m_device == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    if (m_completionValue > 0)
+    {
+        uint64_t constexpr DESTROY_TIMEOUT_NANOSECONDS{1'000'000'000};
+        SZG_LOG_VK(
+            wait(
+                UploadTicket{.completionValue = m_completionValue},
+                DESTROY_TIMEOUT_NANOSECONDS
+            ),
+            "Failed to wait for uploads to finish, destroying them anyway."
+        );
+    }
+    m_inFlight.clear();
+    m_stagingRing.reset();
+    m_pendingOversizedStaging.clear();
+
+    vkDestroySemaphore(m_device, m_transferTimeline, nullptr);
+    vkDestroySemaphore(m_device, m_completionTimeline, nullptr);
+
+    vkDestroyCommandPool(m_device, m_transferPool.pool, nullptr);
+    vkDestroyCommandPool(m_device, m_acquirePool.pool, nullptr);
+
+    m_device = VK_NULL_HANDLE;
+    m_allocator = VK_NULL_HANDLE;
+
+    m_transferQueue = VK_NULL_HANDLE;
+    m_transferQueueFamily = 0;
+    m_universalQueue = VK_NULL_HANDLE;
+    m_universalQueueFamily = 0;
+
+    m_transferPool = CommandPool{};
+    m_acquirePool = CommandPool{};
+
+    m_transferTimeline = VK_NULL_HANDLE;
+    m_transferValue = 0;
+
+    m_completionTimeline = VK_NULL_HANDLE;
+    m_completionValue = 0;
+}
+
+auto UploadQueue::create(
+    VkDevice const device,
+    VmaAllocator const allocator,
+    VkQueue const transferQueue,
+    uint32_t const transferQueueFamily,
+    VkQueue const universalQueue,
+    uint32_t const universalQueueFamily
+) -> std::optional<UploadQueue>
+{
+    std::optional<UploadQueue> uploadQueueResult{UploadQueue{}};
+    UploadQueue& uploadQueue{uploadQueueResult.value()};
+
+    // Resources are immediately owned by uploadQueue, so that they are
+    // cleaned up by its destructor on failure.
+    uploadQueue.m_device = device;
+    uploadQueue.m_allocator = allocator;
+
+    uploadQueue.m_transferQueue = transferQueue;
+    uploadQueue.m_transferQueueFamily = transferQueueFamily;
+    uploadQueue.m_universalQueue = universalQueue;
+    uploadQueue.m_universalQueueFamily = universalQueueFamily;
+
+    if (std::optional<VkCommandPool> const poolResult{
+            createCommandPool(device, transferQueueFamily)
+        };
+        poolResult.has_value())
+    {
+        uploadQueue.m_transferPool.pool = poolResult.value();
+    }
+    else
+    {
+        SZG_ERROR("Failed to create transfer command pool for UploadQueue.");
+        return std::nullopt;
+    }
+
+    if (uploadQueue.hasDedicatedTransfer())
+    {
+        if (std::optional<VkCommandPool> const poolResult{
+                createCommandPool(device, universalQueueFamily)
+            };
+            poolResult.has_value())
+        {
+            uploadQueue.m_acquirePool.pool = poolResult.value();
+        }
+        else
+        {
+            SZG_ERROR("Failed to create acquire command pool for UploadQueue."
+            );
+            return std::nullopt;
+        }
+    }
+
+    if (std::optional<VkSemaphore> const semaphoreResult{
+            createTimelineSemaphore(device)
+        };
+        semaphoreResult.has_value())
+    {
+        uploadQueue.m_transferTimeline = semaphoreResult.value();
+    }
+    else
+    {
+        SZG_ERROR("Failed to create transfer timeline for UploadQueue.");
+        return std::nullopt;
+    }
+
+    if (std::optional<VkSemaphore> const semaphoreResult{
+            createTimelineSemaphore(device)
+        };
+        semaphoreResult.has_value())
+    {
+        uploadQueue.m_completionTimeline = semaphoreResult.value();
+    }
+    else
+    {
+        SZG_ERROR("Failed to create completion timeline for UploadQueue.");
+        return std::nullopt;
+    }
+
+    uploadQueue.m_stagingRing =
+        StagingRing::allocate(device, allocator, STAGING_CAPACITY_BYTES);
+    if (!uploadQueue.m_stagingRing.has_value())
+    {
+        SZG_ERROR("Failed to allocate staging ring for UploadQueue.");
+        return std::nullopt;
+    }
+
+    SZG_INFO(
+        "UploadQueue: using queue family {} for transfers, {}.",
+        transferQueueFamily,
+        uploadQueue.hasDedicatedTransfer() ? "dedicated"
+                                           : "shared with universal queue"
+    );
+
+    return uploadQueueResult;
+}
+
+auto UploadQueue::beginCommands(VkDevice const device, CommandPool& pool)
+    -> std::optional<VkCommandBuffer>
+{
+    VkCommandBuffer cmd{VK_NULL_HANDLE};
+    if (!pool.freeBuffers.empty())
+    {
+        cmd = pool.freeBuffers.back();
+        pool.freeBuffers.pop_back();
+
+        SZG_TRY_VK(
+            vkResetCommandBuffer(cmd, 0),
+            "Failed to reset upload command buffer.",
+            std::nullopt
+        );
+    }
+    else
+    {
+        VkCommandBufferAllocateInfo const commandBufferInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .pNext = nullptr,
+
+            .commandPool = pool.pool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 1,
+        };
+
+        SZG_TRY_VK(
+            vkAllocateCommandBuffers(device, &commandBufferInfo, &cmd),
+            "Failed to allocate upload command buffer.",
+            std::nullopt
+        );
+    }
+
+    VkCommandBufferBeginInfo const cmdBeginInfo{
+        commandBufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT)
+    };
+    if (VkResult const beginResult{vkBeginCommandBuffer(cmd, &cmdBeginInfo)};
+        beginResult != VK_SUCCESS)
+    {
+        SZG_LOG_VK(beginResult, "Failed to begin upload command buffer.");
+        pool.freeBuffers.push_back(cmd);
+        return std::nullopt;
+    }
+
+    return cmd;
+}
+
+auto UploadQueue::allocateStaging(VkDeviceSize const size)
+    -> std::optional<StagingRing::Reservation>
+{
+    if (m_device == VK_NULL_HANDLE)
+    {
+        SZG_ERROR("UploadQueue not initialized.");
+        return std::nullopt;
+    }
+
+    StagingRing& ring{m_stagingRing.value()};
+    if (size <= ring.capacity())
+    {
+        while (true)
+        {
+            if (std::optional<StagingRing::Reservation> const reservation{
+                    ring.reserve(size, STAGING_ALIGNMENT)
+                };
+                reservation.has_value())
+            {
+                return reservation;
+            }
+
+            // Free space is only made by uploads completing, so block on the
+            // oldest one still holding space.
+            std::optional<uint64_t> const oldestValue{
+                ring.oldestCommittedValue()
+            };
+            if (!oldestValue.has_value())
+            {
+                // The ring is filled by staging for a single upload.
+                break;
+            }
+
+            uint64_t constexpr TIMEOUT_NANOSECONDS{1'000'000'000};
+            if (VkResult const waitResult{wait(
+                    UploadTicket{.completionValue = oldestValue.value()},
+                    TIMEOUT_NANOSECONDS
+                )};
+                waitResult != VK_SUCCESS)
+            {
+                SZG_LOG_VK(waitResult, "Failed to wait for staging space.");
+                return std::nullopt;
+            }
+            collect();
+        }
+    }
+
+    AllocatedBuffer& buffer{
+        m_pendingOversizedStaging.emplace_back(AllocatedBuffer::allocate(
+            m_device,
+            m_allocator,
+            size,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VMA_MEMORY_USAGE_CPU_ONLY,
+            VMA_ALLOCATION_CREATE_MAPPED_BIT
+        ))
+    };
+    if (!buffer.isMapped())
+    {
+        SZG_ERROR("Failed to map oversized staging buffer.");
+        m_pendingOversizedStaging.pop_back();
+        return std::nullopt;
+    }
+
+    return StagingRing::Reservation{
+        .buffer = buffer.buffer(),
+        .offset = 0,
+        .bytes = buffer.mappedBytes(),
+    };
+}
+
+auto UploadQueue::submit(
+    std::function<void(VkCommandBuffer)>&& recordCopies,
+    std::span<BufferHandoff const> const buffers,
+    std::span<ImageHandoff const> const images
+) -> std::optional<UploadTicket>
+{
+    if (m_device == VK_NULL_HANDLE)
+    {
+        SZG_ERROR("UploadQueue not initialized.");
+        return std::nullopt;
+    }
+
+    std::optional<UploadTicket> const ticket{
+        recordAndSubmit(std::move(recordCopies), buffers, images)
+    };
+    if (!ticket.has_value())
+    {
+        // Nothing in flight reads this staging, see recordAndSubmit.
+        m_stagingRing.value().cancel();
+        m_pendingOversizedStaging.clear();
+        return std::nullopt;
+    }
+
+    m_stagingRing.value().commit(ticket.value().completionValue);
+    m_inFlight.back().oversizedStaging = std::move(m_pendingOversizedStaging);
+    m_pendingOversizedStaging.clear();
+
+    return ticket;
+}
+
+auto UploadQueue::submit(UploadBatch&& batch) -> std::optional<UploadTicket>
+{
+    return submit(
+        [&](VkCommandBuffer const cmd)
+    {
+        for (std::function<void(VkCommandBuffer)> const& recordCopies :
+             batch.recordCopies)
+        {
+            recordCopies(cmd);
+        }
+    },
+        batch.buffers,
+        batch.images
+    );
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+auto UploadQueue::recordAndSubmit(
+    std::function<void(VkCommandBuffer)>&& recordCopies,
+    std::span<BufferHandoff const> const buffers,
+    std::span<ImageHandoff const> const images
+) -> std::optional<UploadTicket>
+{
+    bool const transferOwnership{hasDedicatedTransfer()};
+
+    // Without a dedicated queue, the "release" barriers are plain barriers
+    // that make the writes available to the destination stages.
+    std::vector<VkBufferMemoryBarrier2> releaseBuffers{};
+    std::vector<VkBufferMemoryBarrier2> acquireBuffers{};
+    for (BufferHandoff const& handoff : buffers)
+    {
+        VkBufferMemoryBarrier2 const barrier{
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+            .pNext = nullptr,
+
+            .srcStageMask = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT,
+            .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            .dstStageMask = handoff.dstStageMask,
+            .dstAccessMask = handoff.dstAccessMask,
+
+            .srcQueueFamilyIndex = transferOwnership ? m_transferQueueFamily
+                                                     : VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = transferOwnership ? m_universalQueueFamily
+                                                     : VK_QUEUE_FAMILY_IGNORED,
+
+            .buffer = handoff.buffer,
+            .offset = 0,
+            .size = VK_WHOLE_SIZE,
+        };
+
+        if (!transferOwnership)
+        {
+            releaseBuffers.push_back(barrier);
+            continue;
+        }
+
+        // The destination scope of a release, and the source scope of an
+        // acquire, are ignored.
+        VkBufferMemoryBarrier2 release{barrier};
+        release.dstStageMask = VK_PIPELINE_STAGE_2_NONE;
+        release.dstAccessMask = VK_ACCESS_2_NONE;
+        releaseBuffers.push_back(release);
+
+        VkBufferMemoryBarrier2 acquire{barrier};
+        acquire.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+        acquire.srcAccessMask = VK_ACCESS_2_NONE;
+        acquireBuffers.push_back(acquire);
+    }
+
+    std::vector<VkImageMemoryBarrier2> releaseImages{};
+    std::vector<VkImageMemoryBarrier2> acquireImages{};
+    for (ImageHandoff const& handoff : images)
+    {
+        VkImageMemoryBarrier2 const barrier{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+            .pNext = nullptr,
+
+            .srcStageMask = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT,
+            .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            .dstStageMask = handoff.dstStageMask,
+            .dstAccessMask = handoff.dstAccessMask,
+
+            .oldLayout = handoff.oldLayout,
+            .newLayout = handoff.newLayout,
+
+            .srcQueueFamilyIndex = transferOwnership ? m_transferQueueFamily
+                                                     : VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = transferOwnership ? m_universalQueueFamily
+                                                     : VK_QUEUE_FAMILY_IGNORED,
+
+            .image = handoff.image,
+            .subresourceRange = handoff.subresourceRange,
+        };
+
+        if (!transferOwnership)
+        {
+            releaseImages.push_back(barrier);
+            continue;
+        }
+
+        VkImageMemoryBarrier2 release{barrier};
+        release.dstStageMask = VK_PIPELINE_STAGE_2_NONE;
+        release.dstAccessMask = VK_ACCESS_2_NONE;
+        releaseImages.push_back(release);
+
+        VkImageMemoryBarrier2 acquire{barrier};
+        acquire.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+        acquire.srcAccessMask = VK_ACCESS_2_NONE;
+        acquireImages.push_back(acquire);
+    }
+
+    std::optional<VkCommandBuffer> const transferCommandsResult{
+        beginCommands(m_device, m_transferPool)
+    };
+    if (!transferCommandsResult.has_value())
+    {
+        return std::nullopt;
+    }
+    VkCommandBuffer const transferCommands{transferCommandsResult.value()};
+
+    recordCopies(transferCommands);
+    recordBarriers(transferCommands, releaseBuffers, releaseImages);
+
+    if (VkResult const endResult{vkEndCommandBuffer(transferCommands)};
+        endResult != VK_SUCCESS)
+    {
+        SZG_LOG_VK(endResult, "Failed to end upload command buffer.");
+        m_transferPool.freeBuffers.push_back(transferCommands);
+        return std::nullopt;
+    }
+
+    {
+        VkSemaphoreSubmitInfo signalInfo{semaphoreSubmitInfo(
+            VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+            transferOwnership ? m_transferTimeline : m_completionTimeline
+        )};
+        signalInfo.value =
+            (transferOwnership ? m_transferValue : m_completionValue) + 1;
+
+        std::vector<VkCommandBufferSubmitInfo> const commandInfos{
+            commandBufferSubmitInfo(transferCommands)
+        };
+        std::vector<VkSemaphoreSubmitInfo> const signalInfos{signalInfo};
+        VkSubmitInfo2 const transferSubmit{
+            submitInfo(commandInfos, {}, signalInfos)
+        };
+
+        if (VkResult const submitResult{vkQueueSubmit2(
+                m_transferQueue, 1, &transferSubmit, VK_NULL_HANDLE
+            )};
+            submitResult != VK_SUCCESS)
+        {
+            SZG_LOG_VK(submitResult, "Failed to submit upload.");
+            m_transferPool.freeBuffers.push_back(transferCommands);
+            return std::nullopt;
+        }
+
+        if (transferOwnership)
+        {
+            m_transferValue++;
+        }
+        else
+        {
+            m_completionValue++;
+        }
+    }
+
+    VkCommandBuffer acquireCommands{VK_NULL_HANDLE};
+    if (transferOwnership)
+    {
+        // If acquiring fails, the copies are still in flight and reading from
+        // staging, so they must finish before it can be freed by submit.
+        DeletionQueue waitForTransfer{};
+        waitForTransfer.pushFunction(
+            [&]()
+        {
+            uint64_t constexpr TIMEOUT_NANOSECONDS{1'000'000'000};
+            VkSemaphoreWaitInfo const waitInfo{
+                .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+                .pNext = nullptr,
+                .flags = 0,
+                .semaphoreCount = 1,
+                .pSemaphores = &m_transferTimeline,
+                .pValues = &m_transferValue,
+            };
+            SZG_LOG_VK(
+                vkWaitSemaphores(m_device, &waitInfo, TIMEOUT_NANOSECONDS),
+                "Failed to wait for orphaned upload."
+            );
+            m_transferPool.freeBuffers.push_back(transferCommands);
+        }
+        );
+
+        std::vector<VkCommandBufferSubmitInfo> acquireCommandInfos{};
+        if (!acquireBuffers.empty() || !acquireImages.empty())
+        {
+            std::optional<VkCommandBuffer> const acquireCommandsResult{
+                beginCommands(m_device, m_acquirePool)
+            };
+            if (!acquireCommandsResult.has_value())
+            {
+                waitForTransfer.flush();
+                return std::nullopt;
+            }
+            acquireCommands = acquireCommandsResult.value();
+
+            recordBarriers(acquireCommands, acquireBuffers, acquireImages);
+
+            if (VkResult const endResult{vkEndCommandBuffer(acquireCommands)};
+                endResult != VK_SUCCESS)
+            {
+                SZG_LOG_VK(endResult, "Failed to end acquire command buffer.");
+                m_acquirePool.freeBuffers.push_back(acquireCommands);
+                waitForTransfer.flush();
+                return std::nullopt;
+            }
+
+            acquireCommandInfos.push_back(
+                commandBufferSubmitInfo(acquireCommands)
+            );
+        }
+
+        VkSemaphoreSubmitInfo waitInfo{semaphoreSubmitInfo(
+            VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, m_transferTimeline
+        )};
+        waitInfo.value = m_transferValue;
+
+        VkSemaphoreSubmitInfo signalInfo{semaphoreSubmitInfo(
+            VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, m_completionTimeline
+        )};
+        signalInfo.value = m_completionValue + 1;
+
+        std::vector<VkSemaphoreSubmitInfo> const waitInfos{waitInfo};
+        std::vector<VkSemaphoreSubmitInfo> const signalInfos{signalInfo};
+        VkSubmitInfo2 const acquireSubmit{
+            submitInfo(acquireCommandInfos, waitInfos, signalInfos)
+        };
+
+        if (VkResult const submitResult{vkQueueSubmit2(
+                m_universalQueue, 1, &acquireSubmit, VK_NULL_HANDLE
+            )};
+            submitResult != VK_SUCCESS)
+        {
+            SZG_LOG_VK(submitResult, "Failed to submit upload acquire.");
+            if (acquireCommands != VK_NULL_HANDLE)
+            {
+                m_acquirePool.freeBuffers.push_back(acquireCommands);
+            }
+            waitForTransfer.flush();
+            return std::nullopt;
+        }
+
+        m_completionValue++;
+        waitForTransfer.clear();
+    }
+
+    m_inFlight.push_back(InFlightUpload{
+        .completionValue = m_completionValue,
+        .transferCommands = transferCommands,
+        .acquireCommands = acquireCommands,
+    });
+
+    return UploadTicket{.completionValue = m_completionValue};
+}
+
+auto UploadQueue::completedValue() const -> uint64_t
+{
+    uint64_t value{0};
+    SZG_LOG_VK(
+        vkGetSemaphoreCounterValue(m_device, m_completionTimeline, &value),
+        "Failed to get upload timeline value."
+    );
+    return value;
+}
+
+auto UploadQueue::isComplete(UploadTicket const ticket) const -> bool
+{
+    if (m_device == VK_NULL_HANDLE)
+    {
+        return false;
+    }
+
+    return ticket.completionValue <= completedValue();
+}
+
+auto UploadQueue::wait(
+    UploadTicket const ticket, uint64_t const timeoutNanoseconds
+) const -> VkResult
+{
+    if (m_device == VK_NULL_HANDLE)
+    {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    VkSemaphoreWaitInfo const waitInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+        .semaphoreCount = 1,
+        .pSemaphores = &m_completionTimeline,
+        .pValues = &ticket.completionValue,
+    };
+
+    return vkWaitSemaphores(m_device, &waitInfo, timeoutNanoseconds);
+}
+
+void UploadQueue::collect()
+{
+    if (m_device == VK_NULL_HANDLE || m_inFlight.empty())
+    {
+        return;
+    }
+
+    uint64_t const completed{completedValue()};
+    while (!m_inFlight.empty()
+           && m_inFlight.front().completionValue <= completed)
+    {
+        InFlightUpload const& upload{m_inFlight.front()};
+
+        m_transferPool.freeBuffers.push_back(upload.transferCommands);
+        if (upload.acquireCommands != VK_NULL_HANDLE)
+        {
+            m_acquirePool.freeBuffers.push_back(upload.acquireCommands);
+        }
+
+        m_inFlight.pop_front();
+    }
+
+    m_stagingRing.value().reclaim(completed);
+}
+
+auto UploadQueue::completionSemaphore() const -> VkSemaphore
+{
+    return m_completionTimeline;
+}
+
+auto UploadQueue::hasDedicatedTransfer() const -> bool
+{
+    return m_transferQueueFamily != m_universalQueueFamily;
+}
+
+auto UploadQueue::uploadsInFlight() const -> size_t
+{
+    return m_inFlight.size();
+}
+} // namespace syzygy
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/platform/vulkanusage.hpp"
+#include "syzygy/renderer/buffers.hpp"
+#include <deque>
+#include <functional>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace syzygy
+{
+struct UploadBatch;
+} // namespace syzygy
+
+namespace syzygy
+{
+// Identifies a submitted upload. The upload is complete once its transfers have
+// finished and its resources have been acquired by the universal queue.
+struct UploadTicket
+{
+    uint64_t completionValue{0};
+};
+
+// Records host to device copies onto a dedicated transfer queue, when the
+// device has one, without waiting on the CPU for them to finish. Progress is
+// tracked with timeline semaphores, which can be polled with UploadTicket.
+//
+// Source data is staged in a persistently mapped StagingRing, whose space is
+// recycled as uploads complete.
+//
+// Destination resources are released from the transfer queue family and
+// acquired by the universal queue family on completion, so they can be used
+// as normal by the renderer once their ticket is complete.
+struct UploadQueue
+{
+public:
+    auto operator=(UploadQueue&&) -> UploadQueue& = delete;
+    UploadQueue(UploadQueue const&) = delete;
+    auto operator=(UploadQueue const&) -> UploadQueue& = delete;
+
+    UploadQueue(UploadQueue&&) noexcept;
+    ~UploadQueue();
+
+private:
+    UploadQueue() = default;
+    void destroy();
+
+public:
+    // If the queue families are equal, no ownership transfers are done and
+    // everything is submitted to the universal queue.
+    static auto create(
+        VkDevice,
+        VmaAllocator,
+        VkQueue transferQueue,
+        uint32_t transferQueueFamily,
+        VkQueue universalQueue,
+        uint32_t universalQueueFamily
+    ) -> std::optional<UploadQueue>;
+
+    // A buffer written by an upload, and how it will be first used.
+    struct BufferHandoff
+    {
+        VkBuffer buffer{VK_NULL_HANDLE};
+        VkPipelineStageFlags2 dstStageMask{VK_PIPELINE_STAGE_2_NONE};
+        VkAccessFlags2 dstAccessMask{VK_ACCESS_2_NONE};
+    };
+
+    // An image written by an upload, and how it will be first used. The upload
+    // is expected to leave the image in oldLayout.
+    struct ImageHandoff
+    {
+        VkImage image{VK_NULL_HANDLE};
+        VkImageSubresourceRange subresourceRange{};
+        VkImageLayout oldLayout{VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL};
+        VkImageLayout newLayout{VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        VkPipelineStageFlags2 dstStageMask{VK_PIPELINE_STAGE_2_NONE};
+        VkAccessFlags2 dstAccessMask{VK_ACCESS_2_NONE};
+    };
+
+    static VkDeviceSize constexpr STAGING_CAPACITY_BYTES{64ULL * 1024 * 1024};
+
+    // Aligned for copies into any uncompressed or block-compressed format.
+    static VkDeviceSize constexpr STAGING_ALIGNMENT{16};
+
+    // Host memory for the source data of the next submitted upload, which
+    // stays reserved until that upload completes.
+    //
+    // This may block on older uploads when the ring is full. Allocations
+    // larger than the ring are given their own buffer.
+    auto allocateStaging(VkDeviceSize size)
+        -> std::optional<StagingRing::Reservation>;
+
+    // The callback should only record transfer commands, since the queue may
+    // be transfer-only. Handoffs are recorded after the callback.
+    //
+    // Staging allocated since the last submit is read by this upload. If
+    // submission fails, that staging is freed.
+    auto submit(
+        std::function<void(VkCommandBuffer)>&& recordCopies,
+        std::span<BufferHandoff const> buffers,
+        std::span<ImageHandoff const> images
+    ) -> std::optional<UploadTicket>;
+
+    // Records every upload in the batch into one command buffer, and submits
+    // them together under a single ticket.
+    auto submit(UploadBatch&& batch) -> std::optional<UploadTicket>;
+
+    [[nodiscard]] auto isComplete(UploadTicket) const -> bool;
+
+    // Blocks until the upload completes, or until the timeout.
+    auto wait(UploadTicket, uint64_t timeoutNanoseconds) const -> VkResult;
+
+    // Recycles the command buffers and staging resources of completed
+    // uploads. Should be called regularly, such as once per frame.
+    void collect();
+
+    // Signaled with UploadTicket::completionValue by the universal queue. Work
+    // that must not start before an upload can wait on this on the GPU.
+    [[nodiscard]] auto completionSemaphore() const -> VkSemaphore;
+
+    [[nodiscard]] auto hasDedicatedTransfer() const -> bool;
+
+    [[nodiscard]] auto uploadsInFlight() const -> size_t;
+
+private:
+    struct CommandPool
+    {
+        VkCommandPool pool{VK_NULL_HANDLE};
+        std::vector<VkCommandBuffer> freeBuffers{};
+    };
+
+    struct InFlightUpload
+    {
+        uint64_t completionValue{0};
+        VkCommandBuffer transferCommands{VK_NULL_HANDLE};
+        VkCommandBuffer acquireCommands{VK_NULL_HANDLE};
+        std::vector<AllocatedBuffer> oversizedStaging{};
+    };
+
+    static auto beginCommands(VkDevice, CommandPool&)
+        -> std::optional<VkCommandBuffer>;
+
+    auto recordAndSubmit(
+        std::function<void(VkCommandBuffer)>&& recordCopies,
+        std::span<BufferHandoff const> buffers,
+        std::span<ImageHandoff const> images
+    ) -> std::optional<UploadTicket>;
+
+    [[nodiscard]] auto completedValue() const -> uint64_t;
+
+    VkDevice m_device{VK_NULL_HANDLE};
+    VmaAllocator m_allocator{VK_NULL_HANDLE};
+
+    VkQueue m_transferQueue{VK_NULL_HANDLE};
+    uint32_t m_transferQueueFamily{0};
+    VkQueue m_universalQueue{VK_NULL_HANDLE};
+    uint32_t m_universalQueueFamily{0};
+
+    CommandPool m_transferPool{};
+    CommandPool m_acquirePool{};
+
+    // With a dedicated transfer queue, the transfer queue signals this, and
+    // the universal queue waits on it before acquiring ownership.
+    VkSemaphore m_transferTimeline{VK_NULL_HANDLE};
+    uint64_t m_transferValue{0};
+
+    VkSemaphore m_completionTimeline{VK_NULL_HANDLE};
+    uint64_t m_completionValue{0};
+
+    std::deque<InFlightUpload> m_inFlight{};
+
+    std::optional<StagingRing> m_stagingRing{};
+    // Staging too large for the ring, waiting to be read by the next submit.
+    std::vector<AllocatedBuffer> m_pendingOversizedStaging{};
+};
+
+// Uploads gathered to be submitted at once, see UploadQueue::submit. Staging
+// for each upload should be allocated and written as it is added, so all host
+// writes are done before any commands are recorded.
+struct UploadBatch
+{
+    std::vector<std::function<void(VkCommandBuffer)>> recordCopies{};
+    std::vector<UploadQueue::BufferHandoff> buffers{};
+    std::vector<UploadQueue::ImageHandoff> images{};
+
+    [[nodiscard]] auto empty() const -> bool { return recordCopies.empty(); }
+};
+} // namespace syzygy
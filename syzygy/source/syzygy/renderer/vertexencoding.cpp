@@ -0,0 +1,214 @@
+#include "vertexencoding.hpp"
+
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/platform/vulkanusage.hpp"
+#include "syzygy/renderer/gputypes.hpp"
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <glm/common.hpp>
+#include <glm/packing.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <limits>
+#include <span>
+
+namespace
+{
+// Maps the unit sphere onto the [-1, 1] square, see "A Survey of Efficient
+// Representations for Independent Unit Vectors" by Cigolle et al. Decoded by
+// decodeOctahedral in shaders/types/meshvertex.glsl.
+auto encodeOctahedral(glm::vec3 const normal) -> glm::vec2
+{
+    float const manhattanLength{
+        std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z)
+    };
+    if (manhattanLength == 0.0F)
+    {
+        return glm::vec2{0.0F};
+    }
+
+    glm::vec2 const projected{
+        glm::vec2{normal.x, normal.y} / manhattanLength
+    };
+    if (normal.z >= 0.0F)
+    {
+        return projected;
+    }
+
+    // Fold the lower hemisphere over the diagonals.
+    return glm::vec2{
+        (1.0F - std::abs(projected.y)) * (projected.x >= 0.0F ? 1.0F : -1.0F),
+        (1.0F - std::abs(projected.x)) * (projected.y >= 0.0F ? 1.0F : -1.0F)
+    };
+}
+
+// The destination, such as staging memory, may not be aligned for T.
+template <typename T>
+void storeVertex(uint8_t* const destination, T const& vertex)
+{
+    std::memcpy(destination, &vertex, sizeof(T));
+}
+
+auto packCompact(syzygy::VertexPacked const& vertex)
+    -> syzygy::VertexCompactPacked
+{
+    return syzygy::VertexCompactPacked{
+        .position = vertex.position,
+        .normalOctahedral =
+            glm::packSnorm2x16(encodeOctahedral(vertex.normal)),
+        .uv = glm::packHalf2x16(glm::vec2{vertex.uv_x, vertex.uv_y}),
+        .color = glm::packUnorm4x8(vertex.color),
+    };
+}
+} // namespace
+
+namespace syzygy
+{
+auto VertexEncoding::create(
+    VertexFormat const format, std::span<VertexPacked const> const vertices
+) -> VertexEncoding
+{
+    VertexEncoding encoding{.format = format};
+    if (format != VertexFormat::Quantized || vertices.empty())
+    {
+        return encoding;
+    }
+
+    glm::vec3 min{std::numeric_limits<float>::max()};
+    glm::vec3 max{std::numeric_limits<float>::lowest()};
+    for (VertexPacked const& vertex : vertices)
+    {
+        min = glm::min(min, vertex.position);
+        max = glm::max(max, vertex.position);
+    }
+
+    encoding.positionOffset = min;
+    encoding.positionScale = max - min;
+    return encoding;
+}
+
+auto VertexEncoding::stride(VertexFormat const format) -> size_t
+{
+    switch (format)
+    {
+    case VertexFormat::Full:
+        return sizeof(VertexPacked);
+    case VertexFormat::Compact:
+        return sizeof(VertexCompactPacked);
+    case VertexFormat::Quantized:
+        return sizeof(VertexQuantizedPacked);
+    }
+    return sizeof(VertexPacked);
+}
+
+void VertexEncoding::encode(
+    std::span<VertexPacked const> const vertices,
+    std::span<uint8_t> const destination
+) const
+{
+    size_t const vertexStride{stride(format)};
+    assert(destination.size() == vertices.size() * vertexStride);
+
+    switch (format)
+    {
+    case VertexFormat::Full:
+        std::memcpy(destination.data(), vertices.data(), vertices.size_bytes());
+        return;
+    case VertexFormat::Compact:
+        for (size_t index{0}; index < vertices.size(); index++)
+        {
+            storeVertex(
+                destination.data() + index * vertexStride,
+                packCompact(vertices[index])
+            );
+        }
+        return;
+    case VertexFormat::Quantized:
+    {
+        // A flat axis has no extent, so every position decodes to the offset
+        // no matter what is stored.
+        glm::vec3 const inverseScale{
+            positionScale.x > 0.0F ? 1.0F / positionScale.x : 0.0F,
+            positionScale.y > 0.0F ? 1.0F / positionScale.y : 0.0F,
+            positionScale.z > 0.0F ? 1.0F / positionScale.z : 0.0F,
+        };
+
+        for (size_t index{0}; index < vertices.size(); index++)
+        {
+            VertexPacked const& vertex{vertices[index]};
+            VertexCompactPacked const compact{packCompact(vertex)};
+
+            glm::vec3 const normalized{
+                (vertex.position - positionOffset) * inverseScale
+            };
+            glm::vec2 const octahedral{encodeOctahedral(vertex.normal)};
+
+            // The low half of positionZNormal is z, then the normal takes the
+            // two high bytes.
+            uint32_t const positionZ{glm::packUnorm2x16(
+                glm::vec2{normalized.z, 0.0F}
+            )};
+            uint32_t const normal{glm::packSnorm4x8(
+                glm::vec4{0.0F, 0.0F, octahedral.x, octahedral.y}
+            )};
+
+            storeVertex(
+                destination.data() + index * vertexStride,
+                VertexQuantizedPacked{
+                    .positionXY = glm::packUnorm2x16(
+                        glm::vec2{normalized.x, normalized.y}
+                    ),
+                    .positionZNormal = positionZ | normal,
+                    .uv = compact.uv,
+                    .color = compact.color,
+                }
+            );
+        }
+        return;
+    }
+    }
+}
+
+auto IndexEncoding::indexType(size_t const vertexCount) -> VkIndexType
+{
+    // Indices go up to one less than the count, so 65536 vertices still fit.
+    return vertexCount <= std::numeric_limits<uint16_t>::max() + 1ULL
+             ? VK_INDEX_TYPE_UINT16
+             : VK_INDEX_TYPE_UINT32;
+}
+
+auto IndexEncoding::stride(VkIndexType const indexType) -> size_t
+{
+    return indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t)
+                                             : sizeof(uint32_t);
+}
+
+void IndexEncoding::encode(
+    std::span<uint32_t const> const indices,
+    VkIndexType const indexType,
+    std::span<uint8_t> const destination
+)
+{
+    assert(destination.size() == indices.size() * stride(indexType));
+
+    if (indexType != VK_INDEX_TYPE_UINT16)
+    {
+        std::memcpy(destination.data(), indices.data(), indices.size_bytes());
+        return;
+    }
+
+    for (size_t index{0}; index < indices.size(); index++)
+    {
+        assert(indices[index] <= std::numeric_limits<uint16_t>::max());
+
+        auto const narrowed{static_cast<uint16_t>(indices[index])};
+        std::memcpy(
+            destination.data() + index * sizeof(uint16_t),
+            &narrowed,
+            sizeof(uint16_t)
+        );
+    }
+}
+} // namespace syzygy
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "syzygy/platform/integer.hpp"
+#include "syzygy/platform/vulkanusage.hpp"
+#include <glm/vec3.hpp>
+#include <span>
+
+namespace syzygy
+{
+struct VertexPacked;
+
+// The layouts a mesh's vertex buffer can be in. The values must match
+// VERTEX_FORMAT_* in shaders/types/meshvertex.glsl.
+enum class VertexFormat : uint32_t
+{
+    // VertexPacked
+    Full = 0,
+    // VertexCompactPacked
+    Compact = 1,
+    // VertexQuantizedPacked
+    Quantized = 2,
+};
+
+// How a mesh's vertices were written into its vertex buffer, which the vertex
+// shaders need to read them back.
+struct VertexEncoding
+{
+    VertexFormat format{VertexFormat::Full};
+
+    // Quantized positions are decoded as offset + scale * unorm, so these are
+    // the minimum and extent of the mesh's bounds. Other formats ignore them.
+    glm::vec3 positionOffset{0.0F};
+    glm::vec3 positionScale{1.0F};
+
+    // Computes the bounds to quantize against, if the format needs them.
+    static auto create(VertexFormat, std::span<VertexPacked const> vertices)
+        -> VertexEncoding;
+
+    [[nodiscard]] static auto stride(VertexFormat) -> size_t;
+
+    // The destination must hold exactly stride() bytes per vertex.
+    void encode(
+        std::span<VertexPacked const> vertices, std::span<uint8_t> destination
+    ) const;
+};
+
+// Indices are narrowed to 16 bits when every vertex can be addressed by them.
+struct IndexEncoding
+{
+    [[nodiscard]] static auto indexType(size_t vertexCount) -> VkIndexType;
+    [[nodiscard]] static auto stride(VkIndexType) -> size_t;
+
+    // The destination must hold exactly stride() bytes per index.
+    static void encode(
+        std::span<uint32_t const> indices,
+        VkIndexType,
+        std::span<uint8_t> destination
+    );
+};
+} // namespace syzygy
@@ -2,9 +2,11 @@
 
 #include "syzygy/platform/integer.hpp"
 #include "syzygy/renderer/pipelines.hpp"
+#include "syzygy/renderer/lodselection.hpp"
 #include "syzygy/renderer/pipelines/deferred.hpp"
 #include "syzygy/renderer/shaders.hpp"
 #include "syzygy/renderer/shadowpass.hpp"
+#include "syzygy/renderer/surfaceculling.hpp"
 #include "syzygy/ui/engineui.hpp"
 #include "syzygy/ui/propertytable.hpp"
 #include <cassert>
@@ -425,6 +427,84 @@ template <> void imguiPipelineControls(DeferredShadingPipeline& pipeline)
 {
     DeferredShadingPipeline::Configuration config{pipeline.getConfiguration()};
     imguiStructureControls(config.shadowPassParameters, ShadowPassParameters{});
+
+    DeferredShadingPipeline::Configuration const defaultConfig{};
+    PropertyTable table{PropertyTable::begin()};
+    table
+        .rowBoolean(
+            "Surface Culling",
+            config.surfaceCulling,
+            defaultConfig.surfaceCulling
+        )
+        .rowBoolean(
+            "Meshlet Culling",
+            config.meshletCulling,
+            defaultConfig.meshletCulling
+        )
+        .rowBoolean(
+            "LOD Selection", config.lodSelection, defaultConfig.lodSelection
+        )
+        .rowFloat(
+            "LOD Pixel Error",
+            config.lodPixelError,
+            defaultConfig.lodPixelError,
+            PropertySliderBehavior{
+                .bounds{0.1F, 64.0F},
+            }
+        );
+
+    {
+        LodStatistics const statistics{pipeline.lodStatistics()};
+        size_t const trianglesSaved{
+            statistics.trianglesFullDetail - statistics.trianglesDrawn
+        };
+        float const percentSaved{
+            statistics.trianglesFullDetail > 0
+                ? 100.0F * static_cast<float>(trianglesSaved)
+                      / static_cast<float>(statistics.trianglesFullDetail)
+                : 0.0F
+        };
+
+        table.rowChildPropertyBegin("LOD Statistics")
+            .rowReadOnlyInteger(
+                "Triangles Drawn",
+                static_cast<int32_t>(statistics.trianglesDrawn)
+            )
+            .rowReadOnlyInteger(
+                "Triangles at Full Detail",
+                static_cast<int32_t>(statistics.trianglesFullDetail)
+            )
+            .rowReadOnlyFloat("Percent Saved", percentSaved)
+            .childPropertyEnd();
+    }
+
+    {
+        SurfaceCullingStatistics const statistics{
+            pipeline.surfaceCullingStatistics()
+        };
+
+        table.rowChildPropertyBegin("Surface Culling Statistics")
+            .rowReadOnlyInteger(
+                "Camera Surfaces",
+                static_cast<int32_t>(statistics.cameraSurfaces)
+            )
+            .rowReadOnlyInteger(
+                "Camera Surfaces Culled",
+                static_cast<int32_t>(statistics.cameraSurfacesCulled)
+            )
+            .rowReadOnlyInteger(
+                "Shadow Surfaces",
+                static_cast<int32_t>(statistics.shadowSurfaces)
+            )
+            .rowReadOnlyInteger(
+                "Shadow Surfaces Culled",
+                static_cast<int32_t>(statistics.shadowSurfacesCulled)
+            )
+            .childPropertyEnd();
+    }
+
+    table.end();
+
     pipeline.setConfiguration(config);
 }
 } // namespace syzygy
\ No newline at end of file
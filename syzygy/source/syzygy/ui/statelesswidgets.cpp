@@ -51,7 +51,7 @@ void editorConfigurationWindow(
     std::string const& title,
     std::optional<ImGuiID> dockNode,
     EditorConfiguration& value,
-    EditorConfiguration const& /*defaults*/
+    EditorConfiguration const& defaults
 )
 {
     UIWindowScope const window{UIWindowScope::beginDockable(
@@ -62,6 +62,9 @@ void editorConfigurationWindow(
         return;
     }
 
+    float constexpr WELD_TOLERANCE_SPEED{0.0001F};
+    float constexpr TEXTURE_BUDGET_SPEED{0.01F};
+
     syzygy::PropertyTable::begin()
         .rowCustom(
             "Gamma Transfer Function",
@@ -91,6 +94,60 @@ void editorConfigurationWindow(
         }
     }
         )
+        .rowBoolean(
+            "Batch Asset Uploads",
+            value.batchAssetUploads,
+            defaults.batchAssetUploads
+        )
+        .rowBoolean(
+            "Compact Mesh Vertices",
+            value.compactMeshVertices,
+            defaults.compactMeshVertices
+        )
+        .rowBoolean(
+            "Quantize Mesh Positions",
+            value.quantizeMeshPositions,
+            defaults.quantizeMeshPositions
+        )
+        .rowFloat(
+            "Weld Position Tolerance",
+            value.weldPositionTolerance,
+            defaults.weldPositionTolerance,
+            PropertySliderBehavior{
+                .speed = WELD_TOLERANCE_SPEED,
+                .bounds{0.0F, 1.0F},
+            }
+        )
+        .rowFloat(
+            "Weld Normal Tolerance",
+            value.weldNormalTolerance,
+            defaults.weldNormalTolerance,
+            PropertySliderBehavior{
+                .speed = WELD_TOLERANCE_SPEED,
+                .bounds{0.0F, 2.0F},
+            }
+        )
+        .rowFloat(
+            "Weld UV Tolerance",
+            value.weldUVTolerance,
+            defaults.weldUVTolerance,
+            PropertySliderBehavior{
+                .speed = WELD_TOLERANCE_SPEED,
+                .bounds{0.0F, 1.0F},
+            }
+        )
+        .rowFloat(
+            "Texture Memory Budget",
+            value.textureMemoryBudget,
+            defaults.textureMemoryBudget,
+            PropertySliderBehavior{
+                .speed = TEXTURE_BUDGET_SPEED,
+                .bounds{0.0F, 1.0F},
+            }
+        )
+        .rowBoolean(
+            "Hot Reload Assets", value.hotReloadAssets, defaults.hotReloadAssets
+        )
         .end();
 }
 } // namespace syzygy
@@ -521,12 +578,13 @@ template <typename T>
 void uiAssetReadOnlyNameField(
     syzygy::PropertyTable& table,
     std::string const& rowName,
-    syzygy::AssetPtr<T> const& asset
+    syzygy::PooledAssetPtr<T> const& asset
 )
 {
+    syzygy::Asset<T> const* const resolved{asset.get()};
     table.rowReadOnlyTextInput(
         rowName,
-        asset.lock() == nullptr ? "None" : asset.lock()->metadata.displayName,
+        resolved == nullptr ? "None" : resolved->metadata.displayName,
         false
     );
 }
@@ -560,6 +618,28 @@ void uiMesh(syzygy::PropertyTable& table, syzygy::Mesh const& mesh)
     }
 
     table.childPropertyEnd();
+
+    table.rowChildPropertyBegin("Levels of Detail");
+
+    size_t level{1};
+    for (syzygy::MeshLod const& lod : mesh.lods)
+    {
+        uint32_t indexCount{0};
+        for (syzygy::GeometrySurface const& surface : lod.surfaces)
+        {
+            indexCount += surface.indexCount;
+        }
+
+        table.rowChildPropertyBegin(fmt::format("LOD {}", level));
+        table.rowReadOnlyInteger(
+            "Index Count", static_cast<int32_t>(indexCount)
+        );
+        table.rowReadOnlyFloat("Error", lod.error);
+        table.childPropertyEnd();
+        level++;
+    }
+
+    table.childPropertyEnd();
 }
 
 void uiMeshMaterialOverrides(
@@ -589,14 +669,17 @@ void uiMeshMaterialOverrides(
             )};
             if (newORM.has_value())
             {
-                newOverride.ORM = newORM.value();
+                newOverride.ORM =
+                    syzygy::PooledAssetPtr<syzygy::ImageView>::from(
+                        newORM.value()
+                    );
                 changed = true;
             }
         },
-            newOverride.ORM.lock() != nullptr,
+            newOverride.ORM.get() != nullptr,
             [&]()
         {
-            newOverride.ORM.reset();
+            newOverride.ORM = {};
             changed = true;
         }
         );
@@ -609,14 +692,17 @@ void uiMeshMaterialOverrides(
             )};
             if (newNormal.has_value())
             {
-                newOverride.normal = newNormal.value();
+                newOverride.normal =
+                    syzygy::PooledAssetPtr<syzygy::ImageView>::from(
+                        newNormal.value()
+                    );
                 changed = true;
             }
         },
-            newOverride.normal.lock() != nullptr,
+            newOverride.normal.get() != nullptr,
             [&]()
         {
-            newOverride.normal.reset();
+            newOverride.normal = {};
             changed = true;
         }
         );
@@ -629,14 +715,17 @@ void uiMeshMaterialOverrides(
             )};
             if (newColor.has_value())
             {
-                newOverride.color = newColor.value();
+                newOverride.color =
+                    syzygy::PooledAssetPtr<syzygy::ImageView>::from(
+                        newColor.value()
+                    );
                 changed = true;
             }
         },
-            newOverride.color.lock() != nullptr,
+            newOverride.color.get() != nullptr,
             [&]()
         {
-            newOverride.color.reset();
+            newOverride.color = {};
             changed = true;
         }
         );